@@ -102,6 +102,7 @@ extern char     tsMonitorFqdn[];
 extern uint16_t tsMonitorPort;
 extern int32_t  tsMonitorMaxLogs;
 extern bool     tsMonitorComp;
+extern uint16_t tsMetricsPort;
 
 // audit
 extern bool     tsEnableAudit;
@@ -122,7 +123,12 @@ extern char    *tsSvrCrashReportUri;
 // query buffer management
 extern int32_t tsQueryBufferSize;  // maximum allowed usage buffer size in MB for each data node during query processing
 extern int64_t tsQueryBufferSizeBytes;    // maximum allowed usage buffer size in byte for each data node
+extern int32_t tsQueryArenaLimit;         // maximum operator scratch memory in MB of one query task, 0 for no limit
+extern int32_t tsSharedBlockCacheSize;    // decoded file blocks in MB shared by the concurrent scans of one vnode
+extern bool    tsTagColumnStore;          // keep the tags of each super table in columns for the tag scans
+extern int32_t tsZoneMapRows;             // rows of one segment in the column zone maps of a data block, 0 for none
 extern int32_t tsCacheLazyLoadThreshold;  // cost threshold for last/last_row loading cache as much as possible
+extern int32_t tsQueryScanThreads;        // number of threads to scan the tables of one aggregate query in parallel
 
 // query client
 extern int32_t tsQueryPolicy;
@@ -206,6 +212,7 @@ extern int32_t tsUptimeInterval;
 
 extern bool    tsDisableStream;
 extern int64_t tsStreamBufferSize;
+extern int32_t tsStreamSubtasks;
 extern bool    tsFilterScalarMode;
 extern int32_t tsMaxStreamBackendCache;
 extern int32_t tsPQSortMemThreshold;
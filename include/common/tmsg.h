@@ -2228,6 +2228,7 @@ typedef struct {
   int64_t  refId;
   int32_t  execId;
   int8_t   status;
+  int64_t  arenaPeak;  // peak arena memory of the task in bytes
 } STaskStatus;
 
 typedef struct {
@@ -2873,6 +2874,7 @@ typedef struct {
 typedef struct {
   int64_t tid;
   char    status[TSDB_JOB_STATUS_LEN];
+  int64_t arenaPeak;  // peak arena memory of the sub task in bytes
 } SQuerySubDesc;
 
 typedef struct {
@@ -3584,6 +3586,8 @@ typedef struct {
   int32_t dstVgId;
   SEpSet  epSet;
   char*   expr;
+  int64_t watermark;  // ms, -1 if unknown
+  int64_t maxDelay;   // ms, -1 if unknown
 } STableIndexInfo;
 
 typedef struct {
@@ -3620,6 +3624,7 @@ typedef struct {
   int64_t      consumerId;
   int64_t      timeout;
   STqOffsetVal reqOffset;
+  int8_t       rawSubmit;  // ask for the submit data of the wal instead of retrieved blocks, db and stable topic only
 } SMqPollReq;
 
 int32_t tSerializeSMqPollReq(void* buf, int32_t bufLen, SMqPollReq* pReq);
@@ -3679,6 +3684,7 @@ typedef struct {
   SArray*      blockData;
   SArray*      blockTbName;
   SArray*      blockSchema;
+  int8_t       rawSubmit;  // each block is an encoded SSubmitReq2 of one SSubmitTbData, not a SRetrieveTableRsp
 } SMqDataRsp;
 
 int32_t tEncodeMqDataRsp(SEncoder* pEncoder, const SMqDataRsp* pRsp);
@@ -3696,6 +3702,7 @@ typedef struct {
   SArray*      blockData;
   SArray*      blockTbName;
   SArray*      blockSchema;
+  int8_t       rawSubmit;
   // the following attributes are extended from SMqDataRsp
   int32_t createTableNum;
   SArray* createTableLen;
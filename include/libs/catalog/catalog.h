@@ -120,6 +120,14 @@ typedef struct SCatalogCfg {
   uint32_t stbRentSec;
 } SCatalogCfg;
 
+typedef struct SCatalogCacheStat {
+  uint64_t cacheSize;    // bytes of all the cached meta of all the clusters
+  uint64_t tbMetaNum;    // table meta entries in cache
+  uint64_t tbMetaHit;
+  uint64_t tbMetaNHit;
+  uint64_t tbMetaEvict;  // table meta entries evicted since the cache exceeds metaCacheMaxSize
+} SCatalogCacheStat;
+
 typedef struct SSTableVersion {
   char     dbFName[TSDB_DB_FNAME_LEN];
   char     stbName[TSDB_TABLE_NAME_LEN];
@@ -339,6 +347,8 @@ int32_t ctgdLaunchAsyncCall(SCatalog* pCtg, SRequestConnInfo* pConn, uint64_t re
 
 int32_t catalogClearCache(void);
 
+int32_t catalogGetCacheStats(SCatalogCacheStat* pStat);
+
 SMetaData* catalogCloneMetaData(SMetaData* pData);
 
 void catalogFreeMetaData(SMetaData* pData);
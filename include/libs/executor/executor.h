@@ -54,6 +54,8 @@ typedef struct {
   void*       pStateBackend;
   int8_t      fillHistory;
   STimeWindow winRange;
+  int32_t     subtaskId;
+  int32_t     numOfSubtasks;  // only the tables of the groups hashed to subtaskId are scanned if it is above 1
 
   struct SStorageAPI api;
 } SReadHandle;
@@ -176,6 +178,14 @@ int32_t qKillTask(qTaskInfo_t tinfo, int32_t rspCode);
 
 bool qTaskIsExecuting(qTaskInfo_t qinfo);
 
+/**
+ * peak memory in bytes taken from the arena of the task so far, only the operator buffers allocated from the arena
+ * are accounted
+ * @param tinfo  qhandle
+ * @return
+ */
+int64_t qGetTaskArenaPeak(qTaskInfo_t tinfo);
+
 /**
  * destroy query info structure
  * @param qHandle
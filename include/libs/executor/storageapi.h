@@ -174,6 +174,7 @@ typedef struct TsdReader {
   int32_t      (*tsdNextDataBlock)();
 
   int32_t      (*tsdReaderRetrieveBlockSMAInfo)();
+  int32_t      (*tsdReaderRetrieveBlockZoneMap)();
   SSDataBlock *(*tsdReaderRetrieveDataBlock)();
 
   void         (*tsdReaderReleaseDataBlock)();
@@ -261,6 +262,7 @@ typedef struct SStoreMeta {
 
   int32_t (*getTableTags)(void* pVnode, uint64_t suid, SArray* uidList);
   int32_t (*getTableTagsByUid)(void* pVnode, int64_t suid, SArray* uidList);
+  int32_t (*getTableTagCols)(void* pVnode, uint64_t suid, SArray* uidList, SSDataBlock* pBlock);  // columnar tag store
   const void* (*extractTagVal)(const void* tag, int16_t type, STagVal* tagVal);  // todo remove it
 
   int32_t (*getTableUidByName)(void* pVnode, char* tbName, uint64_t* uid);
@@ -273,9 +275,9 @@ typedef struct SStoreMeta {
                                    int32_t payloadLen);
 
   int32_t (*getCachedTableList)(void* pVnode, tb_uid_t suid, const uint8_t* pKey, int32_t keyLen, SArray* pList1,
-                                bool* acquireRes);
+                                SArray* pChangedList, int64_t* pVer, bool* acquireRes);
   int32_t (*putCachedTableList)(void* pVnode, uint64_t suid, const void* pKey, int32_t keyLen, void* pPayload,
-                                int32_t payloadLen, double selectivityRatio);
+                                int32_t payloadLen, int64_t ver, double selectivityRatio);
 
   void* (*storeGetIndexInfo)();
   void* (*getInvertIndex)(void* pVnode);
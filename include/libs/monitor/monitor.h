@@ -204,6 +204,8 @@ typedef struct {
   uint16_t    port;
   int32_t     maxLogs;
   bool        comp;
+  const char *metricsFqdn;
+  uint16_t    metricsPort;  // 0 means the prometheus endpoint is disabled
 } SMonCfg;
 
 typedef struct {
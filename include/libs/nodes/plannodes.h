@@ -125,6 +125,7 @@ typedef struct SJoinLogicNode {
   bool           isSingleTableJoin;
   bool           hasSubQuery;
   bool           isLowLevelJoin;
+  SQueryStat     inputStat[2];
 } SJoinLogicNode;
 
 typedef struct SAggLogicNode {
@@ -50,6 +50,8 @@ extern int32_t filterConverNcharColumns(SFilterInfo *pFilterInfo, int32_t rows,
 extern int32_t filterFreeNcharColumns(SFilterInfo *pFilterInfo);
 extern void    filterFreeInfo(SFilterInfo *info);
 extern bool    filterRangeExecute(SFilterInfo *info, SColumnDataAgg **pColsAgg, int32_t numOfCols, int32_t numOfRows);
+extern void    filterRangeExecuteSegs(SFilterInfo *info, SColumnDataAgg **pSegAgg, int32_t numOfCols, int32_t numOfRows,
+                                      int32_t segRows, int32_t numOfSegs, int32_t *pStart, int32_t *pEnd);
 
 /* condition split interface */
 int32_t filterPartitionCond(SNode **pCondition, SNode **pPrimaryKeyCond, SNode **pTagIndexCond, SNode **pTagCond,
@@ -17,6 +17,7 @@
 #include "streamState.h"
 #include "tdatablock.h"
 #include "tdbInt.h"
+#include "tlrucache.h"
 #include "tmsg.h"
 #include "tmsgcb.h"
 #include "tqueue.h"
@@ -311,6 +312,8 @@ typedef struct SSTaskBasicInfo {
   int8_t  taskLevel;
   int8_t  fillHistory;  // is fill history task or not
   int64_t triggerParam; // in msec
+  int32_t subtaskId;     // the source task only handles the groups hashed to this id
+  int32_t numOfSubtasks; // number of source tasks of the stream in the same vnode
 } SSTaskBasicInfo;
 
 typedef struct SStreamDispatchReq SStreamDispatchReq;
@@ -424,7 +427,8 @@ struct SStreamTask {
   int32_t             checkpointNotReadyTasks;
   int32_t             transferStateAlignCnt;
   struct SStreamMeta* pMeta;
-  SSHashObj*          pNameMap;
+  SLRUCache*          pNameMap;   // groupId -> SBlockName of the shuffle dispatch
+  SArray*             pVgRanges;  // vgroup hash ranges of the shuffle dispatch, sorted by hashBegin
   char                reserve[256];
 };
 
@@ -474,8 +478,16 @@ typedef struct SStreamMeta {
   SArray*  chkpInUse;
   int32_t  chkpCap;
   SRWLatch chkpDirLock;
+  void*    pChkpStore;
 } SStreamMeta;
 
+// remote object store the checkpoint files are uploaded to, in addition to the local one
+typedef struct SStreamChkpStoreOps {
+  int32_t (*putFp)(const char* file, const char* object);
+  bool (*getFp)(const char* object, const char* file);
+  void (*delFp)(const char* object[], int32_t num);
+} SStreamChkpStoreOps;
+
 int32_t tEncodeStreamEpInfo(SEncoder* pEncoder, const SStreamChildEpInfo* pInfo);
 int32_t tDecodeStreamEpInfo(SDecoder* pDecoder, SStreamChildEpInfo* pInfo);
 
@@ -789,6 +801,7 @@ int32_t streamProcessScanHistoryFinishRsp(SStreamTask* pTask);
 // stream task meta
 void         streamMetaInit();
 void         streamMetaCleanup();
+void         streamChkpStoreSetRemote(const SStreamChkpStoreOps* pOps);
 SStreamMeta* streamMetaOpen(const char* path, void* ahandle, FTaskExpand expandFunc, int32_t vgId, int64_t stage);
 void         streamMetaClose(SStreamMeta* streamMeta);
 int32_t      streamMetaSaveTask(SStreamMeta* pMeta, SStreamTask* pTask);  // save to stream meta store
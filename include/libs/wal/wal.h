@@ -19,6 +19,7 @@
 #include "tarray.h"
 #include "tdef.h"
 #include "tlog.h"
+#include "tmetrics.h"
 #include "tmsg.h"
 #ifdef __cplusplus
 extern "C" {
@@ -122,6 +123,9 @@ typedef struct SWal {
   char path[WAL_PATH_LEN];
   // reusable write head
   SWalCkHead writeHead;
+  // metrics
+  SMetric *pAppendUs;
+  SMetric *pAppendBytes;
 } SWal;
 
 typedef struct {
@@ -99,6 +99,7 @@ int32_t taosEOFFile(TdFilePtr pFile);
 int32_t taosCloseFile(TdFilePtr *ppFile);
 
 int32_t taosRenameFile(const char *oldName, const char *newName);
+int32_t taosLinkFile(const char *src, const char *dst);
 int64_t taosCopyFile(const char *from, const char *to);
 int32_t taosRemoveFile(const char *path);
 
@@ -53,6 +53,20 @@ void    taosPrintBackTrace();
 void    taosMemoryTrim(int32_t size);
 void   *taosMemoryMallocAlign(uint32_t alignment, int64_t size);
 
+typedef struct {
+  int64_t allocated;  // bytes allocated by the application
+  int64_t active;     // bytes in the pages holding the allocations
+  int64_t resident;   // bytes of the allocator that are resident in physical memory
+  int64_t mapped;     // bytes mapped by the allocator
+  int64_t retained;   // bytes unmapped from the allocator but still kept as virtual memory
+  int32_t numOfArenas;
+} SMemAllocStats;
+
+const char *taosMemoryAllocatorName();
+int32_t     taosMemoryGetAllocStats(SMemAllocStats *pStats);
+int32_t     taosMemoryGetNamedArena(const char *name);
+void        taosMemoryBindArena(int32_t arena);
+
 #define taosMemoryFreeClear(ptr)   \
   do {                             \
     if (ptr) {                     \
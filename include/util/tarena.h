@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TD_UTIL_ARENA_H_
+#define _TD_UTIL_ARENA_H_
+
+#include "os.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TARENA_DEFAULT_CHUNK_SIZE (64 * 1024)
+
+typedef struct SArena SArena;
+
+/*
+ * Region allocator: memory is bump allocated from chunks and is only given back as a whole by taosArenaReset or
+ * taosArenaDestroy. An arena may have a parent, the chunks it holds are then also charged to the parent (and its
+ * ancestors), so that the parent reports the usage of all its children. Allocation fails with
+ * TSDB_CODE_QRY_NOT_ENOUGH_BUFFER once any arena on the path to the root would go beyond its limit.
+ *
+ * A single arena must not be used by several threads at the same time, sub-arenas of the same parent may.
+ */
+SArena *taosArenaInit(SArena *pParent, int32_t chunkSize, int64_t limit);
+void    taosArenaDestroy(SArena *pArena);
+void   *taosArenaAlloc(SArena *pArena, int64_t size);
+void   *taosArenaCalloc(SArena *pArena, int64_t num, int64_t size);
+void    taosArenaReset(SArena *pArena);
+int64_t taosArenaGetUsed(const SArena *pArena);
+int64_t taosArenaGetPeak(const SArena *pArena);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*_TD_UTIL_ARENA_H_*/
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TD_UTIL_METRICS_H_
+#define _TD_UTIL_METRICS_H_
+
+#include "os.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+  METRIC_COUNTER = 1,
+  METRIC_HISTOGRAM,
+} EMetricType;
+
+typedef struct SMetric SMetric;
+
+/*
+ * Process wide metrics registry, dumped in the prometheus text format.
+ *
+ * A metric is identified by its name and labels, e.g. name "taosd_wal_append_us" and labels "vgId=\"2\"". Acquiring
+ * the same metric twice returns the same object, it is freed when the last reference is released. Updates are
+ * lock-free: each metric is split into a few cache line sized stripes, a thread always adds to the same stripe (picked
+ * round-robin when the thread first updates a metric) and the stripes are summed up when the metric is read. Threads
+ * share stripes when there are more of them than stripes, the stripes only spread the contention.
+ * Histogram values are usually latencies in microseconds, they are kept in log-linear buckets with a relative error
+ * below 1/8. All update functions accept a NULL metric, so that a failed acquire only loses the samples.
+ */
+SMetric *taosMetricsAcquire(EMetricType type, const char *name, const char *help, const char *labels);
+void     taosMetricsRelease(SMetric *pMetric);
+void     taosMetricsAdd(SMetric *pMetric, int64_t val);
+void     taosMetricsObserve(SMetric *pMetric, int64_t val);
+int64_t  taosMetricsGetCount(SMetric *pMetric);
+int64_t  taosMetricsGetSum(SMetric *pMetric);
+int64_t  taosMetricsGetQuantile(SMetric *pMetric, double quantile);
+int32_t  taosMetricsDump(char **ppBuf, int32_t *pLen);
+
+#define METRICS_OBSERVE_SINCE(_m, _startUs)                        \
+  do {                                                             \
+    if ((_m) != NULL) {                                            \
+      taosMetricsObserve((_m), taosGetTimestampUs() - (_startUs)); \
+    }                                                              \
+  } while (0)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*_TD_UTIL_METRICS_H_*/
@@ -315,6 +315,43 @@ static FORCE_INLINE SReqResultInfo* tmqGetCurResInfo(TAOS_RES* res) {
 
 SReqResultInfo* tmqGetNextResInfo(TAOS_RES* res, bool convertUcs4);
 
+#define EMPTY_BLOCK_POLL_IDLE_DURATION 10
+
+enum {
+  TMQ_VG_STATUS__IDLE = 0,
+  TMQ_VG_STATUS__WAIT,
+};
+
+typedef struct SVgOffsetInfo {
+  STqOffsetVal committedOffset;
+  STqOffsetVal endOffset;        // the last version in TAOS_RES + 1
+  STqOffsetVal beginOffset;      // the first version in TAOS_RES
+  int64_t      walVerBegin;
+  int64_t      walVerEnd;
+} SVgOffsetInfo;
+
+typedef struct {
+  int64_t       pollCnt;
+  int64_t       numOfRows;
+  SVgOffsetInfo offsetInfo;
+  int32_t       vgId;
+  int32_t       vgStatus;
+  int32_t       vgSkipCnt;              // here used to mark the slow vgroups
+  int64_t       emptyBlockReceiveTs;    // once empty block is received, idle for ignoreCnt then start to poll data
+  bool          seekUpdated;            // offset is updated by seek operator, therefore, not update by vnode rsp.
+  SEpSet        epSet;
+  STqOffsetVal  fetchOffset;            // offset of the next poll req if prefetch is on, ahead of endOffset
+  int32_t       numOfPrefetched;        // poll rsp received but not returned to the application yet
+  int64_t       prefetchedBytes;
+  int32_t       seekVer;                // increased when the prefetched rsp are given up, older rsp are then discarded
+} SMqClientVg;
+
+// count a poll rsp of the vgroup in its prefetch buffer, the vgroup is idle afterwards
+void tmqVgPrefetchAccount(SMqClientVg* pVg, int32_t len, bool hasData, int64_t now);
+
+// the vgroup is not polled for a while after an empty rsp, or when its prefetch buffer is full
+bool tmqVgPollable(const SMqClientVg* pVg, int32_t prefetchNum, int64_t prefetchBytes, int64_t now);
+
 static FORCE_INLINE SReqResultInfo* tscGetCurResInfo(TAOS_RES* res) {
   if (TD_RES_QUERY(res)) return &(((SRequestObj*)res)->body.resInfo);
   return tmqGetCurResInfo(res);
@@ -1749,9 +1749,15 @@ static int32_t doConvertUCS4(SReqResultInfo* pResultInfo, int32_t numOfRows, int
       pResultInfo->convertBuf[i] = p;
 
       SResultColumn* pCol = &pResultInfo->pCol[i];
+      int32_t        lastSrc = -1;
+      int32_t        lastDst = -1;
       for (int32_t j = 0; j < numOfRows; ++j) {
-        if (pCol->offset[j] != -1) {
+        if (pCol->offset[j] != -1 && pCol->offset[j] == lastSrc) {
+          // the rows sharing a value in the block, e.g. the tags of a table, share the converted one as well
+          pCol->offset[j] = lastDst;
+        } else if (pCol->offset[j] != -1) {
           char* pStart = pCol->offset[j] + pCol->pData;
+          lastSrc = pCol->offset[j];
 
           int32_t len = taosUcs4ToMbs((TdUcs4*)varDataVal(pStart), varDataLen(pStart), varDataVal(p));
           if (len > bytes || (p + len) >= (pResultInfo->convertBuf[i] + colLength[i])) {
@@ -1764,6 +1770,7 @@ static int32_t doConvertUCS4(SReqResultInfo* pResultInfo, int32_t numOfRows, int
 
           varDataSetLen(p, len);
           pCol->offset[j] = (p - pResultInfo->convertBuf[i]);
+          lastDst = pCol->offset[j];
           p += (len + VARSTR_HEADER_SIZE);
         }
       }
@@ -1916,6 +1923,10 @@ static int32_t doConvertJson(SReqResultInfo* pResultInfo, int32_t numOfCols, int
         if (offset[j] == -1) {
           continue;
         }
+        if (j > 0 && offset[j] == offset[j - 1]) {
+          offset1[j] = offset1[j - 1];
+          continue;
+        }
         char* data = offset[j] + pStart;
 
         int32_t jsonInnerType = *data;
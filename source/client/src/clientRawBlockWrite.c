@@ -1544,6 +1544,76 @@ end:
   return code;
 }
 
+// The block is the submit data of one table in the wal of the source vnode. It is written with the uid and schema
+// version of the destination table, so the columns are required to be the same in order as the source ones, while
+// a var type column is allowed to be wider. The destination vnode checks the schema version before applying it.
+static int32_t rawSubmitBindBlock(SQuery* pQuery, STableMeta* pTableMeta, int32_t vgId, const SSchemaWrapper* pSW,
+                                  void* data, int32_t dataLen, SVCreateTbReq* pCreateReqDst) {
+  if (pSW->nCols != pTableMeta->tableInfo.numOfColumns) {
+    uError("raw submit columns:%d mismatch with table columns:%d", pSW->nCols, pTableMeta->tableInfo.numOfColumns);
+    return TSDB_CODE_TDB_INVALID_TABLE_SCHEMA_VER;
+  }
+  for (int32_t i = 0; i < pSW->nCols; i++) {
+    SSchema* pSrc = &pSW->pSchema[i];
+    SSchema* pDst = &pTableMeta->schema[i];
+    if (pSrc->type != pDst->type ||
+        (IS_VAR_DATA_TYPE(pSrc->type) ? pSrc->bytes > pDst->bytes : pSrc->bytes != pDst->bytes)) {
+      uError("raw submit column:%s type:%d bytes:%d mismatch with table column:%s type:%d bytes:%d", pSrc->name,
+             pSrc->type, pSrc->bytes, pDst->name, pDst->type, pDst->bytes);
+      return TSDB_CODE_TDB_INVALID_TABLE_SCHEMA_VER;
+    }
+  }
+
+  SSubmitReq2 req = {0};
+  SDecoder    decoder = {0};
+  tDecoderInit(&decoder, data, dataLen);
+  int32_t code = tDecodeSubmitReq(&decoder, &req);
+  tDecoderClear(&decoder);
+  if (code != TSDB_CODE_SUCCESS || taosArrayGetSize(req.aSubmitTbData) != 1) {
+    tDestroySubmitReq(&req, TSDB_MSG_FLG_DECODE);
+    return TSDB_CODE_TMQ_INVALID_MSG;
+  }
+
+  SSubmitTbData tbData = *(SSubmitTbData*)taosArrayGet(req.aSubmitTbData, 0);
+  taosArrayDestroy(req.aSubmitTbData);
+
+  tbData.suid = pTableMeta->suid;
+  tbData.uid = pTableMeta->uid;
+  tbData.sver = pTableMeta->sversion;
+  if (tbData.flags & SUBMIT_REQ_COLUMN_DATA_FORMAT) {
+    for (int32_t i = 0; i < TARRAY_SIZE(tbData.aCol); i++) {
+      SColData* pCol = taosArrayGet(tbData.aCol, i);
+      for (int32_t j = 0; j < pSW->nCols; j++) {
+        if (pSW->pSchema[j].colId == pCol->cid) {
+          pCol->cid = pTableMeta->schema[j].colId;
+          break;
+        }
+      }
+    }
+  } else {
+    // the rows are in the rsp buffer, and they are encoded by column position only
+    for (int32_t i = 0; i < TARRAY_SIZE(tbData.aRowP); i++) {
+      SRow* pRow = taosArrayGetP(tbData.aRowP, i);
+      pRow->sver = tbData.sver;
+    }
+  }
+
+  if (pCreateReqDst) {
+    tbData.flags |= SUBMIT_REQ_AUTO_CREATE_TABLE;
+    tbData.pCreateTbReq = pCreateReqDst;
+  }
+
+  code = rawSubmitBindData(pQuery, vgId, &tbData);
+  if (code != TSDB_CODE_SUCCESS) {
+    if (tbData.flags & SUBMIT_REQ_COLUMN_DATA_FORMAT) {
+      taosArrayDestroy(tbData.aCol);
+    } else {
+      taosArrayDestroy(tbData.aRowP);
+    }
+  }
+  return code;
+}
+
 static int32_t tmqWriteRawDataImpl(TAOS* taos, void* data, int32_t dataLen) {
   if(taos == NULL || data == NULL){
     terrno = TSDB_CODE_INVALID_PARA;
@@ -1635,6 +1705,16 @@ static int32_t tmqWriteRawDataImpl(TAOS* taos, void* data, int32_t dataLen) {
     }
 
     SSchemaWrapper* pSW = (SSchemaWrapper*)taosArrayGetP(rspObj.rsp.blockSchema, rspObj.resIter);
+    if (rspObj.rsp.rawSubmit) {
+      int32_t len = *(int32_t*)taosArrayGet(rspObj.rsp.blockDataLen, rspObj.resIter);
+      code = rawSubmitBindBlock(pQuery, pTableMeta, vg.vgId, pSW, pRetrieve, len, NULL);
+      if (code != TSDB_CODE_SUCCESS) {
+        goto end;
+      }
+      taosMemoryFreeClear(pTableMeta);
+      continue;
+    }
+
     TAOS_FIELD*     fields = taosMemoryCalloc(pSW->nCols, sizeof(TAOS_FIELD));
     if (fields == NULL) {
       goto end;
@@ -1652,7 +1732,11 @@ static int32_t tmqWriteRawDataImpl(TAOS* taos, void* data, int32_t dataLen) {
     taosMemoryFreeClear(pTableMeta);
   }
 
-  code = smlBuildOutput(pQuery, pVgHash);
+  if (rspObj.rsp.rawSubmit) {
+    code = rawSubmitBuildOutput(pQuery, pVgHash);
+  } else {
+    code = smlBuildOutput(pQuery, pVgHash);
+  }
   if (code != TSDB_CODE_SUCCESS) {
     goto end;
   }
@@ -1806,6 +1890,17 @@ static int32_t tmqWriteRawMetaDataImpl(TAOS* taos, void* data, int32_t dataLen)
     }
 
     SSchemaWrapper* pSW = (SSchemaWrapper*)taosArrayGetP(rspObj.rsp.blockSchema, rspObj.resIter);
+    if (rspObj.rsp.rawSubmit) {
+      int32_t len = *(int32_t*)taosArrayGet(rspObj.rsp.blockDataLen, rspObj.resIter);
+      code = rawSubmitBindBlock(pQuery, pTableMeta, vg.vgId, pSW, pRetrieve, len, pCreateReqDst);
+      if (code != TSDB_CODE_SUCCESS) {
+        goto end;
+      }
+      pCreateReqDst = NULL;
+      taosMemoryFreeClear(pTableMeta);
+      continue;
+    }
+
     TAOS_FIELD*     fields = taosMemoryCalloc(pSW->nCols, sizeof(TAOS_FIELD));
     if (fields == NULL) {
       goto end;
@@ -1824,7 +1919,11 @@ static int32_t tmqWriteRawMetaDataImpl(TAOS* taos, void* data, int32_t dataLen)
     taosMemoryFreeClear(pTableMeta);
   }
 
-  code = smlBuildOutput(pQuery, pVgHash);
+  if (rspObj.rsp.rawSubmit) {
+    code = rawSubmitBuildOutput(pQuery, pVgHash);
+  } else {
+    code = smlBuildOutput(pQuery, pVgHash);
+  }
   if (code != TSDB_CODE_SUCCESS) {
     goto end;
   }
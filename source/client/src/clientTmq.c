@@ -24,9 +24,9 @@
 #include "tref.h"
 #include "ttimer.h"
 
-#define EMPTY_BLOCK_POLL_IDLE_DURATION 10
 #define DEFAULT_AUTO_COMMIT_INTERVAL   5000
 #define DEFAULT_HEARTBEAT_INTERVAL   3000
+#define DEFAULT_PREFETCH_BYTES       (16 * 1024 * 1024)
 
 struct SMqMgmt {
   int8_t  inited;
@@ -62,9 +62,12 @@ struct tmq_conf_t {
   int8_t         resetOffset;
   int8_t         withTbName;
   int8_t         snapEnable;
+  int8_t         rawSubmit;
 //  int32_t        snapBatchSize;
   uint16_t       port;
   int32_t        autoCommitInterval;
+  int32_t        prefetchNum;
+  int64_t        prefetchBytes;
   char*          ip;
   char*          user;
   char*          pass;
@@ -78,9 +81,12 @@ struct tmq_t {
   char           clientId[256];
   int8_t         withTbName;
   int8_t         useSnapshot;
+  int8_t         rawSubmit;
   int8_t         autoCommit;
   int32_t        autoCommitInterval;
   int8_t         resetOffsetCfg;
+  int32_t        prefetchNum;    // max poll rsp buffered per vgroup, 0 means poll after the rsp is consumed
+  int64_t        prefetchBytes;  // max bytes of poll rsp buffered per vgroup
   uint64_t       consumerId;
   tmq_commit_cb* commitCb;
   void*          commitCbUserParam;
@@ -116,11 +122,6 @@ typedef struct SAskEpInfo {
   tsem_t  sem;
 } SAskEpInfo;
 
-enum {
-  TMQ_VG_STATUS__IDLE = 0,
-  TMQ_VG_STATUS__WAIT,
-};
-
 enum {
   TMQ_CONSUMER_STATUS__INIT = 0,
   TMQ_CONSUMER_STATUS__READY,
@@ -133,26 +134,6 @@ enum {
   TMQ_DELAYED_TASK__COMMIT,
 };
 
-typedef struct SVgOffsetInfo {
-  STqOffsetVal committedOffset;
-  STqOffsetVal endOffset;        // the last version in TAOS_RES + 1
-  STqOffsetVal beginOffset;      // the first version in TAOS_RES
-  int64_t      walVerBegin;
-  int64_t      walVerEnd;
-} SVgOffsetInfo;
-
-typedef struct {
-  int64_t       pollCnt;
-  int64_t       numOfRows;
-  SVgOffsetInfo offsetInfo;
-  int32_t       vgId;
-  int32_t       vgStatus;
-  int32_t       vgSkipCnt;              // here used to mark the slow vgroups
-  int64_t       emptyBlockReceiveTs;    // once empty block is received, idle for ignoreCnt then start to poll data
-  bool          seekUpdated;            // offset is updated by seek operator, therefore, not update by vnode rsp.
-  SEpSet        epSet;
-} SMqClientVg;
-
 typedef struct {
   char           topicName[TSDB_TOPIC_FNAME_LEN];
   char           db[TSDB_DB_FNAME_LEN];
@@ -170,6 +151,9 @@ typedef struct {
   SMqClientTopic* topicHandle;
   uint64_t        reqId;
   SEpSet*         pEpset;
+  bool            prefetched;  // counted in the prefetch buffer of the vgroup
+  int32_t         seekVer;
+  int32_t         len;
   union {
     SMqDataRsp dataRsp;
     SMqMetaRsp metaRsp;
@@ -195,6 +179,8 @@ typedef struct {
   char            topicName[TSDB_TOPIC_FNAME_LEN];
   int32_t         vgId;
   uint64_t        requestId;  // request id for debug purpose
+  int64_t         timeout;
+  int32_t         seekVer;
 } SMqPollCbParam;
 
 typedef struct SMqVgCommon {
@@ -267,6 +253,7 @@ tmq_conf_t* tmq_conf_new() {
   conf->autoCommit = true;
   conf->autoCommitInterval = DEFAULT_AUTO_COMMIT_INTERVAL;
   conf->resetOffset = TMQ_OFFSET__RESET_LATEST;
+  conf->prefetchBytes = DEFAULT_PREFETCH_BYTES;
 
   return conf;
 }
@@ -356,6 +343,36 @@ tmq_conf_res_t tmq_conf_set(tmq_conf_t* conf, const char* key, const char* value
     }
   }
 
+  if (strcasecmp(key, "msg.raw.submit") == 0) {
+    if (strcasecmp(value, "true") == 0) {
+      conf->rawSubmit = true;
+      return TMQ_CONF_OK;
+    } else if (strcasecmp(value, "false") == 0) {
+      conf->rawSubmit = false;
+      return TMQ_CONF_OK;
+    } else {
+      return TMQ_CONF_INVALID;
+    }
+  }
+
+  if (strcasecmp(key, "msg.prefetch.num") == 0) {
+    int64_t num = taosStr2int64(value);
+    if (num < 0 || num > INT32_MAX) {
+      return TMQ_CONF_INVALID;
+    }
+    conf->prefetchNum = num;
+    return TMQ_CONF_OK;
+  }
+
+  if (strcasecmp(key, "msg.prefetch.bytes") == 0) {
+    int64_t bytes = taosStr2int64(value);
+    if (bytes <= 0) {
+      return TMQ_CONF_INVALID;
+    }
+    conf->prefetchBytes = bytes;
+    return TMQ_CONF_OK;
+  }
+
 //  if (strcasecmp(key, "experimental.snapshot.batch.size") == 0) {
 //    conf->snapBatchSize = taosStr2int64(value);
 //    return TMQ_CONF_OK;
@@ -1066,11 +1083,14 @@ tmq_t* tmq_consumer_new(tmq_conf_t* conf, char* errstr, int32_t errstrLen) {
   strcpy(pTmq->groupId, conf->groupId);
   pTmq->withTbName = conf->withTbName;
   pTmq->useSnapshot = conf->snapEnable;
+  pTmq->rawSubmit = conf->rawSubmit;
   pTmq->autoCommit = conf->autoCommit;
   pTmq->autoCommitInterval = conf->autoCommitInterval;
   pTmq->commitCb = conf->commitCb;
   pTmq->commitCbUserParam = conf->commitCbUserParam;
   pTmq->resetOffsetCfg = conf->resetOffset;
+  pTmq->prefetchNum = conf->prefetchNum;
+  pTmq->prefetchBytes = conf->prefetchBytes;
   taosInitRWLatch(&pTmq->lock);
 
   // assign consumerId
@@ -1285,11 +1305,147 @@ static void setVgIdle(tmq_t* tmq, char* topicName, int32_t vgId){
   taosWUnLockLatch(&tmq->lock);
 }
 
+static SMsgSendInfo* tmqBuildPollSendInfo(tmq_t* pTmq, SMqClientTopic* pTopic, SMqClientVg* pVg, int64_t timeout);
+int32_t              tmqPollCb(void* param, SDataBuf* pMsg, int32_t code);
+
+void tmqVgPrefetchAccount(SMqClientVg* pVg, int32_t len, bool hasData, int64_t now) {
+  pVg->numOfPrefetched++;
+  pVg->prefetchedBytes += len;
+
+  // no new data in vnode, the vgroup idles before it is polled again, like the rsp has been consumed already
+  if (!hasData) {
+    pVg->emptyBlockReceiveTs = now;
+  }
+  atomic_store_32(&pVg->vgStatus, TMQ_VG_STATUS__IDLE);
+}
+
+bool tmqVgPollable(const SMqClientVg* pVg, int32_t prefetchNum, int64_t prefetchBytes, int64_t now) {
+  if (now - pVg->emptyBlockReceiveTs < EMPTY_BLOCK_POLL_IDLE_DURATION) {
+    return false;
+  }
+
+  return prefetchNum <= 0 || (pVg->numOfPrefetched < prefetchNum && pVg->prefetchedBytes < prefetchBytes);
+}
+
+// give up the prefetched rsp of the vgroup, the next poll req starts again from the offset returned to the application
+static void tmqPrefetchReset(SMqClientVg* pVg) {
+  pVg->fetchOffset = pVg->offsetInfo.endOffset;
+  pVg->seekVer++;
+}
+
+// a prefetched rsp is discarded since the epoch changed, the ones buffered after it are discarded as well
+static void tmqPrefetchDiscard(tmq_t* tmq, char* topicName, int32_t vgId) {
+  taosWLockLatch(&tmq->lock);
+  SMqClientVg* pVg = getVgInfo(tmq, topicName, vgId);
+  if (pVg) {
+    tmqPrefetchReset(pVg);
+  }
+  taosWUnLockLatch(&tmq->lock);
+}
+
+// With prefetch on, the next poll req of the vgroup is sent once a rsp arrives instead of after it has been returned
+// to the application. The req starts from the offset in this rsp, so there is at most one req in flight per vgroup,
+// and it stops when msg.prefetch.num rsp or msg.prefetch.bytes are buffered. The offsets to commit are still only
+// updated by the rsp returned in tmqHandleAllRsp.
+// The req is built here under the lock and returned, it is sent by the caller after the rsp is put into the queue and
+// the lock is released.
+static SMsgSendInfo* tmqPrefetchNext(tmq_t* tmq, SMqPollCbParam* pParam, SMqPollRspWrapper* pRspWrapper, int32_t len,
+                                     SEpSet* pEpSet) {
+  STqOffsetVal* pOffset = NULL;
+  bool          hasData = true;
+  int32_t       epoch = 0;
+  if (pRspWrapper->tmqRspType == TMQ_MSG_TYPE__POLL_DATA_RSP) {
+    pOffset = &pRspWrapper->dataRsp.rspOffset;
+    hasData = (pRspWrapper->dataRsp.blockNum != 0);
+    epoch = pRspWrapper->dataRsp.head.epoch;
+  } else if (pRspWrapper->tmqRspType == TMQ_MSG_TYPE__POLL_META_RSP) {
+    pOffset = &pRspWrapper->metaRsp.rspOffset;
+    epoch = pRspWrapper->metaRsp.head.epoch;
+  } else if (pRspWrapper->tmqRspType == TMQ_MSG_TYPE__POLL_DATA_META_RSP) {
+    pOffset = &pRspWrapper->taosxRsp.rspOffset;
+    hasData = (pRspWrapper->taosxRsp.blockNum != 0);
+    epoch = pRspWrapper->taosxRsp.head.epoch;
+  } else {
+    return NULL;
+  }
+
+  taosWLockLatch(&tmq->lock);
+  SMqClientVg*    pVg = getVgInfo(tmq, pParam->topicName, pParam->vgId);
+  SMqClientTopic* pTopic = getTopicInfo(tmq, pParam->topicName);
+  if (pVg == NULL || pTopic == NULL) {
+    taosWUnLockLatch(&tmq->lock);
+    return NULL;
+  }
+
+  int64_t now = taosGetTimestampMs();
+  pRspWrapper->prefetched = true;
+  pRspWrapper->seekVer = pParam->seekVer;
+  pRspWrapper->len = len;
+  tmqVgPrefetchAccount(pVg, len, hasData, now);
+
+  // the rsp is of the offset before seek or rebalance, or of an old epoch, it is discarded when handled
+  if (pParam->seekVer != pVg->seekVer || epoch != atomic_load_32(&tmq->epoch)) {
+    taosWUnLockLatch(&tmq->lock);
+    return NULL;
+  }
+
+  pVg->fetchOffset = *pOffset;
+
+  if (!tmqVgPollable(pVg, tmq->prefetchNum, tmq->prefetchBytes, now) ||
+      atomic_load_8(&tmq->status) == TMQ_CONSUMER_STATUS__RECOVER) {
+    taosWUnLockLatch(&tmq->lock);
+    return NULL;
+  }
+
+  SMsgSendInfo* pInfo = tmqBuildPollSendInfo(tmq, pTopic, pVg, pParam->timeout);
+  if (pInfo != NULL) {
+    tscDebug("consumer:0x%" PRIx64 " prefetch vgId:%d, buffered rsp:%d, bytes:%" PRId64, tmq->consumerId, pVg->vgId,
+             pVg->numOfPrefetched, pVg->prefetchedBytes);
+    atomic_store_32(&pVg->vgStatus, TMQ_VG_STATUS__WAIT);
+    *pEpSet = pVg->epSet;
+    pVg->pollCnt++;
+    pVg->seekUpdated = false;
+    tmq->pollCnt++;
+  }
+  taosWUnLockLatch(&tmq->lock);
+  return pInfo;
+}
+
+// a failed prefetch req is handled like a failed poll rsp, the vgroup is set idle and polled again later
+static void tmqPrefetchSend(tmq_t* tmq, SMsgSendInfo* pInfo, SEpSet* pEpSet) {
+  SMqPollCbParam* pParam = pInfo->param;
+  int64_t         transporterId = 0;
+
+  int32_t code = asyncSendMsgToServer(tmq->pTscObj->pAppInfo->pTransporter, pEpSet, &transporterId, pInfo);
+  tscDebug("consumer:0x%" PRIx64 " send prefetch poll to vgId:%d, code:%d, reqId:0x%" PRIx64, tmq->consumerId,
+           pParam->vgId, code, pParam->requestId);
+  if (code != 0) {
+    tmqPollCb(pParam, NULL, code);
+  }
+}
+
+// the rsp leaves the prefetch buffer, return false if it is outdated by a seek
+static bool tmqPrefetchRelease(tmq_t* tmq, SMqPollRspWrapper* pRspWrapper) {
+  bool valid = true;
+
+  taosWLockLatch(&tmq->lock);
+  SMqClientVg* pVg = getVgInfo(tmq, pRspWrapper->topicName, pRspWrapper->vgId);
+  if (pVg) {
+    pVg->numOfPrefetched--;
+    pVg->prefetchedBytes -= pRspWrapper->len;
+    valid = (pRspWrapper->seekVer == pVg->seekVer);
+  }
+  taosWUnLockLatch(&tmq->lock);
+  return valid;
+}
+
 int32_t tmqPollCb(void* param, SDataBuf* pMsg, int32_t code) {
   SMqPollCbParam* pParam = (SMqPollCbParam*)param;
   int64_t          refId = pParam->refId;
   int32_t           vgId = pParam->vgId;
   uint64_t     requestId = pParam->requestId;
+  SMsgSendInfo* pPrefetch = NULL;
+  SEpSet        prefetchEpSet = {0};
   tmq_t* tmq = taosAcquireRef(tmqMgmt.rsetId, refId);
   if (tmq == NULL) {
     code = TSDB_CODE_TMQ_CONSUMER_CLOSED;
@@ -1354,6 +1510,10 @@ int32_t tmqPollCb(void* param, SDataBuf* pMsg, int32_t code) {
     tscError("consumer:0x%" PRIx64 " invalid rsp msg received, type:%d ignored", tmq->consumerId, rspType);
   }
 
+  if (tmq->prefetchNum > 0) {
+    pPrefetch = tmqPrefetchNext(tmq, pParam, pRspWrapper, pMsg->len, &prefetchEpSet);
+  }
+
 END:
   pRspWrapper->code = code;
   pRspWrapper->vgId = vgId;
@@ -1363,6 +1523,11 @@ END:
   int32_t total = taosQueueItemSize(tmq->mqueue);
   tscDebug("consumer:0x%" PRIx64 " put poll res into mqueue, type:%d, vgId:%d, total in queue:%d, reqId:0x%" PRIx64,
            tmq->consumerId, rspType, vgId, total, requestId);
+
+  // sent after the rsp is queued, so that the rsp of the prefetch req is never handled before it
+  if (pPrefetch != NULL) {
+    tmqPrefetchSend(tmq, pPrefetch, &prefetchEpSet);
+  }
   taosReleaseRef(tmqMgmt.rsetId, refId);
 
 FAIL:
@@ -1378,8 +1543,12 @@ typedef struct SVgroupSaveInfo {
   STqOffsetVal currentOffset;
   STqOffsetVal commitOffset;
   STqOffsetVal seekOffset;
+  STqOffsetVal fetchOffset;
   int64_t      numOfRows;
   int32_t      vgStatus;
+  int32_t      numOfPrefetched;
+  int64_t      prefetchedBytes;
+  int32_t      seekVer;
 } SVgroupSaveInfo;
 
 static void initClientTopicFromRsp(SMqClientTopic* pTopic, SMqSubTopicEp* pTopicEp, SHashObj* pVgOffsetHashMap,
@@ -1416,9 +1585,13 @@ static void initClientTopicFromRsp(SMqClientTopic* pTopic, SMqSubTopicEp* pTopic
         .vgSkipCnt = 0,
         .emptyBlockReceiveTs = 0,
         .numOfRows = pInfo ? pInfo->numOfRows : 0,
+        .numOfPrefetched = pInfo ? pInfo->numOfPrefetched : 0,
+        .prefetchedBytes = pInfo ? pInfo->prefetchedBytes : 0,
+        .seekVer = pInfo ? pInfo->seekVer : 0,
     };
 
     clientVg.offsetInfo.endOffset = pInfo ? pInfo->currentOffset : offsetNew;
+    clientVg.fetchOffset = pInfo ? pInfo->fetchOffset : offsetNew;
     clientVg.offsetInfo.committedOffset = pInfo ? pInfo->commitOffset : offsetNew;
     clientVg.offsetInfo.beginOffset = pInfo ? pInfo->seekOffset : offsetNew;
     clientVg.offsetInfo.walVerBegin = -1;
@@ -1482,7 +1655,12 @@ static bool doUpdateLocalEp(tmq_t* tmq, int32_t epoch, const SMqAskEpRsp* pRsp)
 
         SVgroupSaveInfo info = {.currentOffset = pVgCur->offsetInfo.endOffset, .seekOffset = pVgCur->offsetInfo.beginOffset,
                                 .commitOffset = pVgCur->offsetInfo.committedOffset, .numOfRows = pVgCur->numOfRows,
-                                .vgStatus = pVgCur->vgStatus};
+                                .vgStatus = pVgCur->vgStatus, .numOfPrefetched = pVgCur->numOfPrefetched,
+                                .prefetchedBytes = pVgCur->prefetchedBytes};
+        // the buffered rsp are of the old epoch and discarded, poll again from the offset returned to the application
+        tmqPrefetchReset(pVgCur);
+        info.fetchOffset = pVgCur->fetchOffset;
+        info.seekVer = pVgCur->seekVer;
         taosHashPut(pVgOffsetHashMap, vgKey, strlen(vgKey), &info, sizeof(SVgroupSaveInfo));
       }
     }
@@ -1522,9 +1700,10 @@ void tmqBuildConsumeReqImpl(SMqPollReq* pReq, tmq_t* tmq, int64_t timeout, SMqCl
   pReq->consumerId = tmq->consumerId;
   pReq->timeout = timeout;
   pReq->epoch = tmq->epoch;
-  pReq->reqOffset = pVg->offsetInfo.endOffset;
+  pReq->reqOffset = (tmq->prefetchNum > 0) ? pVg->fetchOffset : pVg->offsetInfo.endOffset;
   pReq->head.vgId = pVg->vgId;
   pReq->useSnapshot = tmq->useSnapshot;
+  pReq->rawSubmit = tmq->rawSubmit;
   pReq->reqId = generateRequestId();
 }
 
@@ -1558,8 +1737,8 @@ SMqRspObj* tmqBuildRspFromWrapper(SMqPollRspWrapper* pWrapper, SMqClientVg* pVg,
     setResSchemaInfo(&pRspObj->resInfo, pWrapper->topicHandle->schema.pSchema, pWrapper->topicHandle->schema.nCols);
   }
 
-  // extract the rows in this data packet
-  for (int32_t i = 0; i < pRspObj->rsp.blockNum; ++i) {
+  // extract the rows in this data packet, the raw submit data is not decoded for it
+  for (int32_t i = 0; i < pRspObj->rsp.blockNum && !pRspObj->rsp.rawSubmit; ++i) {
     SRetrieveTableRsp* pRetrieve = (SRetrieveTableRsp*)taosArrayGetP(pRspObj->rsp.blockData, i);
     int64_t            rows = htobe64(pRetrieve->numOfRows);
     pVg->numOfRows += rows;
@@ -1584,8 +1763,8 @@ SMqTaosxRspObj* tmqBuildTaosxRspFromWrapper(SMqPollRspWrapper* pWrapper, SMqClie
     setResSchemaInfo(&pRspObj->resInfo, pWrapper->topicHandle->schema.pSchema, pWrapper->topicHandle->schema.nCols);
   }
 
-  // extract the rows in this data packet
-  for (int32_t i = 0; i < pRspObj->rsp.blockNum; ++i) {
+  // extract the rows in this data packet, the raw submit data is not decoded for it
+  for (int32_t i = 0; i < pRspObj->rsp.blockNum && !pRspObj->rsp.rawSubmit; ++i) {
     SRetrieveTableRsp* pRetrieve = (SRetrieveTableRsp*)taosArrayGetP(pRspObj->rsp.blockData, i);
     int64_t            rows = htobe64(pRetrieve->numOfRows);
     pVg->numOfRows += rows;
@@ -1594,34 +1773,30 @@ SMqTaosxRspObj* tmqBuildTaosxRspFromWrapper(SMqPollRspWrapper* pWrapper, SMqClie
   return pRspObj;
 }
 
-static int32_t doTmqPollImpl(tmq_t* pTmq, SMqClientTopic* pTopic, SMqClientVg* pVg, int64_t timeout) {
-  SMqPollReq req = {0};
-  char*              msg = NULL;
+// build the poll req of the vgroup, NULL is returned if it fails
+static SMsgSendInfo* tmqBuildPollSendInfo(tmq_t* pTmq, SMqClientTopic* pTopic, SMqClientVg* pVg, int64_t timeout) {
+  SMqPollReq      req = {0};
+  char*           msg = NULL;
   SMqPollCbParam* pParam = NULL;
-  SMsgSendInfo* sendInfo = NULL;
-  int               code = 0;
+  SMsgSendInfo*   sendInfo = NULL;
   tmqBuildConsumeReqImpl(&req, pTmq, timeout, pTopic, pVg);
 
   int32_t msgSize = tSerializeSMqPollReq(NULL, 0, &req);
-  if (msgSize < 0){
-    code = TSDB_CODE_INVALID_MSG;
-    goto FAIL;
+  if (msgSize < 0) {
+    terrno = TSDB_CODE_INVALID_MSG;
+    return NULL;
   }
 
   msg = taosMemoryCalloc(1, msgSize);
-  if (NULL == msg) {
-    code = TSDB_CODE_OUT_OF_MEMORY;
+  pParam = taosMemoryMalloc(sizeof(SMqPollCbParam));
+  sendInfo = taosMemoryCalloc(1, sizeof(SMsgSendInfo));
+  if (msg == NULL || pParam == NULL || sendInfo == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
     goto FAIL;
   }
 
   if (tSerializeSMqPollReq(msg, msgSize, &req) < 0) {
-    code = TSDB_CODE_INVALID_MSG;
-    goto FAIL;
-  }
-
-  pParam = taosMemoryMalloc(sizeof(SMqPollCbParam));
-  if (pParam == NULL) {
-    code = TSDB_CODE_OUT_OF_MEMORY;
+    terrno = TSDB_CODE_INVALID_MSG;
     goto FAIL;
   }
 
@@ -1629,12 +1804,8 @@ static int32_t doTmqPollImpl(tmq_t* pTmq, SMqClientTopic* pTopic, SMqClientVg* p
   strcpy(pParam->topicName, pTopic->topicName);
   pParam->vgId = pVg->vgId;
   pParam->requestId = req.reqId;
-
-  sendInfo = taosMemoryCalloc(1, sizeof(SMsgSendInfo));
-  if (sendInfo == NULL) {
-    code = TSDB_CODE_OUT_OF_MEMORY;
-    goto FAIL;
-  }
+  pParam->timeout = timeout;
+  pParam->seekVer = pVg->seekVer;
 
   sendInfo->msgInfo = (SDataBuf){.pData = msg, .len = msgSize, .handle = NULL};
   sendInfo->requestId = req.reqId;
@@ -1642,15 +1813,35 @@ static int32_t doTmqPollImpl(tmq_t* pTmq, SMqClientTopic* pTopic, SMqClientVg* p
   sendInfo->param = pParam;
   sendInfo->fp = tmqPollCb;
   sendInfo->msgType = TDMT_VND_TMQ_CONSUME;
+  return sendInfo;
 
-  int64_t transporterId = 0;
-  char    offsetFormatBuf[TSDB_OFFSET_LEN] = {0};
-  tFormatOffset(offsetFormatBuf, tListLen(offsetFormatBuf), &pVg->offsetInfo.endOffset);
-  code = asyncSendMsgToServer(pTmq->pTscObj->pAppInfo->pTransporter, &pVg->epSet, &transporterId, sendInfo);
+FAIL:
+  taosMemoryFree(msg);
+  taosMemoryFree(pParam);
+  taosMemoryFree(sendInfo);
+  return NULL;
+}
+
+static int32_t doTmqPollImpl(tmq_t* pTmq, SMqClientTopic* pTopic, SMqClientVg* pVg, int64_t timeout) {
+  SMsgSendInfo* sendInfo = tmqBuildPollSendInfo(pTmq, pTopic, pVg, timeout);
+  if (sendInfo == NULL) {
+    atomic_store_32(&pVg->vgStatus, TMQ_VG_STATUS__IDLE);
+    return terrno;
+  }
+
+  SMqPollCbParam* pParam = sendInfo->param;
+  int64_t         reqId = sendInfo->requestId;
+  int64_t         transporterId = 0;
+  char            offsetFormatBuf[TSDB_OFFSET_LEN] = {0};
+  tFormatOffset(offsetFormatBuf, tListLen(offsetFormatBuf),
+                (pTmq->prefetchNum > 0) ? &pVg->fetchOffset : &pVg->offsetInfo.endOffset);
+
+  // the msg is freed with the send info if it fails
+  int32_t code = asyncSendMsgToServer(pTmq->pTscObj->pAppInfo->pTransporter, &pVg->epSet, &transporterId, sendInfo);
   tscDebug("consumer:0x%" PRIx64 " send poll to %s vgId:%d, code:%d, epoch %d, req:%s, reqId:0x%" PRIx64, pTmq->consumerId,
-           pTopic->topicName, pVg->vgId, code, pTmq->epoch, offsetFormatBuf, req.reqId);
+           pTopic->topicName, pVg->vgId, code, pTmq->epoch, offsetFormatBuf, reqId);
   if(code != 0){
-    goto FAIL;
+    return tmqPollCb(pParam, NULL, code);
   }
 
   pVg->pollCnt++;
@@ -1658,9 +1849,6 @@ static int32_t doTmqPollImpl(tmq_t* pTmq, SMqClientTopic* pTopic, SMqClientVg* p
   pTmq->pollCnt++;
 
   return 0;
-FAIL:
-  taosMemoryFreeClear(msg);
-  return tmqPollCb(pParam, NULL, code);
 }
 
 // broadcast the poll request to all related vnodes
@@ -1680,9 +1868,10 @@ static int32_t tmqPollImpl(tmq_t* tmq, int64_t timeout) {
 
     for (int j = 0; j < numOfVg; j++) {
       SMqClientVg* pVg = taosArrayGet(pTopic->vgs, j);
-      if (taosGetTimestampMs() - pVg->emptyBlockReceiveTs < EMPTY_BLOCK_POLL_IDLE_DURATION) {  // less than 10ms
-        tscTrace("consumer:0x%" PRIx64 " epoch %d, vgId:%d idle for 10ms before start next poll", tmq->consumerId,
-                 tmq->epoch, pVg->vgId);
+      if (!tmqVgPollable(pVg, tmq->prefetchNum, tmq->prefetchBytes, taosGetTimestampMs())) {
+        tscTrace("consumer:0x%" PRIx64 " epoch %d, vgId:%d idle after empty rsp, or prefetch buffer is full, buffered "
+                 "rsp:%d, bytes:%" PRId64,
+                 tmq->consumerId, tmq->epoch, pVg->vgId, pVg->numOfPrefetched, pVg->prefetchedBytes);
         continue;
       }
 
@@ -1708,7 +1897,7 @@ end:
   return code;
 }
 
-static void updateVgInfo(SMqClientVg* pVg, STqOffsetVal* reqOffset, STqOffsetVal* rspOffset, int64_t sver, int64_t ever, int64_t consumerId, bool hasData){
+static void updateVgInfo(SMqClientVg* pVg, STqOffsetVal* reqOffset, STqOffsetVal* rspOffset, int64_t sver, int64_t ever, int64_t consumerId, bool hasData, bool prefetched){
   if (!pVg->seekUpdated) {
     tscDebug("consumer:0x%" PRIx64" local offset is update, since seekupdate not set", consumerId);
     if(hasData) pVg->offsetInfo.beginOffset = *reqOffset;
@@ -1717,8 +1906,10 @@ static void updateVgInfo(SMqClientVg* pVg, STqOffsetVal* reqOffset, STqOffsetVal
     tscDebug("consumer:0x%" PRIx64" local offset is NOT update, since seekupdate is set", consumerId);
   }
 
-  // update the status
-  atomic_store_32(&pVg->vgStatus, TMQ_VG_STATUS__IDLE);
+  // update the status, it is already updated in tmqPollCb for the prefetched rsp
+  if (!prefetched) {
+    atomic_store_32(&pVg->vgStatus, TMQ_VG_STATUS__IDLE);
+  }
 
   // update the valid wal version range
   pVg->offsetInfo.walVerBegin = sver;
@@ -1742,6 +1933,15 @@ static void* tmqHandleAllRsp(tmq_t* tmq, int64_t timeout) {
 
     tscDebug("consumer:0x%" PRIx64 " handle rsp, type:%d", tmq->consumerId, pRspWrapper->tmqRspType);
 
+    if (pRspWrapper->tmqRspType != TMQ_MSG_TYPE__EP_RSP && pRspWrapper->code == 0 &&
+        ((SMqPollRspWrapper*)pRspWrapper)->prefetched && !tmqPrefetchRelease(tmq, (SMqPollRspWrapper*)pRspWrapper)) {
+      tscDebug("consumer:0x%" PRIx64 " vgId:%d prefetched rsp discarded since offset is seeked", tmq->consumerId,
+               ((SMqPollRspWrapper*)pRspWrapper)->vgId);
+      tmqFreeRspWrapper(pRspWrapper);
+      taosFreeQitem(pRspWrapper);
+      continue;
+    }
+
     if (pRspWrapper->code != 0) {
       SMqPollRspWrapper* pollRspWrapper = (SMqPollRspWrapper*)pRspWrapper;
       if (pRspWrapper->code == TSDB_CODE_TMQ_CONSUMER_MISMATCH) {
@@ -1790,7 +1990,7 @@ static void* tmqHandleAllRsp(tmq_t* tmq, int64_t timeout) {
           pVg->epSet = *pollRspWrapper->pEpset;
         }
 
-        updateVgInfo(pVg, &pDataRsp->reqOffset, &pDataRsp->rspOffset, pDataRsp->head.walsver, pDataRsp->head.walever, tmq->consumerId, pDataRsp->blockNum != 0);
+        updateVgInfo(pVg, &pDataRsp->reqOffset, &pDataRsp->rspOffset, pDataRsp->head.walsver, pDataRsp->head.walever, tmq->consumerId, pDataRsp->blockNum != 0, pollRspWrapper->prefetched);
 
         char buf[TSDB_OFFSET_LEN] = {0};
         tFormatOffset(buf, TSDB_OFFSET_LEN, &pDataRsp->rspOffset);
@@ -1818,7 +2018,11 @@ static void* tmqHandleAllRsp(tmq_t* tmq, int64_t timeout) {
       } else {
         tscInfo("consumer:0x%" PRIx64 " vgId:%d msg discard since epoch mismatch: msg epoch %d, consumer epoch %d",
                  tmq->consumerId, pollRspWrapper->vgId, pDataRsp->head.epoch, consumerEpoch);
-        setVgIdle(tmq, pollRspWrapper->topicName, pollRspWrapper->vgId);
+        if (pollRspWrapper->prefetched) {
+          tmqPrefetchDiscard(tmq, pollRspWrapper->topicName, pollRspWrapper->vgId);
+        } else {
+          setVgIdle(tmq, pollRspWrapper->topicName, pollRspWrapper->vgId);
+        }
         tmqFreeRspWrapper(pRspWrapper);
         taosFreeQitem(pRspWrapper);
       }
@@ -1840,7 +2044,7 @@ static void* tmqHandleAllRsp(tmq_t* tmq, int64_t timeout) {
           return NULL;
         }
 
-        updateVgInfo(pVg, &pollRspWrapper->metaRsp.rspOffset, &pollRspWrapper->metaRsp.rspOffset, pollRspWrapper->metaRsp.head.walsver, pollRspWrapper->metaRsp.head.walever, tmq->consumerId, true);
+        updateVgInfo(pVg, &pollRspWrapper->metaRsp.rspOffset, &pollRspWrapper->metaRsp.rspOffset, pollRspWrapper->metaRsp.head.walsver, pollRspWrapper->metaRsp.head.walever, tmq->consumerId, true, pollRspWrapper->prefetched);
         // build rsp
         SMqMetaRspObj* pRsp = tmqBuildMetaRspFromWrapper(pollRspWrapper);
         taosFreeQitem(pRspWrapper);
@@ -1849,7 +2053,11 @@ static void* tmqHandleAllRsp(tmq_t* tmq, int64_t timeout) {
       } else {
         tscInfo("consumer:0x%" PRIx64 " vgId:%d msg discard since epoch mismatch: msg epoch %d, consumer epoch %d",
                  tmq->consumerId, pollRspWrapper->vgId, pollRspWrapper->metaRsp.head.epoch, consumerEpoch);
-        setVgIdle(tmq, pollRspWrapper->topicName, pollRspWrapper->vgId);
+        if (pollRspWrapper->prefetched) {
+          tmqPrefetchDiscard(tmq, pollRspWrapper->topicName, pollRspWrapper->vgId);
+        } else {
+          setVgIdle(tmq, pollRspWrapper->topicName, pollRspWrapper->vgId);
+        }
         tmqFreeRspWrapper(pRspWrapper);
         taosFreeQitem(pRspWrapper);
       }
@@ -1869,7 +2077,7 @@ static void* tmqHandleAllRsp(tmq_t* tmq, int64_t timeout) {
           return NULL;
         }
 
-        updateVgInfo(pVg, &pollRspWrapper->taosxRsp.reqOffset, &pollRspWrapper->taosxRsp.rspOffset, pollRspWrapper->taosxRsp.head.walsver, pollRspWrapper->taosxRsp.head.walever, tmq->consumerId, pollRspWrapper->taosxRsp.blockNum != 0);
+        updateVgInfo(pVg, &pollRspWrapper->taosxRsp.reqOffset, &pollRspWrapper->taosxRsp.rspOffset, pollRspWrapper->taosxRsp.head.walsver, pollRspWrapper->taosxRsp.head.walever, tmq->consumerId, pollRspWrapper->taosxRsp.blockNum != 0, pollRspWrapper->prefetched);
 
         if (pollRspWrapper->taosxRsp.blockNum == 0) {
           tscDebug("consumer:0x%" PRIx64 " taosx empty block received, vgId:%d, vg total:%" PRId64 ", reqId:0x%" PRIx64,
@@ -1907,7 +2115,11 @@ static void* tmqHandleAllRsp(tmq_t* tmq, int64_t timeout) {
       } else {
         tscInfo("consumer:0x%" PRIx64 " vgId:%d msg discard since epoch mismatch: msg epoch %d, consumer epoch %d",
                  tmq->consumerId, pollRspWrapper->vgId, pollRspWrapper->taosxRsp.head.epoch, consumerEpoch);
-        setVgIdle(tmq, pollRspWrapper->topicName, pollRspWrapper->vgId);
+        if (pollRspWrapper->prefetched) {
+          tmqPrefetchDiscard(tmq, pollRspWrapper->topicName, pollRspWrapper->vgId);
+        } else {
+          setVgIdle(tmq, pollRspWrapper->topicName, pollRspWrapper->vgId);
+        }
         tmqFreeRspWrapper(pRspWrapper);
         taosFreeQitem(pRspWrapper);
       }
@@ -2504,6 +2716,12 @@ SReqResultInfo* tmqGetNextResInfo(TAOS_RES* res, bool convertUcs4) {
   SMqRspObj* pRspObj = (SMqRspObj*)res;
   pRspObj->resIter++;
 
+  // the raw submit data can only be written by tmq_write_raw
+  if (pRspObj->rsp.rawSubmit) {
+    tscError("fetch rows from raw submit data of tmq is not supported");
+    return NULL;
+  }
+
   if (pRspObj->resIter < pRspObj->rsp.blockNum) {
     SRetrieveTableRsp* pRetrieve = (SRetrieveTableRsp*)taosArrayGetP(pRspObj->rsp.blockData, pRspObj->resIter);
     if (pRspObj->rsp.withSchema) {
@@ -3034,6 +3252,7 @@ int32_t tmq_offset_seek(tmq_t* tmq, const char* pTopicName, int32_t vgId, int64_
   pOffsetInfo->endOffset.version = offset;
   pOffsetInfo->beginOffset = pOffsetInfo->endOffset;
   pVg->seekUpdated = true;
+  tmqPrefetchReset(pVg);
   SEpSet epSet = pVg->epSet;
   taosWUnLockLatch(&tmq->lock);
 
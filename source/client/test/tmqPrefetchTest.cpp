@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+#include "../inc/clientInt.h"
+
+namespace {
+
+const int32_t kPrefetchNum = 2;
+const int64_t kPrefetchBytes = 1000;
+const int64_t kNow = 1000000;
+
+}  // namespace
+
+TEST(tmqPrefetchTest, bufferLimits) {
+  SMqClientVg vg = {0};
+  vg.vgStatus = TMQ_VG_STATUS__WAIT;
+  ASSERT_TRUE(tmqVgPollable(&vg, kPrefetchNum, kPrefetchBytes, kNow));
+
+  tmqVgPrefetchAccount(&vg, 100, true, kNow);
+  ASSERT_EQ(vg.vgStatus, TMQ_VG_STATUS__IDLE);
+  ASSERT_EQ(vg.numOfPrefetched, 1);
+  ASSERT_EQ(vg.prefetchedBytes, 100);
+  ASSERT_TRUE(tmqVgPollable(&vg, kPrefetchNum, kPrefetchBytes, kNow));
+
+  // full by the number of rsp
+  tmqVgPrefetchAccount(&vg, 100, true, kNow);
+  ASSERT_FALSE(tmqVgPollable(&vg, kPrefetchNum, kPrefetchBytes, kNow));
+
+  // full by the bytes of rsp
+  SMqClientVg big = {0};
+  tmqVgPrefetchAccount(&big, kPrefetchBytes, true, kNow);
+  ASSERT_FALSE(tmqVgPollable(&big, kPrefetchNum, kPrefetchBytes, kNow));
+
+  // no limit with prefetch off
+  ASSERT_TRUE(tmqVgPollable(&vg, 0, kPrefetchBytes, kNow));
+}
+
+TEST(tmqPrefetchTest, idleAfterEmptyRsp) {
+  SMqClientVg vg = {0};
+  vg.vgStatus = TMQ_VG_STATUS__WAIT;
+
+  // the vgroup is set idle and timestamped together, it is not polled again at once by either the prefetch or the
+  // poll of the application
+  tmqVgPrefetchAccount(&vg, 100, false, kNow);
+  ASSERT_EQ(vg.vgStatus, TMQ_VG_STATUS__IDLE);
+  ASSERT_EQ(vg.emptyBlockReceiveTs, kNow);
+  ASSERT_FALSE(tmqVgPollable(&vg, kPrefetchNum, kPrefetchBytes, kNow));
+  ASSERT_FALSE(tmqVgPollable(&vg, 0, kPrefetchBytes, kNow + EMPTY_BLOCK_POLL_IDLE_DURATION - 1));
+  ASSERT_TRUE(tmqVgPollable(&vg, kPrefetchNum, kPrefetchBytes, kNow + EMPTY_BLOCK_POLL_IDLE_DURATION));
+
+  // a rsp with data does not reset the idle duration
+  tmqVgPrefetchAccount(&vg, 100, true, kNow + 1);
+  ASSERT_EQ(vg.emptyBlockReceiveTs, kNow);
+}
+
+#pragma GCC diagnostic pop
@@ -21,21 +21,54 @@
 
 #define MALLOC_ALIGN_BYTES 32
 
+/**
+ * Copy the payload of a reassigned var column into pDst and write the offsets of the copy into pDstOffset, both may be
+ * NULL. Rows sharing the payload with the previous row, e.g. the tag values and the table name of a table, keep
+ * sharing it in the copy, so that a value is stored once per run of rows instead of once per row.
+ * @return the length of the copied payload
+ */
+static int32_t colDataCompactVarData(const SColumnInfoData* pColumnInfoData, int32_t numOfRows, int32_t* pDstOffset,
+                                     char* pDst) {
+  int32_t len = 0;
+  int32_t lastSrc = -1;
+  int32_t lastDst = -1;
+
+  for (int32_t row = 0; row < numOfRows; ++row) {
+    int32_t srcOffset = pColumnInfoData->varmeta.offset[row];
+    if (srcOffset == -1 || srcOffset == lastSrc) {
+      if (pDstOffset != NULL) {
+        pDstOffset[row] = (srcOffset == -1) ? -1 : lastDst;
+      }
+      continue;
+    }
+
+    char*   pColData = pColumnInfoData->pData + srcOffset;
+    int32_t colSize = 0;
+    if (pColumnInfoData->info.type == TSDB_DATA_TYPE_JSON) {
+      colSize = getJsonValueLen(pColData);
+    } else {
+      colSize = varDataTLen(pColData);
+    }
+
+    if (pDstOffset != NULL) {
+      pDstOffset[row] = len;
+    }
+    if (pDst != NULL) {
+      memcpy(pDst + len, pColData, colSize);
+    }
+
+    lastSrc = srcOffset;
+    lastDst = len;
+    len += colSize;
+  }
+
+  return len;
+}
+
 int32_t colDataGetLength(const SColumnInfoData* pColumnInfoData, int32_t numOfRows) {
   if (IS_VAR_DATA_TYPE(pColumnInfoData->info.type)) {
     if (pColumnInfoData->reassigned) {
-      int32_t totalSize = 0;
-      for (int32_t row = 0; row < numOfRows; ++row) {
-        char*   pColData = pColumnInfoData->pData + pColumnInfoData->varmeta.offset[row];
-        int32_t colSize = 0;
-        if (pColumnInfoData->info.type == TSDB_DATA_TYPE_JSON) {
-          colSize = getJsonValueLen(pColData);
-        } else {
-          colSize = varDataTLen(pColData);
-        }
-        totalSize += colSize;
-      }
-      return totalSize;
+      return colDataCompactVarData(pColumnInfoData, numOfRows, NULL, NULL);
     }
     return pColumnInfoData->varmeta.length;
   } else {
@@ -222,20 +255,44 @@ static int32_t doCopyNItems(struct SColumnInfoData* pColumnInfoData, int32_t cur
   return TSDB_CODE_SUCCESS;
 }
 
+// the var value is stored once and all the rows refer to it
+static int32_t doShareNItems(SColumnInfoData* pColumnInfoData, uint32_t currentRow, const char* pData, int32_t itemLen,
+                             uint32_t numOfRows, bool trimValue) {
+  if (pColumnInfoData->info.bytes < itemLen) {
+    uWarn("column/tag actual data len %d is bigger than schema len %d, trim it:%d", itemLen,
+          pColumnInfoData->info.bytes, trimValue);
+    if (trimValue) {
+      itemLen = pColumnInfoData->info.bytes;
+    } else {
+      return TSDB_CODE_TDB_INVALID_TABLE_SCHEMA_VER;
+    }
+  }
+
+  uint32_t offset = pColumnInfoData->varmeta.length;
+  int32_t  code = colDataReserve(pColumnInfoData, offset + itemLen);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  memcpy(pColumnInfoData->pData + offset, pData, itemLen);
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    pColumnInfoData->varmeta.offset[i + currentRow] = offset;
+  }
+
+  pColumnInfoData->varmeta.length += itemLen;
+  if (numOfRows > 1) {
+    pColumnInfoData->reassigned = true;
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
 int32_t colDataSetNItems(SColumnInfoData* pColumnInfoData, uint32_t currentRow, const char* pData, uint32_t numOfRows,
                          bool trimValue) {
-  int32_t len = pColumnInfoData->info.bytes;
   if (IS_VAR_DATA_TYPE(pColumnInfoData->info.type)) {
-    len = varDataTLen(pData);
-    if (pColumnInfoData->varmeta.allocLen < (numOfRows + currentRow) * len) {
-      int32_t code = colDataReserve(pColumnInfoData, (numOfRows + currentRow) * len);
-      if (code != TSDB_CODE_SUCCESS) {
-        return code;
-      }
-    }
+    return doShareNItems(pColumnInfoData, currentRow, pData, varDataTLen(pData), numOfRows, trimValue);
   }
 
-  return doCopyNItems(pColumnInfoData, currentRow, pData, len, numOfRows, trimValue);
+  return doCopyNItems(pColumnInfoData, currentRow, pData, pColumnInfoData->info.bytes, numOfRows, trimValue);
 }
 
 void colDataSetNItemsNull(SColumnInfoData* pColumnInfoData, uint32_t currentRow, uint32_t numOfRows) {
@@ -274,8 +331,10 @@ int32_t colDataCopyAndReassign(SColumnInfoData* pColumnInfoData, uint32_t curren
   
   if (numOfRows > 1) {
     int32_t* pOffset = pColumnInfoData->varmeta.offset;
-    memset(&pOffset[currentRow + 1], pOffset[currentRow], sizeof(pOffset[0]) * (numOfRows - 1));
-    pColumnInfoData->reassigned = true;  
+    for (int32_t i = 1; i < numOfRows; ++i) {
+      pOffset[currentRow + i] = pOffset[currentRow];
+    }
+    pColumnInfoData->reassigned = true;
   }
 
   return TSDB_CODE_SUCCESS;
@@ -675,6 +734,7 @@ int32_t blockDataToBuf(char* buf, const SSDataBlock* pBlock) {
 
   for (int32_t i = 0; i < numOfCols; ++i) {
     SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, i);
+    int32_t*         pOffset = (int32_t*)pStart;
     if (IS_VAR_DATA_TYPE(pCol->info.type)) {
       memcpy(pStart, pCol->varmeta.offset, numOfRows * sizeof(int32_t));
       pStart += numOfRows * sizeof(int32_t);
@@ -689,17 +749,8 @@ int32_t blockDataToBuf(char* buf, const SSDataBlock* pBlock) {
     pStart += sizeof(int32_t);
 
     if (pCol->reassigned && IS_VAR_DATA_TYPE(pCol->info.type)) {
-      for (int32_t row = 0; row < numOfRows; ++row) {
-        char*   pColData = pCol->pData + pCol->varmeta.offset[row];
-        int32_t colSize = 0;
-        if (pCol->info.type == TSDB_DATA_TYPE_JSON) {
-          colSize = getJsonValueLen(pColData);
-        } else {
-          colSize = varDataTLen(pColData);
-        }
-        memcpy(pStart, pColData, colSize);
-        pStart += colSize;
-      }
+      colDataCompactVarData(pCol, numOfRows, pOffset, pStart);
+      pStart += dataSize;
     } else {
       if (dataSize != 0) {
         // ubsan reports error if pCol->pData==NULL && dataSize==0
@@ -1233,6 +1284,7 @@ void colInfoDataCleanup(SColumnInfoData* pColumn, uint32_t numOfRows) {
   pColumn->hasNull = false;
 
   if (IS_VAR_DATA_TYPE(pColumn->info.type)) {
+    pColumn->reassigned = false;
     pColumn->varmeta.length = 0;
     if (pColumn->varmeta.offset != NULL) {
       memset(pColumn->varmeta.offset, 0, sizeof(int32_t) * numOfRows);
@@ -1733,6 +1785,7 @@ int32_t tEncodeDataBlock(void** buf, const SSDataBlock* pBlock) {
     tlen += taosEncodeFixedI32(buf, pColData->info.bytes);
     tlen += taosEncodeFixedBool(buf, pColData->hasNull);
 
+    int32_t* pOffset = (buf != NULL) ? (int32_t*)(*buf) : NULL;
     if (IS_VAR_DATA_TYPE(pColData->info.type)) {
       tlen += taosEncodeBinary(buf, pColData->varmeta.offset, sizeof(int32_t) * rows);
     } else {
@@ -1743,16 +1796,11 @@ int32_t tEncodeDataBlock(void** buf, const SSDataBlock* pBlock) {
     tlen += taosEncodeFixedI32(buf, len);
 
     if (pColData->reassigned && IS_VAR_DATA_TYPE(pColData->info.type)) {
-      for (int32_t row = 0; row < rows; ++row) {
-        char*   pData = pColData->pData + pColData->varmeta.offset[row];
-        int32_t colSize = 0;
-        if (pColData->info.type == TSDB_DATA_TYPE_JSON) {
-          colSize = getJsonValueLen(pData);
-        } else {
-          colSize = varDataTLen(pData);
-        }
-        tlen += taosEncodeBinary(buf, pData, colSize);
+      if (buf != NULL) {
+        colDataCompactVarData(pColData, rows, pOffset, *buf);
+        *buf = POINTER_SHIFT(*buf, len);
       }
+      tlen += len;
     } else {
       tlen += taosEncodeBinary(buf, pColData->pData, len);
     }
@@ -2227,20 +2275,10 @@ int32_t blockEncode(const SSDataBlock* pBlock, char* data, int32_t numOfCols) {
     dataLen += metaSize;
 
     if (pColRes->reassigned && IS_VAR_DATA_TYPE(pColRes->info.type)) {
-      colSizes[col] = 0;
-      for (int32_t row = 0; row < numOfRows; ++row) {
-        char*   pColData = pColRes->pData + pColRes->varmeta.offset[row];
-        int32_t colSize = 0;
-        if (pColRes->info.type == TSDB_DATA_TYPE_JSON) {
-          colSize = getJsonValueLen(pColData);
-        } else {
-          colSize = varDataTLen(pColData);
-        }
-        colSizes[col] += colSize;
-        dataLen += colSize;
-        memmove(data, pColData, colSize);
-        data += colSize;
-      }
+      // the rows sharing a value, e.g. the tags of a table, share it in the encoded block as well
+      colSizes[col] = colDataCompactVarData(pColRes, numOfRows, (int32_t*)(data - metaSize), data);
+      dataLen += colSizes[col];
+      data += colSizes[col];
     } else {
       colSizes[col] = colDataGetLength(pColRes, numOfRows);
       dataLen += colSizes[col];
@@ -96,6 +96,7 @@ char     tsMonitorFqdn[TSDB_FQDN_LEN] = {0};
 uint16_t tsMonitorPort = 6043;
 int32_t  tsMonitorMaxLogs = 100;
 bool     tsMonitorComp = false;
+uint16_t tsMetricsPort = 0;  // prometheus endpoint, 0 means disabled
 
 // audit
 bool     tsEnableAudit = true;
@@ -129,6 +130,7 @@ int32_t tmqMaxTopicNum = 20;
 // query
 int32_t tsQueryPolicy = 1;
 int32_t tsQueryRspPolicy = 0;
+int32_t tsQueryScanThreads = 0;  // 0 or 1: the tables are scanned in the query thread only
 int64_t tsQueryMaxConcurrentTables = 200;  // unit is TSDB_TABLE_NUM_UNIT
 bool    tsEnableQueryHb = true;
 bool    tsEnableScience = false;  // on taos-cli show float and doulbe with scientific notation if true
@@ -190,6 +192,15 @@ char    tsTagFilterCache = 0;
 // positive value (in MB)
 int32_t tsQueryBufferSize = -1;
 int64_t tsQueryBufferSizeBytes = -1;
+// the maximum memory in MB the operators of one query task may allocate from its arena, 0 means no limit. Only the
+// operator scratch buffers come from the arena, currently the batch buffers of the vectorized group by
+int32_t tsQueryArenaLimit = 0;
+// decoded file blocks in MB each vnode keeps for concurrent scans of the same blocks, 0 means disabled
+int32_t tsSharedBlockCacheSize = 0;
+// keep the tag values of each super table in columns, built on the first tag scan and kept until the vnode is closed
+bool    tsTagColumnStore = false;
+// rows of one segment in the per column zone maps written with each data block, 0 means no zone maps
+int32_t tsZoneMapRows = 0;
 int32_t tsCacheLazyLoadThreshold = 500;
 
 int32_t  tsDiskCfgNum = 0;
@@ -257,6 +268,7 @@ char    tsUdfdResFuncs[512] = "";  // udfd resident funcs that teardown when udf
 char    tsUdfdLdLibPath[512] = "";
 bool    tsDisableStream = false;
 int64_t tsStreamBufferSize = 128 * 1024 * 1024;
+int32_t tsStreamSubtasks = 1;  // source tasks created in each vnode for a stream partitioned by tbname or tags
 bool    tsFilterScalarMode = false;
 int     tsResolveFQDNRetryTime = 100;  // seconds
 
@@ -533,8 +545,13 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
     return -1;
   if (cfgAddInt32(pCfg, "countAlwaysReturnValue", tsCountAlwaysReturnValue, 0, 1, CFG_SCOPE_BOTH) != 0) return -1;
   if (cfgAddInt32(pCfg, "queryBufferSize", tsQueryBufferSize, -1, 500000000000, CFG_SCOPE_SERVER) != 0) return -1;
+  if (cfgAddInt32(pCfg, "queryArenaLimit", tsQueryArenaLimit, 0, INT32_MAX, CFG_SCOPE_SERVER) != 0) return -1;
+  if (cfgAddInt32(pCfg, "sharedBlockCacheSize", tsSharedBlockCacheSize, 0, 65536, CFG_SCOPE_SERVER) != 0) return -1;
+  if (cfgAddBool(pCfg, "tagColumnStore", tsTagColumnStore, CFG_SCOPE_SERVER) != 0) return -1;
+  if (cfgAddInt32(pCfg, "zoneMapRows", tsZoneMapRows, 0, 4096, CFG_SCOPE_SERVER) != 0) return -1;
   if (cfgAddBool(pCfg, "printAuth", tsPrintAuth, CFG_SCOPE_SERVER) != 0) return -1;
   if (cfgAddInt32(pCfg, "queryRspPolicy", tsQueryRspPolicy, 0, 1, CFG_SCOPE_SERVER) != 0) return -1;
+  if (cfgAddInt32(pCfg, "queryScanThreads", tsQueryScanThreads, 0, 64, CFG_SCOPE_SERVER) != 0) return -1;
 
   tsNumOfRpcThreads = tsNumOfCores / 2;
   tsNumOfRpcThreads = TRANGE(tsNumOfRpcThreads, 2, TSDB_MAX_RPC_THREADS);
@@ -615,6 +632,7 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
   if (cfgAddInt32(pCfg, "monitorPort", tsMonitorPort, 1, 65056, CFG_SCOPE_SERVER) != 0) return -1;
   if (cfgAddInt32(pCfg, "monitorMaxLogs", tsMonitorMaxLogs, 1, 1000000, CFG_SCOPE_SERVER) != 0) return -1;
   if (cfgAddBool(pCfg, "monitorComp", tsMonitorComp, CFG_SCOPE_SERVER) != 0) return -1;
+  if (cfgAddInt32(pCfg, "metricsPort", tsMetricsPort, 0, 65056, CFG_SCOPE_SERVER) != 0) return -1;
 
   if (cfgAddBool(pCfg, "audit", tsEnableAudit, CFG_SCOPE_SERVER) != 0) return -1;
   if (cfgAddString(pCfg, "auditFqdn", tsAuditFqdn, CFG_SCOPE_SERVER) != 0) return -1;
@@ -652,6 +670,7 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
   if (cfgAddBool(pCfg, "disableStream", tsDisableStream, CFG_SCOPE_SERVER) != 0) return -1;
   if (cfgAddInt64(pCfg, "streamBufferSize", tsStreamBufferSize, 0, INT64_MAX, CFG_SCOPE_SERVER) != 0) return -1;
   if (cfgAddInt64(pCfg, "checkpointInterval", tsStreamCheckpointInterval, 60, 1200, CFG_SCOPE_SERVER) != 0) return -1;
+  if (cfgAddInt32(pCfg, "streamSubtasks", tsStreamSubtasks, 1, 64, CFG_SCOPE_SERVER) != 0) return -1;
   if (cfgAddFloat(pCfg, "streamSinkDataRate", tsSinkDataRate, 0.1, 5, CFG_SCOPE_SERVER) != 0) return -1;
 
   if (cfgAddInt32(pCfg, "cacheLazyLoadThreshold", tsCacheLazyLoadThreshold, 0, 100000, CFG_SCOPE_SERVER) != 0) return -1;
@@ -1003,6 +1022,10 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   tsMaxNumOfDistinctResults = cfgGetItem(pCfg, "maxNumOfDistinctRes")->i32;
   tsCountAlwaysReturnValue = cfgGetItem(pCfg, "countAlwaysReturnValue")->i32;
   tsQueryBufferSize = cfgGetItem(pCfg, "queryBufferSize")->i32;
+  tsQueryArenaLimit = cfgGetItem(pCfg, "queryArenaLimit")->i32;
+  tsSharedBlockCacheSize = cfgGetItem(pCfg, "sharedBlockCacheSize")->i32;
+  tsTagColumnStore = cfgGetItem(pCfg, "tagColumnStore")->bval;
+  tsZoneMapRows = cfgGetItem(pCfg, "zoneMapRows")->i32;
   tsPrintAuth = cfgGetItem(pCfg, "printAuth")->bval;
 
   tsNumOfRpcThreads = cfgGetItem(pCfg, "numOfRpcThreads")->i32;
@@ -1032,7 +1055,9 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   tsMonitorPort = (uint16_t)cfgGetItem(pCfg, "monitorPort")->i32;
   tsMonitorMaxLogs = cfgGetItem(pCfg, "monitorMaxLogs")->i32;
   tsMonitorComp = cfgGetItem(pCfg, "monitorComp")->bval;
+  tsMetricsPort = (uint16_t)cfgGetItem(pCfg, "metricsPort")->i32;
   tsQueryRspPolicy = cfgGetItem(pCfg, "queryRspPolicy")->i32;
+  tsQueryScanThreads = cfgGetItem(pCfg, "queryScanThreads")->i32;
 
   tsEnableAudit = cfgGetItem(pCfg, "audit")->bval;
   tstrncpy(tsAuditFqdn, cfgGetItem(pCfg, "auditFqdn")->str, TSDB_FQDN_LEN);
@@ -1093,6 +1118,7 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   tsDisableStream = cfgGetItem(pCfg, "disableStream")->bval;
   tsStreamBufferSize = cfgGetItem(pCfg, "streamBufferSize")->i64;
   tsStreamCheckpointInterval = cfgGetItem(pCfg, "checkpointInterval")->i32;
+  tsStreamSubtasks = cfgGetItem(pCfg, "streamSubtasks")->i32;
   tsSinkDataRate = cfgGetItem(pCfg, "streamSinkDataRate")->fval;
 
   tsFilterScalarMode = cfgGetItem(pCfg, "filterScalarMode")->bval;
@@ -1369,6 +1395,8 @@ int32_t taosApplyLocalCfg(SConfig *pCfg, char *name) {
         if (tsQueryBufferSize >= 0) {
           tsQueryBufferSizeBytes = tsQueryBufferSize * 1048576UL;
         }
+      } else if (strcasecmp("queryArenaLimit", name) == 0) {
+        tsQueryArenaLimit = cfgGetItem(pCfg, "queryArenaLimit")->i32;
       } else if (strcasecmp("qDebugFlag", name) == 0) {
         qDebugFlag = cfgGetItem(pCfg, "qDebugFlag")->i32;
       } else if (strcasecmp("queryPlannerTrace", name) == 0) {
@@ -1377,6 +1405,8 @@ int32_t taosApplyLocalCfg(SConfig *pCfg, char *name) {
         tsQueryNodeChunkSize = cfgGetItem(pCfg, "queryNodeChunkSize")->i32;
       } else if (strcasecmp("queryUseNodeAllocator", name) == 0) {
         tsQueryUseNodeAllocator = cfgGetItem(pCfg, "queryUseNodeAllocator")->bval;
+      } else if (strcasecmp("queryScanThreads", name) == 0) {
+        tsQueryScanThreads = cfgGetItem(pCfg, "queryScanThreads")->i32;
       } else if (strcasecmp("queryRsmaTolerance", name) == 0) {
         tsQueryRsmaTolerance = cfgGetItem(pCfg, "queryRsmaTolerance")->i32;
       }
@@ -362,6 +362,41 @@ static int32_t tDeserializeSClientHbReq(SDecoder *pDecoder, SClientHbReq *pReq)
   return 0;
 }
 
+// the memory peak of the sub tasks is appended after all the requests, so that an older mnode can skip it
+static int32_t tSerializeSClientHbReqMemPeak(SEncoder *pEncoder, const SClientHbReq *pReq) {
+  if (pReq->connKey.connType != CONN_TYPE__QUERY || NULL == pReq->query) {
+    return 0;
+  }
+
+  int32_t num = taosArrayGetSize(pReq->query->queryDesc);
+  for (int32_t i = 0; i < num; ++i) {
+    SQueryDesc *desc = taosArrayGet(pReq->query->queryDesc, i);
+    int32_t     snum = desc->subDesc ? taosArrayGetSize(desc->subDesc) : 0;
+    for (int32_t m = 0; m < snum; ++m) {
+      SQuerySubDesc *sDesc = taosArrayGet(desc->subDesc, m);
+      if (tEncodeI64(pEncoder, sDesc->arenaPeak) < 0) return -1;
+    }
+  }
+  return 0;
+}
+
+static int32_t tDeserializeSClientHbReqMemPeak(SDecoder *pDecoder, SClientHbReq *pReq) {
+  if (pReq->connKey.connType != CONN_TYPE__QUERY || NULL == pReq->query) {
+    return 0;
+  }
+
+  int32_t num = taosArrayGetSize(pReq->query->queryDesc);
+  for (int32_t i = 0; i < num; ++i) {
+    SQueryDesc *desc = taosArrayGet(pReq->query->queryDesc, i);
+    int32_t     snum = taosArrayGetSize(desc->subDesc);
+    for (int32_t m = 0; m < snum; ++m) {
+      SQuerySubDesc *sDesc = taosArrayGet(desc->subDesc, m);
+      if (tDecodeI64(pDecoder, &sDesc->arenaPeak) < 0) return -1;
+    }
+  }
+  return 0;
+}
+
 static int32_t tSerializeSClientHbRsp(SEncoder *pEncoder, const SClientHbRsp *pRsp) {
   if (tEncodeSClientHbKey(pEncoder, &pRsp->connKey) < 0) return -1;
   if (tEncodeI32(pEncoder, pRsp->status) < 0) return -1;
@@ -450,6 +485,10 @@ int32_t tSerializeSClientHbBatchReq(void *buf, int32_t bufLen, const SClientHbBa
     SClientHbReq *pReq = taosArrayGet(pBatchReq->reqs, i);
     if (tSerializeSClientHbReq(&encoder, pReq) < 0) return -1;
   }
+  for (int32_t i = 0; i < reqNum; i++) {
+    SClientHbReq *pReq = taosArrayGet(pBatchReq->reqs, i);
+    if (tSerializeSClientHbReqMemPeak(&encoder, pReq) < 0) return -1;
+  }
   tEndEncode(&encoder);
 
   int32_t tlen = encoder.pos;
@@ -475,6 +514,12 @@ int32_t tDeserializeSClientHbBatchReq(void *buf, int32_t bufLen, SClientHbBatchR
     tDeserializeSClientHbReq(&decoder, &req);
     taosArrayPush(pBatchReq->reqs, &req);
   }
+  if (!tDecodeIsEnd(&decoder)) {
+    for (int32_t i = 0; i < reqNum; i++) {
+      SClientHbReq *pReq = taosArrayGet(pBatchReq->reqs, i);
+      if (tDeserializeSClientHbReqMemPeak(&decoder, pReq) < 0) return -1;
+    }
+  }
 
   tEndDecode(&decoder);
   tDecoderClear(&decoder);
@@ -3883,6 +3928,9 @@ int32_t tSerializeSTableIndexInfo(SEncoder *pEncoder, STableIndexInfo *pInfo) {
   return 0;
 }
 
+static int32_t tSerializeSTableIndexLag(SEncoder *pEncoder, SArray *pIndex);
+static int32_t tDeserializeSTableIndexLag(SDecoder *pDecoder, SArray *pIndex);
+
 int32_t tSerializeSTableIndexRsp(void *buf, int32_t bufLen, const STableIndexRsp *pRsp) {
   SEncoder encoder = {0};
   tEncoderInit(&encoder, buf, bufLen);
@@ -3901,6 +3949,7 @@ int32_t tSerializeSTableIndexRsp(void *buf, int32_t bufLen, const STableIndexRsp
       if (tSerializeSTableIndexInfo(&encoder, pInfo) < 0) return -1;
     }
   }
+  if (tSerializeSTableIndexLag(&encoder, pRsp->pIndex) < 0) return -1;
   tEndEncode(&encoder);
 
   int32_t tlen = encoder.pos;
@@ -3925,10 +3974,32 @@ int32_t tDeserializeSTableIndexInfo(SDecoder *pDecoder, STableIndexInfo *pInfo)
   if (tDecodeI32(pDecoder, &pInfo->dstVgId) < 0) return -1;
   if (tDecodeSEpSet(pDecoder, &pInfo->epSet) < 0) return -1;
   if (tDecodeCStrAlloc(pDecoder, &pInfo->expr) < 0) return -1;
+  pInfo->watermark = -1;
+  pInfo->maxDelay = -1;
 
   return 0;
 }
 
+static int32_t tSerializeSTableIndexLag(SEncoder *pEncoder, SArray *pIndex) {
+  int32_t num = taosArrayGetSize(pIndex);
+  for (int32_t i = 0; i < num; ++i) {
+    STableIndexInfo *pInfo = (STableIndexInfo *)taosArrayGet(pIndex, i);
+    if (tEncodeI64(pEncoder, pInfo->watermark) < 0) return -1;
+    if (tEncodeI64(pEncoder, pInfo->maxDelay) < 0) return -1;
+  }
+  return 0;
+}
+
+static int32_t tDeserializeSTableIndexLag(SDecoder *pDecoder, SArray *pIndex) {
+  int32_t num = taosArrayGetSize(pIndex);
+  for (int32_t i = 0; i < num; ++i) {
+    STableIndexInfo *pInfo = (STableIndexInfo *)taosArrayGet(pIndex, i);
+    if (tDecodeI64(pDecoder, &pInfo->watermark) < 0) return -1;
+    if (tDecodeI64(pDecoder, &pInfo->maxDelay) < 0) return -1;
+  }
+  return 0;
+}
+
 int32_t tDeserializeSTableIndexRsp(void *buf, int32_t bufLen, STableIndexRsp *pRsp) {
   SDecoder decoder = {0};
   tDecoderInit(&decoder, buf, bufLen);
@@ -3953,6 +4024,9 @@ int32_t tDeserializeSTableIndexRsp(void *buf, int32_t bufLen, STableIndexRsp *pR
       }
     }
   }
+  if (!tDecodeIsEnd(&decoder)) {
+    if (tDeserializeSTableIndexLag(&decoder, pRsp->pIndex) < 0) return -1;
+  }
   tEndDecode(&decoder);
 
   tDecoderClear(&decoder);
@@ -4224,6 +4298,11 @@ int32_t tSerializeSSTbHbRsp(void *buf, int32_t bufLen, SSTbHbRsp *pRsp) {
     }
   }
 
+  for (int32_t i = 0; i < numOfIndex; ++i) {
+    STableIndexRsp *pIndexRsp = taosArrayGet(pRsp->pIndexRsp, i);
+    if (tSerializeSTableIndexLag(&encoder, pIndexRsp->pIndex) < 0) return -1;
+  }
+
   tEndEncode(&encoder);
 
   int32_t tlen = encoder.pos;
@@ -4296,6 +4375,13 @@ int32_t tDeserializeSSTbHbRsp(void *buf, int32_t bufLen, SSTbHbRsp *pRsp) {
     taosArrayPush(pRsp->pIndexRsp, &tableIndexRsp);
   }
 
+  if (!tDecodeIsEnd(&decoder)) {
+    for (int32_t i = 0; i < numOfIndex; ++i) {
+      STableIndexRsp *pIndexRsp = taosArrayGet(pRsp->pIndexRsp, i);
+      if (tDeserializeSTableIndexLag(&decoder, pIndexRsp->pIndex) < 0) return -1;
+    }
+  }
+
   tEndDecode(&decoder);
 
   tDecoderClear(&decoder);
@@ -6219,6 +6305,7 @@ int32_t tSerializeSMqPollReq(void *buf, int32_t bufLen, SMqPollReq *pReq) {
   if (tEncodeI64(&encoder, pReq->consumerId) < 0) return -1;
   if (tEncodeI64(&encoder, pReq->timeout) < 0) return -1;
   if (tSerializeSTqOffsetVal(&encoder, &pReq->reqOffset) < 0) return -1;
+  if (tEncodeI8(&encoder, pReq->rawSubmit) < 0) return -1;
 
   tEndEncode(&encoder);
 
@@ -6254,6 +6341,9 @@ int32_t tDeserializeSMqPollReq(void *buf, int32_t bufLen, SMqPollReq *pReq) {
   if (tDecodeI64(&decoder, &pReq->consumerId) < 0) return -1;
   if (tDecodeI64(&decoder, &pReq->timeout) < 0) return -1;
   if (tDerializeSTqOffsetVal(&decoder, &pReq->reqOffset) < 0) return -1;
+  if (!tDecodeIsEnd(&decoder)) {
+    if (tDecodeI8(&decoder, &pReq->rawSubmit) < 0) return -1;
+  }
 
   tEndDecode(&decoder);
 
@@ -6523,6 +6613,10 @@ int32_t tSerializeSSchedulerHbRsp(void *buf, int32_t bufLen, SSchedulerHbRsp *pR
       if (tEncodeI32(&encoder, status->execId) < 0) return -1;
       if (tEncodeI8(&encoder, status->status) < 0) return -1;
     }
+    for (int32_t i = 0; i < num; ++i) {
+      STaskStatus *status = taosArrayGet(pRsp->taskStatus, i);
+      if (tEncodeI64(&encoder, status->arenaPeak) < 0) return -1;
+    }
   } else {
     if (tEncodeI32(&encoder, 0) < 0) return -1;
   }
@@ -6555,6 +6649,12 @@ int32_t tDeserializeSSchedulerHbRsp(void *buf, int32_t bufLen, SSchedulerHbRsp *
       if (tDecodeI8(&decoder, &status.status) < 0) return -1;
       taosArrayPush(pRsp->taskStatus, &status);
     }
+    if (!tDecodeIsEnd(&decoder)) {
+      for (int32_t i = 0; i < num; ++i) {
+        STaskStatus *status = taosArrayGet(pRsp->taskStatus, i);
+        if (tDecodeI64(&decoder, &status->arenaPeak) < 0) return -1;
+      }
+    }
   } else {
     pRsp->taskStatus = NULL;
   }
@@ -8035,7 +8135,7 @@ int32_t tDecodeMqMetaRsp(SDecoder *pDecoder, SMqMetaRsp *pRsp) {
   return 0;
 }
 
-int32_t tEncodeMqDataRsp(SEncoder *pEncoder, const SMqDataRsp *pRsp) {
+static int32_t tEncodeMqDataRspCommon(SEncoder *pEncoder, const SMqDataRsp *pRsp) {
   if (tEncodeSTqOffsetVal(pEncoder, &pRsp->reqOffset) < 0) return -1;
   if (tEncodeSTqOffsetVal(pEncoder, &pRsp->rspOffset) < 0) return -1;
   if (tEncodeI32(pEncoder, pRsp->blockNum) < 0) return -1;
@@ -8060,7 +8160,13 @@ int32_t tEncodeMqDataRsp(SEncoder *pEncoder, const SMqDataRsp *pRsp) {
   return 0;
 }
 
-int32_t tDecodeMqDataRsp(SDecoder *pDecoder, SMqDataRsp *pRsp) {
+int32_t tEncodeMqDataRsp(SEncoder *pEncoder, const SMqDataRsp *pRsp) {
+  if (tEncodeMqDataRspCommon(pEncoder, pRsp) < 0) return -1;
+  if (tEncodeI8(pEncoder, pRsp->rawSubmit) < 0) return -1;
+  return 0;
+}
+
+static int32_t tDecodeMqDataRspCommon(SDecoder *pDecoder, SMqDataRsp *pRsp) {
   if (tDecodeSTqOffsetVal(pDecoder, &pRsp->reqOffset) < 0) return -1;
   if (tDecodeSTqOffsetVal(pDecoder, &pRsp->rspOffset) < 0) return -1;
   if (tDecodeI32(pDecoder, &pRsp->blockNum) < 0) return -1;
@@ -8105,6 +8211,14 @@ int32_t tDecodeMqDataRsp(SDecoder *pDecoder, SMqDataRsp *pRsp) {
   return 0;
 }
 
+int32_t tDecodeMqDataRsp(SDecoder *pDecoder, SMqDataRsp *pRsp) {
+  if (tDecodeMqDataRspCommon(pDecoder, pRsp) < 0) return -1;
+  if (!tDecodeIsEnd(pDecoder)) {
+    if (tDecodeI8(pDecoder, &pRsp->rawSubmit) < 0) return -1;
+  }
+  return 0;
+}
+
 void tDeleteMqDataRsp(SMqDataRsp *pRsp) {
   pRsp->blockDataLen = taosArrayDestroy(pRsp->blockDataLen);
   taosArrayDestroyP(pRsp->blockData, (FDelete)taosMemoryFree);
@@ -8116,7 +8230,7 @@ void tDeleteMqDataRsp(SMqDataRsp *pRsp) {
 }
 
 int32_t tEncodeSTaosxRsp(SEncoder *pEncoder, const STaosxRsp *pRsp) {
-  if (tEncodeMqDataRsp(pEncoder, (const SMqDataRsp *)pRsp) < 0) return -1;
+  if (tEncodeMqDataRspCommon(pEncoder, (const SMqDataRsp *)pRsp) < 0) return -1;
 
   if (tEncodeI32(pEncoder, pRsp->createTableNum) < 0) return -1;
   if (pRsp->createTableNum) {
@@ -8126,11 +8240,12 @@ int32_t tEncodeSTaosxRsp(SEncoder *pEncoder, const STaosxRsp *pRsp) {
       if (tEncodeBinary(pEncoder, createTableReq, createTableLen) < 0) return -1;
     }
   }
+  if (tEncodeI8(pEncoder, pRsp->rawSubmit) < 0) return -1;
   return 0;
 }
 
 int32_t tDecodeSTaosxRsp(SDecoder *pDecoder, STaosxRsp *pRsp) {
-  if (tDecodeMqDataRsp(pDecoder, (SMqDataRsp *)pRsp) < 0) return -1;
+  if (tDecodeMqDataRspCommon(pDecoder, (SMqDataRsp *)pRsp) < 0) return -1;
 
   if (tDecodeI32(pDecoder, &pRsp->createTableNum) < 0) return -1;
   if (pRsp->createTableNum) {
@@ -8145,6 +8260,9 @@ int32_t tDecodeSTaosxRsp(SDecoder *pDecoder, STaosxRsp *pRsp) {
       taosArrayPush(pRsp->createTableReq, &pCreate);
     }
   }
+  if (!tDecodeIsEnd(pDecoder)) {
+    if (tDecodeI8(pDecoder, &pRsp->rawSubmit) < 0) return -1;
+  }
   return 0;
 }
 
@@ -260,4 +260,61 @@ TEST(testCase, var_dataBlock_split_test) {
   }
 }
 
+TEST(testCase, shared_var_dataBlock_encode_test) {
+  int32_t numOfRows = 10;
+
+  SSDataBlock* b = createDataBlock();
+
+  SColumnInfoData infoData = createColumnInfoData(TSDB_DATA_TYPE_BINARY, 40, 1);
+  blockDataAppendColInfo(b, &infoData);
+  blockDataEnsureCapacity(b, numOfRows);
+
+  char tag1[41] = {0};
+  char tag2[41] = {0};
+  STR_TO_VARSTR(tag1, "shanghai");
+  STR_TO_VARSTR(tag2, "beijing");
+
+  // rows 0-3 share tag1, 4-5 are null, 6-9 share tag2
+  SColumnInfoData* p0 = (SColumnInfoData*)taosArrayGet(b->pDataBlock, 0);
+  ASSERT_EQ(colDataSetNItems(p0, 0, tag1, 4, false), 0);
+  colDataSetNNULL(p0, 4, 2);
+  ASSERT_EQ(colDataSetNItems(p0, 6, tag2, 4, false), 0);
+  b->info.rows = numOfRows;
+
+  // each value is stored and shipped once
+  int32_t payloadLen = varDataTLen(tag1) + varDataTLen(tag2);
+  ASSERT_TRUE(p0->reassigned);
+  ASSERT_EQ(p0->varmeta.length, payloadLen);
+  ASSERT_EQ(colDataGetLength(p0, numOfRows), payloadLen);
+
+  char*   buf = (char*)taosMemoryCalloc(1, blockGetEncodeSize(b));
+  int32_t len = blockEncode(b, buf, 1);
+  ASSERT_EQ(len, blockDataGetSerialMetaSize(1) + numOfRows * sizeof(int32_t) + payloadLen);
+
+  SSDataBlock* pDecoded = createOneDataBlock(b, false);
+  blockDecode(pDecoded, buf);
+  ASSERT_EQ(pDecoded->info.rows, numOfRows);
+
+  SColumnInfoData* p1 = (SColumnInfoData*)taosArrayGet(pDecoded->pDataBlock, 0);
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    if (i == 4 || i == 5) {
+      ASSERT_TRUE(colDataIsNull_s(p1, i));
+      continue;
+    }
+
+    const char* pExpect = (i < 4) ? tag1 : tag2;
+    char*       pVal = colDataGetData(p1, i);
+    ASSERT_EQ(varDataLen(pVal), varDataLen(pExpect));
+    ASSERT_EQ(memcmp(varDataVal(pVal), varDataVal(pExpect), varDataLen(pExpect)), 0);
+  }
+
+  // a cleaned up column is back to one value per row
+  colInfoDataCleanup(p0, numOfRows);
+  ASSERT_FALSE(p0->reassigned);
+
+  taosMemoryFree(buf);
+  blockDataDestroy(pDecoded);
+  blockDataDestroy(b);
+}
+
 #pragma GCC diagnostic pop
\ No newline at end of file
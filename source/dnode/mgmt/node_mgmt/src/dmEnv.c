@@ -56,6 +56,8 @@ static int32_t dmInitMonitor() {
   monCfg.port = tsMonitorPort;
   monCfg.server = tsMonitorFqdn;
   monCfg.comp = tsMonitorComp;
+  monCfg.metricsFqdn = tsLocalFqdn;
+  monCfg.metricsPort = tsMetricsPort;
   if (monInit(&monCfg) != 0) {
     if (terrno != 0) code = terrno;
     goto _exit;
@@ -28,6 +28,7 @@ int32_t mndConvertRsmaTask(char** pDst, int32_t* pDstLen, const char* ast, int64
                            int64_t watermark, int64_t deleteMark);
 
 int32_t mndScheduleStream(SMnode* pMnode, SStreamObj* pStream, int64_t nextWindowSkey);
+int32_t mndGetNumOfSubtasks(const SSubplan* pPlan);
 
 #ifdef __cplusplus
 }
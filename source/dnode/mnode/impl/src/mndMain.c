@@ -42,6 +42,8 @@
 #include "mndUser.h"
 #include "mndVgroup.h"
 
+#define MNODE_SDB_MERGE_INTERVAL_SEC 10
+
 static inline int32_t mndAcquireRpc(SMnode *pMnode) {
   int32_t code = 0;
   taosThreadRwlockRdlock(&pMnode->lock);
@@ -308,6 +310,10 @@ static void *mndThreadFp(void *param) {
     if (sec % (MNODE_TIMEOUT_SEC / 2) == 0) {
       mndSyncCheckTimeout(pMnode);
     }
+
+    if (sec % MNODE_SDB_MERGE_INTERVAL_SEC == 0) {
+      sdbMergeFile(pMnode->pSdb);
+    }
   }
 
   return NULL;
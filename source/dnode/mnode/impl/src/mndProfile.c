@@ -853,6 +853,16 @@ static int32_t packQueriesIntoBlock(SShowObj* pShow, SConnObj* pConn, SSDataBloc
     pColInfo = taosArrayGet(pBlock->pDataBlock, cols++);
     colDataSetVal(pColInfo, curRowIndex, (const char *)sql, false);
 
+    // the tasks of a query run at the same time, so the arena peak of the query is the sum of the peaks of its tasks
+    int64_t arenaPeak = 0;
+    int32_t subNum = taosArrayGetSize(pQuery->subDesc);
+    for (int32_t i = 0; i < subNum; ++i) {
+      SQuerySubDesc *pDesc = taosArrayGet(pQuery->subDesc, i);
+      arenaPeak += pDesc->arenaPeak;
+    }
+    pColInfo = taosArrayGet(pBlock->pDataBlock, cols++);
+    colDataSetVal(pColInfo, curRowIndex, (const char *)&arenaPeak, false);
+
     pBlock->info.rows++;
   }
 
@@ -249,9 +249,36 @@ int32_t doAddSinkTask(SStreamObj* pStream, SArray* pTaskList, SMnode* pMnode, in
   return 0;
 }
 
+// The source task of a vgroup is split into several sub-tasks that run concurrently, each of them scans the tables of
+// the groups hashed to it. It only pays off when the groups are made of whole tables, i.e. partition by tbname or tags.
+int32_t mndGetNumOfSubtasks(const SSubplan* pPlan) {
+  if (tsStreamSubtasks <= 1) {
+    return 1;
+  }
+
+  SPhysiNode* pNode = (SPhysiNode*)pPlan->pNode;
+  while (pNode != NULL && nodeType(pNode) != QUERY_NODE_PHYSICAL_PLAN_STREAM_SCAN) {
+    pNode = (LIST_LENGTH(pNode->pChildren) == 1) ? (SPhysiNode*)nodesListGetNode(pNode->pChildren, 0) : NULL;
+  }
+
+  if (pNode == NULL || ((STableScanPhysiNode*)pNode)->pGroupTags == NULL) {
+    return 1;
+  }
+  return tsStreamSubtasks;
+}
+
+static void setSubtaskInfo(SStreamTask* pTask, int32_t subtaskId, int32_t numOfSubtasks) {
+  pTask->info.subtaskId = subtaskId;
+  pTask->info.numOfSubtasks = numOfSubtasks;
+  if (numOfSubtasks > 1) {
+    mDebug("s-task:0x%x is the sub-task %d of %d", pTask->id.taskId, subtaskId, numOfSubtasks);
+  }
+}
+
 static int32_t addSourceTask(SMnode* pMnode, SVgObj* pVgroup, SArray* pTaskList, SArray* pSinkTaskList,
                              SStreamObj* pStream, SSubplan* plan, uint64_t uid, SEpSet* pEpset, bool fillHistory,
-                             bool hasExtraSink, int64_t firstWindowSkey, bool hasFillHistory) {
+                             bool hasExtraSink, int64_t firstWindowSkey, bool hasFillHistory, int32_t subtaskId,
+                             int32_t numOfSubtasks) {
   SStreamTask* pTask =
       tNewStreamTask(uid, TASK_LEVEL__SOURCE, fillHistory, pStream->conf.triggerParam, pTaskList, hasFillHistory);
   if (pTask == NULL) {
@@ -259,6 +286,7 @@ static int32_t addSourceTask(SMnode* pMnode, SVgObj* pVgroup, SArray* pTaskList,
   }
 
   epsetAssign(&pTask->info.mnodeEpset, pEpset);
+  setSubtaskInfo(pTask, subtaskId, numOfSubtasks);
   STimeWindow* pWindow = &pTask->dataRange.window;
 
   pWindow->skey = INT64_MIN;
@@ -330,7 +358,8 @@ static int32_t addSourceTasksForOneLevelStream(SMnode* pMnode, const SQueryPlan*
     return -1;
   }
 
-  void* pIter = NULL;
+  int32_t numOfSubtasks = mndGetNumOfSubtasks(plan);
+  void*   pIter = NULL;
   while (1) {
     SVgObj* pVgroup;
     pIter = sdbFetch(pSdb, SDB_VGROUP, pIter, (void**)&pVgroup);
@@ -343,19 +372,21 @@ static int32_t addSourceTasksForOneLevelStream(SMnode* pMnode, const SQueryPlan*
       continue;
     }
 
-    // new stream task
-    SArray** pSinkTaskList = taosArrayGet(pStream->tasks, SINK_NODE_LEVEL);
-    int32_t  code = addSourceTask(pMnode, pVgroup, pTaskList, *pSinkTaskList, pStream, plan, pStream->uid, pEpset,
-                                        false, hasExtraSink, nextWindowSkey, pStream->conf.fillHistory);
-    if (code != TSDB_CODE_SUCCESS) {
-      sdbRelease(pSdb, pVgroup);
-      return -1;
-    }
+    int32_t code = TSDB_CODE_SUCCESS;
+    for (int32_t i = 0; i < numOfSubtasks && code == TSDB_CODE_SUCCESS; ++i) {
+      // new stream task
+      SArray** pSinkTaskList = taosArrayGet(pStream->tasks, SINK_NODE_LEVEL);
+      code = addSourceTask(pMnode, pVgroup, pTaskList, *pSinkTaskList, pStream, plan, pStream->uid, pEpset, false,
+                           hasExtraSink, nextWindowSkey, pStream->conf.fillHistory, i, numOfSubtasks);
+      if (code != TSDB_CODE_SUCCESS) {
+        break;
+      }
 
-    if (pStream->conf.fillHistory) {
-      SArray** pHSinkTaskList = taosArrayGet(pStream->pHTasksList, SINK_NODE_LEVEL);
-      code = addSourceTask(pMnode, pVgroup, pHTaskList, *pHSinkTaskList, pStream, plan, pStream->hTaskUid,
-                                 pEpset, true, hasExtraSink, nextWindowSkey, true);
+      if (pStream->conf.fillHistory) {
+        SArray** pHSinkTaskList = taosArrayGet(pStream->pHTasksList, SINK_NODE_LEVEL);
+        code = addSourceTask(pMnode, pVgroup, pHTaskList, *pHSinkTaskList, pStream, plan, pStream->hTaskUid, pEpset,
+                             true, hasExtraSink, nextWindowSkey, true, i, numOfSubtasks);
+      }
     }
 
     sdbRelease(pSdb, pVgroup);
@@ -373,7 +404,7 @@ static int32_t addSourceTasksForOneLevelStream(SMnode* pMnode, const SQueryPlan*
 
 static int32_t doAddSourceTask(SArray* pTaskList, bool isFillhistory, int64_t uid, SStreamTask* pDownstreamTask,
                                SMnode* pMnode, SSubplan* pPlan, SVgObj* pVgroup, SEpSet* pEpset,
-                               int64_t nextWindowSkey, bool hasFillHistory) {
+                               int64_t nextWindowSkey, bool hasFillHistory, int32_t subtaskId, int32_t numOfSubtasks) {
   SStreamTask* pTask = tNewStreamTask(uid, TASK_LEVEL__SOURCE, isFillhistory, 0, pTaskList, hasFillHistory);
   if (pTask == NULL) {
     terrno = TSDB_CODE_OUT_OF_MEMORY;
@@ -381,6 +412,7 @@ static int32_t doAddSourceTask(SArray* pTaskList, bool isFillhistory, int64_t ui
   }
 
   epsetAssign(&(pTask)->info.mnodeEpset, pEpset);
+  setSubtaskInfo(pTask, subtaskId, numOfSubtasks);
 
   // todo set the correct ts, which should be last key of queried table.
   STimeWindow* pWindow = &pTask->dataRange.window;
@@ -508,7 +540,9 @@ static int32_t addSourceTasksForMultiLevelStream(SMnode* pMnode, SQueryPlan* pPl
     return -1;
   }
 
-  void* pIter = NULL;
+  // the agg task aligns the checkpoint barriers of all the sub-tasks as its upstream tasks
+  int32_t numOfSubtasks = mndGetNumOfSubtasks(plan);
+  void*   pIter = NULL;
   while (1) {
     SVgObj* pVgroup;
     pIter = sdbFetch(pSdb, SDB_VGROUP, pIter, (void**)&pVgroup);
@@ -521,20 +555,24 @@ static int32_t addSourceTasksForMultiLevelStream(SMnode* pMnode, SQueryPlan* pPl
       continue;
     }
 
-    int32_t code = doAddSourceTask(pSourceTaskList, false, pStream->uid, pDownstreamTask, pMnode, plan, pVgroup, pEpset,
-                                   nextWindowSkey, pStream->conf.fillHistory);
-    if (code != TSDB_CODE_SUCCESS) {
-      sdbRelease(pSdb, pVgroup);
-      terrno = code;
-      return -1;
-    }
-
-    if (pStream->conf.fillHistory) {
-      code = doAddSourceTask(pHSourceTaskList, true, pStream->hTaskUid, pHDownstreamTask, pMnode, plan, pVgroup, pEpset,
-                             nextWindowSkey, pStream->conf.fillHistory);
+    for (int32_t i = 0; i < numOfSubtasks; ++i) {
+      int32_t code = doAddSourceTask(pSourceTaskList, false, pStream->uid, pDownstreamTask, pMnode, plan, pVgroup,
+                                     pEpset, nextWindowSkey, pStream->conf.fillHistory, i, numOfSubtasks);
       if (code != TSDB_CODE_SUCCESS) {
         sdbRelease(pSdb, pVgroup);
-        return code;
+        sdbCancelFetch(pSdb, pIter);
+        terrno = code;
+        return -1;
+      }
+
+      if (pStream->conf.fillHistory) {
+        code = doAddSourceTask(pHSourceTaskList, true, pStream->hTaskUid, pHDownstreamTask, pMnode, plan, pVgroup,
+                               pEpset, nextWindowSkey, pStream->conf.fillHistory, i, numOfSubtasks);
+        if (code != TSDB_CODE_SUCCESS) {
+          sdbRelease(pSdb, pVgroup);
+          sdbCancelFetch(pSdb, pIter);
+          return code;
+        }
       }
     }
 
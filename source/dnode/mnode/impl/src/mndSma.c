@@ -1100,6 +1100,19 @@ int32_t mndGetTableSma(SMnode *pMnode, char *tbFName, STableIndexRsp *rsp, bool
     info.sliding = pSma->sliding;
     info.dstTbUid = pSma->dstTbUid;
     info.dstVgId = pSma->dstVgId;
+    info.watermark = -1;
+    info.maxDelay = -1;
+
+    char streamName[TSDB_TABLE_FNAME_LEN] = {0};
+    mndGetStreamNameFromSmaName(streamName, pSma->name);
+    SStreamObj *pStream = mndAcquireStream(pMnode, streamName);
+    if (pStream != NULL) {
+      if (pStream->smaId == pSma->uid) {
+        info.watermark = pStream->conf.watermark;
+        info.maxDelay = pStream->conf.triggerParam;
+      }
+      mndReleaseStream(pMnode, pStream);
+    }
 
     SVgObj *pVg = mndAcquireVgroup(pMnode, pSma->dstVgId);
     if (pVg == NULL) {
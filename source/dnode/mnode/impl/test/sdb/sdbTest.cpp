@@ -1009,3 +1009,262 @@ TEST_F(MndTestSdb, 01_Read_Str) {
   ASSERT_EQ(mnode.insertTimes, 9);
   ASSERT_EQ(mnode.deleteTimes, 9);
 }
+
+static void sdbSetDeltaTables(SSdb *pSdb) {
+  SSdbTable strTable1;
+  memset(&strTable1, 0, sizeof(SSdbTable));
+  strTable1.sdbType = SDB_USER;
+  strTable1.keyType = SDB_KEY_BINARY;
+  strTable1.deployFp = (SdbDeployFp)strDefault;
+  strTable1.encodeFp = (SdbEncodeFp)strEncode;
+  strTable1.decodeFp = (SdbDecodeFp)strDecode;
+  strTable1.insertFp = (SdbInsertFp)strInsert;
+  strTable1.updateFp = (SdbUpdateFp)strUpdate;
+  strTable1.deleteFp = (SdbDeleteFp)strDelete;
+
+  SSdbTable strTable2;
+  memset(&strTable2, 0, sizeof(SSdbTable));
+  strTable2.sdbType = SDB_VGROUP;
+  strTable2.keyType = SDB_KEY_INT32;
+  strTable2.encodeFp = (SdbEncodeFp)i32Encode;
+  strTable2.decodeFp = (SdbDecodeFp)i32Decode;
+  strTable2.insertFp = (SdbInsertFp)i32Insert;
+  strTable2.updateFp = (SdbUpdateFp)i32Update;
+  strTable2.deleteFp = (SdbDeleteFp)i32Delete;
+
+  SSdbTable strTable3;
+  memset(&strTable3, 0, sizeof(SSdbTable));
+  strTable3.sdbType = SDB_CONSUMER;
+  strTable3.keyType = SDB_KEY_INT64;
+  strTable3.encodeFp = (SdbEncodeFp)i64Encode;
+  strTable3.decodeFp = (SdbDecodeFp)i64Decode;
+  strTable3.insertFp = (SdbInsertFp)i64Insert;
+  strTable3.updateFp = (SdbUpdateFp)i64Update;
+  strTable3.deleteFp = (SdbDeleteFp)i64Delete;
+
+  sdbSetTable(pSdb, strTable1);
+  sdbSetTable(pSdb, strTable2);
+  sdbSetTable(pSdb, strTable3);
+}
+
+TEST_F(MndTestSdb, 02_Delta_File) {
+  SMnode   mnode = {0};
+  SSdbOpt  opt = {0};
+  SStrObj  strObj = {0};
+  SI32Obj  i32Obj = {0};
+  SI64Obj  i64Obj = {0};
+  SSdbRaw *pRaw = NULL;
+  SStrObj *pObj = NULL;
+  int64_t  index = 0;
+  int64_t  term = 0;
+  int64_t  config = 0;
+  char     file[PATH_MAX] = {0};
+
+  opt.pMnode = &mnode;
+  opt.path = TD_TMP_DIR_PATH "mnode_test_sdb_delta";
+  taosRemoveDir(opt.path);
+
+  SSdb *pSdb = sdbInit(&opt);
+  ASSERT_NE(pSdb, nullptr);
+  mnode.pSdb = pSdb;
+  sdbSetDeltaTables(pSdb);
+  ASSERT_EQ(sdbDeploy(pSdb), 0);
+
+  // the first checkpoint writes sdb.data
+  sdbSetApplyInfo(pSdb, 1, 1, 1);
+  ASSERT_EQ(sdbWriteFile(pSdb, 0), 0);
+  snprintf(file, sizeof(file), "%s/data/sdb.data", opt.path);
+  ASSERT_TRUE(taosCheckExistFile(file));
+
+  // update a row, drop a row and create rows, they go to sdb.delta.1
+  strSetDefault(&strObj, 1);
+  strObj.v8 = 11;
+  pRaw = strEncode(&strObj);
+  sdbSetRawStatus(pRaw, SDB_STATUS_READY);
+  ASSERT_EQ(sdbWrite(pSdb, pRaw), 0);
+
+  strSetDefault(&strObj, 2);
+  pRaw = strEncode(&strObj);
+  sdbSetRawStatus(pRaw, SDB_STATUS_DROPPED);
+  ASSERT_EQ(sdbWrite(pSdb, pRaw), 0);
+
+  for (int32_t key = 5; key <= 6; ++key) {
+    i32SetDefault(&i32Obj, key);
+    pRaw = i32Encode(&i32Obj);
+    sdbSetRawStatus(pRaw, SDB_STATUS_READY);
+    ASSERT_EQ(sdbWrite(pSdb, pRaw), 0);
+  }
+
+  sdbSetApplyInfo(pSdb, 2, 1, 1);
+  ASSERT_EQ(sdbWriteFile(pSdb, 0), 0);
+  snprintf(file, sizeof(file), "%s/data/sdb.delta.1", opt.path);
+  ASSERT_TRUE(taosCheckExistFile(file));
+
+  // a row created in one delta file and dropped in the next one
+  i32SetDefault(&i32Obj, 6);
+  pRaw = i32Encode(&i32Obj);
+  sdbSetRawStatus(pRaw, SDB_STATUS_DROPPED);
+  ASSERT_EQ(sdbWrite(pSdb, pRaw), 0);
+
+  sdbSetApplyInfo(pSdb, 3, 1, 1);
+  ASSERT_EQ(sdbWriteFile(pSdb, 0), 0);
+  snprintf(file, sizeof(file), "%s/data/sdb.delta.2", opt.path);
+  ASSERT_TRUE(taosCheckExistFile(file));
+  sdbCleanup(pSdb);
+
+  // sdb.data and the delta files are replayed in order
+  pSdb = sdbInit(&opt);
+  ASSERT_NE(pSdb, nullptr);
+  mnode.pSdb = pSdb;
+  sdbSetDeltaTables(pSdb);
+  ASSERT_EQ(sdbReadFile(pSdb), 0);
+
+  sdbGetCommitInfo(pSdb, &index, &term, &config);
+  ASSERT_EQ(index, 3);
+  ASSERT_EQ(sdbGetSize(pSdb, SDB_USER), 1);
+  ASSERT_EQ(sdbGetSize(pSdb, SDB_VGROUP), 1);
+  pObj = (SStrObj *)sdbAcquire(pSdb, SDB_USER, "k1000");
+  ASSERT_NE(pObj, nullptr);
+  ASSERT_EQ(pObj->v8, 11);
+  sdbRelease(pSdb, pObj);
+  pObj = (SStrObj *)sdbAcquire(pSdb, SDB_USER, "k2000");
+  ASSERT_EQ(pObj, nullptr);
+
+  // enough delta files to be merged
+  for (int32_t key = 1; key <= 8; ++key) {
+    i64SetDefault(&i64Obj, key);
+    pRaw = i64Encode(&i64Obj);
+    sdbSetRawStatus(pRaw, SDB_STATUS_READY);
+    ASSERT_EQ(sdbWrite(pSdb, pRaw), 0);
+    sdbSetApplyInfo(pSdb, 3 + key, 1, 1);
+    ASSERT_EQ(sdbWriteFile(pSdb, 0), 0);
+  }
+
+  // the snapshot holds sdb.data and all the delta files
+  {
+    SSdbIter *pReader = NULL;
+    SSdbIter *pWritter = NULL;
+    void     *pBuf = NULL;
+    int32_t   len = 0;
+
+    ASSERT_EQ(sdbStartRead(pSdb, &pReader, &index, NULL, NULL), 0);
+    ASSERT_EQ(index, 11);
+    ASSERT_EQ(sdbStartWrite(pSdb, &pWritter), 0);
+    while (sdbDoRead(pSdb, pReader, &pBuf, &len) == 0) {
+      if (pBuf == NULL || len == 0) break;
+      sdbDoWrite(pSdb, pWritter, pBuf, len);
+      taosMemoryFree(pBuf);
+    }
+    sdbStopRead(pSdb, pReader);
+    ASSERT_EQ(sdbStopWrite(pSdb, pWritter, true, -1, -1, -1), 0);
+  }
+
+  ASSERT_EQ(sdbGetSize(pSdb, SDB_USER), 1);
+  ASSERT_EQ(sdbGetSize(pSdb, SDB_VGROUP), 1);
+  ASSERT_EQ(sdbGetSize(pSdb, SDB_CONSUMER), 8);
+  snprintf(file, sizeof(file), "%s/data/sdb.delta.3", opt.path);
+  ASSERT_FALSE(taosCheckExistFile(file));
+
+  for (int32_t key = 1; key <= 8; ++key) {
+    i64SetDefault(&i64Obj, key);
+    i64Obj.v8 = 100;
+    pRaw = i64Encode(&i64Obj);
+    sdbSetRawStatus(pRaw, (key % 2 == 0) ? SDB_STATUS_DROPPED : SDB_STATUS_READY);
+    ASSERT_EQ(sdbWrite(pSdb, pRaw), 0);
+    sdbSetApplyInfo(pSdb, 11 + key, 1, 1);
+    ASSERT_EQ(sdbWriteFile(pSdb, 0), 0);
+  }
+
+  ASSERT_EQ(sdbMergeFile(pSdb), 0);
+  snprintf(file, sizeof(file), "%s/data/sdb.delta.%" PRId64, opt.path, pSdb->deltaSeq);
+  ASSERT_FALSE(taosCheckExistFile(file));
+  sdbCleanup(pSdb);
+
+  pSdb = sdbInit(&opt);
+  ASSERT_NE(pSdb, nullptr);
+  mnode.pSdb = pSdb;
+  sdbSetDeltaTables(pSdb);
+  ASSERT_EQ(sdbReadFile(pSdb), 0);
+
+  sdbGetCommitInfo(pSdb, &index, &term, &config);
+  ASSERT_EQ(index, 19);
+  ASSERT_EQ(sdbGetSize(pSdb, SDB_USER), 1);
+  ASSERT_EQ(sdbGetSize(pSdb, SDB_VGROUP), 1);
+  ASSERT_EQ(sdbGetSize(pSdb, SDB_CONSUMER), 4);
+
+  int64_t  i64key = 3;
+  SI64Obj *pI64Obj = (SI64Obj *)sdbAcquire(pSdb, SDB_CONSUMER, &i64key);
+  ASSERT_NE(pI64Obj, nullptr);
+  ASSERT_EQ(pI64Obj->v8, 100);
+  sdbRelease(pSdb, pI64Obj);
+  sdbCleanup(pSdb);
+}
+
+TEST_F(MndTestSdb, 03_Delta_Snapshot) {
+  SMnode   mnode = {0};
+  SSdbOpt  opt = {0};
+  SStrObj  strObj = {0};
+  SI32Obj  i32Obj = {0};
+  SSdbRaw *pRaw = NULL;
+
+  opt.pMnode = &mnode;
+  opt.path = TD_TMP_DIR_PATH "mnode_test_sdb_delta_snapshot";
+  taosRemoveDir(opt.path);
+
+  SSdb *pSdb = sdbInit(&opt);
+  ASSERT_NE(pSdb, nullptr);
+  mnode.pSdb = pSdb;
+  sdbSetDeltaTables(pSdb);
+  ASSERT_EQ(sdbDeploy(pSdb), 0);
+  sdbSetApplyInfo(pSdb, 1, 1, 1);
+  ASSERT_EQ(sdbWriteFile(pSdb, 0), 0);
+
+  // the delta files hold the drop of a row of sdb.data and of a row created by the previous delta file
+  strSetDefault(&strObj, 2);
+  pRaw = strEncode(&strObj);
+  sdbSetRawStatus(pRaw, SDB_STATUS_DROPPED);
+  ASSERT_EQ(sdbWrite(pSdb, pRaw), 0);
+
+  i32SetDefault(&i32Obj, 5);
+  pRaw = i32Encode(&i32Obj);
+  sdbSetRawStatus(pRaw, SDB_STATUS_READY);
+  ASSERT_EQ(sdbWrite(pSdb, pRaw), 0);
+  sdbSetApplyInfo(pSdb, 2, 1, 1);
+  ASSERT_EQ(sdbWriteFile(pSdb, 0), 0);
+
+  i32SetDefault(&i32Obj, 5);
+  pRaw = i32Encode(&i32Obj);
+  sdbSetRawStatus(pRaw, SDB_STATUS_DROPPED);
+  ASSERT_EQ(sdbWrite(pSdb, pRaw), 0);
+  sdbSetApplyInfo(pSdb, 3, 1, 1);
+  ASSERT_EQ(sdbWriteFile(pSdb, 0), 0);
+  ASSERT_EQ(taosArrayGetSize(pSdb->deltaFiles), 2);
+
+  std::string snapshot;
+  SSdbIter   *pReader = NULL;
+  void       *pBuf = NULL;
+  int32_t     len = 0;
+  ASSERT_EQ(sdbStartRead(pSdb, &pReader, NULL, NULL, NULL), 0);
+  while (sdbDoRead(pSdb, pReader, &pBuf, &len) == 0) {
+    if (pBuf == NULL || len == 0) break;
+    snapshot.append((const char *)pBuf, len);
+    taosMemoryFree(pBuf);
+  }
+  sdbStopRead(pSdb, pReader);
+
+  // followers without delta files fail on the drop of a row they do not have, the snapshot holds no drop at all
+  const size_t headSize = sizeof(int64_t) * (4 + 24 * 2) + 512;
+  int32_t      numOfUsers = 0;
+  int32_t      numOfVgroups = 0;
+  ASSERT_GT(snapshot.size(), headSize);
+  for (size_t pos = headSize; pos < snapshot.size();) {
+    SSdbRaw *pSnapRaw = (SSdbRaw *)(snapshot.data() + pos);
+    ASSERT_NE(pSnapRaw->status, SDB_STATUS_DROPPED);
+    if (pSnapRaw->type == SDB_USER) numOfUsers++;
+    if (pSnapRaw->type == SDB_VGROUP) numOfVgroups++;
+    pos += sizeof(SSdbRaw) + pSnapRaw->dataLen + sizeof(int32_t);
+  }
+  ASSERT_EQ(numOfUsers, sdbGetSize(pSdb, SDB_USER));
+  ASSERT_EQ(numOfVgroups, sdbGetSize(pSdb, SDB_VGROUP));
+  sdbCleanup(pSdb);
+}
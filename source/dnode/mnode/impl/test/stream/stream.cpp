@@ -0,0 +1,72 @@
+/**
+ * @file stream.cpp
+ * @brief MNODE module stream tests
+ * @version 1.0
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include "plannodes.h"
+#include "tglobal.h"
+
+// mndScheduler.h drags in mnode headers that are not valid c++
+extern "C" int32_t mndGetNumOfSubtasks(const SSubplan* pPlan);
+
+namespace {
+
+// project -> stream scan, the scan is partitioned by the given number of group tags
+SSubplan* buildSubplan(int32_t numOfGroupTags) {
+  SSubplan* pPlan = (SSubplan*)nodesMakeNode(QUERY_NODE_PHYSICAL_SUBPLAN);
+  SPhysiNode* pProject = (SPhysiNode*)nodesMakeNode(QUERY_NODE_PHYSICAL_PLAN_PROJECT);
+  STableScanPhysiNode* pScan = (STableScanPhysiNode*)nodesMakeNode(QUERY_NODE_PHYSICAL_PLAN_STREAM_SCAN);
+  for (int32_t i = 0; i < numOfGroupTags; ++i) {
+    nodesListMakeAppend(&pScan->pGroupTags, nodesMakeNode(QUERY_NODE_COLUMN));
+  }
+  nodesListMakeAppend(&pProject->pChildren, (SNode*)pScan);
+  pPlan->pNode = pProject;
+  return pPlan;
+}
+
+class MndTestStream : public ::testing::Test {
+ protected:
+  void SetUp() override { subtasks = tsStreamSubtasks; }
+  void TearDown() override { tsStreamSubtasks = subtasks; }
+
+  int32_t subtasks;
+};
+
+}  // namespace
+
+TEST_F(MndTestStream, 01_Subtasks_Disabled) {
+  tsStreamSubtasks = 1;
+  SSubplan* pPlan = buildSubplan(1);
+  EXPECT_EQ(mndGetNumOfSubtasks(pPlan), 1);
+  nodesDestroyNode((SNode*)pPlan);
+}
+
+TEST_F(MndTestStream, 02_Subtasks_GroupTags) {
+  tsStreamSubtasks = 4;
+  SSubplan* pPlan = buildSubplan(2);
+  EXPECT_EQ(mndGetNumOfSubtasks(pPlan), 4);
+  nodesDestroyNode((SNode*)pPlan);
+}
+
+TEST_F(MndTestStream, 03_Subtasks_NoGroupTags) {
+  // rows of one group may come from any table, so the source task is not split
+  tsStreamSubtasks = 4;
+  SSubplan* pPlan = buildSubplan(0);
+  EXPECT_EQ(mndGetNumOfSubtasks(pPlan), 1);
+  nodesDestroyNode((SNode*)pPlan);
+}
+
+TEST_F(MndTestStream, 04_Subtasks_MultiChildren) {
+  tsStreamSubtasks = 4;
+  SSubplan* pPlan = buildSubplan(1);
+  nodesListAppend(pPlan->pNode->pChildren, nodesMakeNode(QUERY_NODE_PHYSICAL_PLAN_STREAM_SCAN));
+  EXPECT_EQ(mndGetNumOfSubtasks(pPlan), 1);
+  nodesDestroyNode((SNode*)pPlan);
+}
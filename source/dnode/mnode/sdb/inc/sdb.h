@@ -164,6 +164,7 @@ typedef struct SSdbRow {
   ESdbType   type;
   ESdbStatus status;
   int32_t    refCount;
+  int64_t    ver;  // sdb row version of the last change
   char       pObj[];
 } SSdbRow;
 
@@ -192,6 +193,15 @@ typedef struct SSdb {
   SdbDecodeFp    decodeFps[SDB_MAX];
   SdbValidateFp  validateFps[SDB_MAX];
   TdThreadMutex  filelock;
+  int64_t        rowVer;                // increased on every change of a row
+  int64_t        ckptRowVer;            // rowVer when sdb.data or the last delta file is written
+  int64_t        dataIndex;             // apply index of sdb.data, -1 if sdb.data does not exist
+  int32_t        dataGen;               // increased every time sdb.data is replaced
+  int64_t        deltaSeq;              // sequence number of the last delta file
+  SArray        *deltaFiles;            // sequence numbers of the delta files to replay after sdb.data
+  SArray        *droppedRaws[SDB_MAX];  // raws of the rows dropped after the last checkpoint
+  int8_t         merging;
+  int8_t         dropLost;              // a drop could not be recorded, the next checkpoint writes sdb.data
 } SSdb;
 
 typedef struct SSdbIter {
@@ -267,6 +277,14 @@ int32_t sdbReadFile(SSdb *pSdb);
  */
 int32_t sdbWriteFile(SSdb *pSdb, int32_t delta);
 
+/**
+ * @brief Merge the delta files into sdb.data, called in background.
+ *
+ * @param pSdb The sdb object.
+ * @return int32_t 0 for success, -1 for failure.
+ */
+int32_t sdbMergeFile(SSdb *pSdb);
+
 /**
  * @brief Parse and write raw data to sdb, then free the pRaw object
  *
@@ -407,6 +425,7 @@ const char *sdbTableName(ESdbType type);
 const char *sdbStatusName(ESdbStatus status);
 void        sdbPrintOper(SSdb *pSdb, SSdbRow *pRow, const char *oper);
 int32_t     sdbGetIdFromRaw(SSdb *pSdb, SSdbRaw *pRaw);
+int32_t     sdbGetkeySize(SSdb *pSdb, ESdbType type, const void *pKey);
 
 void sdbWriteLock(SSdb *pSdb, int32_t type);
 void sdbReadLock(SSdb *pSdb, int32_t type);
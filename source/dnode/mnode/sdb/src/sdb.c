@@ -59,8 +59,16 @@ SSdb *sdbInit(SSdbOpt *pOption) {
   pSdb->commitIndex = -1;
   pSdb->commitTerm = -1;
   pSdb->commitConfig = -1;
+  pSdb->dataIndex = -1;
   pSdb->pMnode = pOption->pMnode;
   taosThreadMutexInit(&pSdb->filelock, NULL);
+  pSdb->deltaFiles = taosArrayInit(8, sizeof(int64_t));
+  if (pSdb->deltaFiles == NULL) {
+    sdbCleanup(pSdb);
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    mError("failed to init sdb since %s", terrstr());
+    return NULL;
+  }
   mInfo("sdb init success");
   return pSdb;
 }
@@ -106,6 +114,12 @@ void sdbCleanup(SSdb *pSdb) {
     mInfo("sdb table:%s is cleaned up", sdbTableName(i));
   }
 
+  for (ESdbType i = 0; i < SDB_MAX; ++i) {
+    taosArrayDestroyP(pSdb->droppedRaws[i], (FDelete)sdbFreeRaw);
+    pSdb->droppedRaws[i] = NULL;
+  }
+  taosArrayDestroy(pSdb->deltaFiles);
+
   taosThreadMutexDestroy(&pSdb->filelock);
   taosMemoryFree(pSdb);
   mInfo("sdb is cleaned up");
@@ -17,11 +17,26 @@
 #include "sdb.h"
 #include "sync.h"
 #include "tchecksum.h"
+#include "tcompare.h"
 #include "wal.h"
 
-#define SDB_TABLE_SIZE   24
-#define SDB_RESERVE_SIZE 512
-#define SDB_FILE_VER     1
+#define SDB_TABLE_SIZE      24
+#define SDB_RESERVE_SIZE    512
+#define SDB_FILE_VER        1
+#define SDB_HEAD_SIZE       (sizeof(int64_t) * (4 + SDB_TABLE_SIZE * 2) + SDB_RESERVE_SIZE)
+#define SDB_DELTA_PREFIX    "sdb.delta."
+#define SDB_DELTA_MAX_NUM   64
+#define SDB_DELTA_MERGE_NUM 8
+
+// sdb.data holds all the rows at the time it is written, each sdb.delta.<seq> after it only holds the rows changed
+// since the previous checkpoint, both start with the same head
+typedef struct {
+  int64_t applyIndex;
+  int64_t applyTerm;
+  int64_t applyConfig;
+  int64_t maxId[SDB_MAX];
+  int64_t tableVer[SDB_MAX];
+} SSdbFileHead;
 
 static int32_t sdbDeployData(SSdb *pSdb) {
   mInfo("start to deploy sdb");
@@ -41,6 +56,22 @@ static int32_t sdbDeployData(SSdb *pSdb) {
   return 0;
 }
 
+// free the first droppedNum[type] dropped raws of each table, or all of them if droppedNum is NULL
+static void sdbClearDroppedRaws(SSdb *pSdb, const int32_t *droppedNum) {
+  for (int32_t i = 0; i < SDB_MAX; ++i) {
+    SArray *pArray = pSdb->droppedRaws[i];
+    if (pArray == NULL) continue;
+
+    sdbWriteLock(pSdb, i);
+    int32_t num = (droppedNum == NULL) ? taosArrayGetSize(pArray) : droppedNum[i];
+    for (int32_t j = 0; j < num; ++j) {
+      sdbFreeRaw(*(SSdbRaw **)taosArrayGet(pArray, j));
+    }
+    taosArrayPopFrontBatch(pArray, num);
+    sdbUnLock(pSdb, i);
+  }
+}
+
 static void sdbResetData(SSdb *pSdb) {
   mInfo("start to reset sdb");
 
@@ -68,6 +99,7 @@ static void sdbResetData(SSdb *pSdb) {
     mInfo("sdb:%s is reset", sdbTableName(i));
   }
 
+  sdbClearDroppedRaws(pSdb, NULL);
   pSdb->applyIndex = -1;
   pSdb->applyTerm = -1;
   pSdb->applyConfig = -1;
@@ -77,7 +109,31 @@ static void sdbResetData(SSdb *pSdb) {
   mInfo("sdb reset success");
 }
 
-static int32_t sdbReadFileHead(SSdb *pSdb, TdFilePtr pFile) {
+static void sdbGetFileHead(SSdb *pSdb, SSdbFileHead *pHead) {
+  pHead->applyIndex = pSdb->applyIndex;
+  pHead->applyTerm = pSdb->applyTerm;
+  pHead->applyConfig = pSdb->applyConfig;
+  memcpy(pHead->maxId, pSdb->maxId, sizeof(pHead->maxId));
+  memcpy(pHead->tableVer, pSdb->tableVer, sizeof(pHead->tableVer));
+}
+
+static void sdbSetFileHead(SSdb *pSdb, const SSdbFileHead *pHead) {
+  pSdb->applyIndex = pHead->applyIndex;
+  pSdb->applyTerm = pHead->applyTerm;
+  pSdb->applyConfig = pHead->applyConfig;
+  memcpy(pSdb->maxId, pHead->maxId, sizeof(pSdb->maxId));
+  memcpy(pSdb->tableVer, pHead->tableVer, sizeof(pSdb->tableVer));
+}
+
+static void sdbGetDataFile(SSdb *pSdb, char *file, int32_t size) {
+  snprintf(file, size, "%s%ssdb.data", pSdb->currDir, TD_DIRSEP);
+}
+
+static void sdbGetDeltaFile(SSdb *pSdb, int64_t seq, char *file, int32_t size) {
+  snprintf(file, size, "%s%s" SDB_DELTA_PREFIX "%" PRId64, pSdb->currDir, TD_DIRSEP, seq);
+}
+
+static int32_t sdbReadFileHead(SSdbFileHead *pHead, TdFilePtr pFile) {
   int64_t sver = 0;
   int32_t ret = taosReadFile(pFile, &sver, sizeof(int64_t));
   if (ret < 0) {
@@ -93,7 +149,7 @@ static int32_t sdbReadFileHead(SSdb *pSdb, TdFilePtr pFile) {
     return -1;
   }
 
-  ret = taosReadFile(pFile, &pSdb->applyIndex, sizeof(int64_t));
+  ret = taosReadFile(pFile, &pHead->applyIndex, sizeof(int64_t));
   if (ret < 0) {
     terrno = TAOS_SYSTEM_ERROR(errno);
     return -1;
@@ -103,7 +159,7 @@ static int32_t sdbReadFileHead(SSdb *pSdb, TdFilePtr pFile) {
     return -1;
   }
 
-  ret = taosReadFile(pFile, &pSdb->applyTerm, sizeof(int64_t));
+  ret = taosReadFile(pFile, &pHead->applyTerm, sizeof(int64_t));
   if (ret < 0) {
     terrno = TAOS_SYSTEM_ERROR(errno);
     return -1;
@@ -113,7 +169,7 @@ static int32_t sdbReadFileHead(SSdb *pSdb, TdFilePtr pFile) {
     return -1;
   }
 
-  ret = taosReadFile(pFile, &pSdb->applyConfig, sizeof(int64_t));
+  ret = taosReadFile(pFile, &pHead->applyConfig, sizeof(int64_t));
   if (ret < 0) {
     terrno = TAOS_SYSTEM_ERROR(errno);
     return -1;
@@ -135,7 +191,7 @@ static int32_t sdbReadFileHead(SSdb *pSdb, TdFilePtr pFile) {
       return -1;
     }
     if (i < SDB_MAX) {
-      pSdb->maxId[i] = maxId;
+      pHead->maxId[i] = maxId;
     }
   }
 
@@ -151,7 +207,7 @@ static int32_t sdbReadFileHead(SSdb *pSdb, TdFilePtr pFile) {
       return -1;
     }
     if (i < SDB_MAX) {
-      pSdb->tableVer[i] = ver;
+      pHead->tableVer[i] = ver;
     }
   }
 
@@ -169,24 +225,24 @@ static int32_t sdbReadFileHead(SSdb *pSdb, TdFilePtr pFile) {
   return 0;
 }
 
-static int32_t sdbWriteFileHead(SSdb *pSdb, TdFilePtr pFile) {
+static int32_t sdbWriteFileHead(const SSdbFileHead *pHead, TdFilePtr pFile) {
   int64_t sver = SDB_FILE_VER;
   if (taosWriteFile(pFile, &sver, sizeof(int64_t)) != sizeof(int64_t)) {
     terrno = TAOS_SYSTEM_ERROR(errno);
     return -1;
   }
 
-  if (taosWriteFile(pFile, &pSdb->applyIndex, sizeof(int64_t)) != sizeof(int64_t)) {
+  if (taosWriteFile(pFile, &pHead->applyIndex, sizeof(int64_t)) != sizeof(int64_t)) {
     terrno = TAOS_SYSTEM_ERROR(errno);
     return -1;
   }
 
-  if (taosWriteFile(pFile, &pSdb->applyTerm, sizeof(int64_t)) != sizeof(int64_t)) {
+  if (taosWriteFile(pFile, &pHead->applyTerm, sizeof(int64_t)) != sizeof(int64_t)) {
     terrno = TAOS_SYSTEM_ERROR(errno);
     return -1;
   }
 
-  if (taosWriteFile(pFile, &pSdb->applyConfig, sizeof(int64_t)) != sizeof(int64_t)) {
+  if (taosWriteFile(pFile, &pHead->applyConfig, sizeof(int64_t)) != sizeof(int64_t)) {
     terrno = TAOS_SYSTEM_ERROR(errno);
     return -1;
   }
@@ -194,7 +250,7 @@ static int32_t sdbWriteFileHead(SSdb *pSdb, TdFilePtr pFile) {
   for (int32_t i = 0; i < SDB_TABLE_SIZE; ++i) {
     int64_t maxId = 0;
     if (i < SDB_MAX) {
-      maxId = pSdb->maxId[i];
+      maxId = pHead->maxId[i];
     }
     if (taosWriteFile(pFile, &maxId, sizeof(int64_t)) != sizeof(int64_t)) {
       terrno = TAOS_SYSTEM_ERROR(errno);
@@ -205,7 +261,7 @@ static int32_t sdbWriteFileHead(SSdb *pSdb, TdFilePtr pFile) {
   for (int32_t i = 0; i < SDB_TABLE_SIZE; ++i) {
     int64_t ver = 0;
     if (i < SDB_MAX) {
-      ver = pSdb->tableVer[i];
+      ver = pHead->tableVer[i];
     }
     if (taosWriteFile(pFile, &ver, sizeof(int64_t)) != sizeof(int64_t)) {
       terrno = TAOS_SYSTEM_ERROR(errno);
@@ -222,113 +278,253 @@ static int32_t sdbWriteFileHead(SSdb *pSdb, TdFilePtr pFile) {
   return 0;
 }
 
-static int32_t sdbReadFileImp(SSdb *pSdb) {
-  int64_t offset = 0;
-  int32_t code = 0;
-  int32_t readLen = 0;
-  int64_t ret = 0;
-  char    file[PATH_MAX] = {0};
-  int32_t bufLen = TSDB_MAX_MSG_SIZE;
+// read the next raw of the file into *ppRaw, which is enlarged if needed, *pEnd is set at the end of the file
+static int32_t sdbReadFileRaw(TdFilePtr pFile, const char *file, SSdbRaw **ppRaw, int32_t *pBufLen, bool *pEnd) {
+  SSdbRaw *pRaw = *ppRaw;
+  int32_t  code = 0;
+  int32_t  readLen = sizeof(SSdbRaw);
+  int64_t  ret = taosReadFile(pFile, pRaw, readLen);
+  if (ret == 0) {
+    *pEnd = true;
+    return 0;
+  }
 
-  snprintf(file, sizeof(file), "%s%ssdb.data", pSdb->currDir, TD_DIRSEP);
-  mInfo("start to read sdb file:%s", file);
+  if (ret < 0) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    mError("failed to read sdb file:%s since %s", file, tstrerror(code));
+    return code;
+  }
 
-  SSdbRaw *pRaw = taosMemoryMalloc(bufLen + 100);
-  if (pRaw == NULL) {
-    terrno = TSDB_CODE_OUT_OF_MEMORY;
-    mError("failed read sdb file since %s", terrstr());
-    return -1;
+  if (ret != readLen) {
+    code = TSDB_CODE_FILE_CORRUPTED;
+    mError("failed to read sdb file:%s since %s, ret:%" PRId64 " != readLen:%d", file, tstrerror(code), ret, readLen);
+    return code;
   }
 
+  readLen = pRaw->dataLen + sizeof(int32_t);
+  if (readLen >= *pBufLen) {
+    int32_t  bufLen = pRaw->dataLen * 2;
+    SSdbRaw *pNewRaw = taosMemoryMalloc(bufLen + 100);
+    if (pNewRaw == NULL) {
+      mError("failed read sdb file since malloc new sdbRaw size:%d failed", bufLen);
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    mInfo("malloc new sdb raw size:%d, type:%d", bufLen, pRaw->type);
+    memcpy(pNewRaw, pRaw, sizeof(SSdbRaw));
+    sdbFreeRaw(pRaw);
+    pRaw = pNewRaw;
+    *ppRaw = pNewRaw;
+    *pBufLen = bufLen;
+  }
+
+  ret = taosReadFile(pFile, pRaw->pData, readLen);
+  if (ret < 0) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    mError("failed to read sdb file:%s since %s, ret:%" PRId64 " readLen:%d", file, tstrerror(code), ret, readLen);
+    return code;
+  }
+
+  if (ret != readLen) {
+    code = TSDB_CODE_FILE_CORRUPTED;
+    mError("failed to read sdb file:%s since %s, ret:%" PRId64 " != readLen:%d", file, tstrerror(code), ret, readLen);
+    return code;
+  }
+
+  int32_t totalLen = sizeof(SSdbRaw) + pRaw->dataLen + sizeof(int32_t);
+  if ((!taosCheckChecksumWhole((const uint8_t *)pRaw, totalLen)) != 0) {
+    code = TSDB_CODE_CHECKSUM_ERROR;
+    mError("failed to read sdb file:%s since %s, readLen:%d", file, tstrerror(code), readLen);
+    return code;
+  }
+
+  *pEnd = false;
+  return 0;
+}
+
+static int32_t sdbWriteFileRaw(TdFilePtr pFile, SSdbRaw *pRaw) {
+  int32_t writeLen = sizeof(SSdbRaw) + pRaw->dataLen;
+  if (taosWriteFile(pFile, pRaw, writeLen) != writeLen) {
+    return TAOS_SYSTEM_ERROR(errno);
+  }
+
+  int32_t cksum = taosCalcChecksum(0, (const uint8_t *)pRaw, writeLen);
+  if (taosWriteFile(pFile, &cksum, sizeof(int32_t)) != sizeof(int32_t)) {
+    return TAOS_SYSTEM_ERROR(errno);
+  }
+
+  return 0;
+}
+
+static int32_t sdbOpenFileWithHead(const char *file, SSdbFileHead *pHead, TdFilePtr *ppFile) {
   TdFilePtr pFile = taosOpenFile(file, TD_FILE_READ);
   if (pFile == NULL) {
-    taosMemoryFree(pRaw);
     terrno = TAOS_SYSTEM_ERROR(errno);
-    mInfo("read sdb file:%s finished since %s", file, terrstr());
-    return 0;
+    mError("failed to open sdb file:%s since %s", file, terrstr());
+    return terrno;
   }
 
-  if (sdbReadFileHead(pSdb, pFile) != 0) {
+  if (sdbReadFileHead(pHead, pFile) != 0) {
     mError("failed to read sdb file:%s head since %s", file, terrstr());
-    taosMemoryFree(pRaw);
     taosCloseFile(&pFile);
-    return -1;
+    return terrno;
   }
 
-  int64_t tableVer[SDB_MAX] = {0};
-  memcpy(tableVer, pSdb->tableVer, sizeof(tableVer));
+  *ppFile = pFile;
+  return 0;
+}
+
+static int32_t sdbReplayFile(SSdb *pSdb, TdFilePtr pFile, const char *file) {
+  int32_t  code = 0;
+  int32_t  bufLen = TSDB_MAX_MSG_SIZE;
+  SSdbRaw *pRaw = taosMemoryMalloc(bufLen + 100);
+  if (pRaw == NULL) {
+    mError("failed read sdb file since %s", tstrerror(TSDB_CODE_OUT_OF_MEMORY));
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
 
   while (1) {
-    readLen = sizeof(SSdbRaw);
-    ret = taosReadFile(pFile, pRaw, readLen);
-    if (ret == 0) break;
+    bool end = false;
+    code = sdbReadFileRaw(pFile, file, &pRaw, &bufLen, &end);
+    if (code != 0 || end) break;
 
-    if (ret < 0) {
-      code = TAOS_SYSTEM_ERROR(errno);
-      mError("failed to read sdb file:%s since %s", file, tstrerror(code));
-      goto _OVER;
+    code = sdbWriteWithoutFree(pSdb, pRaw);
+    if (code == TSDB_CODE_SDB_OBJ_NOT_THERE && pRaw->status == SDB_STATUS_DROPPED) {
+      // the row is created and dropped after the same checkpoint
+      code = 0;
+      continue;
     }
-
-    if (ret != readLen) {
-      code = TSDB_CODE_FILE_CORRUPTED;
-      mError("failed to read sdb file:%s since %s, ret:%" PRId64 " != readLen:%d", file, tstrerror(code), ret, readLen);
-      goto _OVER;
+    if (code != 0) {
+      mError("failed to read sdb file:%s since %s", file, terrstr());
+      break;
     }
+  }
 
-    readLen = pRaw->dataLen + sizeof(int32_t);
-    if (readLen >= bufLen) {
-      bufLen = pRaw->dataLen * 2;
-      SSdbRaw *pNewRaw = taosMemoryMalloc(bufLen + 100);
-      if (pNewRaw == NULL) {
-        terrno = TSDB_CODE_OUT_OF_MEMORY;
-        mError("failed read sdb file since malloc new sdbRaw size:%d failed", bufLen);
-        goto _OVER;
-      }
-      mInfo("malloc new sdb raw size:%d, type:%d", bufLen, pRaw->type);
-      memcpy(pNewRaw, pRaw, sizeof(SSdbRaw));
-      sdbFreeRaw(pRaw);
-      pRaw = pNewRaw;
-    }
+  sdbFreeRaw(pRaw);
+  return code;
+}
 
-    ret = taosReadFile(pFile, pRaw->pData, readLen);
-    if (ret < 0) {
-      code = TAOS_SYSTEM_ERROR(errno);
-      mError("failed to read sdb file:%s since %s, ret:%" PRId64 " readLen:%d", file, tstrerror(code), ret, readLen);
-      goto _OVER;
+static int32_t sdbListDeltaFiles(SSdb *pSdb, SArray *pSeqs) {
+  TdDirPtr pDir = taosOpenDir(pSdb->currDir);
+  if (pDir == NULL) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    mError("failed to open sdb dir:%s since %s", pSdb->currDir, terrstr());
+    return terrno;
+  }
+
+  int32_t       code = 0;
+  int32_t       prefixLen = strlen(SDB_DELTA_PREFIX);
+  TdDirEntryPtr pEntry = NULL;
+  while ((pEntry = taosReadDir(pDir)) != NULL) {
+    char *name = taosGetDirEntryName(pEntry);
+    if (strncmp(name, SDB_DELTA_PREFIX, prefixLen) != 0) continue;
+
+    int64_t seq = taosStr2Int64(name + prefixLen, NULL, 10);
+    if (seq <= 0) continue;
+
+    if (taosArrayPush(pSeqs, &seq) == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      break;
     }
+  }
 
-    if (ret != readLen) {
-      code = TSDB_CODE_FILE_CORRUPTED;
-      mError("failed to read sdb file:%s since %s, ret:%" PRId64 " != readLen:%d", file, tstrerror(code), ret, readLen);
-      goto _OVER;
+  taosCloseDir(&pDir);
+  taosArraySort(pSeqs, compareInt64Val);
+  return code;
+}
+
+static void sdbRemoveDeltaFiles(SSdb *pSdb, SArray *pSeqs, int32_t num) {
+  char file[PATH_MAX] = {0};
+  for (int32_t i = 0; i < num; ++i) {
+    sdbGetDeltaFile(pSdb, *(int64_t *)taosArrayGet(pSeqs, i), file, sizeof(file));
+    if (taosRemoveFile(file) != 0) {
+      mWarn("failed to remove sdb delta file:%s since %s", file, tstrerror(TAOS_SYSTEM_ERROR(errno)));
     }
+  }
+  taosArrayPopFrontBatch(pSeqs, num);
+}
 
-    int32_t totalLen = sizeof(SSdbRaw) + pRaw->dataLen + sizeof(int32_t);
-    if ((!taosCheckChecksumWhole((const uint8_t *)pRaw, totalLen)) != 0) {
-      code = TSDB_CODE_CHECKSUM_ERROR;
-      mError("failed to read sdb file:%s since %s, readLen:%d", file, tstrerror(code), readLen);
-      goto _OVER;
+static int32_t sdbReadFileImp(SSdb *pSdb) {
+  int32_t      code = 0;
+  char         file[PATH_MAX] = {0};
+  TdFilePtr    pFile = NULL;
+  SSdbFileHead head = {0};
+
+  sdbGetDataFile(pSdb, file, sizeof(file));
+  mInfo("start to read sdb file:%s", file);
+
+  SArray *pSeqs = taosArrayInit(8, sizeof(int64_t));
+  if (pSeqs == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    mError("failed read sdb file since %s", terrstr());
+    return -1;
+  }
+
+  taosArrayClear(pSdb->deltaFiles);
+  pSdb->dataIndex = -1;
+  pSdb->dataGen++;
+  code = sdbListDeltaFiles(pSdb, pSeqs);
+  if (code != 0) goto _OVER;
+
+  if (!taosCheckExistFile(file)) {
+    // delta files can not be replayed without the sdb.data they are based on
+    sdbRemoveDeltaFiles(pSdb, pSeqs, taosArrayGetSize(pSeqs));
+    mInfo("read sdb file:%s finished since it not exist", file);
+    goto _OVER;
+  }
+
+  code = sdbOpenFileWithHead(file, &head, &pFile);
+  if (code != 0) goto _OVER;
+
+  sdbSetFileHead(pSdb, &head);
+  code = sdbReplayFile(pSdb, pFile, file);
+  taosCloseFile(&pFile);
+  if (code != 0) goto _OVER;
+  pSdb->dataIndex = head.applyIndex;
+
+  for (int32_t i = 0; i < taosArrayGetSize(pSeqs); ++i) {
+    int64_t      seq = *(int64_t *)taosArrayGet(pSeqs, i);
+    SSdbFileHead deltaHead = {0};
+    pSdb->deltaSeq = TMAX(pSdb->deltaSeq, seq);
+    sdbGetDeltaFile(pSdb, seq, file, sizeof(file));
+
+    code = sdbOpenFileWithHead(file, &deltaHead, &pFile);
+    if (code != 0) goto _OVER;
+
+    if (deltaHead.applyIndex <= pSdb->applyIndex) {
+      // already merged into sdb.data, the process stopped before it was removed
+      taosCloseFile(&pFile);
+      (void)taosRemoveFile(file);
+      mInfo("sdb delta file:%s is removed, apply index:%" PRId64, file, deltaHead.applyIndex);
+      continue;
     }
 
-    code = sdbWriteWithoutFree(pSdb, pRaw);
-    if (code != 0) {
-      mError("failed to read sdb file:%s since %s", file, terrstr());
+    head = deltaHead;
+    sdbSetFileHead(pSdb, &head);
+    code = sdbReplayFile(pSdb, pFile, file);
+    taosCloseFile(&pFile);
+    if (code != 0) goto _OVER;
+
+    if (taosArrayPush(pSdb->deltaFiles, &seq) == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
       goto _OVER;
     }
   }
 
-  code = 0;
   pSdb->commitIndex = pSdb->applyIndex;
   pSdb->commitTerm = pSdb->applyTerm;
   pSdb->commitConfig = pSdb->applyConfig;
-  memcpy(pSdb->tableVer, tableVer, sizeof(tableVer));
-  mInfo("read sdb file:%s success, commit index:%" PRId64 " term:%" PRId64 " config:%" PRId64, file, pSdb->commitIndex,
-        pSdb->commitTerm, pSdb->commitConfig);
+  memcpy(pSdb->tableVer, head.tableVer, sizeof(pSdb->tableVer));
+  sdbClearDroppedRaws(pSdb, NULL);
+  pSdb->ckptRowVer = atomic_load_64(&pSdb->rowVer);
+  mInfo("read sdb file success, delta files:%d, commit index:%" PRId64 " term:%" PRId64 " config:%" PRId64,
+        (int32_t)taosArrayGetSize(pSdb->deltaFiles), pSdb->commitIndex, pSdb->commitTerm, pSdb->commitConfig);
 
 _OVER:
-  taosCloseFile(&pFile);
-  sdbFreeRaw(pRaw);
-
+  if (code != 0) {
+    taosArrayClear(pSdb->deltaFiles);
+    pSdb->dataIndex = -1;
+  }
+  taosArrayDestroy(pSeqs);
   terrno = code;
   return code;
 }
@@ -347,33 +543,11 @@ int32_t sdbReadFile(SSdb *pSdb) {
   return code;
 }
 
-static int32_t sdbWriteFileImp(SSdb *pSdb) {
+// write the dropped raws and the rows changed after ckptRowVer, or all the rows if it is a full write
+static int32_t sdbWriteRows(SSdb *pSdb, TdFilePtr pFile, bool isDelta, int32_t *droppedNum) {
   int32_t code = 0;
 
-  char tmpfile[PATH_MAX] = {0};
-  snprintf(tmpfile, sizeof(tmpfile), "%s%ssdb.data", pSdb->tmpDir, TD_DIRSEP);
-  char curfile[PATH_MAX] = {0};
-  snprintf(curfile, sizeof(curfile), "%s%ssdb.data", pSdb->currDir, TD_DIRSEP);
-
-  mInfo("start to write sdb file, apply index:%" PRId64 " term:%" PRId64 " config:%" PRId64 ", commit index:%" PRId64
-        " term:%" PRId64 " config:%" PRId64 ", file:%s",
-        pSdb->applyIndex, pSdb->applyTerm, pSdb->applyConfig, pSdb->commitIndex, pSdb->commitTerm, pSdb->commitConfig,
-        curfile);
-
-  TdFilePtr pFile = taosOpenFile(tmpfile, TD_FILE_CREATE | TD_FILE_WRITE | TD_FILE_TRUNC);
-  if (pFile == NULL) {
-    terrno = TAOS_SYSTEM_ERROR(errno);
-    mError("failed to open sdb file:%s for write since %s", tmpfile, terrstr());
-    return -1;
-  }
-
-  if (sdbWriteFileHead(pSdb, pFile) != 0) {
-    mError("failed to write sdb file:%s head since %s", tmpfile, terrstr());
-    taosCloseFile(&pFile);
-    return -1;
-  }
-
-  for (int32_t i = SDB_MAX - 1; i >= 0; --i) {
+  for (int32_t i = SDB_MAX - 1; i >= 0 && code == 0; --i) {
     SdbEncodeFp encodeFp = pSdb->encodeFps[i];
     if (encodeFp == NULL) continue;
 
@@ -382,15 +556,22 @@ static int32_t sdbWriteFileImp(SSdb *pSdb) {
     SHashObj *hash = pSdb->hashObjs[i];
     sdbWriteLock(pSdb, i);
 
+    SArray *pDropped = pSdb->droppedRaws[i];
+    droppedNum[i] = taosArrayGetSize(pDropped);
+    for (int32_t j = 0; isDelta && j < droppedNum[i] && code == 0; ++j) {
+      code = sdbWriteFileRaw(pFile, *(SSdbRaw **)taosArrayGet(pDropped, j));
+    }
+
     SSdbRow **ppRow = taosHashIterate(hash, NULL);
-    while (ppRow != NULL) {
+    while (ppRow != NULL && code == 0) {
       SSdbRow *pRow = *ppRow;
-      if (pRow == NULL) {
+      if (pRow == NULL || (isDelta && pRow->ver <= pSdb->ckptRowVer)) {
         ppRow = taosHashIterate(hash, ppRow);
         continue;
       }
 
-      if (pRow->status != SDB_STATUS_READY && pRow->status != SDB_STATUS_DROPPING) {
+      bool written = (pRow->status == SDB_STATUS_READY || pRow->status == SDB_STATUS_DROPPING);
+      if (!written && !isDelta) {
         sdbPrintOper(pSdb, pRow, "not-write");
         ppRow = taosHashIterate(hash, ppRow);
         continue;
@@ -400,34 +581,63 @@ static int32_t sdbWriteFileImp(SSdb *pSdb) {
 
       SSdbRaw *pRaw = (*encodeFp)(pRow->pObj);
       if (pRaw != NULL) {
-        pRaw->status = pRow->status;
-        int32_t writeLen = sizeof(SSdbRaw) + pRaw->dataLen;
-        if (taosWriteFile(pFile, pRaw, writeLen) != writeLen) {
-          code = TAOS_SYSTEM_ERROR(errno);
-          taosHashCancelIterate(hash, ppRow);
-          sdbFreeRaw(pRaw);
-          break;
-        }
-
-        int32_t cksum = taosCalcChecksum(0, (const uint8_t *)pRaw, sizeof(SSdbRaw) + pRaw->dataLen);
-        if (taosWriteFile(pFile, &cksum, sizeof(int32_t)) != sizeof(int32_t)) {
-          code = TAOS_SYSTEM_ERROR(errno);
-          taosHashCancelIterate(hash, ppRow);
-          sdbFreeRaw(pRaw);
-          break;
-        }
+        // a row that is not in sdb.data must not survive the replay of the delta file either
+        pRaw->status = written ? pRow->status : SDB_STATUS_DROPPED;
+        code = sdbWriteFileRaw(pFile, pRaw);
+        sdbFreeRaw(pRaw);
       } else {
         code = TSDB_CODE_APP_ERROR;
+      }
+
+      if (code != 0) {
         taosHashCancelIterate(hash, ppRow);
         break;
       }
-
-      sdbFreeRaw(pRaw);
       ppRow = taosHashIterate(hash, ppRow);
     }
     sdbUnLock(pSdb, i);
   }
 
+  return code;
+}
+
+static int32_t sdbWriteFileImp(SSdb *pSdb, bool isDelta) {
+  int32_t      code = 0;
+  int64_t      seq = pSdb->deltaSeq + 1;
+  int64_t      rowVer = atomic_load_64(&pSdb->rowVer);
+  int32_t      droppedNum[SDB_MAX] = {0};
+  SSdbFileHead head = {0};
+
+  char tmpfile[PATH_MAX] = {0};
+  snprintf(tmpfile, sizeof(tmpfile), "%s%s%s", pSdb->tmpDir, TD_DIRSEP, isDelta ? "sdb.delta" : "sdb.data");
+  char curfile[PATH_MAX] = {0};
+  if (isDelta) {
+    sdbGetDeltaFile(pSdb, seq, curfile, sizeof(curfile));
+  } else {
+    sdbGetDataFile(pSdb, curfile, sizeof(curfile));
+  }
+
+  mInfo("start to write sdb file, apply index:%" PRId64 " term:%" PRId64 " config:%" PRId64 ", commit index:%" PRId64
+        " term:%" PRId64 " config:%" PRId64 ", file:%s",
+        pSdb->applyIndex, pSdb->applyTerm, pSdb->applyConfig, pSdb->commitIndex, pSdb->commitTerm, pSdb->commitConfig,
+        curfile);
+
+  TdFilePtr pFile = taosOpenFile(tmpfile, TD_FILE_CREATE | TD_FILE_WRITE | TD_FILE_TRUNC);
+  if (pFile == NULL) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    mError("failed to open sdb file:%s for write since %s", tmpfile, terrstr());
+    return -1;
+  }
+
+  sdbGetFileHead(pSdb, &head);
+  if (sdbWriteFileHead(&head, pFile) != 0) {
+    mError("failed to write sdb file:%s head since %s", tmpfile, terrstr());
+    taosCloseFile(&pFile);
+    return -1;
+  }
+
+  code = sdbWriteRows(pSdb, pFile, isDelta, droppedNum);
+
   if (code == 0) {
     code = taosFsyncFile(pFile);
     if (code != 0) {
@@ -448,16 +658,34 @@ static int32_t sdbWriteFileImp(SSdb *pSdb) {
 
   if (code != 0) {
     mError("failed to write sdb file:%s since %s", curfile, tstrerror(code));
+    terrno = code;
+    return code;
+  }
+
+  // the rows dropped or changed while the file was written are left for the next delta file
+  sdbClearDroppedRaws(pSdb, droppedNum);
+  pSdb->ckptRowVer = rowVer;
+
+  if (isDelta) {
+    pSdb->deltaSeq = seq;
+    if (taosArrayPush(pSdb->deltaFiles, &seq) == NULL) {
+      // not replayed by snapshot read, the next checkpoint writes sdb.data and removes it
+      pSdb->dataIndex = -1;
+    }
   } else {
-    pSdb->commitIndex = pSdb->applyIndex;
-    pSdb->commitTerm = pSdb->applyTerm;
-    pSdb->commitConfig = pSdb->applyConfig;
-    mInfo("write sdb file success, commit index:%" PRId64 " term:%" PRId64 " config:%" PRId64 " file:%s",
-          pSdb->commitIndex, pSdb->commitTerm, pSdb->commitConfig, curfile);
+    sdbRemoveDeltaFiles(pSdb, pSdb->deltaFiles, taosArrayGetSize(pSdb->deltaFiles));
+    pSdb->dataIndex = head.applyIndex;
+    pSdb->dataGen++;
   }
 
-  terrno = code;
-  return code;
+  pSdb->commitIndex = pSdb->applyIndex;
+  pSdb->commitTerm = pSdb->applyTerm;
+  pSdb->commitConfig = pSdb->applyConfig;
+  mInfo("write sdb file success, commit index:%" PRId64 " term:%" PRId64 " config:%" PRId64 " file:%s",
+        pSdb->commitIndex, pSdb->commitTerm, pSdb->commitConfig, curfile);
+
+  terrno = 0;
+  return 0;
 }
 
 int32_t sdbWriteFile(SSdb *pSdb, int32_t delta) {
@@ -477,7 +705,12 @@ int32_t sdbWriteFile(SSdb *pSdb, int32_t delta) {
     }
   }
   if (code == 0) {
-    code = sdbWriteFileImp(pSdb);
+    if (atomic_val_compare_exchange_8(&pSdb->dropLost, 1, 0) == 1) {
+      pSdb->dataIndex = -1;
+    }
+    // only the changed rows are written until there are too many delta files for the merge to catch up
+    bool isDelta = pSdb->dataIndex >= 0 && taosArrayGetSize(pSdb->deltaFiles) < SDB_DELTA_MAX_NUM;
+    code = sdbWriteFileImp(pSdb, isDelta);
   }
   if (code == 0) {
     if (pSdb->pWal != NULL) {
@@ -493,6 +726,197 @@ int32_t sdbWriteFile(SSdb *pSdb, int32_t delta) {
   return code;
 }
 
+// load the raws of the file into the hash of its table, keyed by the row key, so the last change of a row wins
+static int32_t sdbLoadFileRaws(SSdb *pSdb, const char *file, SHashObj **hashes, SSdbFileHead *pHead) {
+  TdFilePtr pFile = NULL;
+  int32_t   code = sdbOpenFileWithHead(file, pHead, &pFile);
+  if (code != 0) return code;
+
+  int32_t  bufLen = TSDB_MAX_MSG_SIZE;
+  SSdbRaw *pRaw = taosMemoryMalloc(bufLen + 100);
+  if (pRaw == NULL) {
+    taosCloseFile(&pFile);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  while (1) {
+    bool end = false;
+    code = sdbReadFileRaw(pFile, file, &pRaw, &bufLen, &end);
+    if (code != 0 || end) break;
+
+    if (pRaw->type < 0 || pRaw->type >= SDB_MAX || hashes[pRaw->type] == NULL) {
+      code = TSDB_CODE_FILE_CORRUPTED;
+      mError("failed to merge sdb file:%s since invalid type:%d", file, pRaw->type);
+      break;
+    }
+
+    SSdbRow *pRow = (*pSdb->decodeFps[pRaw->type])(pRaw);
+    if (pRow == NULL) {
+      code = terrno;
+      mError("failed to merge sdb file:%s since %s", file, tstrerror(code));
+      break;
+    }
+    pRow->type = pRaw->type;
+
+    SHashObj *hash = hashes[pRaw->type];
+    int32_t   keySize = sdbGetkeySize(pSdb, pRow->type, pRow->pObj);
+    SSdbRaw **ppOld = taosHashGet(hash, pRow->pObj, keySize);
+    if (ppOld != NULL) {
+      sdbFreeRaw(*ppOld);
+      taosHashRemove(hash, pRow->pObj, keySize);
+    }
+
+    if (pRaw->status != SDB_STATUS_DROPPED) {
+      int32_t  size = sizeof(SSdbRaw) + pRaw->dataLen;
+      SSdbRaw *pCopy = taosMemoryMalloc(size);
+      if (pCopy != NULL) {
+        memcpy(pCopy, pRaw, size);
+      }
+      if (pCopy == NULL || taosHashPut(hash, pRow->pObj, keySize, &pCopy, sizeof(void *)) != 0) {
+        taosMemoryFree(pCopy);
+        code = TSDB_CODE_OUT_OF_MEMORY;
+      }
+    }
+
+    sdbFreeRow(pSdb, pRow, false);
+    if (code != 0) break;
+  }
+
+  sdbFreeRaw(pRaw);
+  taosCloseFile(&pFile);
+  return code;
+}
+
+static int32_t sdbMergeFileImp(SSdb *pSdb, SArray *pSeqs, const char *tmpfile, SSdbFileHead *pHead) {
+  int32_t   code = 0;
+  char      file[PATH_MAX] = {0};
+  SHashObj *hashes[SDB_MAX] = {0};
+  TdFilePtr pFile = NULL;
+
+  for (int32_t i = 0; i < SDB_MAX; ++i) {
+    if (pSdb->encodeFps[i] == NULL || pSdb->decodeFps[i] == NULL) continue;
+    hashes[i] = taosHashInit(64, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), true, HASH_NO_LOCK);
+    if (hashes[i] == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _OVER;
+    }
+  }
+
+  sdbGetDataFile(pSdb, file, sizeof(file));
+  code = sdbLoadFileRaws(pSdb, file, hashes, pHead);
+  if (code != 0) goto _OVER;
+
+  for (int32_t i = 0; i < taosArrayGetSize(pSeqs); ++i) {
+    sdbGetDeltaFile(pSdb, *(int64_t *)taosArrayGet(pSeqs, i), file, sizeof(file));
+    code = sdbLoadFileRaws(pSdb, file, hashes, pHead);
+    if (code != 0) goto _OVER;
+  }
+
+  pFile = taosOpenFile(tmpfile, TD_FILE_CREATE | TD_FILE_WRITE | TD_FILE_TRUNC);
+  if (pFile == NULL) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    mError("failed to open sdb file:%s for write since %s", tmpfile, tstrerror(code));
+    goto _OVER;
+  }
+
+  if (sdbWriteFileHead(pHead, pFile) != 0) {
+    code = terrno;
+    goto _OVER;
+  }
+
+  for (int32_t i = SDB_MAX - 1; i >= 0 && code == 0; --i) {
+    if (hashes[i] == NULL) continue;
+
+    SSdbRaw **ppRaw = taosHashIterate(hashes[i], NULL);
+    while (ppRaw != NULL) {
+      code = sdbWriteFileRaw(pFile, *ppRaw);
+      if (code != 0) {
+        taosHashCancelIterate(hashes[i], ppRaw);
+        break;
+      }
+      ppRaw = taosHashIterate(hashes[i], ppRaw);
+    }
+  }
+
+  if (code == 0 && taosFsyncFile(pFile) != 0) {
+    code = TAOS_SYSTEM_ERROR(errno);
+  }
+
+_OVER:
+  if (pFile != NULL) {
+    taosCloseFile(&pFile);
+  }
+
+  for (int32_t i = 0; i < SDB_MAX; ++i) {
+    if (hashes[i] == NULL) continue;
+
+    SSdbRaw **ppRaw = taosHashIterate(hashes[i], NULL);
+    while (ppRaw != NULL) {
+      sdbFreeRaw(*ppRaw);
+      ppRaw = taosHashIterate(hashes[i], ppRaw);
+    }
+    taosHashCleanup(hashes[i]);
+  }
+
+  return code;
+}
+
+int32_t sdbMergeFile(SSdb *pSdb) {
+  taosThreadMutexLock(&pSdb->filelock);
+  int32_t num = taosArrayGetSize(pSdb->deltaFiles);
+  if (pSdb->merging || pSdb->dataIndex < 0 || num < SDB_DELTA_MERGE_NUM) {
+    taosThreadMutexUnlock(&pSdb->filelock);
+    return 0;
+  }
+
+  SArray *pSeqs = taosArrayDup(pSdb->deltaFiles, NULL);
+  int32_t dataGen = pSdb->dataGen;
+  if (pSeqs == NULL) {
+    taosThreadMutexUnlock(&pSdb->filelock);
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+  pSdb->merging = 1;
+  taosThreadMutexUnlock(&pSdb->filelock);
+
+  // the files are immutable once written, merge them without blocking the checkpoints
+  char tmpfile[PATH_MAX] = {0};
+  snprintf(tmpfile, sizeof(tmpfile), "%s%ssdb.data.merge", pSdb->tmpDir, TD_DIRSEP);
+  mInfo("start to merge %d sdb delta files into sdb.data", num);
+
+  SSdbFileHead head = {0};
+  int32_t      code = sdbMergeFileImp(pSdb, pSeqs, tmpfile, &head);
+
+  taosThreadMutexLock(&pSdb->filelock);
+  if (code == 0 && dataGen != pSdb->dataGen) {
+    mInfo("sdb.data is replaced while merging, discard the merged file");
+  } else if (code == 0) {
+    char curfile[PATH_MAX] = {0};
+    sdbGetDataFile(pSdb, curfile, sizeof(curfile));
+    if (taosRenameFile(tmpfile, curfile) != 0) {
+      code = TAOS_SYSTEM_ERROR(errno);
+    } else {
+      sdbRemoveDeltaFiles(pSdb, pSdb->deltaFiles, num);
+      pSdb->dataIndex = head.applyIndex;
+      pSdb->dataGen++;
+      mInfo("merge sdb delta files success, apply index:%" PRId64 ", left delta files:%d", head.applyIndex,
+            (int32_t)taosArrayGetSize(pSdb->deltaFiles));
+    }
+  }
+  pSdb->merging = 0;
+  taosThreadMutexUnlock(&pSdb->filelock);
+
+  (void)taosRemoveFile(tmpfile);
+  taosArrayDestroy(pSeqs);
+
+  if (code != 0) {
+    mError("failed to merge sdb delta files since %s", tstrerror(code));
+    terrno = code;
+    return -1;
+  }
+  return 0;
+}
+
 int32_t sdbDeploy(SSdb *pSdb) {
   if (sdbDeployData(pSdb) != 0) {
     return -1;
@@ -542,20 +966,41 @@ static void sdbCloseIter(SSdbIter *pIter) {
   taosMemoryFree(pIter);
 }
 
+// the snapshot is a plain sdb.data: with delta files, they are folded into it like sdbMergeFile does, so that followers
+// never see the drop records of the delta files, which the versions without delta files fail to replay
+static int32_t sdbCopyDataFiles(SSdb *pSdb, const char *dst) {
+  char datafile[PATH_MAX] = {0};
+  sdbGetDataFile(pSdb, datafile, sizeof(datafile));
+  if (taosArrayGetSize(pSdb->deltaFiles) == 0) {
+    if (taosCopyFile(datafile, dst) < 0) {
+      terrno = TAOS_SYSTEM_ERROR(errno);
+      return -1;
+    }
+    return 0;
+  }
+
+  SSdbFileHead head = {0};
+  int32_t      code = sdbMergeFileImp(pSdb, pSdb->deltaFiles, dst, &head);
+  if (code != 0) {
+    terrno = code;
+    return -1;
+  }
+  return 0;
+}
+
 int32_t sdbStartRead(SSdb *pSdb, SSdbIter **ppIter, int64_t *index, int64_t *term, int64_t *config) {
   SSdbIter *pIter = sdbCreateIter(pSdb);
   if (pIter == NULL) return -1;
 
   char datafile[PATH_MAX] = {0};
-  snprintf(datafile, sizeof(datafile), "%s%ssdb.data", pSdb->currDir, TD_DIRSEP);
+  sdbGetDataFile(pSdb, datafile, sizeof(datafile));
 
   taosThreadMutexLock(&pSdb->filelock);
   int64_t commitIndex = pSdb->commitIndex;
   int64_t commitTerm = pSdb->commitTerm;
   int64_t commitConfig = pSdb->commitConfig;
-  if (taosCopyFile(datafile, pIter->name) < 0) {
+  if (sdbCopyDataFiles(pSdb, pIter->name) < 0) {
     taosThreadMutexUnlock(&pSdb->filelock);
-    terrno = TAOS_SYSTEM_ERROR(errno);
     mError("failed to copy sdb file %s to %s since %s", datafile, pIter->name, terrstr());
     sdbCloseIter(pIter);
     return -1;
@@ -649,12 +1094,20 @@ int32_t sdbStopWrite(SSdb *pSdb, SSdbIter *pIter, bool isApply, int64_t index, i
   pIter->file = NULL;
 
   char datafile[PATH_MAX] = {0};
-  snprintf(datafile, sizeof(datafile), "%s%ssdb.data", pSdb->currDir, TD_DIRSEP);
+  sdbGetDataFile(pSdb, datafile, sizeof(datafile));
+
+  // the delta files are based on the replaced sdb.data
+  taosThreadMutexLock(&pSdb->filelock);
+  sdbRemoveDeltaFiles(pSdb, pSdb->deltaFiles, taosArrayGetSize(pSdb->deltaFiles));
+  pSdb->dataIndex = -1;
+  pSdb->dataGen++;
   if (taosRenameFile(pIter->name, datafile) != 0) {
+    taosThreadMutexUnlock(&pSdb->filelock);
     terrno = TAOS_SYSTEM_ERROR(errno);
     mError("sdbiter:%p, failed to rename file %s to %s since %s", pIter, pIter->name, datafile, terrstr());
     goto _OVER;
   }
+  taosThreadMutexUnlock(&pSdb->filelock);
 
   if (sdbReadFile(pSdb) != 0) {
     mError("sdbiter:%p, failed to read from %s since %s", pIter, datafile, terrstr());
@@ -119,7 +119,7 @@ static SHashObj *sdbGetHash(SSdb *pSdb, int32_t type) {
   return hash;
 }
 
-static int32_t sdbGetkeySize(SSdb *pSdb, ESdbType type, const void *pKey) {
+int32_t sdbGetkeySize(SSdb *pSdb, ESdbType type, const void *pKey) {
   int32_t  keySize = 0;
   EKeyType keyType = pSdb->keyTypes[type];
 
@@ -148,6 +148,7 @@ static int32_t sdbInsertRow(SSdb *pSdb, SHashObj *hash, SSdbRaw *pRaw, SSdbRow *
 
   pRow->refCount = 0;
   pRow->status = pRaw->status;
+  pRow->ver = atomic_add_fetch_64(&pSdb->rowVer, 1);
   sdbPrintOper(pSdb, pRow, "insert");
 
   if (taosHashPut(hash, pRow->pObj, keySize, &pRow, sizeof(void *)) != 0) {
@@ -197,6 +198,7 @@ static int32_t sdbUpdateRow(SSdb *pSdb, SHashObj *hash, SSdbRaw *pRaw, SSdbRow *
 
   SSdbRow *pOldRow = *ppOldRow;
   pOldRow->status = pRaw->status;
+  pOldRow->ver = atomic_add_fetch_64(&pSdb->rowVer, 1);
   sdbPrintOper(pSdb, pOldRow, "update");
 
   int32_t     code = 0;
@@ -213,6 +215,27 @@ static int32_t sdbUpdateRow(SSdb *pSdb, SHashObj *hash, SSdbRaw *pRaw, SSdbRow *
   return code;
 }
 
+// the row is gone from the hash after it is dropped, keep its raw so that the next delta file can replay the drop
+static void sdbRecordDroppedRaw(SSdb *pSdb, SSdbRaw *pRaw) {
+  SArray *pArray = pSdb->droppedRaws[pRaw->type];
+  if (pArray == NULL) {
+    pArray = taosArrayInit(4, sizeof(void *));
+    pSdb->droppedRaws[pRaw->type] = pArray;
+  }
+
+  int32_t  size = sizeof(SSdbRaw) + pRaw->dataLen;
+  SSdbRaw *pCopy = taosMemoryMalloc(size);
+  if (pArray != NULL && pCopy != NULL) {
+    memcpy(pCopy, pRaw, size);
+    if (taosArrayPush(pArray, &pCopy) != NULL) return;
+  }
+
+  // the drop can not be replayed from a delta file, the next checkpoint falls back to a full write. dataIndex is only
+  // changed under the file lock, which must not be taken while the table lock is held
+  taosMemoryFree(pCopy);
+  atomic_store_8(&pSdb->dropLost, 1);
+}
+
 static int32_t sdbDeleteRow(SSdb *pSdb, SHashObj *hash, SSdbRaw *pRaw, SSdbRow *pRow, int32_t keySize) {
   int32_t type = pRow->type;
   sdbWriteLock(pSdb, type);
@@ -226,6 +249,8 @@ static int32_t sdbDeleteRow(SSdb *pSdb, SHashObj *hash, SSdbRaw *pRaw, SSdbRow *
   }
   SSdbRow *pOldRow = *ppOldRow;
   pOldRow->status = pRaw->status;
+  pOldRow->ver = atomic_add_fetch_64(&pSdb->rowVer, 1);
+  sdbRecordDroppedRaw(pSdb, pRaw);
 
   atomic_add_fetch_32(&pOldRow->refCount, 1);
   sdbPrintOper(pSdb, pOldRow, "delete");
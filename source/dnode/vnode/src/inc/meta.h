@@ -24,9 +24,10 @@
 extern "C" {
 #endif
 
-typedef struct SMetaIdx   SMetaIdx;
-typedef struct SMetaDB    SMetaDB;
-typedef struct SMetaCache SMetaCache;
+typedef struct SMetaIdx      SMetaIdx;
+typedef struct SMetaDB       SMetaDB;
+typedef struct SMetaCache    SMetaCache;
+typedef struct SMetaTagStore SMetaTagStore;
 
 // metaDebug ==================
 // clang-format off
@@ -74,6 +75,13 @@ int32_t metaStatsCacheGet(SMeta* pMeta, int64_t uid, SMetaStbStats* pInfo);
 void    metaUpdateStbStats(SMeta* pMeta, int64_t uid, int64_t deltaCtb, int32_t deltaCol);
 int32_t metaUidFilterCacheGet(SMeta* pMeta, uint64_t suid, const void* pKey, int32_t keyLen, LRUHandle** pHandle);
 
+// metaTagStore ==================
+int32_t metaTagStoreOpen(SMeta* pMeta);
+void    metaTagStoreClose(SMeta* pMeta);
+void    metaTagStoreUpsert(SMeta* pMeta, tb_uid_t suid, tb_uid_t uid, const STag* pTag);
+void    metaTagStoreDelete(SMeta* pMeta, tb_uid_t suid, tb_uid_t uid);
+void    metaTagStoreDrop(SMeta* pMeta, tb_uid_t suid);
+
 struct SMeta {
   TdThreadRwlock lock;
 
@@ -103,7 +111,8 @@ struct SMeta {
 
   SMetaIdx* pIdx;
 
-  SMetaCache* pCache;
+  SMetaCache*    pCache;
+  SMetaTagStore* pTagStore;
 };
 
 typedef struct {
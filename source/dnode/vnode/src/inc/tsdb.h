@@ -81,6 +81,8 @@ typedef struct STsdbFilterInfo  STsdbFilterInfo;
 #define TSDB_FILE_DLMT ((uint32_t)0xF00AFA0F)
 #define TSDB_FHDR_SIZE 512
 
+#define TSDB_SHARED_BLOCK_LOCKS 32
+
 #define VERSION_MIN 0
 #define VERSION_MAX INT64_MAX
 
@@ -171,6 +173,8 @@ int32_t tBlockDataUpdateRow(SBlockData *pBlockData, TSDBROW *pRow, STSchema *pTS
 int32_t tBlockDataTryUpsertRow(SBlockData *pBlockData, TSDBROW *pRow, int64_t uid);
 int32_t tBlockDataUpsertRow(SBlockData *pBlockData, TSDBROW *pRow, STSchema *pTSchema, int64_t uid);
 void    tBlockDataClear(SBlockData *pBlockData);
+int32_t tBlockDataCopy(SBlockData *pBlockDataFrom, SBlockData *pBlockDataTo);
+int64_t tBlockDataSize(SBlockData *pBlockData);
 void    tBlockDataGetColData(SBlockData *pBlockData, int16_t cid, SColData **ppColData);
 int32_t tCmprBlockData(SBlockData *pBlockData, int8_t cmprAlg, uint8_t **ppOut, int32_t *szOut, uint8_t *aBuf[],
                        int32_t aBufN[]);
@@ -205,6 +209,7 @@ int32_t tsdbFidLevel(int32_t fid, STsdbKeepCfg *pKeepCfg, int64_t nowSec);
 int32_t tsdbBuildDeleteSkyline(SArray *aDelData, int32_t sidx, int32_t eidx, SArray *aSkyline);
 int32_t tPutColumnDataAgg(uint8_t *p, SColumnDataAgg *pColAgg);
 int32_t tGetColumnDataAgg(uint8_t *p, SColumnDataAgg *pColAgg);
+void    tColDataCalcZoneMap(SColData *pColData, int32_t segRows, SColumnDataAgg *aSeg);
 int32_t tsdbCmprData(uint8_t *pIn, int32_t szIn, int8_t type, int8_t cmprAlg, uint8_t **ppOut, int32_t nOut,
                      int32_t *szOut, uint8_t **ppBuf);
 int32_t tsdbDecmprData(uint8_t *pIn, int32_t szIn, int8_t type, int8_t cmprAlg, uint8_t **ppOut, int32_t szOut,
@@ -381,6 +386,11 @@ struct STsdb {
   TdThreadMutex        biMutex;
   SLRUCache           *bCache;
   TdThreadMutex        bMutex;
+  SLRUCache           *sbCache;  // decoded data blocks shared by concurrent readers
+  TdThreadMutex        sbMutex[TSDB_SHARED_BLOCK_LOCKS];
+  TdThreadCond         sbCond[TSDB_SHARED_BLOCK_LOCKS];  // signaled when a block being loaded is published
+  SHashObj            *sbLoading;                        // keys of the blocks being loaded by some reader
+  int32_t              numOfReaders;  // open readers, the shared block cache is bypassed while there is only one
   struct STFileSystem *pFS;  // new
   SRocksCache          rCache;
 };
@@ -874,6 +884,12 @@ int32_t tsdbBICacheRelease(SLRUCache *pCache, LRUHandle *h);
 int32_t tsdbCacheGetBlockS3(SLRUCache *pCache, STsdbFD *pFD, LRUHandle **handle);
 int32_t tsdbBCacheRelease(SLRUCache *pCache, LRUHandle *h);
 
+int32_t tsdbOpenSBCache(STsdb *pTsdb);
+void    tsdbCloseSBCache(STsdb *pTsdb);
+bool    tsdbSharedBlockEnabled(STsdb *pTsdb);
+int32_t tsdbSharedBlockGet(STsdb *pTsdb, const void *key, int32_t klen, SBlockData *bData,
+                           int32_t (*fp)(void *param, SBlockData *bData), void *param);
+
 int32_t tsdbCacheDeleteLastrow(SLRUCache *pCache, tb_uid_t uid, TSKEY eKey);
 int32_t tsdbCacheDeleteLast(SLRUCache *pCache, tb_uid_t uid, TSKEY eKey);
 int32_t tsdbCacheDelete(SLRUCache *pCache, tb_uid_t uid, TSKEY eKey);
@@ -36,6 +36,7 @@
 #include "tlockfree.h"
 #include "tlosertree.h"
 #include "tlrucache.h"
+#include "tmetrics.h"
 #include "tmsgcb.h"
 #include "trbtree.h"
 #include "tref.h"
@@ -58,6 +59,7 @@ typedef struct STsdb              STsdb;
 typedef struct STQ                STQ;
 typedef struct SVState            SVState;
 typedef struct SVStatis           SVStatis;
+typedef struct SVMetrics          SVMetrics;
 typedef struct SVBufPool          SVBufPool;
 typedef struct SQueueWorker       SQHandle;
 typedef struct STsdbKeepCfg       STsdbKeepCfg;
@@ -165,6 +167,7 @@ int             metaGetTableEntryByName(SMetaReader* pReader, const char* name);
 int             metaAlterCache(SMeta* pMeta, int32_t nPage);
 
 int32_t metaUidCacheClear(SMeta* pMeta, uint64_t suid);
+int32_t metaUidCacheUpdate(SMeta* pMeta, uint64_t suid, tb_uid_t uid, bool dropped);
 int32_t metaTbGroupCacheClear(SMeta* pMeta, uint64_t suid);
 
 int metaAddIndexToSTable(SMeta* pMeta, int64_t version, SVCreateStbReq* pReq);
@@ -391,6 +394,13 @@ struct SVStatis {
   int64_t nBatchInsertSuccess;  // delta
 };
 
+struct SVMetrics {
+  SMetric* pInsertUs;     // memtable insert of one table
+  SMetric* pCommitUs;     // whole commit, including the tsdb flush
+  SMetric* pMergeUs;      // tsdb file merge
+  SMetric* pBlockReadUs;  // read and decompress one data block
+};
+
 struct SVnodeInfo {
   SVnodeCfg config;
   SVState   state;
@@ -424,6 +434,7 @@ struct SVnode {
   SVnodeCfg config;
   SVState   state;
   SVStatis  statis;
+  SVMetrics metrics;
   STfs*     pTfs;
   int32_t   diskPrimary;
   SMsgCb    msgCb;
@@ -21,9 +21,12 @@ extern const int   tkLogStbNum;
 extern const int   tkAuditStbNum;
 #endif
 
-#define TAG_FILTER_RES_KEY_LEN  32
-#define META_CACHE_BASE_BUCKET  1024
-#define META_CACHE_STATS_BUCKET 16
+#define TAG_FILTER_RES_KEY_LEN      32
+#define TAG_FILTER_MAX_CHANGES      4096
+#define TAG_FILTER_CACHE_FILE       "tagFilterCache"
+#define TAG_FILTER_CACHE_FILE_VER   1
+#define META_CACHE_BASE_BUCKET      1024
+#define META_CACHE_STATS_BUCKET     16
 
 // (uid , suid) : child table
 // (uid,     0) : normal table
@@ -40,10 +43,24 @@ typedef struct SMetaStbStatsEntry {
 } SMetaStbStatsEntry;
 
 typedef struct STagFilterResEntry {
-  SList    list;      // the linked list of md5 digest, extracted from the serialized tag query condition
-  uint32_t hitTimes;  // queried times for current super table
+  SList     list;      // the linked list of md5 digest, extracted from the serialized tag query condition
+  uint32_t  hitTimes;  // queried times for current super table
+  int64_t   ver;       // bumped each time a child table is created, dropped or has its tags altered
+  int64_t   minVer;    // all the changes after minVer are kept in pChanged, older uid lists can not be patched
+  SHashObj* pChanged;  // uid -> STagFilterChange, child tables changed after the oldest cached uid list
 } STagFilterResEntry;
 
+// the list item of the uid list cache, the digest is followed by the change version the uid list is up to date with
+typedef struct STagFilterResKey {
+  uint64_t digest[2];
+  int64_t  ver;
+} STagFilterResKey;
+
+typedef struct STagFilterChange {
+  int64_t ver;
+  bool    dropped;
+} STagFilterChange;
+
 struct SMetaCache {
   // child, normal, super, table entry cache
   struct SEntryCache {
@@ -113,9 +130,13 @@ static void statsCacheClose(SMeta* pMeta) {
 static void freeCacheEntryFp(void* param) {
   STagFilterResEntry** p = param;
   tdListEmpty(&(*p)->list);
+  taosHashCleanup((*p)->pChanged);
   taosMemoryFreeClear(*p);
 }
 
+static void metaUidCacheLoad(SMeta* pMeta);
+static void metaUidCacheSave(SMeta* pMeta);
+
 int32_t metaCacheOpen(SMeta* pMeta) {
   int32_t     code = 0;
   SMetaCache* pCache = NULL;
@@ -194,6 +215,7 @@ int32_t metaCacheOpen(SMeta* pMeta) {
   }
 
   pMeta->pCache = pCache;
+  metaUidCacheLoad(pMeta);
   return code;
 
 _err2:
@@ -207,6 +229,7 @@ _err:
 
 void metaCacheClose(SMeta* pMeta) {
   if (pMeta->pCache) {
+    metaUidCacheSave(pMeta);
     entryCacheClose(pMeta);
     statsCacheClose(pMeta);
 
@@ -525,8 +548,67 @@ static void initCacheKey(uint64_t* buf, const SHashObj* pHashMap, uint64_t suid,
   ASSERT(keyLen == sizeof(uint64_t) * 2);
 }
 
+static STagFilterResKey* uidCacheFindKey(STagFilterResEntry* pEntry, const void* pKey) {
+  SListIter iter = {0};
+  tdListInitIter(&pEntry->list, &iter, TD_LIST_FORWARD);
+
+  SListNode* pNode = NULL;
+  while ((pNode = tdListNext(&iter)) != NULL) {
+    STagFilterResKey* pResKey = (STagFilterResKey*)pNode->data;
+    if (memcmp(pResKey->digest, pKey, sizeof(pResKey->digest)) == 0) {
+      return pResKey;
+    }
+  }
+
+  return NULL;
+}
+
+// forget the changes once all the cached uid lists of the super table are up to date with them
+static void uidCacheTrimChanges(STagFilterResEntry* pEntry) {
+  if (pEntry->pChanged == NULL || taosHashGetSize(pEntry->pChanged) == 0) {
+    return;
+  }
+
+  SListIter iter = {0};
+  tdListInitIter(&pEntry->list, &iter, TD_LIST_FORWARD);
+
+  SListNode* pNode = NULL;
+  while ((pNode = tdListNext(&iter)) != NULL) {
+    if (((STagFilterResKey*)pNode->data)->ver < pEntry->ver) {
+      return;
+    }
+  }
+
+  taosHashClear(pEntry->pChanged);
+  pEntry->minVer = pEntry->ver;
+}
+
+static STagFilterResEntry* uidCacheAddEntry(SHashObj* pTableEntry, uint64_t suid, int64_t ver) {
+  STagFilterResEntry* p = taosMemoryMalloc(sizeof(STagFilterResEntry));
+  if (p == NULL) {
+    return NULL;
+  }
+
+  p->hitTimes = 0;
+  p->ver = ver;
+  p->minVer = ver;
+  p->pChanged = NULL;
+  tdListInit(&p->list, sizeof(STagFilterResKey));
+  if (taosHashPut(pTableEntry, &suid, sizeof(uint64_t), &p, POINTER_BYTES) != 0) {
+    taosMemoryFree(p);
+    return NULL;
+  }
+
+  return p;
+}
+
+static int32_t uidCachePutImpl(SMeta* pMeta, uint64_t suid, const void* pKey, int32_t keyLen, void* pPayload,
+                               int32_t payloadLen, int64_t ver);
+
+// the change version of the super table is returned in pVer, the uid list computed after a miss, or by filtering the
+// changed tables again, should be put back with it, so that the changes during the computing are not lost
 int32_t metaGetCachedTableUidList(void* pVnode, tb_uid_t suid, const uint8_t* pKey, int32_t keyLen, SArray* pList1,
-                                  bool* acquireRes) {
+                                  SArray* pChangedList, int64_t* pVer, bool* acquireRes) {
   SMeta*  pMeta = ((SVnode*)pVnode)->pMeta;
   int32_t vgId = TD_VID(pMeta->pVnode);
 
@@ -536,32 +618,83 @@ int32_t metaGetCachedTableUidList(void* pVnode, tb_uid_t suid, const uint8_t* pK
   TdThreadMutex* pLock = &pMeta->pCache->sTagFilterResCache.lock;
 
   *acquireRes = 0;
+  *pVer = 0;
   uint64_t key[4];
   initCacheKey(key, pTableMap, suid, (const char*)pKey, keyLen);
 
   taosThreadMutexLock(pLock);
   pMeta->pCache->sTagFilterResCache.accTimes += 1;
 
+  // the entry is created on the first miss, so that the changes made while the uid list is computed are recorded
+  STagFilterResEntry** pEntry = taosHashGet(pTableMap, &suid, sizeof(uint64_t));
+  if (pEntry == NULL) {
+    STagFilterResEntry* p = uidCacheAddEntry(pTableMap, suid, 0);
+    taosThreadMutexUnlock(pLock);
+    return (p == NULL) ? TSDB_CODE_OUT_OF_MEMORY : TSDB_CODE_SUCCESS;
+  }
+
+  *pVer = (*pEntry)->ver;
+
   LRUHandle* pHandle = taosLRUCacheLookup(pCache, key, TAG_FILTER_RES_KEY_LEN);
   if (pHandle == NULL) {
     taosThreadMutexUnlock(pLock);
     return TSDB_CODE_SUCCESS;
   }
 
-  // do some book mark work after acquiring the filter result from cache
-  STagFilterResEntry** pEntry = taosHashGet(pTableMap, &suid, sizeof(uint64_t));
-  if (NULL == pEntry) {
-    metaError("meta/cache: pEntry should not be NULL.");
-    return TSDB_CODE_FAILED;
+  STagFilterResKey* pResKey = uidCacheFindKey(*pEntry, pKey);
+  if (pResKey == NULL || (pResKey->ver < (*pEntry)->ver && pChangedList == NULL)) {
+    taosLRUCacheRelease(pCache, pHandle, false);
+    taosThreadMutexUnlock(pLock);
+    return TSDB_CODE_SUCCESS;
   }
 
   *acquireRes = 1;
 
-  const char* p = taosLRUCacheValue(pCache, pHandle);
-  int32_t     size = *(int32_t*)p;
+  const char*     p = taosLRUCacheValue(pCache, pHandle);
+  int32_t         size = *(int32_t*)p;
+  const uint64_t* pUid = (const uint64_t*)(p + sizeof(int32_t));
 
   // set the result into the buffer
-  taosArrayAddBatch(pList1, p + sizeof(int32_t), size);
+  void* pPatched = NULL;
+  if (pResKey->ver == (*pEntry)->ver) {
+    taosArrayAddBatch(pList1, pUid, size);
+  } else {
+    int32_t start = taosArrayGetSize(pList1);
+
+    // the child tables changed after the uid list was cached are taken out of it, the ones still existing are returned
+    // to be checked against the tag condition again
+    SHashObj* pChanged = (*pEntry)->pChanged;
+    for (int32_t i = 0; i < size; ++i) {
+      STagFilterChange* pChange = taosHashGet(pChanged, &pUid[i], sizeof(uint64_t));
+      if (pChange == NULL || pChange->ver <= pResKey->ver) {
+        taosArrayPush(pList1, &pUid[i]);
+      }
+    }
+
+    void* pIter = taosHashIterate(pChanged, NULL);
+    while (pIter != NULL) {
+      STagFilterChange* pChange = pIter;
+      if (pChange->ver > pResKey->ver && !pChange->dropped) {
+        taosArrayPush(pChangedList, taosHashGetKey(pIter, NULL));
+      }
+      pIter = taosHashIterate(pChanged, pIter);
+    }
+
+    metaDebug("vgId:%d, suid:%" PRIu64 " cached uid list patched, cached:%d, changed:%d", vgId, suid, size,
+              (int32_t)taosArrayGetSize(pChangedList));
+
+    // only dropped tables are taken out, nothing is left to filter again, so the patched list is up to date already
+    if (taosArrayGetSize(pChangedList) == 0) {
+      int32_t num = taosArrayGetSize(pList1) - start;
+      pPatched = taosMemoryMalloc(sizeof(int32_t) + num * sizeof(uint64_t));
+      if (pPatched != NULL) {
+        *(int32_t*)pPatched = num;
+        if (num > 0) {
+          memcpy((char*)pPatched + sizeof(int32_t), taosArrayGet(pList1, start), num * sizeof(uint64_t));
+        }
+      }
+    }
+  }
 
   (*pEntry)->hitTimes += 1;
 
@@ -572,6 +705,10 @@ int32_t metaGetCachedTableUidList(void* pVnode, tb_uid_t suid, const uint8_t* pK
   }
 
   taosLRUCacheRelease(pCache, pHandle, false);
+  if (pPatched != NULL) {
+    uidCachePutImpl(pMeta, suid, pKey, keyLen, pPatched, sizeof(int32_t) + (*(int32_t*)pPatched) * sizeof(uint64_t),
+                    (*pEntry)->ver);
+  }
 
   // unlock meta
   taosThreadMutexUnlock(pLock);
@@ -625,16 +762,83 @@ static int32_t addNewEntry(SHashObj* pTableEntry, const void* pKey, int32_t keyL
   }
 
   p->hitTimes = 0;
+  p->ver = 0;
+  p->minVer = 0;
+  p->pChanged = NULL;
   tdListInit(&p->list, keyLen);
   taosHashPut(pTableEntry, &suid, sizeof(uint64_t), &p, POINTER_BYTES);
   tdListAppend(&p->list, pKey);
   return 0;
 }
 
+// the uid list is up to date with the change version ver, it is given up if the changes after ver are not kept anymore
+static int32_t uidCachePutImpl(SMeta* pMeta, uint64_t suid, const void* pKey, int32_t keyLen, void* pPayload,
+                               int32_t payloadLen, int64_t ver) {
+  SLRUCache* pCache = pMeta->pCache->sTagFilterResCache.pUidResCache;
+  SHashObj*  pTableEntry = pMeta->pCache->sTagFilterResCache.pTableEntry;
+
+  uint64_t key[4] = {0};
+  initCacheKey(key, pTableEntry, suid, pKey, keyLen);
+
+  STagFilterResKey resKey = {.ver = ver};
+  memcpy(resKey.digest, pKey, sizeof(resKey.digest));
+
+  STagFilterResEntry*  p = NULL;
+  STagFilterResEntry** pEntry = taosHashGet(pTableEntry, &suid, sizeof(uint64_t));
+  if (pEntry == NULL) {
+    p = uidCacheAddEntry(pTableEntry, suid, ver);
+    if (p == NULL) {
+      taosMemoryFree(pPayload);
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  } else {  // check if it exists or not
+    p = *pEntry;
+    if (ver < p->minVer) {
+      taosMemoryFree(pPayload);
+      return TSDB_CODE_SUCCESS;
+    }
+
+    STagFilterResKey* pResKey = uidCacheFindKey(p, pKey);
+    if (pResKey != NULL && pResKey->ver >= ver) {
+      // we have already found the existed items, no need to added to cache anymore.
+      taosMemoryFree(pPayload);
+      return TSDB_CODE_SUCCESS;
+    }
+
+    if (pResKey != NULL) {  // replace the stale one, its list item is removed in freeUidCachePayload
+      taosLRUCacheErase(pCache, key, TAG_FILTER_RES_KEY_LEN);
+    }
+  }
+
+  tdListAppend(&p->list, &resKey);
+  uidCacheTrimChanges(p);
+
+  // add to cache.
+  taosLRUCacheInsert(pCache, key, TAG_FILTER_RES_KEY_LEN, pPayload, payloadLen, freeUidCachePayload, NULL,
+                     TAOS_LRU_PRIORITY_LOW, NULL);
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t uidCachePut(SMeta* pMeta, uint64_t suid, const void* pKey, int32_t keyLen, void* pPayload,
+                           int32_t payloadLen, int64_t ver) {
+  int32_t vgId = TD_VID(pMeta->pVnode);
+
+  SLRUCache*     pCache = pMeta->pCache->sTagFilterResCache.pUidResCache;
+  SHashObj*      pTableEntry = pMeta->pCache->sTagFilterResCache.pTableEntry;
+  TdThreadMutex* pLock = &pMeta->pCache->sTagFilterResCache.lock;
+
+  taosThreadMutexLock(pLock);
+  int32_t code = uidCachePutImpl(pMeta, suid, pKey, keyLen, pPayload, payloadLen, ver);
+  taosThreadMutexUnlock(pLock);
+
+  metaDebug("vgId:%d, suid:%" PRIu64 " list cache added into cache, ver:%" PRId64 ", total:%d, tables:%d", vgId, suid,
+            ver, (int32_t)taosLRUCacheGetUsage(pCache), taosHashGetSize(pTableEntry));
+  return code;
+}
+
 // check both the payload size and selectivity ratio
 int32_t metaUidFilterCachePut(void* pVnode, uint64_t suid, const void* pKey, int32_t keyLen, void* pPayload,
-                              int32_t payloadLen, double selectivityRatio) {
-  int32_t code = 0;
+                              int32_t payloadLen, int64_t ver, double selectivityRatio) {
   SMeta*  pMeta = ((SVnode*)pVnode)->pMeta;
   int32_t vgId = TD_VID(pMeta->pVnode);
 
@@ -654,84 +858,284 @@ int32_t metaUidFilterCachePut(void* pVnode, uint64_t suid, const void* pKey, int
     return TSDB_CODE_SUCCESS;
   }
 
-  SLRUCache*     pCache = pMeta->pCache->sTagFilterResCache.pUidResCache;
-  SHashObj*      pTableEntry = pMeta->pCache->sTagFilterResCache.pTableEntry;
-  TdThreadMutex* pLock = &pMeta->pCache->sTagFilterResCache.lock;
+  return uidCachePut(pMeta, suid, pKey, keyLen, pPayload, payloadLen, ver);
+}
 
-  uint64_t key[4] = {0};
-  initCacheKey(key, pTableEntry, suid, pKey, keyLen);
+static void uidCacheClearImpl(SMeta* pMeta, STagFilterResEntry* pEntry, uint64_t suid) {
+  uint64_t  p[4] = {0};
+  SHashObj* pEntryHashMap = pMeta->pCache->sTagFilterResCache.pTableEntry;
+
+  uint64_t dummy[2] = {0};
+  initCacheKey(p, pEntryHashMap, suid, (char*)&dummy[0], 16);
+
+  pEntry->hitTimes = 0;
+
+  SListIter iter = {0};
+  tdListInitIter(&pEntry->list, &iter, TD_LIST_FORWARD);
 
+  SListNode* pNode = NULL;
+  while ((pNode = tdListNext(&iter)) != NULL) {
+    setMD5DigestInKey(p, pNode->data, 2 * sizeof(uint64_t));
+    taosLRUCacheErase(pMeta->pCache->sTagFilterResCache.pUidResCache, p, TAG_FILTER_RES_KEY_LEN);
+  }
+
+  tdListEmpty(&pEntry->list);
+  taosHashClear(pEntry->pChanged);
+
+  // the uid lists computed before are not put into the cache anymore
+  pEntry->minVer = ++pEntry->ver;
+}
+
+// remove the lru cache that are expired due to the altering or dropping of the super table
+int32_t metaUidCacheClear(SMeta* pMeta, uint64_t suid) {
+  int32_t   vgId = TD_VID(pMeta->pVnode);
+  SHashObj* pEntryHashMap = pMeta->pCache->sTagFilterResCache.pTableEntry;
+
+  TdThreadMutex* pLock = &pMeta->pCache->sTagFilterResCache.lock;
   taosThreadMutexLock(pLock);
-  STagFilterResEntry** pEntry = taosHashGet(pTableEntry, &suid, sizeof(uint64_t));
+
+  STagFilterResEntry** pEntry = taosHashGet(pEntryHashMap, &suid, sizeof(uint64_t));
   if (pEntry == NULL) {
-    code = addNewEntry(pTableEntry, pKey, keyLen, suid);
-    if (code != TSDB_CODE_SUCCESS) {
-      goto _end;
-    }
-  } else {  // check if it exists or not
-    size_t size = listNEles(&(*pEntry)->list);
-    if (size == 0) {
-      tdListAppend(&(*pEntry)->list, pKey);
-    } else {
-      SListNode* pNode = listHead(&(*pEntry)->list);
-      uint64_t*  p = (uint64_t*)pNode->data;
-      if (p[1] == ((uint64_t*)pKey)[1] && p[0] == ((uint64_t*)pKey)[0]) {
-        // we have already found the existed items, no need to added to cache anymore.
-        taosThreadMutexUnlock(pLock);
-        return TSDB_CODE_SUCCESS;
-      } else {  // not equal, append it
-        tdListAppend(&(*pEntry)->list, pKey);
-      }
-    }
+    taosThreadMutexUnlock(pLock);
+    return TSDB_CODE_SUCCESS;
   }
 
-  // add to cache.
-  taosLRUCacheInsert(pCache, key, TAG_FILTER_RES_KEY_LEN, pPayload, payloadLen, freeUidCachePayload, NULL,
-                     TAOS_LRU_PRIORITY_LOW, NULL);
-_end:
+  uidCacheClearImpl(pMeta, *pEntry, suid);
   taosThreadMutexUnlock(pLock);
-  metaDebug("vgId:%d, suid:%" PRIu64 " list cache added into cache, total:%d, tables:%d", vgId, suid,
-            (int32_t)taosLRUCacheGetUsage(pCache), taosHashGetSize(pTableEntry));
 
-  return code;
+  metaDebug("vgId:%d suid:%" PRId64 " cached related tag filter uid list cleared", vgId, suid);
+  return TSDB_CODE_SUCCESS;
 }
 
-// remove the lru cache that are expired due to the tags value update, or creating, or dropping, of child tables
-int32_t metaUidCacheClear(SMeta* pMeta, uint64_t suid) {
-  uint64_t  p[4] = {0};
+// record a child table created, dropped or with tags altered, the cached uid lists of its super table are patched
+// when they are acquired next time, instead of being thrown away
+int32_t metaUidCacheUpdate(SMeta* pMeta, uint64_t suid, tb_uid_t uid, bool dropped) {
   int32_t   vgId = TD_VID(pMeta->pVnode);
   SHashObj* pEntryHashMap = pMeta->pCache->sTagFilterResCache.pTableEntry;
 
-  uint64_t dummy[2] = {0};
-  initCacheKey(p, pEntryHashMap, suid, (char*)&dummy[0], 16);
-
   TdThreadMutex* pLock = &pMeta->pCache->sTagFilterResCache.lock;
   taosThreadMutexLock(pLock);
 
   STagFilterResEntry** pEntry = taosHashGet(pEntryHashMap, &suid, sizeof(uint64_t));
-  if (pEntry == NULL || listNEles(&(*pEntry)->list) == 0) {
+  if (pEntry == NULL) {
     taosThreadMutexUnlock(pLock);
     return TSDB_CODE_SUCCESS;
   }
 
-  (*pEntry)->hitTimes = 0;
+  // nothing to patch, the uid lists being computed are made stale by bumping the version only
+  if (listNEles(&(*pEntry)->list) == 0) {
+    taosHashClear((*pEntry)->pChanged);
+    (*pEntry)->minVer = ++(*pEntry)->ver;
+    taosThreadMutexUnlock(pLock);
+    return TSDB_CODE_SUCCESS;
+  }
 
-  SListIter iter = {0};
-  tdListInitIter(&(*pEntry)->list, &iter, TD_LIST_FORWARD);
+  if ((*pEntry)->pChanged == NULL) {
+    (*pEntry)->pChanged = taosHashInit(64, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), false, HASH_NO_LOCK);
+  }
 
-  SListNode* pNode = NULL;
-  while ((pNode = tdListNext(&iter)) != NULL) {
-    setMD5DigestInKey(p, pNode->data, 2 * sizeof(uint64_t));
-    taosLRUCacheErase(pMeta->pCache->sTagFilterResCache.pUidResCache, p, TAG_FILTER_RES_KEY_LEN);
+  // too many changes to patch the cached uid lists cheaply, start over
+  if ((*pEntry)->pChanged == NULL || taosHashGetSize((*pEntry)->pChanged) >= TAG_FILTER_MAX_CHANGES) {
+    uidCacheClearImpl(pMeta, *pEntry, suid);
+    taosThreadMutexUnlock(pLock);
+    metaDebug("vgId:%d suid:%" PRId64 " cached related tag filter uid list cleared", vgId, suid);
+    return TSDB_CODE_SUCCESS;
+  }
+
+  STagFilterChange change = {.ver = ++(*pEntry)->ver, .dropped = dropped};
+  int32_t          code = taosHashPut((*pEntry)->pChanged, &uid, sizeof(uid), &change, sizeof(change));
+  if (code != 0) {
+    uidCacheClearImpl(pMeta, *pEntry, suid);
   }
 
-  tdListEmpty(&(*pEntry)->list);
   taosThreadMutexUnlock(pLock);
+  return TSDB_CODE_SUCCESS;
+}
 
-  metaDebug("vgId:%d suid:%" PRId64 " cached related tag filter uid list cleared", vgId, suid);
+static void uidCacheFileName(SMeta* pMeta, char* fname) {
+  snprintf(fname, TSDB_FILENAME_LEN, "%s%s%s", pMeta->path, TD_DIRSEP, TAG_FILTER_CACHE_FILE);
+}
+
+static int32_t uidCacheEnsureBuf(char** ppBuf, int32_t* pCap, int32_t len) {
+  if (len <= *pCap) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t cap = TMAX(len, (*pCap) * 2);
+  char*   p = taosMemoryRealloc(*ppBuf, cap);
+  if (p == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  *ppBuf = p;
+  *pCap = cap;
   return TSDB_CODE_SUCCESS;
 }
 
+/*
+ * Write the up to date uid lists to a file when the vnode is closed, and load them back when it is opened. They are
+ * only valid if the meta is opened at the same version, i.e. nothing is left to be replayed from the wal, and the file
+ * is removed once loaded so that it is never used after a crash.
+ * format: [version][committed version][number of items] { [suid][digest][payload length][payload] } [checksum]
+ */
+static void metaUidCacheSave(SMeta* pMeta) {
+  SVnode* pVnode = pMeta->pVnode;
+  if (!tsTagFilterCache || pVnode->state.applied != pVnode->state.committed) {
+    return;
+  }
+
+  SLRUCache* pCache = pMeta->pCache->sTagFilterResCache.pUidResCache;
+  SHashObj*  pTableEntry = pMeta->pCache->sTagFilterResCache.pTableEntry;
+  int32_t    headLen = sizeof(int32_t) + sizeof(int64_t) + sizeof(int32_t);
+  int32_t    cap = 4096;
+  int32_t    len = headLen;
+  int32_t    numOfItems = 0;
+  int32_t    code = TSDB_CODE_SUCCESS;
+  char*      pBuf = taosMemoryMalloc(cap);
+  if (pBuf == NULL) {
+    return;
+  }
+
+  void* pIter = taosHashIterate(pTableEntry, NULL);
+  while (pIter != NULL && code == TSDB_CODE_SUCCESS) {
+    STagFilterResEntry* pEntry = *(STagFilterResEntry**)pIter;
+    uint64_t            suid = *(uint64_t*)taosHashGetKey(pIter, NULL);
+
+    SListIter iter = {0};
+    tdListInitIter(&pEntry->list, &iter, TD_LIST_FORWARD);
+
+    SListNode* pNode = NULL;
+    while ((pNode = tdListNext(&iter)) != NULL && code == TSDB_CODE_SUCCESS) {
+      STagFilterResKey* pResKey = (STagFilterResKey*)pNode->data;
+      if (pResKey->ver != pEntry->ver) {
+        continue;
+      }
+
+      uint64_t key[4];
+      initCacheKey(key, pTableEntry, suid, (const char*)pResKey->digest, sizeof(pResKey->digest));
+      LRUHandle* pHandle = taosLRUCacheLookup(pCache, key, TAG_FILTER_RES_KEY_LEN);
+      if (pHandle == NULL) {
+        continue;
+      }
+
+      const char* pPayload = taosLRUCacheValue(pCache, pHandle);
+      int32_t     payloadLen = sizeof(int32_t) + (*(int32_t*)pPayload) * sizeof(uint64_t);
+      code = uidCacheEnsureBuf(&pBuf, &cap, len + sizeof(suid) + sizeof(pResKey->digest) + sizeof(int32_t) + payloadLen);
+      if (code == TSDB_CODE_SUCCESS) {
+        memcpy(pBuf + len, &suid, sizeof(suid));
+        len += sizeof(suid);
+        memcpy(pBuf + len, pResKey->digest, sizeof(pResKey->digest));
+        len += sizeof(pResKey->digest);
+        memcpy(pBuf + len, &payloadLen, sizeof(int32_t));
+        len += sizeof(int32_t);
+        memcpy(pBuf + len, pPayload, payloadLen);
+        len += payloadLen;
+        numOfItems += 1;
+      }
+
+      taosLRUCacheRelease(pCache, pHandle, false);
+    }
+
+    pIter = taosHashIterate(pTableEntry, pIter);
+  }
+  taosHashCancelIterate(pTableEntry, pIter);
+
+  if (code == TSDB_CODE_SUCCESS && numOfItems > 0) {
+    code = uidCacheEnsureBuf(&pBuf, &cap, len + sizeof(TSCKSUM));
+  }
+
+  if (code == TSDB_CODE_SUCCESS && numOfItems > 0) {
+    *(int32_t*)pBuf = TAG_FILTER_CACHE_FILE_VER;
+    *(int64_t*)(pBuf + sizeof(int32_t)) = pVnode->state.committed;
+    *(int32_t*)(pBuf + sizeof(int32_t) + sizeof(int64_t)) = numOfItems;
+    len += sizeof(TSCKSUM);
+    taosCalcChecksumAppend(0, (uint8_t*)pBuf, len);
+
+    char fname[TSDB_FILENAME_LEN] = {0};
+    uidCacheFileName(pMeta, fname);
+
+    TdFilePtr pFile = taosOpenFile(fname, TD_FILE_CREATE | TD_FILE_WRITE | TD_FILE_TRUNC);
+    if (pFile == NULL || taosWriteFile(pFile, pBuf, len) != len || taosFsyncFile(pFile) < 0) {
+      metaWarn("vgId:%d, failed to save tag filter cache since %s", TD_VID(pVnode), tstrerror(TAOS_SYSTEM_ERROR(errno)));
+      taosCloseFile(&pFile);
+      taosRemoveFile(fname);
+    } else {
+      taosCloseFile(&pFile);
+      metaInfo("vgId:%d, %d cached tag filter uid lists saved, ver:%" PRId64, TD_VID(pVnode), numOfItems,
+               pVnode->state.committed);
+    }
+  }
+
+  taosMemoryFree(pBuf);
+}
+
+static void metaUidCacheLoad(SMeta* pMeta) {
+  SVnode* pVnode = pMeta->pVnode;
+  char    fname[TSDB_FILENAME_LEN] = {0};
+  int64_t size = 0;
+  char*   pBuf = NULL;
+
+  uidCacheFileName(pMeta, fname);
+  if (taosStatFile(fname, &size, NULL, NULL) < 0) {
+    return;
+  }
+
+  int32_t   headLen = sizeof(int32_t) + sizeof(int64_t) + sizeof(int32_t);
+  TdFilePtr pFile = taosOpenFile(fname, TD_FILE_READ);
+  if (pFile == NULL || !tsTagFilterCache || size < headLen + sizeof(TSCKSUM) || size > INT32_MAX) {
+    goto _end;
+  }
+
+  pBuf = taosMemoryMalloc(size);
+  if (pBuf == NULL || taosReadFile(pFile, pBuf, size) != size || !taosCheckChecksumWhole((uint8_t*)pBuf, size)) {
+    goto _end;
+  }
+
+  int64_t ver = *(int64_t*)(pBuf + sizeof(int32_t));
+  if (*(int32_t*)pBuf != TAG_FILTER_CACHE_FILE_VER || ver != pVnode->state.committed) {
+    metaInfo("vgId:%d, saved tag filter cache of ver:%" PRId64 " is outdated, committed:%" PRId64, TD_VID(pVnode), ver,
+             pVnode->state.committed);
+    goto _end;
+  }
+
+  int32_t numOfItems = *(int32_t*)(pBuf + sizeof(int32_t) + sizeof(int64_t));
+  int32_t len = headLen;
+  int32_t end = size - sizeof(TSCKSUM);
+  int32_t numOfLoaded = 0;
+  for (int32_t i = 0; i < numOfItems; ++i) {
+    int32_t itemHead = sizeof(uint64_t) + sizeof(uint64_t) * 2 + sizeof(int32_t);
+    if (len + itemHead > end) {
+      break;
+    }
+
+    uint64_t    suid = *(uint64_t*)(pBuf + len);
+    const char* pDigest = pBuf + len + sizeof(uint64_t);
+    int32_t     payloadLen = *(int32_t*)(pDigest + sizeof(uint64_t) * 2);
+    len += itemHead;
+    if (payloadLen < sizeof(int32_t) || len + payloadLen > end) {
+      break;
+    }
+
+    void* pPayload = taosMemoryMalloc(payloadLen);
+    if (pPayload == NULL) {
+      break;
+    }
+
+    memcpy(pPayload, pBuf + len, payloadLen);
+    len += payloadLen;
+    if (uidCachePut(pMeta, suid, pDigest, sizeof(uint64_t) * 2, pPayload, payloadLen, 0) == TSDB_CODE_SUCCESS) {
+      numOfLoaded += 1;
+    }
+  }
+
+  metaInfo("vgId:%d, %d cached tag filter uid lists loaded, ver:%" PRId64, TD_VID(pVnode), numOfLoaded, ver);
+
+_end:
+  taosMemoryFree(pBuf);
+  taosCloseFile(&pFile);
+  taosRemoveFile(fname);
+}
+
 int32_t metaGetCachedTbGroup(void* pVnode, tb_uid_t suid, const uint8_t* pKey, int32_t keyLen, SArray** pList) {
   SMeta*  pMeta = ((SVnode*)pVnode)->pMeta;
   int32_t vgId = TD_VID(pMeta->pVnode);
@@ -176,6 +176,13 @@ int metaOpen(SVnode *pVnode, SMeta **ppMeta, int8_t rollback) {
     goto _err;
   }
 
+  code = metaTagStoreOpen(pMeta);
+  if (code) {
+    terrno = code;
+    metaError("vgId:%d, failed to open meta tag store since %s", TD_VID(pVnode), tstrerror(terrno));
+    goto _err;
+  }
+
   if (metaInitTbFilterCache(pMeta) != 0) {
     goto _err;
   }
@@ -273,6 +280,7 @@ static void metaCleanup(SMeta **ppMeta) {
   if (pMeta) {
     if (pMeta->pEnv) metaAbort(pMeta);
     if (pMeta->pCache) metaCacheClose(pMeta);
+    if (pMeta->pTagStore) metaTagStoreClose(pMeta);
     if (pMeta->pIdx) metaCloseIdx(pMeta);
     if (pMeta->pStreamDb) tdbTbClose(pMeta->pStreamDb);
     if (pMeta->pNcolIdx) tdbTbClose(pMeta->pNcolIdx);
@@ -415,6 +415,7 @@ int metaAlterSTable(SMeta *pMeta, int64_t version, SVCreateStbReq *pReq) {
   if (updStat) {
     metaUpdateStbStats(pMeta, pReq->suid, 0, deltaCol);
   }
+  metaTagStoreDrop(pMeta, pReq->suid);
   metaULock(pMeta);
 
   if (updStat) {
@@ -813,7 +814,6 @@ int metaCreateTable(SMeta *pMeta, int64_t ver, SVCreateTbReq *pReq, STableMetaRs
 
     metaWLock(pMeta);
     metaUpdateStbStats(pMeta, me.ctbEntry.suid, 1, 0);
-    metaUidCacheClear(pMeta, me.ctbEntry.suid);
     metaTbGroupCacheClear(pMeta, me.ctbEntry.suid);
     metaULock(pMeta);
   } else {
@@ -830,6 +830,11 @@ int metaCreateTable(SMeta *pMeta, int64_t ver, SVCreateTbReq *pReq, STableMetaRs
 
   if (metaHandleEntry(pMeta, &me) < 0) goto _err;
 
+  // recorded after the table is written, a tag filter running in between must not be stamped as up to date with it
+  if (me.type == TSDB_CHILD_TABLE) {
+    metaUidCacheUpdate(pMeta, me.ctbEntry.suid, me.uid, false);
+  }
+
   metaTimeSeriesNotifyCheck(pMeta);
 
   if (pMetaRsp) {
@@ -1159,8 +1164,9 @@ static int metaDropTableByUid(SMeta *pMeta, tb_uid_t uid, int *type, tb_uid_t *p
 
     --pMeta->pVnode->config.vndStats.numOfCTables;
     metaUpdateStbStats(pMeta, e.ctbEntry.suid, -1, 0);
-    metaUidCacheClear(pMeta, e.ctbEntry.suid);
+    metaUidCacheUpdate(pMeta, e.ctbEntry.suid, uid, true);
     metaTbGroupCacheClear(pMeta, e.ctbEntry.suid);
+    metaTagStoreDelete(pMeta, e.ctbEntry.suid, uid);
   } else if (e.type == TSDB_NORMAL_TABLE) {
     // drop schema.db (todo)
 
@@ -1173,6 +1179,7 @@ static int metaDropTableByUid(SMeta *pMeta, tb_uid_t uid, int *type, tb_uid_t *p
     metaStatsCacheDrop(pMeta, uid);
     metaUidCacheClear(pMeta, uid);
     metaTbGroupCacheClear(pMeta, uid);
+    metaTagStoreDrop(pMeta, uid);
     --pMeta->pVnode->config.vndStats.numOfSTables;
   }
 
@@ -1594,11 +1601,9 @@ static int metaUpdateTableTagVal(SMeta *pMeta, int64_t version, SVAlterTbReq *pA
     goto _err;
   }
 
-  SCtbIdxKey ctbIdxKey = {.suid = ctbEntry.ctbEntry.suid, .uid = uid};
-  tdbTbUpsert(pMeta->pCtbIdx, &ctbIdxKey, sizeof(ctbIdxKey), ctbEntry.ctbEntry.pTags,
-              ((STag *)(ctbEntry.ctbEntry.pTags))->len, pMeta->txn);
+  metaUpdateCtbIdx(pMeta, &ctbEntry);
 
-  metaUidCacheClear(pMeta, ctbEntry.ctbEntry.suid);
+  metaUidCacheUpdate(pMeta, ctbEntry.ctbEntry.suid, uid, false);
   metaTbGroupCacheClear(pMeta, ctbEntry.ctbEntry.suid);
 
   metaUpdateChangeTime(pMeta, ctbEntry.uid, pAlterTbReq->ctimeMs);
@@ -2101,11 +2106,18 @@ int metaUpdateChangeTimeWithLock(SMeta *pMeta, tb_uid_t uid, int64_t changeTimeM
   return ret;
 }
 
+// the tag store follows ctb.idx, whether the child table is created, altered or written by a snapshot
 static int metaUpdateCtbIdx(SMeta *pMeta, const SMetaEntry *pME) {
   SCtbIdxKey ctbIdxKey = {.suid = pME->ctbEntry.suid, .uid = pME->uid};
 
-  return tdbTbUpsert(pMeta->pCtbIdx, &ctbIdxKey, sizeof(ctbIdxKey), pME->ctbEntry.pTags,
-                     ((STag *)(pME->ctbEntry.pTags))->len, pMeta->txn);
+  int ret = tdbTbUpsert(pMeta->pCtbIdx, &ctbIdxKey, sizeof(ctbIdxKey), pME->ctbEntry.pTags,
+                        ((STag *)(pME->ctbEntry.pTags))->len, pMeta->txn);
+  if (ret == 0) {
+    metaTagStoreUpsert(pMeta, pME->ctbEntry.suid, pME->uid, (const STag *)pME->ctbEntry.pTags);
+  } else {
+    metaTagStoreDrop(pMeta, pME->ctbEntry.suid);
+  }
+  return ret;
 }
 
 int metaCreateTagIdxKey(tb_uid_t suid, int32_t cid, const void *pTagData, int32_t nTagData, int8_t type, tb_uid_t uid,
@@ -2306,6 +2318,9 @@ int metaHandleEntry(SMeta *pMeta, const SMetaEntry *pME) {
     if (pME->type == TSDB_SUPER_TABLE) {
       code = metaUpdateSuidIdx(pMeta, pME);
       VND_CHECK_CODE(code, line, _err);
+
+      // a snapshot may bring another tag schema
+      metaTagStoreDrop(pMeta, pME->uid);
     }
   }
 
@@ -0,0 +1,433 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "meta.h"
+
+#define TAG_STORE_MIN_ROWS 1024
+
+// The tag values of all the child tables of one super table, kept column by column in a data block. A child table
+// gets the next ordinal (row) when it is created, the ordinal of a dropped one is left as a hole with uid 0. The store
+// is dropped and built again on the next query once there are too many holes or replaced var values.
+typedef struct STagColStore {
+  int32_t      numOfDropped;  // holes left by the dropped child tables
+  int64_t      garbage;       // bytes of the var tag values replaced by altering the tags
+  bool         json;          // the super table has a json tag, which is not kept in columns
+  SArray*      pUids;         // ordinal -> uid, 0 if the child table is dropped
+  SHashObj*    pOrdinal;      // uid -> ordinal
+  SSDataBlock* pBlock;        // one column for each tag, info.rows is the number of ordinals
+} STagColStore;
+
+struct SMetaTagStore {
+  TdThreadMutex lock;
+  SHashObj*     pStores;  // suid -> STagColStore*, built on the first tag scan of the super table
+  char*         pBuf;     // buffer to convert a var tag value to var data
+  int32_t       bufLen;
+};
+
+static void tagStoreDestroy(STagColStore* pStore) {
+  if (pStore == NULL) {
+    return;
+  }
+
+  taosArrayDestroy(pStore->pUids);
+  taosHashCleanup(pStore->pOrdinal);
+  blockDataDestroy(pStore->pBlock);
+  taosMemoryFree(pStore);
+}
+
+static void freeTagStoreFp(void* param) { tagStoreDestroy(*(STagColStore**)param); }
+
+int32_t metaTagStoreOpen(SMeta* pMeta) {
+  SMetaTagStore* pTagStore = taosMemoryCalloc(1, sizeof(SMetaTagStore));
+  if (pTagStore == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  pTagStore->pStores = taosHashInit(16, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), false, HASH_NO_LOCK);
+  if (pTagStore->pStores == NULL) {
+    taosMemoryFree(pTagStore);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  taosHashSetFreeFp(pTagStore->pStores, freeTagStoreFp);
+  taosThreadMutexInit(&pTagStore->lock, NULL);
+  pMeta->pTagStore = pTagStore;
+  return TSDB_CODE_SUCCESS;
+}
+
+void metaTagStoreClose(SMeta* pMeta) {
+  SMetaTagStore* pTagStore = pMeta->pTagStore;
+  if (pTagStore == NULL) {
+    return;
+  }
+
+  taosHashCleanup(pTagStore->pStores);
+  taosThreadMutexDestroy(&pTagStore->lock);
+  taosMemoryFree(pTagStore->pBuf);
+  taosMemoryFree(pTagStore);
+  pMeta->pTagStore = NULL;
+}
+
+static int32_t tagStoreSetRow(SMetaTagStore* pTagStore, STagColStore* pStore, int32_t row, const STag* pTag,
+                              bool replace) {
+  int32_t numOfCols = taosArrayGetSize(pStore->pBlock->pDataBlock);
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SColumnInfoData* pCol = taosArrayGet(pStore->pBlock->pDataBlock, i);
+    if (replace && IS_VAR_DATA_TYPE(pCol->info.type) && !colDataIsNull_var(pCol, row)) {
+      pStore->garbage += varDataTLen(colDataGetVarData(pCol, row));
+    }
+
+    STagVal tagVal = {.cid = pCol->info.colId};
+    if (pTag == NULL || !tTagGet(pTag, &tagVal)) {
+      colDataSetNULL(pCol, row);
+      continue;
+    }
+
+    int32_t code = 0;
+    if (IS_VAR_DATA_TYPE(pCol->info.type)) {
+      int32_t len = tagVal.nData + VARSTR_HEADER_SIZE;
+      if (pTagStore->bufLen < len) {
+        char* p = taosMemoryRealloc(pTagStore->pBuf, len);
+        if (p == NULL) {
+          return TSDB_CODE_OUT_OF_MEMORY;
+        }
+        pTagStore->pBuf = p;
+        pTagStore->bufLen = len;
+      }
+
+      varDataSetLen(pTagStore->pBuf, tagVal.nData);
+      memcpy(varDataVal(pTagStore->pBuf), tagVal.pData, tagVal.nData);
+      code = colDataSetVal(pCol, row, pTagStore->pBuf, false);
+    } else {
+      code = colDataSetVal(pCol, row, (const char*)&tagVal.i64, false);
+    }
+
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t tagStoreAppend(SMetaTagStore* pTagStore, STagColStore* pStore, tb_uid_t uid, const STag* pTag) {
+  SSDataBlock* pBlock = pStore->pBlock;
+  int32_t      row = pBlock->info.rows;
+
+  if (row >= pBlock->info.capacity) {
+    int32_t code = blockDataEnsureCapacity(pBlock, TMAX(pBlock->info.capacity * 2, TAG_STORE_MIN_ROWS));
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
+  if (taosArrayPush(pStore->pUids, &uid) == NULL ||
+      taosHashPut(pStore->pOrdinal, &uid, sizeof(uid), &row, sizeof(row)) != 0) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  pBlock->info.rows += 1;
+  return tagStoreSetRow(pTagStore, pStore, row, pTag, false);
+}
+
+static int32_t tagStoreBuild(SMeta* pMeta, tb_uid_t suid, STagColStore** ppStore) {
+  SMetaTagStore* pTagStore = pMeta->pTagStore;
+  SMetaReader    mr = {0};
+  int32_t        code = TSDB_CODE_SUCCESS;
+  int64_t        st = taosGetTimestampUs();
+
+  STagColStore* pStore = taosMemoryCalloc(1, sizeof(STagColStore));
+  if (pStore == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  metaReaderDoInit(&mr, pMeta, META_READER_NOLOCK);
+  if (metaReaderGetTableEntryByUid(&mr, suid) < 0 || mr.me.type != TSDB_SUPER_TABLE) {
+    code = TSDB_CODE_PAR_TABLE_NOT_EXIST;
+    goto _err;
+  }
+
+  const SSchemaWrapper* pTagSchema = &mr.me.stbEntry.schemaTag;
+  if (pTagSchema->nCols == 1 && pTagSchema->pSchema[0].type == TSDB_DATA_TYPE_JSON) {
+    pStore->json = true;
+    metaReaderClear(&mr);
+    *ppStore = pStore;
+    return TSDB_CODE_SUCCESS;
+  }
+
+  pStore->pUids = taosArrayInit(TAG_STORE_MIN_ROWS, sizeof(tb_uid_t));
+  pStore->pOrdinal = taosHashInit(TAG_STORE_MIN_ROWS, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), false,
+                                  HASH_NO_LOCK);
+  pStore->pBlock = createDataBlock();
+  if (pStore->pUids == NULL || pStore->pOrdinal == NULL || pStore->pBlock == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _err;
+  }
+
+  for (int32_t i = 0; i < pTagSchema->nCols; ++i) {
+    SSchema*        pSchema = &pTagSchema->pSchema[i];
+    SColumnInfoData colInfo = createColumnInfoData(pSchema->type, pSchema->bytes, pSchema->colId);
+    code = blockDataAppendColInfo(pStore->pBlock, &colInfo);
+    if (code != TSDB_CODE_SUCCESS) {
+      goto _err;
+    }
+  }
+  metaReaderClear(&mr);
+
+  SMCtbCursor* pCur = metaOpenCtbCursor(pMeta->pVnode, suid, 0);
+  if (pCur == NULL) {
+    tagStoreDestroy(pStore);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  tb_uid_t uid = 0;
+  while (code == TSDB_CODE_SUCCESS && (uid = metaCtbCursorNext(pCur)) != 0) {
+    code = tagStoreAppend(pTagStore, pStore, uid, pCur->pVal);
+  }
+  metaCloseCtbCursor(pCur);
+  if (code != TSDB_CODE_SUCCESS) {
+    tagStoreDestroy(pStore);
+    return code;
+  }
+
+  metaDebug("vgId:%d, suid:%" PRId64 " tag store is built, numOfTables:%d, elapsed time:%.2fms",
+            TD_VID(pMeta->pVnode), suid, pStore->pBlock->info.rows, (taosGetTimestampUs() - st) / 1000.0);
+  *ppStore = pStore;
+  return TSDB_CODE_SUCCESS;
+
+_err:
+  metaReaderClear(&mr);
+  tagStoreDestroy(pStore);
+  return code;
+}
+
+static bool tagStoreNeedRebuild(STagColStore* pStore) {
+  int32_t rows = pStore->pBlock->info.rows;
+  if (rows < TAG_STORE_MIN_ROWS) {
+    return false;
+  }
+
+  if (pStore->numOfDropped > rows / 2) {
+    return true;
+  }
+
+  int64_t varLen = 0;
+  int32_t numOfCols = taosArrayGetSize(pStore->pBlock->pDataBlock);
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SColumnInfoData* pCol = taosArrayGet(pStore->pBlock->pDataBlock, i);
+    if (IS_VAR_DATA_TYPE(pCol->info.type)) {
+      varLen += pCol->varmeta.length;
+    }
+  }
+
+  return pStore->garbage > varLen / 2;
+}
+
+static void tagStoreRemove(SMeta* pMeta, tb_uid_t suid, const char* reason) {
+  if (taosHashRemove(pMeta->pTagStore->pStores, &suid, sizeof(suid)) == 0) {
+    metaDebug("vgId:%d, suid:%" PRId64 " tag store is dropped since %s", TD_VID(pMeta->pVnode), suid, reason);
+  }
+}
+
+// the child table is created or its tags are altered, only the stores that are already built need to be updated
+void metaTagStoreUpsert(SMeta* pMeta, tb_uid_t suid, tb_uid_t uid, const STag* pTag) {
+  SMetaTagStore* pTagStore = pMeta->pTagStore;
+  taosThreadMutexLock(&pTagStore->lock);
+
+  STagColStore** ppStore = taosHashGet(pTagStore->pStores, &suid, sizeof(suid));
+  if (ppStore == NULL || (*ppStore)->json) {
+    taosThreadMutexUnlock(&pTagStore->lock);
+    return;
+  }
+
+  STagColStore* pStore = *ppStore;
+  int32_t*      pRow = taosHashGet(pStore->pOrdinal, &uid, sizeof(uid));
+
+  int32_t code = 0;
+  if (pRow == NULL) {
+    code = tagStoreAppend(pTagStore, pStore, uid, pTag);
+  } else {
+    code = tagStoreSetRow(pTagStore, pStore, *pRow, pTag, true);
+  }
+
+  if (code != TSDB_CODE_SUCCESS) {
+    tagStoreRemove(pMeta, suid, tstrerror(code));
+  } else if (tagStoreNeedRebuild(pStore)) {
+    tagStoreRemove(pMeta, suid, "too many tag values replaced");
+  }
+
+  taosThreadMutexUnlock(&pTagStore->lock);
+}
+
+void metaTagStoreDelete(SMeta* pMeta, tb_uid_t suid, tb_uid_t uid) {
+  SMetaTagStore* pTagStore = pMeta->pTagStore;
+  taosThreadMutexLock(&pTagStore->lock);
+
+  STagColStore** ppStore = taosHashGet(pTagStore->pStores, &suid, sizeof(suid));
+  if (ppStore == NULL || (*ppStore)->json) {
+    taosThreadMutexUnlock(&pTagStore->lock);
+    return;
+  }
+
+  STagColStore* pStore = *ppStore;
+  int32_t*      pRow = taosHashGet(pStore->pOrdinal, &uid, sizeof(uid));
+  if (pRow != NULL) {
+    *(tb_uid_t*)taosArrayGet(pStore->pUids, *pRow) = 0;
+    taosHashRemove(pStore->pOrdinal, &uid, sizeof(uid));
+    pStore->numOfDropped += 1;
+
+    if (tagStoreNeedRebuild(pStore)) {
+      tagStoreRemove(pMeta, suid, "too many child tables dropped");
+    }
+  }
+
+  taosThreadMutexUnlock(&pTagStore->lock);
+}
+
+// the super table is dropped or its tag schema is altered
+void metaTagStoreDrop(SMeta* pMeta, tb_uid_t suid) {
+  SMetaTagStore* pTagStore = pMeta->pTagStore;
+  taosThreadMutexLock(&pTagStore->lock);
+  tagStoreRemove(pMeta, suid, "super table changed");
+  taosThreadMutexUnlock(&pTagStore->lock);
+}
+
+static int32_t tagStoreFill(STagColStore* pStore, SArray* pUidList, SSDataBlock* pBlock) {
+  int32_t           code = TSDB_CODE_SUCCESS;
+  int32_t           numOfCols = taosArrayGetSize(pBlock->pDataBlock);
+  int32_t           numOfStoreCols = taosArrayGetSize(pStore->pBlock->pDataBlock);
+  SColumnInfoData** pSrcCols = taosMemoryCalloc(numOfCols, POINTER_BYTES);
+  if (pSrcCols == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  // a tag missing in the store is null for all tables, tbname and a tag of another type are not supported
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SColumnInfoData* pDst = taosArrayGet(pBlock->pDataBlock, i);
+    for (int32_t j = 0; j < numOfStoreCols; ++j) {
+      SColumnInfoData* pSrc = taosArrayGet(pStore->pBlock->pDataBlock, j);
+      if (pSrc->info.colId == pDst->info.colId) {
+        pSrcCols[i] = pSrc;
+        break;
+      }
+    }
+
+    if (pDst->info.colId == -1 || (pSrcCols[i] != NULL && pSrcCols[i]->info.type != pDst->info.type)) {
+      code = TSDB_CODE_OPS_NOT_SUPPORT;
+      goto _end;
+    }
+  }
+
+  bool    all = (taosArrayGetSize(pUidList) == 0);
+  int32_t numOfOrdinals = pStore->pBlock->info.rows;
+  int32_t numOfRows = all ? numOfOrdinals - pStore->numOfDropped : taosArrayGetSize(pUidList);
+  if (numOfRows == 0) {
+    goto _end;
+  }
+
+  code = blockDataEnsureCapacity(pBlock, numOfRows);
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _end;
+  }
+
+  if (all && pStore->numOfDropped == 0) {  // copy the whole columns
+    for (int32_t i = 0; i < numOfCols && code == TSDB_CODE_SUCCESS; ++i) {
+      SColumnInfoData* pDst = taosArrayGet(pBlock->pDataBlock, i);
+      if (pSrcCols[i] == NULL) {
+        colDataSetNNULL(pDst, 0, numOfRows);
+      } else {
+        code = colDataAssign(pDst, pSrcCols[i], numOfRows, &pBlock->info);
+      }
+    }
+
+    if (code == TSDB_CODE_SUCCESS && taosArrayAddBatch(pUidList, TARRAY_DATA(pStore->pUids), numOfRows) == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+    }
+  } else {
+    int32_t row = 0;
+    int32_t num = all ? numOfOrdinals : numOfRows;
+    for (int32_t i = 0; i < num && code == TSDB_CODE_SUCCESS; ++i) {
+      int32_t ordinal = -1;
+      if (all) {
+        tb_uid_t uid = *(tb_uid_t*)taosArrayGet(pStore->pUids, i);
+        if (uid == 0) {
+          continue;
+        }
+        ordinal = i;
+        taosArrayPush(pUidList, &uid);
+      } else {
+        int32_t* pOrdinal = taosHashGet(pStore->pOrdinal, taosArrayGet(pUidList, i), sizeof(tb_uid_t));
+        ordinal = (pOrdinal == NULL) ? -1 : *pOrdinal;
+      }
+
+      for (int32_t j = 0; j < numOfCols && code == TSDB_CODE_SUCCESS; ++j) {
+        SColumnInfoData* pDst = taosArrayGet(pBlock->pDataBlock, j);
+        SColumnInfoData* pSrc = pSrcCols[j];
+        if (ordinal < 0 || pSrc == NULL || colDataIsNull_s(pSrc, ordinal)) {
+          colDataSetNULL(pDst, row);
+        } else {
+          code = colDataSetVal(pDst, row, colDataGetData(pSrc, ordinal), false);
+        }
+      }
+      row += 1;
+    }
+  }
+
+  pBlock->info.rows = numOfRows;
+
+_end:
+  taosMemoryFree(pSrcCols);
+  return code;
+}
+
+/*
+ * Fill the tag columns described by pBlock with the tag values of the child tables of the super table. If pUidList is
+ * empty, all the child tables are returned and their uids are added into it, otherwise the rows follow the order of
+ * pUidList and the tables not found are null. TSDB_CODE_OPS_NOT_SUPPORT is returned if the tag store is disabled or
+ * can not serve the columns, the caller should read the tags of each table instead.
+ */
+int32_t metaGetTableTagCols(void* pVnode, uint64_t suid, SArray* pUidList, SSDataBlock* pBlock) {
+  if (!tsTagColumnStore) {
+    return TSDB_CODE_OPS_NOT_SUPPORT;
+  }
+
+  SMeta*         pMeta = ((SVnode*)pVnode)->pMeta;
+  SMetaTagStore* pTagStore = pMeta->pTagStore;
+  int32_t        code = TSDB_CODE_SUCCESS;
+
+  // the meta lock is always taken before the store lock, the same as the update of a child table
+  metaRLock(pMeta);
+  taosThreadMutexLock(&pTagStore->lock);
+
+  STagColStore** ppStore = taosHashGet(pTagStore->pStores, &suid, sizeof(suid));
+  STagColStore*  pStore = (ppStore != NULL) ? *ppStore : NULL;
+  if (pStore == NULL) {
+    code = tagStoreBuild(pMeta, suid, &pStore);
+    if (code == TSDB_CODE_SUCCESS) {
+      code = taosHashPut(pTagStore->pStores, &suid, sizeof(suid), &pStore, POINTER_BYTES);
+      if (code != 0) {
+        tagStoreDestroy(pStore);
+        code = TSDB_CODE_OUT_OF_MEMORY;
+      }
+    }
+  }
+
+  if (code == TSDB_CODE_SUCCESS) {
+    code = pStore->json ? TSDB_CODE_OPS_NOT_SUPPORT : tagStoreFill(pStore, pUidList, pBlock);
+  }
+
+  taosThreadMutexUnlock(&pTagStore->lock);
+  metaULock(pMeta);
+  return code;
+}
@@ -775,6 +775,8 @@ int32_t tqExpandTask(STQ* pTq, SStreamTask* pTask, int64_t nextProcessVer) {
         .pStateBackend = pTask->pState,
         .fillHistory = pTask->info.fillHistory,
         .winRange = pTask->dataRange.window,
+        .subtaskId = pTask->info.subtaskId,
+        .numOfSubtasks = pTask->info.numOfSubtasks,
     };
 
     initStorageAPI(&handle.api);
@@ -1026,6 +1026,25 @@ FAIL:
   return -1;
 }
 
+// take the submit data of the next table as it is, only the column schema of its version is retrieved
+int32_t tqRetrieveTaosxSubmit(STqReader* pReader, SArray* schemas, SSubmitTbData** pSubmitTbDataRet) {
+  SSubmitTbData* pSubmitTbData = taosArrayGet(pReader->submit.aSubmitTbData, pReader->nextBlk);
+  pReader->nextBlk++;
+  pReader->lastBlkUid = pSubmitTbData->uid;
+  *pSubmitTbDataRet = pSubmitTbData;
+
+  SSchemaWrapper* pSW = metaGetTableSchema(pReader->pVnodeMeta, pSubmitTbData->uid, pSubmitTbData->sver, 1);
+  if (pSW == NULL) {
+    tqWarn("vgId:%d, cannot found schema wrapper for table: uid:%" PRId64 ", version %d, possibly dropped table",
+           pReader->pWalReader->pWal->cfg.vgId, pSubmitTbData->uid, pSubmitTbData->sver);
+    terrno = TSDB_CODE_TQ_TABLE_SCHEMA_NOT_FOUND;
+    return -1;
+  }
+
+  taosArrayPush(schemas, &pSW);
+  return 0;
+}
+
 void tqReaderSetColIdList(STqReader* pReader, SArray* pColIdList) { pReader->pColIdList = pColIdList; }
 
 int tqReaderSetTbUidList(STqReader* pReader, const SArray* tbUidList, const char* id) {
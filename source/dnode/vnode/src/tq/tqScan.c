@@ -37,6 +37,50 @@ int32_t tqAddBlockDataToRsp(const SSDataBlock* pBlock, SMqDataRsp* pRsp, int32_t
   return TSDB_CODE_SUCCESS;
 }
 
+// the submit data is shipped as it is, the auto create req is sent in createTableReq of the rsp instead
+static int32_t tqAddSubmitDataToRsp(const SSubmitTbData* pSubmitTbData, SMqDataRsp* pRsp, int32_t* numOfRows) {
+  SSubmitTbData tbData = *pSubmitTbData;
+  tbData.flags &= ~SUBMIT_REQ_AUTO_CREATE_TABLE;
+  tbData.pCreateTbReq = NULL;
+
+  SSubmitReq2 req = {.aSubmitTbData = taosArrayInit(1, sizeof(SSubmitTbData))};
+  if (req.aSubmitTbData == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  taosArrayPush(req.aSubmitTbData, &tbData);
+
+  int32_t  code = TSDB_CODE_SUCCESS;
+  uint32_t len = 0;
+  void*    buf = NULL;
+  tEncodeSize(tEncodeSubmitReq, &req, len, code);
+  if (code >= 0) {
+    buf = taosMemoryMalloc(len);
+    code = (buf == NULL) ? TSDB_CODE_OUT_OF_MEMORY : TSDB_CODE_SUCCESS;
+  }
+  if (code == TSDB_CODE_SUCCESS) {
+    SEncoder encoder = {0};
+    tEncoderInit(&encoder, buf, len);
+    code = tEncodeSubmitReq(&encoder, &req);
+    tEncoderClear(&encoder);
+  }
+  taosArrayDestroy(req.aSubmitTbData);
+  if (code < 0) {
+    taosMemoryFree(buf);
+    return code;
+  }
+
+  int32_t actualLen = len;
+  taosArrayPush(pRsp->blockDataLen, &actualLen);
+  taosArrayPush(pRsp->blockData, &buf);
+
+  if (tbData.flags & SUBMIT_REQ_COLUMN_DATA_FORMAT) {
+    *numOfRows = ((SColData*)TARRAY_DATA(tbData.aCol))->nVal;
+  } else {
+    *numOfRows = TARRAY_SIZE(tbData.aRowP);
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
 static int32_t tqAddBlockSchemaToRsp(const STqExecHandle* pExec, STaosxRsp* pRsp) {
   SSchemaWrapper* pSW = tCloneSSchemaWrapper(pExec->pTqReader->pSchemaWrapper);
   if (pSW == NULL) {
@@ -214,12 +258,14 @@ int32_t tqTaosxScanLog(STQ* pTq, STqHandle* pHandle, SPackedData submit, STaosxR
       taosArrayClear(pBlocks);
       taosArrayClear(pSchemas);
       SSubmitTbData* pSubmitTbDataRet = NULL;
-      if (tqRetrieveTaosxBlock(pReader, pBlocks, pSchemas, &pSubmitTbDataRet) < 0) {
+      if (pRsp->rawSubmit) {
+        if (tqRetrieveTaosxSubmit(pReader, pSchemas, &pSubmitTbDataRet) < 0) goto loop_table;
+      } else if (tqRetrieveTaosxBlock(pReader, pBlocks, pSchemas, &pSubmitTbDataRet) < 0) {
         if (terrno == TSDB_CODE_TQ_TABLE_SCHEMA_NOT_FOUND) goto loop_table;
       }
       if (pRsp->withTbName) {
         int64_t uid = pExec->pTqReader->lastBlkUid;
-        if (tqAddTbNameToRsp(pTq, uid, pRsp, taosArrayGetSize(pBlocks)) < 0) {
+        if (tqAddTbNameToRsp(pTq, uid, pRsp, pRsp->rawSubmit ? 1 : taosArrayGetSize(pBlocks)) < 0) {
           goto loop_table;
         }
       }
@@ -254,6 +300,17 @@ int32_t tqTaosxScanLog(STQ* pTq, STqHandle* pHandle, SPackedData submit, STaosxR
       if (pHandle->fetchMeta == ONLY_META && pSubmitTbDataRet->pCreateTbReq == NULL){
         goto loop_table;
       }
+      if (pRsp->rawSubmit) {
+        int32_t numOfRows = 0;
+        if (tqAddSubmitDataToRsp(pSubmitTbDataRet, (SMqDataRsp*)pRsp, &numOfRows) < 0) {
+          goto loop_table;
+        }
+        *totalRows += numOfRows;
+        SSchemaWrapper* pSW = taosArrayGetP(pSchemas, 0);
+        taosArrayPush(pRsp->blockSchema, &pSW);
+        pRsp->blockNum++;
+        continue;
+      }
       for (int32_t i = 0; i < taosArrayGetSize(pBlocks); i++) {
         SSDataBlock* pBlock = taosArrayGet(pBlocks, i);
         tqAddBlockDataToRsp(pBlock, (SMqDataRsp*)pRsp, taosArrayGetSize(pBlock->pDataBlock),
@@ -278,12 +335,14 @@ int32_t tqTaosxScanLog(STQ* pTq, STqHandle* pHandle, SPackedData submit, STaosxR
       taosArrayClear(pBlocks);
       taosArrayClear(pSchemas);
       SSubmitTbData* pSubmitTbDataRet = NULL;
-      if (tqRetrieveTaosxBlock(pReader, pBlocks, pSchemas, &pSubmitTbDataRet) < 0) {
+      if (pRsp->rawSubmit) {
+        if (tqRetrieveTaosxSubmit(pReader, pSchemas, &pSubmitTbDataRet) < 0) goto loop_db;
+      } else if (tqRetrieveTaosxBlock(pReader, pBlocks, pSchemas, &pSubmitTbDataRet) < 0) {
         if (terrno == TSDB_CODE_TQ_TABLE_SCHEMA_NOT_FOUND) goto loop_db;
       }
       if (pRsp->withTbName) {
         int64_t uid = pExec->pTqReader->lastBlkUid;
-        if (tqAddTbNameToRsp(pTq, uid, pRsp, taosArrayGetSize(pBlocks)) < 0) {
+        if (tqAddTbNameToRsp(pTq, uid, pRsp, pRsp->rawSubmit ? 1 : taosArrayGetSize(pBlocks)) < 0) {
           goto loop_db;
         }
       }
@@ -318,6 +377,17 @@ int32_t tqTaosxScanLog(STQ* pTq, STqHandle* pHandle, SPackedData submit, STaosxR
       if (pHandle->fetchMeta == ONLY_META && pSubmitTbDataRet->pCreateTbReq == NULL){
         goto loop_db;
       }
+      if (pRsp->rawSubmit) {
+        int32_t numOfRows = 0;
+        if (tqAddSubmitDataToRsp(pSubmitTbDataRet, (SMqDataRsp*)pRsp, &numOfRows) < 0) {
+          goto loop_db;
+        }
+        *totalRows += numOfRows;
+        SSchemaWrapper* pSW = taosArrayGetP(pSchemas, 0);
+        taosArrayPush(pRsp->blockSchema, &pSW);
+        pRsp->blockNum++;
+        continue;
+      }
       for (int32_t i = 0; i < taosArrayGetSize(pBlocks); i++) {
         SSDataBlock* pBlock = taosArrayGet(pBlocks, i);
         tqAddBlockDataToRsp(pBlock, (SMqDataRsp*)pRsp, taosArrayGetSize(pBlock->pDataBlock),
@@ -220,6 +220,8 @@ static int32_t extractDataAndRspForDbStbSubscribe(STQ* pTq, STqHandle* pHandle,
   }
 
   if (offset->type == TMQ_OFFSET__LOG) {
+    // the snapshot data above is always sent as retrieved blocks
+    taosxRsp.rawSubmit = pRequest->rawSubmit;
     walReaderVerifyOffset(pHandle->pWalReader, offset);
     int64_t fetchVer = offset->version;
 
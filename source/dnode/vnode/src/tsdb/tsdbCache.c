@@ -87,6 +87,121 @@ static void tsdbCloseBCache(STsdb *pTsdb) {
   }
 }
 
+int32_t tsdbOpenSBCache(STsdb *pTsdb) {
+  if (tsSharedBlockCacheSize <= 0) {
+    pTsdb->sbCache = NULL;
+    return 0;
+  }
+
+  SLRUCache *pCache = taosLRUCacheInit((int64_t)tsSharedBlockCacheSize * 1024 * 1024, 0, .5);
+  if (pCache == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  taosLRUCacheSetStrictCapacity(pCache, false);
+
+  pTsdb->sbLoading = taosHashInit(64, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), true, HASH_ENTRY_LOCK);
+  if (pTsdb->sbLoading == NULL) {
+    taosLRUCacheCleanup(pCache);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  for (int32_t i = 0; i < TSDB_SHARED_BLOCK_LOCKS; ++i) {
+    taosThreadMutexInit(&pTsdb->sbMutex[i], NULL);
+    taosThreadCondInit(&pTsdb->sbCond[i], NULL);
+  }
+
+  pTsdb->sbCache = pCache;
+  return 0;
+}
+
+void tsdbCloseSBCache(STsdb *pTsdb) {
+  SLRUCache *pCache = pTsdb->sbCache;
+  if (pCache) {
+    taosLRUCacheEraseUnrefEntries(pCache);
+    taosLRUCacheCleanup(pCache);
+
+    for (int32_t i = 0; i < TSDB_SHARED_BLOCK_LOCKS; ++i) {
+      taosThreadMutexDestroy(&pTsdb->sbMutex[i]);
+      taosThreadCondDestroy(&pTsdb->sbCond[i]);
+    }
+    taosHashCleanup(pTsdb->sbLoading);
+    pTsdb->sbLoading = NULL;
+    pTsdb->sbCache = NULL;
+  }
+}
+
+// a single reader never finds a block decoded by another one, so the cache is only worth its copies with concurrency
+bool tsdbSharedBlockEnabled(STsdb *pTsdb) {
+  return pTsdb->sbCache != NULL && atomic_load_32(&pTsdb->numOfReaders) > 1;
+}
+
+static void tsdbSharedBlockDeleter(const void *key, size_t klen, void *value, void *ud) {
+  SBlockData *pBlockData = value;
+  tBlockDataDestroy(pBlockData);
+  taosMemoryFree(pBlockData);
+}
+
+// failing to copy the block only costs the waiting readers a load of their own
+static SBlockData *tsdbSharedBlockDup(SBlockData *bData) {
+  SBlockData *pShared = taosMemoryCalloc(1, sizeof(SBlockData));
+  if (pShared != NULL && tBlockDataCopy(bData, pShared) != 0) {
+    tsdbSharedBlockDeleter(NULL, 0, pShared, NULL);
+    pShared = NULL;
+  }
+  return pShared;
+}
+
+/*
+ * Get a decoded data block through the shared block cache. On a miss the first reader registers the key as being
+ * loaded and loads the block by fp into bData without holding any lock, the readers asking for the same block in the
+ * meantime wait on the condition of the key's stripe until the block is published, so that each block is decoded
+ * once. If the load fails, the waiters find neither the block nor the pending key and one of them loads it again.
+ */
+int32_t tsdbSharedBlockGet(STsdb *pTsdb, const void *key, int32_t klen, SBlockData *bData,
+                           int32_t (*fp)(void *param, SBlockData *bData), void *param) {
+  if (!tsdbSharedBlockEnabled(pTsdb)) {
+    return fp(param, bData);
+  }
+
+  SLRUCache     *pCache = pTsdb->sbCache;
+  int32_t        stripe = MurmurHash3_32((const char *)key, klen) % TSDB_SHARED_BLOCK_LOCKS;
+  TdThreadMutex *pMutex = &pTsdb->sbMutex[stripe];
+
+  LRUHandle *h = taosLRUCacheLookup(pCache, key, klen);
+  if (h == NULL) {
+    taosThreadMutexLock(pMutex);
+    while ((h = taosLRUCacheLookup(pCache, key, klen)) == NULL && taosHashGet(pTsdb->sbLoading, key, klen) != NULL) {
+      taosThreadCondWait(&pTsdb->sbCond[stripe], pMutex);
+    }
+    // without the pending key the block is loaded anyway, it is just not deduplicated
+    bool loading = (h == NULL && taosHashPut(pTsdb->sbLoading, key, klen, NULL, 0) == 0);
+    taosThreadMutexUnlock(pMutex);
+
+    if (h == NULL) {
+      int32_t     code = fp(param, bData);
+      SBlockData *pShared = (code == 0) ? tsdbSharedBlockDup(bData) : NULL;
+
+      taosThreadMutexLock(pMutex);
+      if (pShared != NULL) {
+        // the cache owns the block from now on, it is freed by the deleter if it does not fit
+        taosLRUCacheInsert(pCache, key, klen, pShared, tBlockDataSize(pShared), tsdbSharedBlockDeleter, NULL,
+                           TAOS_LRU_PRIORITY_LOW, NULL);
+      }
+      if (loading) {
+        (void)taosHashRemove(pTsdb->sbLoading, key, klen);
+        taosThreadCondBroadcast(&pTsdb->sbCond[stripe]);
+      }
+      taosThreadMutexUnlock(pMutex);
+      return code;
+    }
+  }
+
+  int32_t code = tBlockDataCopy((SBlockData *)taosLRUCacheValue(pCache, h), bData);
+  taosLRUCacheRelease(pCache, h, false);
+  return code;
+}
+
 #define ROCKS_KEY_LEN (sizeof(tb_uid_t) + sizeof(int16_t) + sizeof(int8_t))
 
 typedef struct {
@@ -1191,6 +1306,12 @@ int32_t tsdbOpenCache(STsdb *pTsdb) {
     goto _err;
   }
 
+  code = tsdbOpenSBCache(pTsdb);
+  if (code != TSDB_CODE_SUCCESS) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _err;
+  }
+
   code = tsdbOpenRocksCache(pTsdb);
   if (code != TSDB_CODE_SUCCESS) {
     code = TSDB_CODE_OUT_OF_MEMORY;
@@ -1221,6 +1342,7 @@ void tsdbCloseCache(STsdb *pTsdb) {
 
   tsdbCloseBICache(pTsdb);
   tsdbCloseBCache(pTsdb);
+  tsdbCloseSBCache(pTsdb);
   tsdbCloseRocksCache(pTsdb);
 }
 
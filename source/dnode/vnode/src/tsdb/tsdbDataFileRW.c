@@ -360,12 +360,140 @@ _exit:
   return code;
 }
 
+typedef struct {
+  int32_t fid;
+  int32_t sver;
+  int64_t cid;
+  int64_t offset;
+  int64_t suid;
+  int64_t uid;
+  int32_t ncid;
+  int16_t cids[];
+} SSharedBlockKey;
+
+typedef struct {
+  SDataFileReader   *reader;
+  const SBrinRecord *record;
+  STSchema          *pTSchema;
+  int16_t           *cids;
+  int32_t            ncid;
+} SSharedBlockLoader;
+
+static int32_t tsdbSharedBlockLoad(void *param, SBlockData *bData) {
+  SSharedBlockLoader *pLoader = param;
+  return tsdbDataFileReadBlockDataByColumn(pLoader->reader, pLoader->record, bData, pLoader->pTSchema, pLoader->cids,
+                                           pLoader->ncid);
+}
+
+/*
+ * Read a data block through the decoded block cache of the vnode, so that concurrent queries scanning the same file
+ * blocks with the same columns decode each block once. The key carries the commit id of the data file and the schema
+ * version, a block rewritten by a merge or read with another schema is never served stale.
+ */
+int32_t tsdbDataFileReadBlockDataShared(SDataFileReader *reader, const SBrinRecord *record, SBlockData *bData,
+                                        STSchema *pTSchema, int16_t cids[], int32_t ncid) {
+  STsdb *pTsdb = reader->config->tsdb;
+  if (!tsdbSharedBlockEnabled(pTsdb)) {
+    return tsdbDataFileReadBlockDataByColumn(reader, record, bData, pTSchema, cids, ncid);
+  }
+
+  int32_t code = 0;
+  int32_t lino = 0;
+  int32_t klen = sizeof(SSharedBlockKey) + sizeof(int16_t) * ncid;
+
+  SSharedBlockKey *pKey = taosMemoryCalloc(1, klen);
+  if (pKey == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  pKey->fid = reader->config->files[TSDB_FTYPE_DATA].file.fid;
+  pKey->sver = pTSchema->version;
+  pKey->cid = reader->config->files[TSDB_FTYPE_DATA].file.cid;
+  pKey->offset = record->blockOffset;
+  pKey->suid = record->suid;
+  pKey->uid = record->uid;
+  pKey->ncid = ncid;
+  if (ncid > 0) {
+    memcpy(pKey->cids, cids, sizeof(int16_t) * ncid);
+  }
+
+  SSharedBlockLoader loader = {
+      .reader = reader, .record = record, .pTSchema = pTSchema, .cids = cids, .ncid = ncid};
+  code = tsdbSharedBlockGet(pTsdb, pKey, klen, bData, tsdbSharedBlockLoad, &loader);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+_exit:
+  taosMemoryFree(pKey);
+  if (code) {
+    TSDB_ERROR_LOG(TD_VID(pTsdb->pVnode), lino, code);
+  }
+  return code;
+}
+
+/*
+ * The zone maps of a block follow its column aggregates in the .sma file, one for each fixed length column. A zone map
+ * starts with the negated column id and the rows of a segment, then the null count, max and min of each segment.
+ */
+static bool tsdbIsZoneMap(uint8_t *p) {
+  int16_t cid;
+  tGetI16v(p, &cid);
+  return cid < 0;
+}
+
+static int32_t tPutColumnZoneMap(uint8_t *p, int32_t segRows, int32_t nSeg, SColumnDataAgg *aSeg) {
+  int32_t n = 0;
+
+  n += tPutI16v(p ? p + n : p, -aSeg[0].colId);
+  n += tPutI32v(p ? p + n : p, segRows);
+  for (int32_t iSeg = 0; iSeg < nSeg; iSeg++) {
+    n += tPutI16v(p ? p + n : p, aSeg[iSeg].numOfNull);
+    n += tPutI64(p ? p + n : p, aSeg[iSeg].max);
+    n += tPutI64(p ? p + n : p, aSeg[iSeg].min);
+  }
+
+  return n;
+}
+
+static int32_t tGetColumnZoneMap(uint8_t *p, int32_t numRow, int32_t *segRows, TColumnDataAggArray *aSeg) {
+  int32_t n = 0;
+  int16_t cid;
+
+  n += tGetI16v(p + n, &cid);
+  n += tGetI32v(p + n, segRows);
+  if (*segRows <= 0) {
+    return -1;
+  }
+  for (int32_t iRow = 0; iRow < numRow; iRow += *segRows) {
+    SColumnDataAgg seg = {.colId = -cid};
+
+    n += tGetI16v(p + n, &seg.numOfNull);
+    n += tGetI64(p + n, &seg.max);
+    n += tGetI64(p + n, &seg.min);
+
+    if (TARRAY2_APPEND(aSeg, seg)) {
+      return -1;
+    }
+  }
+
+  return n;
+}
+
+/*
+ * Read the column aggregates of a block. The zone maps behind them come with the same read, they are parsed into
+ * zoneMapArray when it is not NULL and skipped otherwise.
+ */
 int32_t tsdbDataFileReadBlockSma(SDataFileReader *reader, const SBrinRecord *record,
-                                 TColumnDataAggArray *columnDataAggArray) {
+                                 TColumnDataAggArray *columnDataAggArray, int32_t *segRows,
+                                 TColumnDataAggArray *zoneMapArray) {
   int32_t code = 0;
   int32_t lino = 0;
 
   TARRAY2_CLEAR(columnDataAggArray, NULL);
+  if (zoneMapArray) {
+    *segRows = 0;
+    TARRAY2_CLEAR(zoneMapArray, NULL);
+  }
   if (record->smaSize > 0) {
     code = tRealloc(&reader->config->bufArr[0], record->smaSize);
     TSDB_CHECK_CODE(code, lino, _exit);
@@ -373,9 +501,9 @@ int32_t tsdbDataFileReadBlockSma(SDataFileReader *reader, const SBrinRecord *rec
     code = tsdbReadFile(reader->fd[TSDB_FTYPE_SMA], record->smaOffset, reader->config->bufArr[0], record->smaSize);
     TSDB_CHECK_CODE(code, lino, _exit);
 
-    // decode sma data
+    // decode sma data, the zone maps follow
     int32_t size = 0;
-    while (size < record->smaSize) {
+    while (size < record->smaSize && !tsdbIsZoneMap(reader->config->bufArr[0] + size)) {
       SColumnDataAgg sma[1];
 
       size += tGetColumnDataAgg(reader->config->bufArr[0] + size, sma);
@@ -383,7 +511,16 @@ int32_t tsdbDataFileReadBlockSma(SDataFileReader *reader, const SBrinRecord *rec
       code = TARRAY2_APPEND_PTR(columnDataAggArray, sma);
       TSDB_CHECK_CODE(code, lino, _exit);
     }
-    ASSERT(size == record->smaSize);
+
+    while (zoneMapArray && size < record->smaSize) {
+      int32_t n = tGetColumnZoneMap(reader->config->bufArr[0] + size, record->numRow, segRows, zoneMapArray);
+      if (n < 0) {
+        code = (*segRows <= 0) ? TSDB_CODE_FILE_CORRUPTED : TSDB_CODE_OUT_OF_MEMORY;
+        TSDB_CHECK_CODE(code, lino, _exit);
+      }
+      size += n;
+    }
+    ASSERT(size <= record->smaSize);
   }
 
 _exit:
@@ -757,6 +894,47 @@ _exit:
   return code;
 }
 
+static int32_t tsdbDataFileDoWriteBlockZoneMap(SDataFileWriter *writer, SBlockData *bData, SBrinRecord *record) {
+  int32_t segRows = tsZoneMapRows / 8 * 8;
+  if (segRows <= 0 || bData->nRow < segRows * 2) {
+    return 0;
+  }
+
+  int32_t         code = 0;
+  int32_t         lino = 0;
+  int32_t         nSeg = (bData->nRow + segRows - 1) / segRows;
+  SColumnDataAgg *aSeg = taosMemoryMalloc(sizeof(SColumnDataAgg) * nSeg);
+  if (aSeg == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  for (int32_t i = 0; i < bData->nColData; ++i) {
+    SColData *colData = bData->aColData + i;
+    if ((!colData->smaOn) || ((colData->flag & HAS_VALUE) == 0) || IS_VAR_DATA_TYPE(colData->type) ||
+        tColDataCalcSMA[colData->type] == NULL) {
+      continue;
+    }
+
+    tColDataCalcZoneMap(colData, segRows, aSeg);
+
+    int32_t size = tPutColumnZoneMap(NULL, segRows, nSeg, aSeg);
+
+    code = tRealloc(&writer->config->bufArr[0], record->smaSize + size);
+    TSDB_CHECK_CODE(code, lino, _exit);
+
+    tPutColumnZoneMap(writer->config->bufArr[0] + record->smaSize, segRows, nSeg, aSeg);
+    record->smaSize += size;
+  }
+
+_exit:
+  if (code) {
+    TSDB_ERROR_LOG(TD_VID(writer->config->tsdb->pVnode), lino, code);
+  }
+  taosMemoryFree(aSeg);
+  return code;
+}
+
 static int32_t tsdbDataFileDoWriteBlockData(SDataFileWriter *writer, SBlockData *bData) {
   if (bData->nRow == 0) return 0;
 
@@ -830,6 +1008,9 @@ static int32_t tsdbDataFileDoWriteBlockData(SDataFileWriter *writer, SBlockData
     record->smaSize += size;
   }
 
+  code = tsdbDataFileDoWriteBlockZoneMap(writer, bData, record);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
   if (record->smaSize > 0) {
     code = tsdbWriteFile(writer->fd[TSDB_FTYPE_SMA], record->smaOffset, writer->config->bufArr[0], record->smaSize);
     TSDB_CHECK_CODE(code, lino, _exit);
@@ -414,6 +414,7 @@ _exit:
 static int32_t tsdbMergeFileSet(SMerger *merger, STFileSet *fset) {
   int32_t code = 0;
   int32_t lino = 0;
+  int64_t startUs = taosGetTimestampUs();
 
   merger->ctx->fset = fset;
   code = tsdbMergeFileSetBegin(merger);
@@ -471,6 +472,7 @@ _exit:
   if (code) {
     tsdbError("vgId:%d %s failed at line %d since %s", TD_VID(merger->tsdb->pVnode), __func__, lino, tstrerror(code));
   } else {
+    METRICS_OBSERVE_SINCE(merger->tsdb->pVnode->metrics.pMergeUs, startUs);
     tsdbDebug("vgId:%d %s done, fid:%d", TD_VID(merger->tsdb->pVnode), __func__, fset->fid);
   }
   return code;
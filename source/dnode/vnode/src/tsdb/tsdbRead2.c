@@ -1072,8 +1072,8 @@ static int32_t doLoadFileBlockData(STsdbReader* pReader, SDataBlockIter* pBlockI
   SFileBlockDumpInfo* pDumpInfo = &pReader->status.fBlockDumpInfo;
 
   SBrinRecord* pRecord = &pBlockInfo->record;
-  code = tsdbDataFileReadBlockDataByColumn(pReader->pFileReader, pRecord, pBlockData, pSchema, &pSup->colId[1],
-                                           pSup->numOfCols - 1);
+  code = tsdbDataFileReadBlockDataShared(pReader->pFileReader, pRecord, pBlockData, pSchema, &pSup->colId[1],
+                                         pSup->numOfCols - 1);
   if (code != TSDB_CODE_SUCCESS) {
     tsdbError("%p error occurs in loading file block, global index:%d, table index:%d, brange:%" PRId64 "-%" PRId64
               ", rows:%d, code:%s %s",
@@ -1082,6 +1082,7 @@ static int32_t doLoadFileBlockData(STsdbReader* pReader, SDataBlockIter* pBlockI
     return code;
   }
 
+  METRICS_OBSERVE_SINCE(pReader->pTsdb->pVnode->metrics.pBlockReadUs, st);
   double elapsedTime = (taosGetTimestampUs() - st) / 1000.0;
 
   tsdbDebug("%p load file block into buffer, global index:%d, index in table block list:%d, brange:%" PRId64 "-%" PRId64
@@ -3901,6 +3902,8 @@ int32_t tsdbReaderOpen2(void* pVnode, SQueryTableDataCond* pCond, void* pTableLi
 
   // check for query time window
   STsdbReader* pReader = *ppReader;
+  pReader->counted = true;
+  atomic_add_fetch_32(&pReader->pTsdb->numOfReaders, 1);
   if (isEmptyQueryTimeWindow(&pReader->info.window) && pCond->type == TIMEWINDOW_RANGE_CONTAINED) {
     tsdbDebug("%p query window not overlaps with the data set, no result returned, %s", pReader, pReader->idStr);
     return TSDB_CODE_SUCCESS;
@@ -4034,6 +4037,8 @@ void tsdbReaderClose2(STsdbReader* pReader) {
 
   SBlockLoadSuppInfo* pSupInfo = &pReader->suppInfo;
   TARRAY2_DESTROY(&pSupInfo->colAggArray, NULL);
+  TARRAY2_DESTROY(&pSupInfo->zoneMapArray, NULL);
+  taosMemoryFreeClear(pSupInfo->pZoneMapAgg);
   for (int32_t i = 0; i < pSupInfo->numOfCols; ++i) {
     if (pSupInfo->buildBuf[i] != NULL) {
       taosMemoryFreeClear(pSupInfo->buildBuf[i]);
@@ -4097,6 +4102,9 @@ void tsdbReaderClose2(STsdbReader* pReader) {
   taosMemoryFree(pReader->info.pSchema);
 
   tSimpleHashCleanup(pReader->pSchemaMap);
+  if (pReader->counted) {
+    atomic_sub_fetch_32(&pReader->pTsdb->numOfReaders, 1);
+  }
   taosMemoryFreeClear(pReader);
 }
 
@@ -4496,6 +4504,10 @@ int32_t tsdbRetrieveDatablockSMA2(STsdbReader* pReader, SSDataBlock* pDataBlock,
   *allHave = false;
   *pBlockSMA = NULL;
 
+  // the zone maps only describe the block whose SMA was loaded last
+  TARRAY2_CLEAR(&pReader->suppInfo.zoneMapArray, NULL);
+  pReader->suppInfo.zoneMapSegRows = 0;
+
   if (pReader->type == TIMEWINDOW_RANGE_EXTERNAL) {
     return TSDB_CODE_SUCCESS;
   }
@@ -4516,7 +4528,8 @@ int32_t tsdbRetrieveDatablockSMA2(STsdbReader* pReader, SSDataBlock* pDataBlock,
   //  int64_t st = taosGetTimestampUs();
   TARRAY2_CLEAR(&pSup->colAggArray, 0);
 
-  code = tsdbDataFileReadBlockSma(pReader->pFileReader, &pFBlock->record, &pSup->colAggArray);
+  code = tsdbDataFileReadBlockSma(pReader->pFileReader, &pFBlock->record, &pSup->colAggArray, &pSup->zoneMapSegRows,
+                                  (tsZoneMapRows > 0) ? &pSup->zoneMapArray : NULL);
   if (code != TSDB_CODE_SUCCESS) {
     tsdbDebug("vgId:%d, failed to load block SMA for uid %" PRIu64 ", code:%s, %s", 0, pFBlock->uid, tstrerror(code),
               pReader->idStr);
@@ -4577,6 +4590,66 @@ int32_t tsdbRetrieveDatablockSMA2(STsdbReader* pReader, SSDataBlock* pDataBlock,
   return code;
 }
 
+int32_t tsdbRetrieveDatablockZoneMap2(STsdbReader* pReader, SSDataBlock* pDataBlock, int32_t* segRows,
+                                      int32_t* numOfSegs, SColumnDataAgg*** pSegAgg) {
+  SBlockLoadSuppInfo* pSup = &pReader->suppInfo;
+  int32_t             code = 0;
+
+  *segRows = 0;
+  *numOfSegs = 0;
+  *pSegAgg = NULL;
+
+  // the zone maps describe the whole file block, like the block SMA
+  if (pReader->type == TIMEWINDOW_RANGE_EXTERNAL || pReader->status.composedDataBlock || (!pSup->smaValid)) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  // the zone maps were parsed from the .sma read of tsdbRetrieveDatablockSMA2, nothing is read here
+  SFileDataBlockInfo* pFBlock = getCurrentBlockInfo(&pReader->status.blockIter);
+  SSDataBlock*        pResBlock = pReader->resBlockInfo.pResBlock;
+  if (pResBlock->info.id.uid != pFBlock->uid || pResBlock->info.rows != pFBlock->record.numRow ||
+      TARRAY2_SIZE(&pSup->zoneMapArray) == 0) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  *segRows = pSup->zoneMapSegRows;
+  int32_t numOfSlots = taosArrayGetSize(pDataBlock->pDataBlock);
+  int32_t nSeg = (pFBlock->record.numRow + *segRows - 1) / *segRows;
+  int32_t size = nSeg * numOfSlots;
+  if (size > pSup->zoneMapAggSize) {
+    SColumnDataAgg** p = taosMemoryRealloc(pSup->pZoneMapAgg, size * POINTER_BYTES);
+    if (p == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    pSup->pZoneMapAgg = p;
+    pSup->zoneMapAggSize = size;
+  }
+  memset(pSup->pZoneMapAgg, 0, size * POINTER_BYTES);
+
+  // the zone maps are stored column by column in the column id order, as the loaded columns are
+  int32_t j = 0;
+  for (int32_t i = 0; i < TARRAY2_SIZE(&pSup->zoneMapArray); i += nSeg) {
+    SColumnDataAgg* pSeg = TARRAY2_GET_PTR(&pSup->zoneMapArray, i);
+    while (j < pSup->numOfCols && pSup->colId[j] < pSeg->colId) {
+      j += 1;
+    }
+    if (j >= pSup->numOfCols) {
+      break;
+    }
+    if (pSup->colId[j] != pSeg->colId) {
+      continue;
+    }
+
+    for (int32_t iSeg = 0; iSeg < nSeg; ++iSeg) {
+      pSup->pZoneMapAgg[iSeg * numOfSlots + pSup->slotId[j]] = pSeg + iSeg;
+    }
+  }
+
+  *numOfSegs = nSeg;
+  *pSegAgg = pSup->pZoneMapAgg;
+  return code;
+}
+
 static SSDataBlock* doRetrieveDataBlock(STsdbReader* pReader) {
   SReaderStatus*      pStatus = &pReader->status;
   int32_t             code = TSDB_CODE_SUCCESS;
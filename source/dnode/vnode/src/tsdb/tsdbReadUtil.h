@@ -132,6 +132,10 @@ typedef struct SBlockOrderSupporter {
 
 typedef struct SBlockLoadSuppInfo {
   TColumnDataAggArray colAggArray;
+  TColumnDataAggArray zoneMapArray;  // zone maps read along with the block SMA, empty when the block has none
+  int32_t             zoneMapSegRows;
+  SColumnDataAgg**    pZoneMapAgg;  // zone maps of the current block, segment by segment, each in the slot order
+  int32_t             zoneMapAggSize;
   SColumnDataAgg      tsColAgg;
   int16_t*            colId;
   int16_t*            slotId;
@@ -216,6 +220,7 @@ struct STsdbReader {
   SBlockInfoBuf      blockInfoBuf;
   EContentData       step;
   STsdbReader*       innerReader[2];
+  bool               counted;  // counted in pTsdb->numOfReaders, the inner readers are not
 };
 
 typedef struct SBrinRecordIter {
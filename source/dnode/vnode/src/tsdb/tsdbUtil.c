@@ -1167,6 +1167,96 @@ void tBlockDataClear(SBlockData *pBlockData) {
   }
 }
 
+static int32_t tBlockDataCopyArray(uint8_t **ppTo, const void *pFrom, int64_t size) {
+  if (pFrom == NULL || size == 0) {
+    return 0;
+  }
+
+  int32_t code = tRealloc(ppTo, size);
+  if (code) return code;
+
+  memcpy(*ppTo, pFrom, size);
+  return 0;
+}
+
+static int32_t tColDataCopyTo(SColData *pFrom, SColData *pTo) {
+  int32_t  code = 0;
+  uint8_t *pBitMap = pTo->pBitMap;
+  int32_t *aOffset = pTo->aOffset;
+  uint8_t *pData = pTo->pData;
+
+  // keep the buffers of the destination, so that copying to the same block over and over does not allocate
+  *pTo = *pFrom;
+  pTo->pBitMap = pBitMap;
+  pTo->aOffset = aOffset;
+  pTo->pData = pData;
+
+  int64_t szBitMap = 0;
+  switch (pFrom->flag) {
+    case (HAS_NULL | HAS_NONE):
+    case (HAS_VALUE | HAS_NONE):
+    case (HAS_VALUE | HAS_NULL):
+      szBitMap = BIT1_SIZE(pFrom->nVal);
+      break;
+    case (HAS_VALUE | HAS_NULL | HAS_NONE):
+      szBitMap = BIT2_SIZE(pFrom->nVal);
+      break;
+    default:
+      break;
+  }
+
+  code = tBlockDataCopyArray(&pTo->pBitMap, pFrom->pBitMap, szBitMap);
+  if (code) return code;
+
+  if (IS_VAR_DATA_TYPE(pFrom->type) && (pFrom->flag & HAS_VALUE)) {
+    code = tBlockDataCopyArray((uint8_t **)&pTo->aOffset, pFrom->aOffset, sizeof(int32_t) * pFrom->nVal);
+    if (code) return code;
+  }
+
+  return tBlockDataCopyArray(&pTo->pData, pFrom->pData, pFrom->nData);
+}
+
+int32_t tBlockDataCopy(SBlockData *pBlockDataFrom, SBlockData *pBlockDataTo) {
+  int32_t code = 0;
+  int32_t nRow = pBlockDataFrom->nRow;
+
+  code = tBlockDataAdjustColData(pBlockDataTo, pBlockDataFrom->nColData);
+  if (code) goto _exit;
+
+  pBlockDataTo->suid = pBlockDataFrom->suid;
+  pBlockDataTo->uid = pBlockDataFrom->uid;
+  pBlockDataTo->nRow = nRow;
+
+  code = tBlockDataCopyArray((uint8_t **)&pBlockDataTo->aUid, pBlockDataFrom->aUid, sizeof(int64_t) * nRow);
+  if (code) goto _exit;
+  code = tBlockDataCopyArray((uint8_t **)&pBlockDataTo->aVersion, pBlockDataFrom->aVersion, sizeof(int64_t) * nRow);
+  if (code) goto _exit;
+  code = tBlockDataCopyArray((uint8_t **)&pBlockDataTo->aTSKEY, pBlockDataFrom->aTSKEY, sizeof(TSKEY) * nRow);
+  if (code) goto _exit;
+
+  for (int32_t iColData = 0; iColData < pBlockDataFrom->nColData; iColData++) {
+    code = tColDataCopyTo(&pBlockDataFrom->aColData[iColData], &pBlockDataTo->aColData[iColData]);
+    if (code) goto _exit;
+  }
+
+_exit:
+  return code;
+}
+
+// memory held by the rows of the block, the spare capacity of the buffers is not counted
+int64_t tBlockDataSize(SBlockData *pBlockData) {
+  int64_t size = sizeof(SBlockData) + sizeof(SColData) * pBlockData->nColData;
+  size += (sizeof(int64_t) * 2 + sizeof(TSKEY)) * pBlockData->nRow;
+  for (int32_t iColData = 0; iColData < pBlockData->nColData; iColData++) {
+    SColData *pColData = &pBlockData->aColData[iColData];
+    size += pColData->nData + BIT2_SIZE(pColData->nVal);
+    if (IS_VAR_DATA_TYPE(pColData->type)) {
+      size += sizeof(int32_t) * pColData->nVal;
+    }
+  }
+  return size;
+}
+
 /* flag > 0: forward update
  * flag == 0: insert
  * flag < 0: backward update
@@ -1538,6 +1628,27 @@ int32_t tGetColumnDataAgg(uint8_t *p, SColumnDataAgg *pColAgg) {
   return n;
 }
 
+// The min/max and null count of every segRows rows of a fixed length column. The segments are views on the column
+// data, so segRows must be a multiple of 8 to keep the bitmap of each segment byte aligned.
+void tColDataCalcZoneMap(SColData *pColData, int32_t segRows, SColumnDataAgg *aSeg) {
+  ASSERT(segRows > 0 && segRows % 8 == 0 && !IS_VAR_DATA_TYPE(pColData->type));
+
+  int32_t bytes = tDataTypes[pColData->type].bytes;
+  for (int32_t iStart = 0, iSeg = 0; iStart < pColData->nVal; iStart += segRows, iSeg++) {
+    SColData seg = *pColData;
+    seg.nVal = TMIN(segRows, pColData->nVal - iStart);
+    seg.pData = pColData->pData + (int64_t)iStart * bytes;
+    if (pColData->flag == (HAS_VALUE | HAS_NULL | HAS_NONE)) {
+      seg.pBitMap = pColData->pBitMap + iStart / 4;
+    } else if (pColData->flag != HAS_VALUE) {
+      seg.pBitMap = pColData->pBitMap + iStart / 8;
+    }
+
+    aSeg[iSeg].colId = pColData->cid;
+    tColDataCalcSMA[pColData->type](&seg, &aSeg[iSeg].sum, &aSeg[iSeg].max, &aSeg[iSeg].min, &aSeg[iSeg].numOfNull);
+  }
+}
+
 int32_t tsdbCmprData(uint8_t *pIn, int32_t szIn, int8_t type, int8_t cmprAlg, uint8_t **ppOut, int32_t nOut,
                      int32_t *szOut, uint8_t **ppBuf) {
   int32_t code = 0;
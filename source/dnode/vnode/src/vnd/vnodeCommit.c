@@ -428,6 +428,7 @@ static int vnodeCommitImpl(SCommitInfo *pInfo) {
 
   char    dir[TSDB_FILENAME_LEN] = {0};
   SVnode *pVnode = pInfo->pVnode;
+  int64_t startUs = taosGetTimestampUs();
 
   vInfo("vgId:%d, start to commit, commitId:%" PRId64 " version:%" PRId64 " term: %" PRId64, TD_VID(pVnode),
         pInfo->info.state.commitID, pInfo->info.state.committed, pInfo->info.state.commitTerm);
@@ -492,6 +493,7 @@ _exit:
   if (code) {
     vError("vgId:%d, %s failed at line %d since %s", TD_VID(pVnode), __func__, lino, tstrerror(code));
   } else {
+    METRICS_OBSERVE_SINCE(pVnode->metrics.pCommitUs, startUs);
     vInfo("vgId:%d, commit end", TD_VID(pVnode));
   }
   return 0;
@@ -85,6 +85,10 @@ int vnodeInit(int nthreads) {
   if (s3Init() < 0) {
     return -1;
   }
+  if (tsS3Enabled) {
+    SStreamChkpStoreOps ops = {.putFp = s3PutObjectFromFile, .getFp = s3Get, .delFp = s3DeleteObjects};
+    streamChkpStoreSetRemote(&ops);
+  }
 
   return 0;
 }
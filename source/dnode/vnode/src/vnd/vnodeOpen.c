@@ -321,6 +321,28 @@ static int32_t vnodeCheckDisk(int32_t diskPrimary, STfs *pTfs) {
   return 0;
 }
 
+static void vnodeInitMetrics(SVnode *pVnode) {
+  SVMetrics *pMetrics = &pVnode->metrics;
+  char       labels[32];
+  snprintf(labels, sizeof(labels), "vgId=\"%d\"", TD_VID(pVnode));
+
+  pMetrics->pInsertUs =
+      taosMetricsAcquire(METRIC_HISTOGRAM, "taosd_tsdb_insert_us", "memtable insert of a table", labels);
+  pMetrics->pCommitUs = taosMetricsAcquire(METRIC_HISTOGRAM, "taosd_vnode_commit_us", "duration of a commit", labels);
+  pMetrics->pMergeUs = taosMetricsAcquire(METRIC_HISTOGRAM, "taosd_tsdb_merge_us", "duration of a file merge", labels);
+  pMetrics->pBlockReadUs =
+      taosMetricsAcquire(METRIC_HISTOGRAM, "taosd_tsdb_block_read_us", "read of a data block from file", labels);
+}
+
+static void vnodeCleanupMetrics(SVnode *pVnode) {
+  SVMetrics *pMetrics = &pVnode->metrics;
+  taosMetricsRelease(pMetrics->pInsertUs);
+  taosMetricsRelease(pMetrics->pCommitUs);
+  taosMetricsRelease(pMetrics->pMergeUs);
+  taosMetricsRelease(pMetrics->pBlockReadUs);
+  memset(pMetrics, 0, sizeof(*pMetrics));
+}
+
 SVnode *vnodeOpen(const char *path, int32_t diskPrimary, STfs *pTfs, SMsgCb msgCb) {
   SVnode    *pVnode = NULL;
   SVnodeInfo info = {0};
@@ -377,6 +399,7 @@ SVnode *vnodeOpen(const char *path, int32_t diskPrimary, STfs *pTfs, SMsgCb msgC
   pVnode->pTfs = pTfs;
   pVnode->diskPrimary = diskPrimary;
   pVnode->msgCb = msgCb;
+  vnodeInitMetrics(pVnode);
   taosThreadMutexInit(&pVnode->lock, NULL);
   pVnode->blocked = false;
 
@@ -473,6 +496,7 @@ _err:
   if (pVnode->freeList) vnodeCloseBufPool(pVnode);
 
   tsem_destroy(&(pVnode->canCommit));
+  vnodeCleanupMetrics(pVnode);
   taosMemoryFree(pVnode);
   return NULL;
 }
@@ -503,6 +527,7 @@ void vnodeClose(SVnode *pVnode) {
     taosThreadCondDestroy(&pVnode->poolNotEmpty);
     taosThreadMutexDestroy(&pVnode->mutex);
     taosThreadMutexDestroy(&pVnode->lock);
+    vnodeCleanupMetrics(pVnode);
     taosMemoryFree(pVnode);
   }
 }
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <map>
+
+#include "metaTagStoreTestUtil.h"
+
+namespace {
+
+const int64_t kSuid = 100;
+
+class MetaTagStoreTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    mtsEnableTagStore(true);
+    pVnode = mtsOpen("/tmp/metaTagStoreTest");
+    ASSERT_NE(pVnode, nullptr);
+    ASSERT_EQ(mtsCreateSuperTable(pVnode, kSuid, version++, false), 0);
+  }
+
+  void TearDown() override {
+    mtsClose(pVnode);
+    mtsEnableTagStore(false);
+  }
+
+  // t1 of all the child tables, by uid
+  std::map<int64_t, int32_t> getAll() {
+    int64_t uids[64] = {0};
+    int32_t t1[64] = {0};
+    bool    isNull[64] = {0};
+    int32_t num = 0;
+
+    std::map<int64_t, int32_t> res;
+    EXPECT_EQ(mtsGetT1(pVnode, kSuid, uids, &num, t1, isNull, false, false), 0);
+    for (int32_t i = 0; i < num; ++i) {
+      EXPECT_FALSE(isNull[i]);
+      res[uids[i]] = t1[i];
+    }
+    return res;
+  }
+
+  void   *pVnode = nullptr;
+  int64_t version = 1;
+};
+
+}  // namespace
+
+TEST_F(MetaTagStoreTest, build) {
+  for (int64_t uid = 1; uid <= 10; ++uid) {
+    ASSERT_EQ(mtsPutChildTable(pVnode, kSuid, uid, version++, (int32_t)uid * 10, "abc"), 0);
+  }
+
+  std::map<int64_t, int32_t> res = getAll();
+  ASSERT_EQ(res.size(), 10);
+  for (int64_t uid = 1; uid <= 10; ++uid) {
+    ASSERT_EQ(res[uid], uid * 10);
+  }
+
+  // the rows follow the given uids, an unknown table is null
+  int64_t uids[3] = {7, 999, 2};
+  int32_t t1[3] = {0};
+  bool    isNull[3] = {0};
+  int32_t num = 3;
+  ASSERT_EQ(mtsGetT1(pVnode, kSuid, uids, &num, t1, isNull, false, false), 0);
+  ASSERT_EQ(num, 3);
+  ASSERT_EQ(t1[0], 70);
+  ASSERT_TRUE(isNull[1]);
+  ASSERT_EQ(t1[2], 20);
+}
+
+TEST_F(MetaTagStoreTest, update) {
+  for (int64_t uid = 1; uid <= 4; ++uid) {
+    ASSERT_EQ(mtsPutChildTable(pVnode, kSuid, uid, version++, 1, "abc"), 0);
+  }
+  ASSERT_EQ(getAll().size(), 4);
+
+  // created after the store is built
+  ASSERT_EQ(mtsPutChildTable(pVnode, kSuid, 5, version++, 5, "abc"), 0);
+  // altered tag
+  ASSERT_EQ(mtsAlterChildTableT1(pVnode, 2, version++, 20), 0);
+  // written again by a snapshot
+  ASSERT_EQ(mtsPutChildTable(pVnode, kSuid, 3, version++, 30, "xyz"), 0);
+
+  std::map<int64_t, int32_t> res = getAll();
+  ASSERT_EQ(res.size(), 5);
+  ASSERT_EQ(res[1], 1);
+  ASSERT_EQ(res[2], 20);
+  ASSERT_EQ(res[3], 30);
+  ASSERT_EQ(res[4], 1);
+  ASSERT_EQ(res[5], 5);
+}
+
+TEST_F(MetaTagStoreTest, drop) {
+  for (int64_t uid = 1; uid <= 4; ++uid) {
+    ASSERT_EQ(mtsPutChildTable(pVnode, kSuid, uid, version++, (int32_t)uid, "abc"), 0);
+  }
+  ASSERT_EQ(getAll().size(), 4);
+
+  ASSERT_EQ(mtsDropChildTable(pVnode, 2, version++), 0);
+  std::map<int64_t, int32_t> res = getAll();
+  ASSERT_EQ(res.size(), 3);
+  ASSERT_EQ(res.count(2), 0);
+  ASSERT_EQ(res[4], 4);
+
+  // the super table written by a snapshot drops the store, it is built again
+  ASSERT_EQ(mtsCreateSuperTable(pVnode, kSuid, version++, false), 0);
+  ASSERT_EQ(mtsPutChildTable(pVnode, kSuid, 6, version++, 6, "abc"), 0);
+  res = getAll();
+  ASSERT_EQ(res.size(), 4);
+  ASSERT_EQ(res[6], 6);
+}
+
+// the caller reads the tags of each table when the store can not serve the columns
+TEST_F(MetaTagStoreTest, notSupported) {
+  ASSERT_EQ(mtsPutChildTable(pVnode, kSuid, 1, version++, 1, "abc"), 0);
+
+  int64_t uids[4] = {0};
+  int32_t t1[4] = {0};
+  bool    isNull[4] = {0};
+  int32_t num = 0;
+  ASSERT_NE(mtsGetT1(pVnode, kSuid, uids, &num, t1, isNull, true, false), 0);
+  ASSERT_NE(mtsGetT1(pVnode, kSuid, uids, &num, t1, isNull, false, true), 0);
+
+  const int64_t jsonSuid = 200;
+  ASSERT_EQ(mtsCreateSuperTable(pVnode, jsonSuid, version++, true), 0);
+  ASSERT_NE(mtsGetT1(pVnode, jsonSuid, uids, &num, t1, isNull, false, false), 0);
+
+  mtsEnableTagStore(false);
+  ASSERT_NE(mtsGetT1(pVnode, kSuid, uids, &num, t1, isNull, false, false), 0);
+}
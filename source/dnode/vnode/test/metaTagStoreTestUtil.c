@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// meta.h does not compile as C++, the test drives the tag store through these helpers
+#include "meta.h"
+#include "metaTagStoreTestUtil.h"
+
+#define MTS_T1_CID 3
+#define MTS_T2_CID 4
+
+void *mtsOpen(const char *dir) {
+  SVnode *pVnode = taosMemoryCalloc(1, sizeof(SVnode));
+  if (pVnode == NULL) {
+    return NULL;
+  }
+
+  taosRemoveDir(dir);
+  taosMkDir(dir);
+  pVnode->path = taosStrdup(dir);
+  pVnode->config.vgId = 1;
+  pVnode->config.szPage = 4096;
+  pVnode->config.szCache = 256;
+
+  if (metaOpen(pVnode, &pVnode->pMeta, 0) < 0 || metaBegin(pVnode->pMeta, META_BEGIN_HEAP_OS) < 0) {
+    mtsClose(pVnode);
+    return NULL;
+  }
+  return pVnode;
+}
+
+void mtsClose(void *pVnode) {
+  SVnode *p = pVnode;
+  if (p->pMeta) {
+    metaClose(&p->pMeta);
+  }
+  taosRemoveDir(p->path);
+  taosMemoryFree(p->path);
+  taosMemoryFree(p);
+}
+
+void mtsEnableTagStore(bool enable) { tsTagColumnStore = enable; }
+
+int32_t mtsCreateSuperTable(void *pVnode, int64_t suid, int64_t version, bool json) {
+  SSchema cols[] = {
+      {.type = TSDB_DATA_TYPE_TIMESTAMP, .colId = 1, .bytes = 8, .name = "ts"},
+      {.type = TSDB_DATA_TYPE_INT, .colId = 2, .bytes = 4, .name = "c1"},
+  };
+  SSchema tags[] = {
+      {.type = TSDB_DATA_TYPE_INT, .colId = MTS_T1_CID, .bytes = 4, .name = "t1"},
+      {.type = TSDB_DATA_TYPE_VARCHAR, .colId = MTS_T2_CID, .bytes = 16 + VARSTR_HEADER_SIZE, .name = "t2"},
+  };
+  SSchema jsonTag = {.type = TSDB_DATA_TYPE_JSON, .colId = MTS_T1_CID, .bytes = TSDB_MAX_JSON_TAG_LEN, .name = "t1"};
+
+  char name[TSDB_TABLE_NAME_LEN];
+  snprintf(name, sizeof(name), "st%" PRId64, suid);
+
+  SMetaEntry me = {.version = version, .type = TSDB_SUPER_TABLE, .uid = suid, .name = name};
+  me.stbEntry.schemaRow = (SSchemaWrapper){.version = 1, .nCols = 2, .pSchema = cols};
+  me.stbEntry.schemaTag = json ? (SSchemaWrapper){.version = 1, .nCols = 1, .pSchema = &jsonTag}
+                               : (SSchemaWrapper){.version = 1, .nCols = 2, .pSchema = tags};
+  return metaHandleEntry(((SVnode *)pVnode)->pMeta, &me);
+}
+
+int32_t mtsPutChildTable(void *pVnode, int64_t suid, int64_t uid, int64_t version, int32_t t1, const char *t2) {
+  SArray *pTagVals = taosArrayInit(2, sizeof(STagVal));
+  STag   *pTag = NULL;
+  if (pTagVals == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  STagVal v1 = {.cid = MTS_T1_CID, .type = TSDB_DATA_TYPE_INT};
+  memcpy(&v1.i64, &t1, sizeof(t1));
+  taosArrayPush(pTagVals, &v1);
+  if (t2 != NULL) {
+    STagVal v2 = {.cid = MTS_T2_CID, .type = TSDB_DATA_TYPE_VARCHAR, .pData = (uint8_t *)t2, .nData = strlen(t2)};
+    taosArrayPush(pTagVals, &v2);
+  }
+
+  int32_t code = tTagNew(pTagVals, 1, false, &pTag);
+  taosArrayDestroy(pTagVals);
+  if (code != 0) {
+    return code;
+  }
+
+  char name[TSDB_TABLE_NAME_LEN];
+  snprintf(name, sizeof(name), "ct%" PRId64, uid);
+
+  SMetaEntry me = {.version = version, .type = TSDB_CHILD_TABLE, .uid = uid, .name = name};
+  me.ctbEntry.btime = taosGetTimestampMs();
+  me.ctbEntry.suid = suid;
+  me.ctbEntry.pTags = (uint8_t *)pTag;
+  code = metaHandleEntry(((SVnode *)pVnode)->pMeta, &me);
+  tTagFree(pTag);
+  return code;
+}
+
+int32_t mtsAlterChildTableT1(void *pVnode, int64_t uid, int64_t version, int32_t t1) {
+  char name[TSDB_TABLE_NAME_LEN];
+  snprintf(name, sizeof(name), "ct%" PRId64, uid);
+
+  SVAlterTbReq req = {.tbName = name,
+                      .action = TSDB_ALTER_TABLE_UPDATE_TAG_VAL,
+                      .tagName = "t1",
+                      .tagType = TSDB_DATA_TYPE_INT,
+                      .nTagVal = sizeof(t1),
+                      .pTagVal = (uint8_t *)&t1};
+  return metaAlterTable(((SVnode *)pVnode)->pMeta, version, &req, NULL);
+}
+
+int32_t mtsDropChildTable(void *pVnode, int64_t uid, int64_t version) {
+  char name[TSDB_TABLE_NAME_LEN];
+  snprintf(name, sizeof(name), "ct%" PRId64, uid);
+
+  SVDropTbReq req = {.name = name};
+  return metaDropTable(((SVnode *)pVnode)->pMeta, version, &req, NULL, NULL);
+}
+
+int32_t mtsGetT1(void *pVnode, int64_t suid, int64_t *uids, int32_t *numOfTables, int32_t *t1, bool *isNull,
+                 bool asBigint, bool withTbname) {
+  SArray      *pUidList = taosArrayInit(8, sizeof(uint64_t));
+  SSDataBlock *pBlock = createDataBlock();
+  int32_t      code = TSDB_CODE_SUCCESS;
+  if (pUidList == NULL || pBlock == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _end;
+  }
+
+  SColumnInfoData colInfo = asBigint ? createColumnInfoData(TSDB_DATA_TYPE_BIGINT, 8, MTS_T1_CID)
+                                     : createColumnInfoData(TSDB_DATA_TYPE_INT, 4, MTS_T1_CID);
+  blockDataAppendColInfo(pBlock, &colInfo);
+  if (withTbname) {
+    SColumnInfoData tbname = createColumnInfoData(TSDB_DATA_TYPE_VARCHAR, TSDB_TABLE_NAME_LEN, -1);
+    blockDataAppendColInfo(pBlock, &tbname);
+  }
+
+  for (int32_t i = 0; i < *numOfTables; ++i) {
+    taosArrayPush(pUidList, &uids[i]);
+  }
+
+  code = metaGetTableTagCols(pVnode, suid, pUidList, pBlock);
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _end;
+  }
+
+  SColumnInfoData *pCol = taosArrayGet(pBlock->pDataBlock, 0);
+  *numOfTables = pBlock->info.rows;
+  for (int32_t i = 0; i < pBlock->info.rows; ++i) {
+    uids[i] = *(int64_t *)taosArrayGet(pUidList, i);
+    isNull[i] = colDataIsNull_s(pCol, i);
+    t1[i] = isNull[i] ? 0 : *(int32_t *)colDataGetData(pCol, i);
+  }
+
+_end:
+  taosArrayDestroy(pUidList);
+  blockDataDestroy(pBlock);
+  return code;
+}
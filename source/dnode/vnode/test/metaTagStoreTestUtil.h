@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TD_META_TAG_STORE_TEST_UTIL_H_
+#define _TD_META_TAG_STORE_TEST_UTIL_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// a vnode with only the meta opened in dir, the super tables have the tags t1 int and t2 varchar(16)
+void   *mtsOpen(const char *dir);
+void    mtsClose(void *pVnode);
+void    mtsEnableTagStore(bool enable);
+int32_t mtsCreateSuperTable(void *pVnode, int64_t suid, int64_t version, bool json);
+
+// create the child table, or write it again the way a snapshot does
+int32_t mtsPutChildTable(void *pVnode, int64_t suid, int64_t uid, int64_t version, int32_t t1, const char *t2);
+int32_t mtsAlterChildTableT1(void *pVnode, int64_t uid, int64_t version, int32_t t1);
+int32_t mtsDropChildTable(void *pVnode, int64_t uid, int64_t version);
+
+/*
+ * Read t1 of the child tables through the tag store. If *numOfTables is 0 all the child tables are returned in uids,
+ * otherwise the tables in uids are read and the ones not found are null. Reading t1 as bigint or reading tbname as
+ * well is not supported by the tag store.
+ */
+int32_t mtsGetT1(void *pVnode, int64_t suid, int64_t *uids, int32_t *numOfTables, int32_t *t1, bool *isNull,
+                 bool asBigint, bool withTbname);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*_TD_META_TAG_STORE_TEST_UTIL_H_*/
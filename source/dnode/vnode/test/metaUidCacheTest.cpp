@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "metaTagStoreTestUtil.h"
+#include "metaUidCacheTestUtil.h"
+
+namespace {
+
+const int64_t kSuid = 100;
+const int32_t kCond = 1;
+
+struct CachedList {
+  bool                 acquired = false;
+  int64_t              ver = 0;
+  std::vector<int64_t> uids;
+  std::vector<int64_t> changed;
+};
+
+class MetaUidCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    mucEnableTagFilterCache(true);
+    pVnode = mtsOpen("/tmp/metaUidCacheTest");
+    ASSERT_NE(pVnode, nullptr);
+    ASSERT_EQ(mtsCreateSuperTable(pVnode, kSuid, version++, false), 0);
+  }
+
+  void TearDown() override {
+    mtsClose(pVnode);
+    mucEnableTagFilterCache(false);
+  }
+
+  CachedList get(bool patch) {
+    int64_t uids[64] = {0};
+    int64_t changed[64] = {0};
+    int32_t numOfUids = 0;
+    int32_t numOfChanged = 0;
+
+    CachedList res;
+    EXPECT_EQ(mucGet(pVnode, kSuid, kCond, patch, uids, &numOfUids, changed, &numOfChanged, &res.ver, &res.acquired),
+              0);
+    res.uids.assign(uids, uids + numOfUids);
+    res.changed.assign(changed, changed + numOfChanged);
+    return res;
+  }
+
+  void put(const std::vector<int64_t> &uids, int64_t ver) {
+    ASSERT_EQ(mucPut(pVnode, kSuid, kCond, uids.data(), (int32_t)uids.size(), ver), 0);
+  }
+
+  void   *pVnode = nullptr;
+  int64_t version = 1;
+};
+
+}  // namespace
+
+TEST_F(MetaUidCacheTest, patchCreatedAndDropped) {
+  ASSERT_EQ(mucCreateChildTable(pVnode, kSuid, 11, version++), 0);
+  ASSERT_EQ(mucCreateChildTable(pVnode, kSuid, 12, version++), 0);
+
+  CachedList res = get(true);
+  ASSERT_FALSE(res.acquired);
+  put({11, 12}, res.ver);
+
+  res = get(false);
+  ASSERT_TRUE(res.acquired);
+  ASSERT_EQ(res.uids, std::vector<int64_t>({11, 12}));
+
+  // a created table is returned to be filtered again, the list is stale until it is put back
+  ASSERT_EQ(mucCreateChildTable(pVnode, kSuid, 13, version++), 0);
+  ASSERT_FALSE(get(false).acquired);
+
+  res = get(true);
+  ASSERT_TRUE(res.acquired);
+  ASSERT_EQ(res.uids, std::vector<int64_t>({11, 12}));
+  ASSERT_EQ(res.changed, std::vector<int64_t>({13}));
+  put({11, 12, 13}, res.ver);
+
+  res = get(false);
+  ASSERT_TRUE(res.acquired);
+  ASSERT_EQ(res.uids, std::vector<int64_t>({11, 12, 13}));
+
+  // a dropped table is only taken out, the patched list is put back by the cache itself
+  ASSERT_EQ(mtsDropChildTable(pVnode, 12, version++), 0);
+  res = get(true);
+  ASSERT_TRUE(res.acquired);
+  ASSERT_EQ(res.uids, std::vector<int64_t>({11, 13}));
+  ASSERT_TRUE(res.changed.empty());
+
+  res = get(false);
+  ASSERT_TRUE(res.acquired);
+  ASSERT_EQ(res.uids, std::vector<int64_t>({11, 13}));
+}
+
+TEST_F(MetaUidCacheTest, changedWhileFiltering) {
+  ASSERT_EQ(mucCreateChildTable(pVnode, kSuid, 11, version++), 0);
+
+  // nothing is cached to be patched when a table is created while filtering, the list computed is given up
+  CachedList miss = get(true);
+  ASSERT_FALSE(miss.acquired);
+  ASSERT_EQ(mucCreateChildTable(pVnode, kSuid, 12, version++), 0);
+  put({11}, miss.ver);
+
+  miss = get(true);
+  ASSERT_FALSE(miss.acquired);
+  put({11, 12}, miss.ver);
+
+  // the list is stamped with the version seen before filtering, a table created in the meanwhile is patched
+  ASSERT_EQ(mucCreateChildTable(pVnode, kSuid, 13, version++), 0);
+  CachedList res = get(true);
+  ASSERT_TRUE(res.acquired);
+  ASSERT_EQ(res.changed, std::vector<int64_t>({13}));
+  ASSERT_EQ(mucCreateChildTable(pVnode, kSuid, 14, version++), 0);
+  put({11, 12, 13}, res.ver);
+
+  ASSERT_FALSE(get(false).acquired);
+  res = get(true);
+  ASSERT_TRUE(res.acquired);
+  ASSERT_EQ(res.uids, std::vector<int64_t>({11, 12, 13}));
+  ASSERT_EQ(res.changed, std::vector<int64_t>({14}));
+
+  // an older list never replaces a newer one
+  put({11, 12}, miss.ver);
+  res = get(true);
+  ASSERT_EQ(res.uids, std::vector<int64_t>({11, 12, 13}));
+  ASSERT_EQ(res.changed, std::vector<int64_t>({14}));
+}
+
+TEST_F(MetaUidCacheTest, saveAndLoad) {
+  ASSERT_EQ(mucCreateChildTable(pVnode, kSuid, 11, version++), 0);
+  ASSERT_EQ(mucCreateChildTable(pVnode, kSuid, 12, version++), 0);
+
+  CachedList res = get(true);
+  ASSERT_FALSE(res.acquired);
+  put({11, 12}, res.ver);
+
+  ASSERT_EQ(mucReopen(pVnode, 0), 0);
+  res = get(false);
+  ASSERT_TRUE(res.acquired);
+  ASSERT_EQ(res.uids, std::vector<int64_t>({11, 12}));
+
+  // the loaded list is patched as usual
+  ASSERT_EQ(mucCreateChildTable(pVnode, kSuid, 13, version++), 0);
+  res = get(true);
+  ASSERT_TRUE(res.acquired);
+  ASSERT_EQ(res.uids, std::vector<int64_t>({11, 12}));
+  ASSERT_EQ(res.changed, std::vector<int64_t>({13}));
+}
+
+TEST_F(MetaUidCacheTest, outdatedNotLoaded) {
+  ASSERT_EQ(mucCreateChildTable(pVnode, kSuid, 11, version++), 0);
+
+  CachedList res = get(true);
+  ASSERT_FALSE(res.acquired);
+  put({11}, res.ver);
+
+  // saved at the committed version 0, there is something replayed from the wal if opened at another one
+  ASSERT_EQ(mucReopen(pVnode, 10), 0);
+  ASSERT_FALSE(get(false).acquired);
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// meta.h does not compile as C++, the test drives the tag filter uid list cache through these helpers
+#include "meta.h"
+#include "metaUidCacheTestUtil.h"
+
+#define MUC_T1_CID 3
+
+void mucEnableTagFilterCache(bool enable) { tsTagFilterCache = enable; }
+
+// the uncommitted tables are thrown away, only the saved uid lists are expected to survive
+int32_t mucReopen(void *pVnode, int64_t committed) {
+  SVnode *p = pVnode;
+  metaAbort(p->pMeta);
+  metaClose(&p->pMeta);
+
+  p->state.applied = committed;
+  p->state.committed = committed;
+  if (metaOpen(p, &p->pMeta, 0) < 0 || metaBegin(p->pMeta, META_BEGIN_HEAP_OS) < 0) {
+    return -1;
+  }
+  return 0;
+}
+
+int32_t mucCreateChildTable(void *pVnode, int64_t suid, int64_t uid, int64_t version) {
+  SArray *pTagVals = taosArrayInit(1, sizeof(STagVal));
+  STag   *pTag = NULL;
+  if (pTagVals == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  int32_t t1 = (int32_t)uid;
+  STagVal v1 = {.cid = MUC_T1_CID, .type = TSDB_DATA_TYPE_INT};
+  memcpy(&v1.i64, &t1, sizeof(t1));
+  taosArrayPush(pTagVals, &v1);
+
+  int32_t code = tTagNew(pTagVals, 1, false, &pTag);
+  taosArrayDestroy(pTagVals);
+  if (code != 0) {
+    return code;
+  }
+
+  char name[TSDB_TABLE_NAME_LEN];
+  char stbName[TSDB_TABLE_NAME_LEN];
+  snprintf(name, sizeof(name), "ct%" PRId64, uid);
+  snprintf(stbName, sizeof(stbName), "st%" PRId64, suid);
+
+  SVCreateTbReq req = {.name = name, .uid = uid, .btime = taosGetTimestampMs(), .type = TSDB_CHILD_TABLE};
+  req.ctb.stbName = stbName;
+  req.ctb.suid = suid;
+  req.ctb.pTag = (uint8_t *)pTag;
+  code = metaCreateTable(((SVnode *)pVnode)->pMeta, version, &req, NULL);
+  tTagFree(pTag);
+  return code;
+}
+
+static void mucDigest(int32_t cond, uint8_t *digest) {
+  memset(digest, 0, 16);
+  memcpy(digest, &cond, sizeof(cond));
+}
+
+int32_t mucGet(void *pVnode, int64_t suid, int32_t cond, bool patch, int64_t *uids, int32_t *numOfUids, int64_t *changed,
+               int32_t *numOfChanged, int64_t *ver, bool *acquired) {
+  uint8_t digest[16];
+  mucDigest(cond, digest);
+
+  SArray *pList = taosArrayInit(8, sizeof(uint64_t));
+  SArray *pChangedList = taosArrayInit(8, sizeof(uint64_t));
+  int32_t code = TSDB_CODE_SUCCESS;
+  if (pList == NULL || pChangedList == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _end;
+  }
+
+  code = metaGetCachedTableUidList(pVnode, suid, digest, sizeof(digest), pList, patch ? pChangedList : NULL, ver,
+                                   acquired);
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _end;
+  }
+
+  *numOfUids = taosArrayGetSize(pList);
+  for (int32_t i = 0; i < *numOfUids; ++i) {
+    uids[i] = *(int64_t *)taosArrayGet(pList, i);
+  }
+
+  *numOfChanged = taosArrayGetSize(pChangedList);
+  for (int32_t i = 0; i < *numOfChanged; ++i) {
+    changed[i] = *(int64_t *)taosArrayGet(pChangedList, i);
+  }
+
+_end:
+  taosArrayDestroy(pList);
+  taosArrayDestroy(pChangedList);
+  return code;
+}
+
+int32_t mucPut(void *pVnode, int64_t suid, int32_t cond, const int64_t *uids, int32_t numOfUids, int64_t ver) {
+  uint8_t digest[16];
+  mucDigest(cond, digest);
+
+  int32_t size = sizeof(int32_t) + numOfUids * sizeof(uint64_t);
+  char   *pPayload = taosMemoryMalloc(size);
+  if (pPayload == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  *(int32_t *)pPayload = numOfUids;
+  memcpy(pPayload + sizeof(int32_t), uids, numOfUids * sizeof(uint64_t));
+  return metaUidFilterCachePut(pVnode, suid, digest, sizeof(digest), pPayload, size, ver, 0);
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TD_META_UID_CACHE_TEST_UTIL_H_
+#define _TD_META_UID_CACHE_TEST_UTIL_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// the vnode is opened and the super tables are created by the helpers of metaTagStoreTestUtil.h
+void mucEnableTagFilterCache(bool enable);
+
+// close and open the meta again, it is opened at the committed version given
+int32_t mucReopen(void *pVnode, int64_t committed);
+
+// create the child table the way a create table request does, t1 is set to uid
+int32_t mucCreateChildTable(void *pVnode, int64_t suid, int64_t uid, int64_t version);
+
+/*
+ * Acquire the uid list cached for the tag condition identified by cond. Only an up to date list is returned unless
+ * patch is set, in which case a stale list is returned with the changed tables to be filtered again.
+ */
+int32_t mucGet(void *pVnode, int64_t suid, int32_t cond, bool patch, int64_t *uids, int32_t *numOfUids, int64_t *changed,
+               int32_t *numOfChanged, int64_t *ver, bool *acquired);
+int32_t mucPut(void *pVnode, int64_t suid, int32_t cond, const int64_t *uids, int32_t numOfUids, int64_t ver);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*_TD_META_UID_CACHE_TEST_UTIL_H_*/
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "tsdbSharedBlockTestUtil.h"
+
+class TsdbSharedBlockTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    pTsdb = sbtOpen(1);
+    ASSERT_NE(pTsdb, nullptr);
+    // the cache is bypassed with a single reader
+    sbtSetReaders(pTsdb, 2);
+  }
+
+  void TearDown() override { sbtClose(pTsdb); }
+
+  void *pTsdb = nullptr;
+};
+
+TEST_F(TsdbSharedBlockTest, hitAndMiss) {
+  int32_t loadsA = 0, loadsB = 0;
+  bool    valid = false;
+
+  // miss, loaded and published
+  ASSERT_EQ(sbtGetBlock(pTsdb, 1, 100, &loadsA, &valid), 0);
+  ASSERT_TRUE(valid);
+  ASSERT_EQ(loadsA, 1);
+
+  // hit, copied from the cache
+  ASSERT_EQ(sbtGetBlock(pTsdb, 1, 100, &loadsA, &valid), 0);
+  ASSERT_TRUE(valid);
+  ASSERT_EQ(loadsA, 1);
+
+  // another block misses
+  ASSERT_EQ(sbtGetBlock(pTsdb, 2, 200, &loadsB, &valid), 0);
+  ASSERT_TRUE(valid);
+  ASSERT_EQ(loadsB, 1);
+
+  ASSERT_EQ(sbtGetBlock(pTsdb, 1, 100, &loadsA, &valid), 0);
+  ASSERT_TRUE(valid);
+  ASSERT_EQ(loadsA, 1);
+}
+
+TEST_F(TsdbSharedBlockTest, bypassSingleReader) {
+  int32_t loads = 0;
+  bool    valid = false;
+
+  sbtSetReaders(pTsdb, 1);
+  ASSERT_EQ(sbtGetBlock(pTsdb, 1, 100, &loads, &valid), 0);
+  ASSERT_EQ(sbtGetBlock(pTsdb, 1, 100, &loads, &valid), 0);
+  ASSERT_TRUE(valid);
+  ASSERT_EQ(loads, 2);
+
+  // nothing was published while bypassed
+  sbtSetReaders(pTsdb, 2);
+  ASSERT_EQ(sbtGetBlock(pTsdb, 1, 100, &loads, &valid), 0);
+  ASSERT_EQ(loads, 3);
+}
+
+TEST_F(TsdbSharedBlockTest, eviction) {
+  // about 480KB each, the 1MB cache holds two of them
+  const int32_t nRow = 20000;
+  int32_t       loadsA = 0, loadsB = 0, loadsC = 0;
+  bool          valid = false;
+
+  ASSERT_EQ(sbtGetBlock(pTsdb, 1, nRow, &loadsA, &valid), 0);
+  ASSERT_EQ(sbtGetBlock(pTsdb, 2, nRow, &loadsB, &valid), 0);
+  ASSERT_EQ(sbtGetBlock(pTsdb, 1, nRow, &loadsA, &valid), 0);
+  ASSERT_EQ(loadsA, 1);
+  ASSERT_EQ(loadsB, 1);
+
+  // the third block evicts the least recently used one
+  ASSERT_EQ(sbtGetBlock(pTsdb, 3, nRow, &loadsC, &valid), 0);
+  ASSERT_EQ(loadsC, 1);
+  ASSERT_EQ(sbtGetBlock(pTsdb, 1, nRow, &loadsA, &valid), 0);
+  ASSERT_EQ(loadsA, 1);
+  ASSERT_EQ(sbtGetBlock(pTsdb, 2, nRow, &loadsB, &valid), 0);
+  ASSERT_TRUE(valid);
+  ASSERT_EQ(loadsB, 2);
+}
+
+TEST_F(TsdbSharedBlockTest, concurrentMissLoadsOnce) {
+  int32_t loads = 0;
+  bool    valid = false;
+
+  // the readers arriving while the first one decodes the block wait for it instead of decoding it again
+  ASSERT_EQ(sbtGetBlockConcurrently(pTsdb, 1, 100, 8, 100, &loads, &valid), 0);
+  ASSERT_TRUE(valid);
+  ASSERT_EQ(loads, 1);
+
+  ASSERT_EQ(sbtGetBlockConcurrently(pTsdb, 1, 100, 8, 100, &loads, &valid), 0);
+  ASSERT_TRUE(valid);
+  ASSERT_EQ(loads, 1);
+}
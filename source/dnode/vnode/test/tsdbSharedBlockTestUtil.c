@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// tsdb.h does not compile as C++, the test drives the shared block cache through these helpers
+#include "tsdb.h"
+#include "tsdbSharedBlockTestUtil.h"
+
+typedef struct {
+  int64_t uid;
+  int32_t nRow;
+  int32_t numOfLoads;
+  int32_t loadMs;
+} SSbtBlock;
+
+static int32_t sbtLoadBlock(void *param, SBlockData *bData) {
+  SSbtBlock *pBlock = param;
+  atomic_add_fetch_32(&pBlock->numOfLoads, 1);
+  if (pBlock->loadMs > 0) {
+    taosMsleep(pBlock->loadMs);
+  }
+
+  bData->suid = 1;
+  bData->uid = pBlock->uid;
+  bData->nRow = pBlock->nRow;
+  if (tRealloc((uint8_t **)&bData->aVersion, sizeof(int64_t) * pBlock->nRow) ||
+      tRealloc((uint8_t **)&bData->aTSKEY, sizeof(TSKEY) * pBlock->nRow)) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  for (int32_t i = 0; i < pBlock->nRow; ++i) {
+    bData->aVersion[i] = pBlock->uid;
+    bData->aTSKEY[i] = pBlock->uid * 1000000 + i;
+  }
+  return 0;
+}
+
+void *sbtOpen(int32_t cacheSizeMB) {
+  STsdb *pTsdb = taosMemoryCalloc(1, sizeof(STsdb));
+  if (pTsdb == NULL) {
+    return NULL;
+  }
+
+  int32_t size = tsSharedBlockCacheSize;
+  tsSharedBlockCacheSize = cacheSizeMB;
+  int32_t code = tsdbOpenSBCache(pTsdb);
+  tsSharedBlockCacheSize = size;
+  if (code != 0 || pTsdb->sbCache == NULL) {
+    taosMemoryFree(pTsdb);
+    return NULL;
+  }
+  return pTsdb;
+}
+
+void sbtClose(void *pTsdb) {
+  tsdbCloseSBCache(pTsdb);
+  taosMemoryFree(pTsdb);
+}
+
+void sbtSetReaders(void *pTsdb, int32_t numOfReaders) { ((STsdb *)pTsdb)->numOfReaders = numOfReaders; }
+
+int32_t sbtGetBlock(void *pTsdb, int64_t uid, int32_t nRow, int32_t *pNumOfLoads, bool *pValid) {
+  SSbtBlock  block = {.uid = uid, .nRow = nRow, .numOfLoads = 0};
+  SBlockData bData = {0};
+  tBlockDataCreate(&bData);
+
+  int32_t code = tsdbSharedBlockGet(pTsdb, &uid, sizeof(uid), &bData, sbtLoadBlock, &block);
+
+  *pNumOfLoads += block.numOfLoads;
+  *pValid = (code == 0 && bData.uid == uid && bData.nRow == nRow);
+  for (int32_t i = 0; *pValid && i < nRow; ++i) {
+    *pValid = (bData.aTSKEY[i] == uid * 1000000 + i && bData.aVersion[i] == uid);
+  }
+
+  tBlockDataDestroy(&bData);
+  return code;
+}
+
+typedef struct {
+  void      *pTsdb;
+  SSbtBlock *pBlock;
+  bool       valid;
+} SSbtReader;
+
+static void *sbtReaderThread(void *param) {
+  SSbtReader *pReader = param;
+  SBlockData  bData = {0};
+  tBlockDataCreate(&bData);
+
+  int32_t code = tsdbSharedBlockGet(pReader->pTsdb, &pReader->pBlock->uid, sizeof(int64_t), &bData, sbtLoadBlock,
+                                    pReader->pBlock);
+  pReader->valid = (code == 0 && bData.uid == pReader->pBlock->uid && bData.nRow == pReader->pBlock->nRow);
+
+  tBlockDataDestroy(&bData);
+  return NULL;
+}
+
+int32_t sbtGetBlockConcurrently(void *pTsdb, int64_t uid, int32_t nRow, int32_t numOfReaders, int32_t loadMs,
+                                int32_t *pNumOfLoads, bool *pValid) {
+  SSbtBlock   block = {.uid = uid, .nRow = nRow, .numOfLoads = 0, .loadMs = loadMs};
+  SSbtReader *pReaders = taosMemoryCalloc(numOfReaders, sizeof(SSbtReader));
+  TdThread   *pThreads = taosMemoryCalloc(numOfReaders, sizeof(TdThread));
+  if (pReaders == NULL || pThreads == NULL) {
+    taosMemoryFree(pReaders);
+    taosMemoryFree(pThreads);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  for (int32_t i = 0; i < numOfReaders; ++i) {
+    pReaders[i] = (SSbtReader){.pTsdb = pTsdb, .pBlock = &block, .valid = false};
+    taosThreadCreate(&pThreads[i], NULL, sbtReaderThread, &pReaders[i]);
+  }
+
+  *pValid = true;
+  for (int32_t i = 0; i < numOfReaders; ++i) {
+    taosThreadJoin(pThreads[i], NULL);
+    *pValid = *pValid && pReaders[i].valid;
+  }
+  *pNumOfLoads += block.numOfLoads;
+
+  taosMemoryFree(pReaders);
+  taosMemoryFree(pThreads);
+  return 0;
+}
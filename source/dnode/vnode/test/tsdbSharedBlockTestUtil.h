@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TD_TSDB_SHARED_BLOCK_TEST_UTIL_H_
+#define _TD_TSDB_SHARED_BLOCK_TEST_UTIL_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// a tsdb with only the shared block cache opened
+void *sbtOpen(int32_t cacheSizeMB);
+void  sbtClose(void *pTsdb);
+void  sbtSetReaders(void *pTsdb, int32_t numOfReaders);
+
+// get the block of uid with nRow rows through the cache, loads are counted in *pNumOfLoads
+int32_t sbtGetBlock(void *pTsdb, int64_t uid, int32_t nRow, int32_t *pNumOfLoads, bool *pValid);
+
+// get the block of uid from numOfReaders threads at once, each load of the block takes loadMs
+int32_t sbtGetBlockConcurrently(void *pTsdb, int64_t uid, int32_t nRow, int32_t numOfReaders, int32_t loadMs,
+                                int32_t *pNumOfLoads, bool *pValid);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*_TD_TSDB_SHARED_BLOCK_TEST_UTIL_H_*/
@@ -138,6 +138,7 @@ typedef struct SCtgCacheStat {
   uint64_t cacheSize[CTG_CI_MAX_VALUE];
   uint64_t cacheHit[CTG_CI_MAX_VALUE];
   uint64_t cacheNHit[CTG_CI_MAX_VALUE];
+  uint64_t cacheEvict[CTG_CI_MAX_VALUE];
 } SCtgCacheStat;
 
 typedef struct SCtgAuthReq {
@@ -245,6 +246,7 @@ typedef STableIndexRsp STableIndex;
 typedef struct SCtgTbCache {
   SRWLatch     metaLock;
   SRWLatch     indexLock;
+  int8_t       accessed;  // referenced since the last clear round, evicted in the next round otherwise
   STableMeta*  pMeta;
   STableIndex* pIndex;
 } SCtgTbCache;
@@ -582,6 +584,7 @@ typedef struct SCtgCacheItemInfo {
 #define CTG_CACHE_NUM_DEC(item, n)  (CTG_STAT_DEC(pCtg->cacheStat.cacheNum[item], n))
 #define CTG_CACHE_HIT_INC(item, n)  (CTG_STAT_INC(pCtg->cacheStat.cacheHit[item], n))
 #define CTG_CACHE_NHIT_INC(item, n) (CTG_STAT_INC(pCtg->cacheStat.cacheNHit[item], n))
+#define CTG_CACHE_EVICT_INC(item, n) (CTG_STAT_INC(pCtg->cacheStat.cacheEvict[item], n))
 
 #define CTG_DB_NUM_INC(_item)   dbCache->dbCacheNum[_item] += 1
 #define CTG_DB_NUM_DEC(_item)   dbCache->dbCacheNum[_item] -= 1
@@ -651,8 +654,31 @@ typedef struct SCtgCacheItemInfo {
     }                                                 \
   } while (0)
 
+#define CTG_META_EVICT_INC(type)                        \
+  do {                                                  \
+    switch (type) {                                     \
+      case TSDB_SUPER_TABLE:                            \
+        CTG_CACHE_EVICT_INC(CTG_CI_STABLE_META, 1);     \
+        break;                                          \
+      case TSDB_CHILD_TABLE:                            \
+        CTG_CACHE_EVICT_INC(CTG_CI_CTABLE_META, 1);     \
+        break;                                          \
+      case TSDB_NORMAL_TABLE:                           \
+        CTG_CACHE_EVICT_INC(CTG_CI_NTABLE_META, 1);     \
+        break;                                          \
+      case TSDB_SYSTEM_TABLE:                           \
+        CTG_CACHE_EVICT_INC(CTG_CI_SYSTABLE_META, 1);   \
+        break;                                          \
+      default:                                          \
+        CTG_CACHE_EVICT_INC(CTG_CI_OTHERTABLE_META, 1); \
+        break;                                          \
+    }                                                   \
+  } while (0)
+
 #define CTG_META_NHIT_INC() CTG_CACHE_NHIT_INC(CTG_CI_OTHERTABLE_META, 1)
 
+#define CTG_TB_CACHE_TOUCH(_cache) atomic_store_8(&(_cache)->accessed, 1)
+
 #define CTG_IS_META_NULL(type)   ((type) == META_TYPE_NULL_TABLE)
 #define CTG_IS_META_CTABLE(type) ((type) == META_TYPE_CTABLE)
 #define CTG_IS_META_TABLE(type)  ((type) == META_TYPE_TABLE)
@@ -999,8 +1025,8 @@ uint64_t ctgGetTbMetaCacheSize(STableMeta *pMeta);
 uint64_t ctgGetDbVgroupCacheSize(SDBVgInfo *pVg);
 uint64_t ctgGetUserCacheSize(SGetUserAuthRsp *pAuth);
 uint64_t ctgGetClusterCacheSize(SCatalog *pCtg);
-void     ctgClearHandleMeta(SCatalog* pCtg, int64_t *pClearedSize, int64_t *pCleardNum, bool *roundDone);
-void     ctgClearAllHandleMeta(int64_t *clearedSize, int64_t *clearedNum, bool *roundDone);
+void     ctgClearHandleMeta(SCatalog* pCtg, int64_t *pClearedSize, int64_t *pCleardNum, int64_t *pSkippedNum, bool *roundDone);
+void     ctgClearAllHandleMeta(int64_t *clearedSize, int64_t *clearedNum, int64_t *skippedNum, bool *roundDone);
 void     ctgProcessTimerEvent(void *param, void *tmrId);
 
 int32_t ctgGetTbMeta(SCatalog* pCtg, SRequestConnInfo* pConn, SCtgTbMetaCtx* ctx, STableMeta** pTableMeta);
@@ -1667,6 +1667,42 @@ int32_t catalogClearCache(void) {
   CTG_API_LEAVE_NOLOCK(code);
 }
 
+int32_t catalogGetCacheStats(SCatalogCacheStat* pStat) {
+  CTG_API_ENTER();
+
+  memset(pStat, 0, sizeof(*pStat));
+  if (NULL == gCtgMgmt.pCluster) {
+    CTG_API_LEAVE(TSDB_CODE_SUCCESS);
+  }
+
+  void* pIter = taosHashIterate(gCtgMgmt.pCluster, NULL);
+  while (pIter) {
+    SCatalog* pCtg = *(SCatalog**)pIter;
+    if (pCtg) {
+      for (int32_t i = CTG_CI_STABLE_META; i <= CTG_CI_OTHERTABLE_META; ++i) {
+        pStat->tbMetaHit += atomic_load_64(&pCtg->cacheStat.cacheHit[i]);
+        pStat->tbMetaNHit += atomic_load_64(&pCtg->cacheStat.cacheNHit[i]);
+        pStat->tbMetaEvict += atomic_load_64(&pCtg->cacheStat.cacheEvict[i]);
+      }
+
+      void* pDbIter = taosHashIterate(pCtg->dbCache, NULL);
+      while (pDbIter) {
+        SCtgDBCache* dbCache = pDbIter;
+        for (int32_t i = CTG_CI_STABLE_META; i <= CTG_CI_OTHERTABLE_META; ++i) {
+          pStat->tbMetaNum += atomic_load_64(&dbCache->dbCacheNum[i]);
+        }
+        pDbIter = taosHashIterate(pCtg->dbCache, pDbIter);
+      }
+    }
+
+    pIter = taosHashIterate(gCtgMgmt.pCluster, pIter);
+  }
+
+  ctgGetGlobalCacheSize(&pStat->cacheSize);
+
+  CTG_API_LEAVE(TSDB_CODE_SUCCESS);
+}
+
 void catalogDestroy(void) {
   qInfo("start to destroy catalog");
 
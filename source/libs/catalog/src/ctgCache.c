@@ -257,6 +257,7 @@ int32_t ctgAcquireTbMetaFromCache(SCatalog *pCtg, char *dbFName, char *tbName, S
   ctgDebug("tb %s meta got in cache, dbFName:%s", tbName, dbFName);
 
   CTG_META_HIT_INC(pCache->pMeta->tableType);
+  CTG_TB_CACHE_TOUCH(pCache);
 
   return TSDB_CODE_SUCCESS;
 
@@ -314,6 +315,7 @@ int32_t ctgAcquireVgMetaFromCache(SCatalog *pCtg, const char *dbFName, const cha
   ctgDebug("tb %s meta got in cache, dbFName:%s", tbName, dbFName);
 
   CTG_META_HIT_INC(tbCache->pMeta->tableType);
+  CTG_TB_CACHE_TOUCH(tbCache);
 
   return TSDB_CODE_SUCCESS;
 
@@ -420,6 +422,7 @@ int32_t ctgAcquireStbMetaFromCache(SCtgDBCache *dbCache, SCatalog *pCtg, char *d
   ctgDebug("stb 0x%" PRIx64 " meta got in cache, dbFName:%s", suid, dbFName);
 
   CTG_META_HIT_INC(pCache->pMeta->tableType);
+  CTG_TB_CACHE_TOUCH(pCache);
 
   return TSDB_CODE_SUCCESS;
 
@@ -1675,6 +1678,7 @@ int32_t ctgWriteTbMetaToCache(SCatalog *pCtg, SCtgDBCache *dbCache, char *dbFNam
   if (NULL == pCache) {
     SCtgTbCache cache = {0};
     cache.pMeta = meta;
+    cache.accessed = 1;
     if (taosHashPut(dbCache->tbCache, tbName, strlen(tbName), &cache, sizeof(SCtgTbCache)) != 0) {
       ctgError("taosHashPut new tbCache failed, dbFName:%s, tbName:%s, tbType:%d", dbFName, tbName, meta->tableType);
       taosMemoryFree(meta);
@@ -2453,16 +2457,19 @@ void ctgClearMetaCache(SCtgCacheOperation *operation) {
   SCatalog          *pCtg = msg->pCtg;
   int64_t            clearedSize = 0;
   int64_t            clearedNum = 0;
+  int64_t            skippedNum = 0;
   int64_t            remainSize = 0;
   bool               roundDone = false;
 
   if (pCtg) {
-    ctgClearHandleMeta(pCtg, &clearedSize, &clearedNum, &roundDone);
+    ctgClearHandleMeta(pCtg, &clearedSize, &clearedNum, &skippedNum, &roundDone);
   } else {
-    ctgClearAllHandleMeta(&clearedSize, &clearedNum, &roundDone);
+    ctgClearAllHandleMeta(&clearedSize, &clearedNum, &skippedNum, &roundDone);
   }
 
-  qDebug("catalog finish one round meta clear, clearedSize:%" PRId64 ", clearedNum:%" PRId64 ", done:%d", clearedSize, clearedNum, roundDone);
+  qDebug("catalog finish one round meta clear, clearedSize:%" PRId64 ", clearedNum:%" PRId64 ", skippedNum:%" PRId64
+         ", done:%d",
+         clearedSize, clearedNum, skippedNum, roundDone);
 
   ctgGetGlobalCacheSize(&remainSize);
   int32_t cacheMaxSize = atomic_load_32(&tsMetaCacheMaxSize);
@@ -2473,7 +2480,8 @@ void ctgClearMetaCache(SCtgCacheOperation *operation) {
     return;
   }
 
-  if (!roundDone) {
+  // the recently referenced tables skipped in this round are evicted in the next round before the whole handle
+  if (!roundDone && 0 == skippedNum) {
     qDebug("catalog all meta cleared, remainSize:%" PRId64 ", cacheMaxSize:%dMB, to clear handle", remainSize, cacheMaxSize);
     ctgClearFreeCache(operation);
     taosTmrReset(ctgProcessTimerEvent, CTG_DEFAULT_CACHE_MON_MSEC, NULL, gCtgMgmt.timer, &gCtgMgmt.cacheTimer);
@@ -2798,6 +2806,7 @@ int32_t ctgGetTbMetasFromCache(SCatalog *pCtg, SRequestConnInfo *pConn, SCtgTbMe
     STableMeta *tbMeta = pCache->pMeta;
 
     CTG_META_HIT_INC(tbMeta->tableType);
+    CTG_TB_CACHE_TOUCH(pCache);
 
     SCtgTbMetaCtx nctx = {0};
     nctx.flag = flag;
@@ -347,7 +347,7 @@ void ctgFreeHandle(SCatalog* pCtg) {
   ctgInfo("handle freed, clusterId:0x%" PRIx64, clusterId);
 }
 
-void ctgClearHandleMeta(SCatalog* pCtg, int64_t *pClearedSize, int64_t *pCleardNum, bool *roundDone) {
+void ctgClearHandleMeta(SCatalog* pCtg, int64_t *pClearedSize, int64_t *pCleardNum, int64_t *pSkippedNum, bool *roundDone) {
   int64_t cacheSize = 0;
   void* pIter = taosHashIterate(pCtg->dbCache, NULL);
   while (pIter) {
@@ -362,6 +362,14 @@ void ctgClearHandleMeta(SCatalog* pCtg, int64_t *pClearedSize, int64_t *pCleardN
         pCache = taosHashIterate(dbCache->tbCache, pCache);
         continue;
       }
+
+      // second chance, the tables referenced since the last round are kept and evicted in the next round if they are
+      // not referenced again, which approximates LRU without a global list to maintain on each cache hit
+      if (atomic_val_compare_exchange_8(&pCache->accessed, 1, 0)) {
+        (*pSkippedNum)++;
+        pCache = taosHashIterate(dbCache->tbCache, pCache);
+        continue;
+      }
       
       taosHashRemove(dbCache->tbCache, key, len);
       cacheSize = len + sizeof(SCtgTbCache) + ctgGetTbMetaCacheSize(pCache->pMeta) + ctgGetTbIndexCacheSize(pCache->pIndex);
@@ -371,6 +379,7 @@ void ctgClearHandleMeta(SCatalog* pCtg, int64_t *pClearedSize, int64_t *pCleardN
 
       if (pCache->pMeta) {
         CTG_META_NUM_DEC(pCache->pMeta->tableType);
+        CTG_META_EVICT_INC(pCache->pMeta->tableType);
       }
       
       ctgFreeTbCacheImpl(pCache, true);
@@ -393,7 +402,7 @@ _return:
   }
 }
 
-void ctgClearAllHandleMeta(int64_t *clearedSize, int64_t *clearedNum, bool *roundDone) {
+void ctgClearAllHandleMeta(int64_t *clearedSize, int64_t *clearedNum, int64_t *skippedNum, bool *roundDone) {
   SCatalog *pCtg = NULL;
 
   void *pIter = taosHashIterate(gCtgMgmt.pCluster, NULL);
@@ -401,7 +410,7 @@ void ctgClearAllHandleMeta(int64_t *clearedSize, int64_t *clearedNum, bool *roun
     pCtg = *(SCatalog **)pIter;
 
     if (pCtg) {
-      ctgClearHandleMeta(pCtg, clearedSize, clearedNum, roundDone);
+      ctgClearHandleMeta(pCtg, clearedSize, clearedNum, skippedNum, roundDone);
       if (*roundDone) {
         taosHashCancelIterate(gCtgMgmt.pCluster, pIter);
         break;
@@ -1925,6 +1934,7 @@ void ctgSummaryClusterCacheStat(SCatalog* pCtg) {
     gCtgMgmt.statInfo.cache.cacheNum[i] += pCtg->cacheStat.cacheNum[i];
     gCtgMgmt.statInfo.cache.cacheHit[i] += pCtg->cacheStat.cacheHit[i];
     gCtgMgmt.statInfo.cache.cacheNHit[i] += pCtg->cacheStat.cacheNHit[i];
+    gCtgMgmt.statInfo.cache.cacheEvict[i] += pCtg->cacheStat.cacheEvict[i];
   }
 }
 
@@ -1937,6 +1947,7 @@ void ctgGetGlobalCacheStat(SCtgCacheStat* pStat) {
     gCtgMgmt.statInfo.cache.cacheNum[i] = 0;
     gCtgMgmt.statInfo.cache.cacheHit[i] = 0;
     gCtgMgmt.statInfo.cache.cacheNHit[i] = 0;
+    gCtgMgmt.statInfo.cache.cacheEvict[i] = 0;
   }
 
   SCatalog* pCtg = NULL;
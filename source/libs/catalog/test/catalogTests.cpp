@@ -3096,6 +3096,84 @@ TEST(apiTest, catalogGetDnodeList_test) {
   catalogDestroy();
 }
 
+static SCtgTbCache *ctgTestPutTbCache(SCtgDBCache *dbCache, const char *tbName, int8_t tableType, int8_t accessed) {
+  STableMeta *pMeta = (STableMeta *)taosMemoryCalloc(1, sizeof(STableMeta) + sizeof(SSchema));
+  pMeta->tableType = tableType;
+  pMeta->tableInfo.numOfColumns = 1;
+
+  SCtgTbCache cache = {0};
+  cache.pMeta = pMeta;
+  cache.accessed = accessed;
+  taosHashPut(dbCache->tbCache, tbName, strlen(tbName), &cache, sizeof(cache));
+  CTG_META_NUM_INC(tableType);
+
+  return (SCtgTbCache *)taosHashGet(dbCache->tbCache, tbName, strlen(tbName));
+}
+
+static SCtgTbCache *ctgTestGetTbCache(SCtgDBCache *dbCache, const char *tbName) {
+  return (SCtgTbCache *)taosHashGet(dbCache->tbCache, tbName, strlen(tbName));
+}
+
+TEST(cacheEvict, clockSecondChance) {
+  SCatalog ctg = {0};
+  ctg.dbCache = taosHashInit(4, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), true, HASH_ENTRY_LOCK);
+
+  SCtgDBCache db = {0};
+  db.tbCache = taosHashInit(16, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), true, HASH_ENTRY_LOCK);
+  taosHashPut(ctg.dbCache, ctgTestDbname, strlen(ctgTestDbname), &db, sizeof(db));
+  SCtgDBCache *dbCache = (SCtgDBCache *)taosHashGet(ctg.dbCache, ctgTestDbname, strlen(ctgTestDbname));
+
+  ctgTestPutTbCache(dbCache, "stb", TSDB_SUPER_TABLE, 0);
+  ctgTestPutTbCache(dbCache, "cold", TSDB_NORMAL_TABLE, 0);
+  ctgTestPutTbCache(dbCache, "coldctb", TSDB_CHILD_TABLE, 0);
+  ctgTestPutTbCache(dbCache, "hot", TSDB_NORMAL_TABLE, 1);
+  ctgTestPutTbCache(dbCache, "warm", TSDB_CHILD_TABLE, 1);
+
+  // round 1: the unreferenced tables are the victims, the referenced ones lose their reference bit
+  int64_t clearedSize = 0, clearedNum = 0, skippedNum = 0;
+  bool    roundDone = false;
+  ctgClearHandleMeta(&ctg, &clearedSize, &clearedNum, &skippedNum, &roundDone);
+  ASSERT_EQ(clearedNum, 2);
+  ASSERT_EQ(skippedNum, 2);
+  ASSERT_FALSE(roundDone);
+  ASSERT_EQ(ctgTestGetTbCache(dbCache, "cold"), nullptr);
+  ASSERT_EQ(ctgTestGetTbCache(dbCache, "coldctb"), nullptr);
+  ASSERT_EQ(ctgTestGetTbCache(dbCache, "hot")->accessed, 0);
+  ASSERT_EQ(ctgTestGetTbCache(dbCache, "warm")->accessed, 0);
+  ASSERT_EQ(ctg.cacheStat.cacheEvict[CTG_CI_NTABLE_META], 1);
+  ASSERT_EQ(ctg.cacheStat.cacheEvict[CTG_CI_CTABLE_META], 1);
+
+  // round 2: only the table referenced again since round 1 survives
+  CTG_TB_CACHE_TOUCH(ctgTestGetTbCache(dbCache, "warm"));
+  clearedNum = 0, skippedNum = 0;
+  ctgClearHandleMeta(&ctg, &clearedSize, &clearedNum, &skippedNum, &roundDone);
+  ASSERT_EQ(clearedNum, 1);
+  ASSERT_EQ(skippedNum, 1);
+  ASSERT_EQ(ctgTestGetTbCache(dbCache, "hot"), nullptr);
+  ASSERT_NE(ctgTestGetTbCache(dbCache, "warm"), nullptr);
+
+  // round 3: not referenced any more
+  clearedNum = 0, skippedNum = 0;
+  ctgClearHandleMeta(&ctg, &clearedSize, &clearedNum, &skippedNum, &roundDone);
+  ASSERT_EQ(clearedNum, 1);
+  ASSERT_EQ(skippedNum, 0);
+  ASSERT_EQ(ctgTestGetTbCache(dbCache, "warm"), nullptr);
+
+  // super tables are never evicted
+  ASSERT_NE(ctgTestGetTbCache(dbCache, "stb"), nullptr);
+  ASSERT_EQ(taosHashGetSize(dbCache->tbCache), 1);
+  ASSERT_EQ(dbCache->dbCacheNum[CTG_CI_STABLE_META], 1);
+  ASSERT_EQ(dbCache->dbCacheNum[CTG_CI_NTABLE_META], 0);
+  ASSERT_EQ(dbCache->dbCacheNum[CTG_CI_CTABLE_META], 0);
+  ASSERT_EQ(ctg.cacheStat.cacheEvict[CTG_CI_NTABLE_META], 2);
+  ASSERT_EQ(ctg.cacheStat.cacheEvict[CTG_CI_CTABLE_META], 2);
+  ASSERT_EQ(ctg.cacheStat.cacheEvict[CTG_CI_STABLE_META], 0);
+
+  ctgFreeTbCacheImpl(ctgTestGetTbCache(dbCache, "stb"), false);
+  taosHashCleanup(dbCache->tbCache);
+  taosHashCleanup(ctg.dbCache);
+}
+
 #ifdef INTEGRATION_TEST
 TEST(intTest, autoCreateTableTest) {
   struct SCatalog *pCtg = NULL;
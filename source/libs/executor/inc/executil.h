@@ -119,6 +119,8 @@ int32_t         tableListGetOutputGroups(const STableListInfo* pTableList);
 bool            oneTableForEachGroup(const STableListInfo* pTableList);
 uint64_t        tableListGetTableGroupId(const STableListInfo* pTableList, uint64_t tableUid);
 int32_t         tableListAddTableInfo(STableListInfo* pTableList, uint64_t uid, uint64_t gid);
+bool            isGroupOfSubtask(const SReadHandle* pHandle, uint64_t groupId);
+void            removeTablesOfOtherSubtasks(STableListInfo* pTableListInfo, const SReadHandle* pHandle);
 int32_t         tableListGetGroupList(const STableListInfo* pTableList, int32_t ordinalIndex, STableKeyInfo** pKeyInfo,
                                       int32_t* num);
 uint64_t        tableListGetSize(const STableListInfo* pTableList);
@@ -159,6 +161,8 @@ int32_t getNumOfTotalRes(SGroupResInfo* pGroupResInfo);
 SSDataBlock* createDataBlockFromDescNode(SDataBlockDescNode* pNode);
 
 EDealRes doTranslateTagExpr(SNode** pNode, void* pContext);
+int32_t  createTagValBlockFromStore(SArray* pColList, SArray* pUidTagList, void* pVnode, uint64_t suid,
+                                    SSDataBlock** ppBlock, SStorageAPI* pStorageAPI);
 int32_t  getGroupIdFromTagsVal(void* pVnode, uint64_t uid, SNodeList* pGroupNode, char* keyBuf, uint64_t* pGroupId, SStorageAPI* pAPI);
 size_t   getTableTagsBufLen(const SNodeList* pGroups);
 
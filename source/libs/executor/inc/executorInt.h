@@ -33,6 +33,7 @@ extern "C" {
 #include "planner.h"
 #include "scalar.h"
 #include "taosdef.h"
+#include "tarena.h"
 #include "tarray.h"
 #include "tfill.h"
 #include "thash.h"
@@ -42,6 +43,7 @@ extern "C" {
 // #include "tstream.h"
 // #include "tstreamUpdate.h"
 #include "tlrucache.h"
+#include "tbloomfilter.h"
 
 typedef int32_t (*__block_search_fn_t)(char* data, int32_t num, int64_t key, int32_t order);
 
@@ -239,6 +241,19 @@ typedef struct STableMetaCacheInfo {
   uint64_t   cacheHit;
 } STableMetaCacheInfo;
 
+// runtime filter published by the build side of a hash join, and applied by the table scan of the probe side
+typedef struct SJoinRuntimeFilter {
+  int32_t       slotId;       // slot of the join key in the result block of the table scan
+  int8_t        type;
+  bool          primaryTs;    // the join key is the primary timestamp column of the scanned tables
+  bool          hasMinMax;    // min/max is only available for the integer and timestamp join keys
+  int64_t       min;
+  int64_t       max;
+  SBloomFilter* pBloomFilter;
+  int64_t       filteredRows;
+  int64_t       prunedBlocks;
+} SJoinRuntimeFilter;
+
 typedef struct STableScanBase {
   STsdbReader*           dataReader;
   SFileBlockLoadRecorder readRecorder;
@@ -252,23 +267,66 @@ typedef struct STableScanBase {
   int32_t                dataBlockLoadFlag;
   SLimitInfo             limitInfo;
   // there are more than one table list exists in one task, if only one vnode exists.
-  STableListInfo* pTableListInfo;
-  TsdReader       readerAPI;
+  STableListInfo*     pTableListInfo;
+  TsdReader           readerAPI;
+  SJoinRuntimeFilter* pRuntimeFilter;  // owned by the hash join operator
 } STableScanBase;
 
+struct STableScanParallel;
+
+// one worker thread of the parallel table scan, it scans the morsels of the table list one by one with the same
+// reader, so that only one snapshot of the tsdb is taken by each worker.
+typedef struct STableScanWorker {
+  int32_t                    index;
+  TdThread                   thread;
+  bool                       started;
+  STsdbReader*               dataReader;
+  SQueryTableDataCond        cond;  // shallow copy of the scan condition, owned by the table scan operator
+  SSDataBlock*               pResBlock;
+  SFilterInfo*               pFilterInfo;
+  SHashObj*                  pIgnoreTables;
+  STableMetaCacheInfo        metaCache;  // the LRU cache is not thread safe, so each worker has its own one
+  SFileBlockLoadRecorder     readRecorder;
+  struct STableScanParallel* pParallel;
+} STableScanWorker;
+
+typedef struct STableScanParallel {
+  struct SOperatorInfo* pOperator;
+  int32_t               numOfWorkers;
+  STableScanWorker*     pWorkers;
+  int32_t               morselSize;  // number of tables in each morsel
+  int32_t               nextTable;   // start index of the next morsel in the table list
+  int32_t               runningWorkers;
+  int32_t               code;  // the first error reported by workers
+  bool                  started;
+  bool                  stop;
+  SSDataBlock**         pQueue;  // ring buffer of the loaded data blocks
+  int32_t               queueCap;
+  int32_t               queueHead;
+  int32_t               queueSize;
+  SSDataBlock*          pCurrent;  // the block returned to the upstream operator last time
+  SSDataBlock**         pFreeList;  // blocks returned by the upstream operator, whose buffers can be reused
+  int32_t               freeCap;
+  int32_t               numOfFree;
+  TdThreadMutex         lock;
+  TdThreadCond          notEmpty;
+  TdThreadCond          notFull;
+} STableScanParallel;
+
 typedef struct STableScanInfo {
-  STableScanBase  base;
-  SScanInfo       scanInfo;
-  int32_t         scanTimes;
-  SSDataBlock*    pResBlock;
-  SHashObj*       pIgnoreTables;
-  SSampleExecInfo sample;  // sample execution info
-  int32_t         currentGroupId;
-  int32_t         currentTable;
-  int8_t          scanMode;
-  int8_t          assignBlockUid;
-  bool            hasGroupByTag;
-  bool            countOnly;
+  STableScanBase      base;
+  SScanInfo           scanInfo;
+  int32_t             scanTimes;
+  SSDataBlock*        pResBlock;
+  SHashObj*           pIgnoreTables;
+  SSampleExecInfo     sample;  // sample execution info
+  int32_t             currentGroupId;
+  int32_t             currentTable;
+  int8_t              scanMode;
+  int8_t              assignBlockUid;
+  bool                hasGroupByTag;
+  bool                countOnly;
+  STableScanParallel* pParallel;  // not NULL if the tables are scanned by several worker threads
   //  TsdReader    readerAPI;
 } STableScanInfo;
 
@@ -46,6 +46,8 @@ typedef struct SHJoinColInfo {
   int32_t  dstSlot;
   bool     keyCol;
   bool     vardata;
+  int8_t   type;
+  bool     primaryTs;
   int32_t* offset;
   int32_t  bytes;
   char*    data;
@@ -94,19 +96,20 @@ typedef struct SHJoinExecInfo {
 
 
 typedef struct SHJoinOperatorInfo {
-  int32_t          joinType;
-  SHJoinTableInfo  tbs[2];
-  SHJoinTableInfo* pBuild;
-  SHJoinTableInfo* pProbe;
-  SSDataBlock*     pRes;
-  int32_t          pResColNum;
-  int8_t*          pResColMap;
-  SArray*          pRowBufs;
-  SNode*           pCond;
-  SSHashObj*       pKeyHash;
-  bool             keyHashBuilt;
-  SHJoinCtx        ctx;
-  SHJoinExecInfo   execInfo;
+  int32_t             joinType;
+  SHJoinTableInfo     tbs[2];
+  SHJoinTableInfo*    pBuild;
+  SHJoinTableInfo*    pProbe;
+  SSDataBlock*        pRes;
+  int32_t             pResColNum;
+  int8_t*             pResColMap;
+  SArray*             pRowBufs;
+  SNode*              pCond;
+  SSHashObj*          pKeyHash;
+  bool                keyHashBuilt;
+  SJoinRuntimeFilter* pRuntimeFilter;
+  SHJoinCtx           ctx;
+  SHJoinExecInfo      execInfo;
 } SHJoinOperatorInfo;
 
 #ifdef __cplusplus
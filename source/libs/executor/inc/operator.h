@@ -82,6 +82,7 @@ typedef struct SOperatorInfo {
   int32_t                numOfDownstream;  // number of downstream. The value is always ONE expect for join operator
   int32_t                numOfRealDownstream;
   SOperatorFpSet         fpSet;
+  SArena*                pArena;  // sub-arena of the task arena, created on first use
 } SOperatorInfo;
 
 // operator creater functions
@@ -172,6 +173,7 @@ void           setOperatorCompleted(SOperatorInfo* pOperator);
 void           setOperatorInfo(SOperatorInfo* pOperator, const char* name, int32_t type, bool blocking, int32_t status,
                                void* pInfo, SExecTaskInfo* pTaskInfo);
 int32_t        optrDefaultBufFn(SOperatorInfo* pOperator);
+SArena*        getOperatorArena(SOperatorInfo* pOperator);
 SSDataBlock*   optrDefaultGetNextExtFn(struct SOperatorInfo* pOperator, SOperatorParam* pParam);
 int32_t        optrDefaultNotifyFn(struct SOperatorInfo* pOperator, SOperatorParam* pParam);
 SSDataBlock*   getNextBlockFromDownstream(struct SOperatorInfo* pOperator, int32_t idx);
@@ -185,6 +187,9 @@ void           destroyOperator(SOperatorInfo* pOperator);
 SOperatorInfo* extractOperatorInTree(SOperatorInfo* pOperator, int32_t type, const char* id);
 int32_t        getTableScanInfo(SOperatorInfo* pOperator, int32_t* order, int32_t* scanFlag, bool inheritUsOrder);
 int32_t        stopTableScanOperator(SOperatorInfo* pOperator, const char* pIdStr, SStorageAPI* pAPI);
+void           tableScanEnableParallel(SOperatorInfo* pOperator, STableScanPhysiNode* pTableScanNode, int32_t numOfThreads);
+void           tableScanNotifyClosing(STableScanInfo* pInfo, SStorageAPI* pAPI);
+void           tableScanSetRuntimeFilter(SOperatorInfo* pOperator, SJoinRuntimeFilter* pFilter);
 int32_t        getOperatorExplainExecInfo(struct SOperatorInfo* operatorInfo, SArray* pExecInfoList);
 void *         getOperatorParam(int32_t opType, SOperatorParam* param, int32_t idx);
 
@@ -97,6 +97,7 @@ struct SExecTaskInfo {
   int8_t                dynamicTask;
   SOperatorParam*       pOpParam;
   bool                  paramSet;
+  SArena*               pArena;  // root of the operator arenas, accounts the memory of the whole task
 };
 
 void           buildTaskId(uint64_t taskId, uint64_t queryId, char* dst);
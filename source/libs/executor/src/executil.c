@@ -18,6 +18,7 @@
 #include "index.h"
 #include "os.h"
 #include "query.h"
+#include "tcompare.h"
 #include "tdatablock.h"
 #include "thash.h"
 #include "tmsg.h"
@@ -515,16 +516,19 @@ int32_t getColInfoResultForGroupby(void* pVnode, SNodeList* group, STableListInf
     taosArrayPush(pUidTagList, &info);
   }
 
-  code = pAPI->metaFn.getTableTags(pVnode, pTableListInfo->idInfo.suid, pUidTagList);
-  if (code != TSDB_CODE_SUCCESS) {
-    goto end;
-  }
+  if (createTagValBlockFromStore(ctx.cInfoList, pUidTagList, pVnode, pTableListInfo->idInfo.suid, &pResBlock, pAPI) !=
+      TSDB_CODE_SUCCESS) {
+    code = pAPI->metaFn.getTableTags(pVnode, pTableListInfo->idInfo.suid, pUidTagList);
+    if (code != TSDB_CODE_SUCCESS) {
+      goto end;
+    }
 
-  int32_t numOfTables = taosArrayGetSize(pUidTagList);
-  pResBlock = createTagValBlockForFilter(ctx.cInfoList, numOfTables, pUidTagList, pVnode, pAPI);
-  if (pResBlock == NULL) {
-    code = terrno;
-    goto end;
+    int32_t numOfTables = taosArrayGetSize(pUidTagList);
+    pResBlock = createTagValBlockForFilter(ctx.cInfoList, numOfTables, pUidTagList, pVnode, pAPI);
+    if (pResBlock == NULL) {
+      code = terrno;
+      goto end;
+    }
   }
 
   //  int64_t st1 = taosGetTimestampUs();
@@ -926,6 +930,55 @@ SSDataBlock* createTagValBlockForFilter(SArray* pColList, int32_t numOfTables, S
   return pResBlock;
 }
 
+// read the tag columns from the columnar tag store of the super table, if pUidTagList is empty all the child tables are
+// added into it. A non-zero code means the tag store can not be used, the tags of each table need to be read instead.
+int32_t createTagValBlockFromStore(SArray* pColList, SArray* pUidTagList, void* pVnode, uint64_t suid,
+                                   SSDataBlock** ppBlock, SStorageAPI* pStorageAPI) {
+  if (pStorageAPI->metaFn.getTableTagCols == NULL) {
+    return TSDB_CODE_OPS_NOT_SUPPORT;
+  }
+
+  int32_t      numOfTables = taosArrayGetSize(pUidTagList);
+  SArray*      pUidList = taosArrayInit(TMAX(numOfTables, 8), sizeof(uint64_t));
+  SSDataBlock* pResBlock = createDataBlock();
+  if (pUidList == NULL || pResBlock == NULL) {
+    taosArrayDestroy(pUidList);
+    blockDataDestroy(pResBlock);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  for (int32_t i = 0; i < taosArrayGetSize(pColList); ++i) {
+    SColumnInfoData colInfo = {0};
+    colInfo.info = *(SColumnInfo*)taosArrayGet(pColList, i);
+    blockDataAppendColInfo(pResBlock, &colInfo);
+  }
+
+  for (int32_t i = 0; i < numOfTables; ++i) {
+    taosArrayPush(pUidList, &((STUidTagInfo*)taosArrayGet(pUidTagList, i))->uid);
+  }
+
+  int32_t code = pStorageAPI->metaFn.getTableTagCols(pVnode, suid, pUidList, pResBlock);
+  if (code == TSDB_CODE_SUCCESS && numOfTables == 0) {
+    numOfTables = taosArrayGetSize(pUidList);
+    for (int32_t i = 0; i < numOfTables; ++i) {
+      STUidTagInfo info = {.uid = *(uint64_t*)taosArrayGet(pUidList, i)};
+      if (taosArrayPush(pUidTagList, &info) == NULL) {
+        code = TSDB_CODE_OUT_OF_MEMORY;
+        break;
+      }
+    }
+  }
+
+  taosArrayDestroy(pUidList);
+  if (code != TSDB_CODE_SUCCESS) {
+    blockDataDestroy(pResBlock);
+    return code;
+  }
+
+  *ppBlock = pResBlock;
+  return TSDB_CODE_SUCCESS;
+}
+
 static int32_t doSetQualifiedUid(STableListInfo* pListInfo, SArray* pUidList, const SArray* pUidTagList, bool* pResultList, bool addUid) {
   taosArrayClear(pUidList);
 
@@ -1013,7 +1066,8 @@ static int32_t doFilterByTagCond(STableListInfo* pListInfo, SArray* pUidList, SN
       taosArrayPush(pUidList, &pInfo->uid);
     }
     terrno = 0;
-  } else {
+  } else if (createTagValBlockFromStore(ctx.cInfoList, pUidTagList, pVnode, pListInfo->idInfo.suid, &pResBlock,
+                                        pAPI) != TSDB_CODE_SUCCESS) {
     if ((condType == FILTER_NO_LOGIC || condType == FILTER_AND) && status != SFLT_NOT_INDEX) {
       code = pAPI->metaFn.getTableTagsByUid(pVnode, pListInfo->idInfo.suid, pUidTagList);
     } else {
@@ -1031,10 +1085,12 @@ static int32_t doFilterByTagCond(STableListInfo* pListInfo, SArray* pUidList, SN
     goto end;
   }
 
-  pResBlock = createTagValBlockForFilter(ctx.cInfoList, numOfTables, pUidTagList, pVnode, pAPI);
   if (pResBlock == NULL) {
-    code = terrno;
-    goto end;
+    pResBlock = createTagValBlockForFilter(ctx.cInfoList, numOfTables, pUidTagList, pVnode, pAPI);
+    if (pResBlock == NULL) {
+      code = terrno;
+      goto end;
+    }
   }
 
   //  int64_t st1 = taosGetTimestampUs();
@@ -1074,6 +1130,34 @@ end:
   return code;
 }
 
+// evaluate the tag filter condition on the tables changed since the cached result was generated, and merge the
+// qualified ones into the still valid part of the cached result
+static int32_t filterChangedTables(STableListInfo* pListInfo, SArray* pUidList, SArray* pChangedList, SNode* pTagCond,
+                                   void* pVnode, SStorageAPI* pAPI) {
+  bool           listAdded = false;
+  STableListInfo info = {.idInfo = pListInfo->idInfo};
+
+  info.pTableList = taosArrayInit(taosArrayGetSize(pChangedList), sizeof(STableKeyInfo));
+  if (info.pTableList == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  int32_t code = doFilterByTagCond(&info, pChangedList, pTagCond, pVnode, SFLT_NOT_INDEX, pAPI, true, &listAdded);
+  taosArrayDestroy(info.pTableList);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  if (taosArrayAddAll(pUidList, pChangedList) == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  // the tbname in optimization may bring back the tables that are already in the cached result
+  taosArraySort(pUidList, compareUint64Val);
+  taosArrayRemoveDuplicate(pUidList, compareUint64Val, NULL);
+  return TSDB_CODE_SUCCESS;
+}
+
 int32_t getTableList(void* pVnode, SScanPhysiNode* pScanNode, SNode* pTagCond, SNode* pTagIndexCond,
                      STableListInfo* pListInfo, uint8_t* digest, const char* idstr, SStorageAPI* pStorageAPI) {
   int32_t code = TSDB_CODE_SUCCESS;
@@ -1097,20 +1181,40 @@ int32_t getTableList(void* pVnode, SScanPhysiNode* pScanNode, SNode* pTagCond, S
     }
   } else {
     T_MD5_CTX context = {0};
+    int64_t   ver = 0;
 
     if (tsTagFilterCache) {
       // try to retrieve the result from meta cache
       genTagFilterDigest(pTagCond, &context);
 
-      bool acquired = false;
+      bool    acquired = false;
+      SArray* pChangedList = taosArrayInit(4, sizeof(uint64_t));
       pStorageAPI->metaFn.getCachedTableList(pVnode, pScanNode->suid, context.digest, tListLen(context.digest),
-                                             pUidList, &acquired);
-      if (acquired) {
+                                             pUidList, pChangedList, &ver, &acquired);
+      // nothing to filter again, if only dropped tables are taken out of the cached list, it has been put back already
+      if (acquired && taosArrayGetSize(pChangedList) == 0) {
+        taosArrayDestroy(pChangedList);
         digest[0] = 1;
         memcpy(digest + 1, context.digest, tListLen(context.digest));
         qDebug("retrieve table uid list from cache, numOfTables:%d", (int32_t)taosArrayGetSize(pUidList));
         goto _end;
       }
+
+      if (acquired) {
+        // only the tables created or altered since the result was cached need to be filtered again
+        int32_t numOfChanged = taosArrayGetSize(pChangedList);
+        code = filterChangedTables(pListInfo, pUidList, pChangedList, pTagCond, pVnode, pStorageAPI);
+        taosArrayDestroy(pChangedList);
+        if (code != TSDB_CODE_SUCCESS) {
+          goto _end;
+        }
+
+        qDebug("refresh table uid list from cache, numOfChanged:%d, numOfTables:%d", numOfChanged,
+               (int32_t)taosArrayGetSize(pUidList));
+        goto _put;
+      }
+
+      taosArrayDestroy(pChangedList);
     }
 
     if (!pTagCond) {  // no tag filter condition exists, let's fetch all tables of this super table
@@ -1140,6 +1244,7 @@ int32_t getTableList(void* pVnode, SScanPhysiNode* pScanNode, SNode* pTagCond, S
       goto _end;
     }
 
+  _put:
     // let's add the filter results into meta-cache
     numOfTables = taosArrayGetSize(pUidList);
 
@@ -1152,7 +1257,9 @@ int32_t getTableList(void* pVnode, SScanPhysiNode* pScanNode, SNode* pTagCond, S
         memcpy(pPayload + sizeof(int32_t), taosArrayGet(pUidList, 0), numOfTables * sizeof(uint64_t));
       }
 
-      pStorageAPI->metaFn.putCachedTableList(pVnode, pScanNode->suid, context.digest, tListLen(context.digest), pPayload, size, 1);
+      // stamped with the version seen before filtering, the changes made in the meanwhile are patched on next acquiring
+      pStorageAPI->metaFn.putCachedTableList(pVnode, pScanNode->suid, context.digest, tListLen(context.digest), pPayload,
+                                             size, ver, 1);
       digest[0] = 1;
       memcpy(digest + 1, context.digest, tListLen(context.digest));
     }
@@ -1977,6 +2084,35 @@ int32_t tableListAddTableInfo(STableListInfo* pTableList, uint64_t uid, uint64_t
   return TSDB_CODE_SUCCESS;
 }
 
+bool isGroupOfSubtask(const SReadHandle* pHandle, uint64_t groupId) {
+  if (pHandle->numOfSubtasks <= 1) {
+    return true;
+  }
+  return MurmurHash3_32((const char*)&groupId, sizeof(groupId)) % pHandle->numOfSubtasks == pHandle->subtaskId;
+}
+
+// the groups are spread among the sub-tasks of a stream source task, each sub-task only keeps its own tables
+void removeTablesOfOtherSubtasks(STableListInfo* pTableListInfo, const SReadHandle* pHandle) {
+  if (pHandle->numOfSubtasks <= 1) {
+    return;
+  }
+
+  size_t  numOfTables = taosArrayGetSize(pTableListInfo->pTableList);
+  int32_t num = 0;
+  for (int32_t i = 0; i < numOfTables; ++i) {
+    STableKeyInfo* p = taosArrayGet(pTableListInfo->pTableList, i);
+    if (isGroupOfSubtask(pHandle, p->groupId)) {
+      if (num != i) {
+        taosArraySet(pTableListInfo->pTableList, num, p);
+      }
+      num++;
+    }
+  }
+  taosArrayPopTailBatch(pTableListInfo->pTableList, numOfTables - num);
+  qDebug("keep %d of %d tables for sub-task %d of %d", num, (int32_t)numOfTables, pHandle->subtaskId,
+         pHandle->numOfSubtasks);
+}
+
 int32_t tableListGetGroupList(const STableListInfo* pTableList, int32_t ordinalGroupIndex, STableKeyInfo** pKeyInfo,
                               int32_t* size) {
   int32_t totalGroups = tableListGetOutputGroups(pTableList);
@@ -2122,6 +2258,8 @@ int32_t buildGroupIdMapForAllTables(STableListInfo* pTableListInfo, SReadHandle*
       info->groupId = groupByTbname ? info->uid : 0;
     }
 
+    removeTablesOfOtherSubtasks(pTableListInfo, pHandle);
+    numOfTables = taosArrayGetSize(pTableListInfo->pTableList);
     pTableListInfo->oneTableForEachGroup = groupByTbname;
 
     if (groupSort && groupByTbname) {
@@ -2137,6 +2275,7 @@ int32_t buildGroupIdMapForAllTables(STableListInfo* pTableListInfo, SReadHandle*
     if (code != TSDB_CODE_SUCCESS) {
       return code;
     }
+    removeTablesOfOtherSubtasks(pTableListInfo, pHandle);
     if (pScanNode->groupOrderScan) pTableListInfo->numOfOuputGroups = taosArrayGetSize(pTableListInfo->pTableList);
 
     if (groupSort || pScanNode->groupOrderScan) {
@@ -411,11 +411,6 @@ int32_t qUpdateTableListForStreamScanner(qTaskInfo_t tinfo, const SArray* tableI
     SArray* qa = filterUnqualifiedTables(pScanInfo, tableIdList, id, &pTaskInfo->storageAPI);
     int32_t numOfQualifiedTables = taosArrayGetSize(qa);
     qDebug("%d qualified child tables added into stream scanner, %s", numOfQualifiedTables, id);
-    code = pTaskInfo->storageAPI.tqReaderFn.tqReaderAddTables(pScanInfo->tqReader, qa);
-    if (code != TSDB_CODE_SUCCESS) {
-      taosArrayDestroy(qa);
-      return code;
-    }
 
     bool   assignUid = false;
     size_t bufLen = (pScanInfo->pGroupTags != NULL) ? getTableTagsBufLen(pScanInfo->pGroupTags) : 0;
@@ -430,6 +425,7 @@ int32_t qUpdateTableListForStreamScanner(qTaskInfo_t tinfo, const SArray* tableI
     }
 
     STableListInfo* pTableListInfo = ((STableScanInfo*)pScanInfo->pTableScanOp->info)->base.pTableListInfo;
+    int32_t         numOfAdded = 0;
     taosWLockLatch(&pTaskInfo->lock);
 
     for (int32_t i = 0; i < numOfQualifiedTables; ++i) {
@@ -451,7 +447,13 @@ int32_t qUpdateTableListForStreamScanner(qTaskInfo_t tinfo, const SArray* tableI
         }
       }
 
+      // the group of the new table belongs to another sub-task of the stream
+      if (!isGroupOfSubtask(&pScanInfo->readHandle, keyInfo.groupId)) {
+        continue;
+      }
+
       tableListAddTableInfo(pTableListInfo, keyInfo.uid, keyInfo.groupId);
+      taosArraySet(qa, numOfAdded++, &keyInfo.uid);
     }
 
     taosWUnLockLatch(&pTaskInfo->lock);
@@ -459,6 +461,8 @@ int32_t qUpdateTableListForStreamScanner(qTaskInfo_t tinfo, const SArray* tableI
       taosMemoryFree(keyBuf);
     }
 
+    taosArrayPopTailBatch(qa, numOfQualifiedTables - numOfAdded);
+    code = pTaskInfo->storageAPI.tqReaderFn.tqReaderAddTables(pScanInfo->tqReader, qa);
     taosArrayDestroy(qa);
   } else {  // remove the table id in current list
     qDebug("%d remove child tables from the stream scanner, %s", (int32_t)taosArrayGetSize(tableIdList), id);
@@ -831,6 +835,15 @@ bool qTaskIsExecuting(qTaskInfo_t qinfo) {
   return 0 != atomic_load_64(&pTaskInfo->owner);
 }
 
+int64_t qGetTaskArenaPeak(qTaskInfo_t tinfo) {
+  SExecTaskInfo* pTaskInfo = (SExecTaskInfo*)tinfo;
+  if (NULL == pTaskInfo || NULL == pTaskInfo->pArena) {
+    return 0;
+  }
+
+  return taosArenaGetPeak(pTaskInfo->pArena);
+}
+
 static void printTaskExecCostInLog(SExecTaskInfo* pTaskInfo) {
   STaskCostInfo* pSummary = &pTaskInfo->cost;
   int64_t        idleTime = pSummary->start - pSummary->created;
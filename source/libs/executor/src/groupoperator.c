@@ -28,16 +28,44 @@
 #include "thash.h"
 #include "ttypes.h"
 
+// blocks with fewer rows than this are aggregated row by row
+#define GROUPBY_BATCH_MIN_ROWS 64
+#define GROUPBY_PREFETCH_DIST  8
+
+#if defined(__GNUC__) || defined(__clang__)
+#define GROUPBY_PREFETCH(_p) __builtin_prefetch((_p), 1, 1)
+#else
+#define GROUPBY_PREFETCH(_p)
+#endif
+
+// scratch buffers of the vectorized group by path, reused across blocks. The buffers are taken from the operator arena
+// and are released with the operator.
+typedef struct SGroupbyBatchSup {
+  int32_t      capacity;      // max number of rows the buffers can hold
+  int32_t      numOfSlots;    // size of the open addressing table, power of 2
+  char*        pKeys;         // group keys of each row, groupKeyLen bytes per row
+  int32_t*     pKeyLen;       // actual length of each row's group key
+  uint32_t*    pHashVal;      // hash value of each row's group key
+  int32_t*     pSlots;        // open addressing table, group ordinal + 1, 0 for empty slot
+  int32_t*     pGroupIndex;   // group ordinal of each row
+  int32_t*     pFirstRow;     // first row of each group
+  int32_t*     pGroupRows;    // number of rows of each group
+  int32_t*     pGroupEnd;     // end position of each group in the selection vector
+  int32_t*     pSelection;    // row index of the input block, gathered by group
+  SSDataBlock* pGatherBlock;  // input rows reordered according to the selection vector
+} SGroupbyBatchSup;
+
 typedef struct SGroupbyOperatorInfo {
-  SOptrBasicInfo binfo;
-  SAggSupporter  aggSup;
-  SArray*        pGroupCols;     // group by columns, SArray<SColumn>
-  SArray*        pGroupColVals;  // current group column values, SArray<SGroupKeys>
-  bool           isInit;         // denote if current val is initialized or not
-  char*          keyBuf;         // group by keys for hash
-  int32_t        groupKeyLen;    // total group by column width
-  SGroupResInfo  groupResInfo;
-  SExprSupp      scalarSup;
+  SOptrBasicInfo   binfo;
+  SAggSupporter    aggSup;
+  SArray*          pGroupCols;     // group by columns, SArray<SColumn>
+  SArray*          pGroupColVals;  // current group column values, SArray<SGroupKeys>
+  bool             isInit;         // denote if current val is initialized or not
+  char*            keyBuf;         // group by keys for hash
+  int32_t          groupKeyLen;    // total group by column width
+  SGroupResInfo    groupResInfo;
+  SExprSupp        scalarSup;
+  SGroupbyBatchSup batchSup;
 } SGroupbyOperatorInfo;
 
 // The sort in partition may be needed later.
@@ -73,12 +101,20 @@ static void freeGroupKey(void* param) {
   taosMemoryFree(pKey->pData);
 }
 
+static void cleanupGroupbyBatchSup(SGroupbyBatchSup* pSup) {
+  SSDataBlock* pGatherBlock = pSup->pGatherBlock;
+  memset(pSup, 0, sizeof(SGroupbyBatchSup));
+  blockDataDestroy(pGatherBlock);
+}
+
 static void destroyGroupOperatorInfo(void* param) {
   SGroupbyOperatorInfo* pInfo = (SGroupbyOperatorInfo*)param;
   if (pInfo == NULL) {
     return;
   }
 
+  cleanupGroupbyBatchSup(&pInfo->batchSup);
+
   cleanupBasicInfo(&pInfo->binfo);
   taosMemoryFreeClear(pInfo->keyBuf);
   taosArrayDestroy(pInfo->pGroupCols);
@@ -348,6 +384,268 @@ static void doHashGroupbyAgg(SOperatorInfo* pOperator, SSDataBlock* pBlock) {
   }
 }
 
+// the arena is owned by the batch buffers only, so it is rewound as a whole when the buffers need to grow
+static int32_t ensureGroupbyBatchSup(SGroupbyBatchSup* pSup, SArena* pArena, int32_t rows, int32_t keyLen) {
+  if (rows <= pSup->capacity) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  if (pArena == NULL) {
+    return terrno;
+  }
+
+  SSDataBlock* pGatherBlock = pSup->pGatherBlock;
+  memset(pSup, 0, sizeof(SGroupbyBatchSup));
+  pSup->pGatherBlock = pGatherBlock;
+  taosArenaReset(pArena);
+
+  int32_t numOfSlots = 1;
+  while (numOfSlots < rows * 2) {
+    numOfSlots <<= 1;
+  }
+
+  pSup->pKeys = taosArenaAlloc(pArena, (int64_t)rows * keyLen);
+  pSup->pKeyLen = taosArenaAlloc(pArena, rows * sizeof(int32_t));
+  pSup->pHashVal = taosArenaAlloc(pArena, rows * sizeof(uint32_t));
+  pSup->pSlots = taosArenaAlloc(pArena, numOfSlots * sizeof(int32_t));
+  pSup->pGroupIndex = taosArenaAlloc(pArena, rows * sizeof(int32_t));
+  pSup->pFirstRow = taosArenaAlloc(pArena, rows * sizeof(int32_t));
+  pSup->pGroupRows = taosArenaAlloc(pArena, rows * sizeof(int32_t));
+  pSup->pGroupEnd = taosArenaAlloc(pArena, rows * sizeof(int32_t));
+  pSup->pSelection = taosArenaAlloc(pArena, rows * sizeof(int32_t));
+  if (pSup->pKeys == NULL || pSup->pKeyLen == NULL || pSup->pHashVal == NULL || pSup->pSlots == NULL ||
+      pSup->pGroupIndex == NULL || pSup->pFirstRow == NULL || pSup->pGroupRows == NULL || pSup->pGroupEnd == NULL ||
+      pSup->pSelection == NULL) {
+    memset(pSup, 0, sizeof(SGroupbyBatchSup));
+    pSup->pGatherBlock = pGatherBlock;
+    taosArenaReset(pArena);
+    return terrno;
+  }
+
+  pSup->capacity = rows;
+  pSup->numOfSlots = numOfSlots;
+  return TSDB_CODE_SUCCESS;
+}
+
+// Build the group keys of all rows column by column. The key layout is identical to the one generated by
+// buildGroupKeys, so that the result rows are shared with the row-wise path.
+static int32_t buildBatchGroupKeys(SGroupbyOperatorInfo* pInfo, SSDataBlock* pBlock) {
+  SGroupbyBatchSup* pSup = &pInfo->batchSup;
+  int32_t           numOfGroupCols = taosArrayGetSize(pInfo->pGroupCols);
+  int32_t           rows = pBlock->info.rows;
+
+  for (int32_t j = 0; j < rows; ++j) {
+    pSup->pKeyLen[j] = sizeof(int8_t) * numOfGroupCols;
+  }
+
+  for (int32_t i = 0; i < numOfGroupCols; ++i) {
+    SColumn*         pCol = taosArrayGet(pInfo->pGroupCols, i);
+    SColumnInfoData* pColInfoData = taosArrayGet(pBlock->pDataBlock, pCol->slotId);
+
+    char* pKey = pSup->pKeys;
+    for (int32_t j = 0; j < rows; ++j, pKey += pInfo->groupKeyLen) {
+      if (colDataIsNull(pColInfoData, rows, j, NULL)) {
+        pKey[i] = 1;
+        continue;
+      }
+
+      pKey[i] = 0;
+      char*   val = colDataGetData(pColInfoData, j);
+      int32_t dataLen = pCol->bytes;
+      if (pCol->type == TSDB_DATA_TYPE_JSON) {
+        if (tTagIsJson(val)) {
+          return TSDB_CODE_QRY_JSON_IN_GROUP_ERROR;
+        }
+        dataLen = getJsonValueLen(val);
+      } else if (IS_VAR_DATA_TYPE(pCol->type)) {
+        dataLen = varDataTLen(val);
+      }
+
+      memcpy(pKey + pSup->pKeyLen[j], val, dataLen);
+      pSup->pKeyLen[j] += dataLen;
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// Hash all keys of the block first, and then probe the open addressing table with the slots of the following rows
+// prefetched. Each distinct key gets a group ordinal in the order of its first appearance.
+static int32_t assignBatchGroups(SGroupbyOperatorInfo* pInfo, int32_t rows, int32_t* numOfRuns) {
+  SGroupbyBatchSup* pSup = &pInfo->batchSup;
+  int32_t           keyLen = pInfo->groupKeyLen;
+  uint32_t          mask = pSup->numOfSlots - 1;
+
+  for (int32_t j = 0; j < rows; ++j) {
+    pSup->pHashVal[j] = MurmurHash3_32(pSup->pKeys + (int64_t)j * keyLen, pSup->pKeyLen[j]);
+  }
+
+  memset(pSup->pSlots, 0, pSup->numOfSlots * sizeof(int32_t));
+
+  int32_t numOfGroups = 0;
+  *numOfRuns = 0;
+
+  for (int32_t j = 0; j < rows; ++j) {
+    if (j + GROUPBY_PREFETCH_DIST < rows) {
+      GROUPBY_PREFETCH(&pSup->pSlots[pSup->pHashVal[j + GROUPBY_PREFETCH_DIST] & mask]);
+    }
+
+    uint32_t hashVal = pSup->pHashVal[j];
+    char*    pKey = pSup->pKeys + (int64_t)j * keyLen;
+    uint32_t slot = hashVal & mask;
+    int32_t  groupIndex = -1;
+
+    while (1) {
+      groupIndex = pSup->pSlots[slot] - 1;
+      if (groupIndex < 0) {
+        groupIndex = numOfGroups++;
+        pSup->pSlots[slot] = groupIndex + 1;
+        pSup->pFirstRow[groupIndex] = j;
+        pSup->pGroupRows[groupIndex] = 0;
+        break;
+      }
+
+      int32_t first = pSup->pFirstRow[groupIndex];
+      if (pSup->pHashVal[first] == hashVal && pSup->pKeyLen[first] == pSup->pKeyLen[j] &&
+          memcmp(pSup->pKeys + (int64_t)first * keyLen, pKey, pSup->pKeyLen[j]) == 0) {
+        break;
+      }
+
+      slot = (slot + 1) & mask;
+    }
+
+    if (j == 0 || pSup->pGroupIndex[j - 1] != groupIndex) {
+      (*numOfRuns) += 1;
+    }
+
+    pSup->pGroupIndex[j] = groupIndex;
+    pSup->pGroupRows[groupIndex] += 1;
+  }
+
+  return numOfGroups;
+}
+
+// Copy the rows of the input block into the gather block, so that the rows of each group are contiguous.
+static int32_t gatherGroupRows(SGroupbyBatchSup* pSup, SSDataBlock* pBlock, int32_t numOfGroups) {
+  int32_t rows = pBlock->info.rows;
+
+  int32_t start = 0;
+  for (int32_t i = 0; i < numOfGroups; ++i) {
+    pSup->pGroupEnd[i] = start;
+    start += pSup->pGroupRows[i];
+  }
+
+  for (int32_t j = 0; j < rows; ++j) {
+    pSup->pSelection[pSup->pGroupEnd[pSup->pGroupIndex[j]]++] = j;
+  }
+
+  if (pSup->pGatherBlock == NULL) {
+    pSup->pGatherBlock = createOneDataBlock(pBlock, false);
+    if (pSup->pGatherBlock == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+
+  SSDataBlock* pDst = pSup->pGatherBlock;
+  blockDataCleanup(pDst);
+  int32_t code = blockDataEnsureCapacity(pDst, rows);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  size_t numOfCols = taosArrayGetSize(pBlock->pDataBlock);
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SColumnInfoData* pSrc = taosArrayGet(pBlock->pDataBlock, i);
+    SColumnInfoData* pDstCol = taosArrayGet(pDst->pDataBlock, i);
+    if (pSrc->pData == NULL) {
+      continue;
+    }
+
+    if (!IS_VAR_DATA_TYPE(pSrc->info.type) && !pSrc->hasNull) {
+      int32_t bytes = pSrc->info.bytes;
+      for (int32_t j = 0; j < rows; ++j) {
+        memcpy(pDstCol->pData + (int64_t)j * bytes, pSrc->pData + (int64_t)pSup->pSelection[j] * bytes, bytes);
+      }
+      continue;
+    }
+
+    for (int32_t j = 0; j < rows; ++j) {
+      int32_t rowIndex = pSup->pSelection[j];
+      bool    isNull = colDataIsNull(pSrc, rows, rowIndex, NULL);
+      code = colDataSetVal(pDstCol, j, isNull ? NULL : colDataGetData(pSrc, rowIndex), isNull);
+      if (code != TSDB_CODE_SUCCESS) {
+        return code;
+      }
+    }
+  }
+
+  pDst->info.rows = rows;
+  pDst->info.id = pBlock->info.id;
+  pDst->info.scanFlag = pBlock->info.scanFlag;
+  return TSDB_CODE_SUCCESS;
+}
+
+static bool isGroupbyBatchApplicable(SSDataBlock* pBlock) {
+  return pBlock->info.rows >= GROUPBY_BATCH_MIN_ROWS && pBlock->pBlockAgg == NULL;
+}
+
+// Vectorized version of doHashGroupbyAgg: all rows of a block are assigned to groups first, then the aggregate
+// functions are invoked once for each group, instead of once for each run of identical keys.
+static void doHashGroupbyAggBatch(SOperatorInfo* pOperator, SSDataBlock* pBlock) {
+  SExecTaskInfo*        pTaskInfo = pOperator->pTaskInfo;
+  SGroupbyOperatorInfo* pInfo = pOperator->info;
+  SGroupbyBatchSup*     pSup = &pInfo->batchSup;
+  SqlFunctionCtx*       pCtx = pOperator->exprSupp.pCtx;
+  int32_t               numOfExprs = pOperator->exprSupp.numOfExprs;
+  int32_t               rows = pBlock->info.rows;
+
+  int32_t code = ensureGroupbyBatchSup(pSup, getOperatorArena(pOperator), rows, pInfo->groupKeyLen);
+  if (code != TSDB_CODE_SUCCESS) {
+    T_LONG_JMP(pTaskInfo->env, code);
+  }
+
+  code = buildBatchGroupKeys(pInfo, pBlock);
+  if (code != TSDB_CODE_SUCCESS) {  // group by json error
+    T_LONG_JMP(pTaskInfo->env, code);
+  }
+
+  int32_t numOfRuns = 0;
+  int32_t numOfGroups = assignBatchGroups(pInfo, rows, &numOfRuns);
+
+  // the previous group key is not kept by this path
+  pInfo->isInit = false;
+
+  bool gathered = false;
+  if (numOfRuns > numOfGroups) {
+    code = gatherGroupRows(pSup, pBlock, numOfGroups);
+    if (code != TSDB_CODE_SUCCESS) {
+      qWarn("%s failed to gather rows for group by, code:%s, aggregate row by row", GET_TASKID(pTaskInfo),
+            tstrerror(code));
+      doHashGroupbyAgg(pOperator, pBlock);
+      return;
+    }
+
+    setInputDataBlock(&pOperator->exprSupp, pSup->pGatherBlock, pInfo->binfo.inputTsOrder, pBlock->info.scanFlag,
+                      true);
+    gathered = true;
+  }
+
+  for (int32_t i = 0; i < numOfGroups; ++i) {
+    int32_t first = pSup->pFirstRow[i];
+    int32_t ret = setGroupResultOutputBuf(pOperator, &(pInfo->binfo), numOfExprs,
+                                          pSup->pKeys + (int64_t)first * pInfo->groupKeyLen, pSup->pKeyLen[first],
+                                          pBlock->info.id.groupId, pInfo->aggSup.pResultBuf, &pInfo->aggSup);
+    if (ret != TSDB_CODE_SUCCESS) {
+      T_LONG_JMP(pTaskInfo->env, TSDB_CODE_APP_ERROR);
+    }
+
+    // without gathering, the rows of each group are already contiguous in the input block
+    int32_t rowIndex = gathered ? (pSup->pGroupEnd[i] - pSup->pGroupRows[i]) : first;
+    applyAggFunctionOnPartialTuples(pTaskInfo, pCtx, NULL, rowIndex, pSup->pGroupRows[i], rows, numOfExprs);
+    doAssignGroupKeys(pCtx, numOfExprs, rows, rowIndex);
+  }
+}
+
 static SSDataBlock* buildGroupResultDataBlock(SOperatorInfo* pOperator) {
   SGroupbyOperatorInfo* pInfo = pOperator->info;
 
@@ -406,7 +704,11 @@ static SSDataBlock* hashGroupbyAggregate(SOperatorInfo* pOperator) {
       }
     }
 
-    doHashGroupbyAgg(pOperator, pBlock);
+    if (isGroupbyBatchApplicable(pBlock)) {
+      doHashGroupbyAggBatch(pOperator, pBlock);
+    } else {
+      doHashGroupbyAgg(pOperator, pBlock);
+    }
   }
 
   pOperator->status = OP_RES_TO_RETURN;
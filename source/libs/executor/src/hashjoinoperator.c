@@ -67,6 +67,9 @@ static int32_t initHJoinKeyColsInfo(SHJoinTableInfo* pTable, SNodeList* pList) {
     SColumnNode* pColNode = (SColumnNode*)pNode;
     pTable->keyCols[i].srcSlot = pColNode->slotId;
     pTable->keyCols[i].vardata = IS_VAR_DATA_TYPE(pColNode->node.resType.type);
+    pTable->keyCols[i].type = pColNode->node.resType.type;
+    pTable->keyCols[i].primaryTs =
+        (pColNode->colId == PRIMARYKEY_TIMESTAMP_COL_ID && pColNode->colType == COLUMN_TYPE_COLUMN);
     pTable->keyCols[i].bytes = pColNode->node.resType.bytes;
     bufSize += pColNode->node.resType.bytes;
     ++i;
@@ -297,6 +300,18 @@ static void destroyHJoinKeyHash(SSHashObj** ppHash) {
   *ppHash = NULL;
 }
 
+static void destroyHJoinRuntimeFilter(SJoinRuntimeFilter** ppFilter) {
+  if (NULL == ppFilter || NULL == (*ppFilter)) {
+    return;
+  }
+
+  qDebug("hashJoin runtime filter, filteredRows:%" PRId64 ", prunedBlocks:%" PRId64, (*ppFilter)->filteredRows,
+         (*ppFilter)->prunedBlocks);
+
+  tBloomFilterDestroy((*ppFilter)->pBloomFilter);
+  taosMemoryFreeClear(*ppFilter);
+}
+
 static void destroyHashJoinOperator(void* param) {
   SHJoinOperatorInfo* pJoinOperator = (SHJoinOperatorInfo*)param;
   qError("hashJoin exec info, buildBlk:%" PRId64 ", buildRows:%" PRId64 ", probeBlk:%" PRId64 ", probeRows:%" PRId64 ", resRows:%" PRId64, 
@@ -304,6 +319,7 @@ static void destroyHashJoinOperator(void* param) {
          pJoinOperator->execInfo.probeBlkRows, pJoinOperator->execInfo.resRows);
 
   destroyHJoinKeyHash(&pJoinOperator->pKeyHash);
+  destroyHJoinRuntimeFilter(&pJoinOperator->pRuntimeFilter);
 
   freeHJoinTableInfo(&pJoinOperator->tbs[0]);
   freeHJoinTableInfo(&pJoinOperator->tbs[1]);
@@ -714,6 +730,63 @@ static int32_t buildHJoinKeyHash(struct SOperatorInfo* pOperator) {
   return TSDB_CODE_SUCCESS;
 }
 
+static bool hJoinRuntimeFilterApplicable(SHJoinOperatorInfo* pJoin) {
+  SHJoinTableInfo* pProbe = pJoin->pProbe;
+  SHJoinTableInfo* pBuild = pJoin->pBuild;
+
+  // only the rows of the probe side without any match can be dropped in advance
+  if (pJoin->joinType != JOIN_TYPE_INNER || pProbe->keyNum != 1 || pBuild->keyNum != 1) {
+    return false;
+  }
+
+  if (pProbe->keyCols[0].type != pBuild->keyCols[0].type || pProbe->keyCols[0].bytes != pBuild->keyCols[0].bytes) {
+    return false;
+  }
+
+  return pProbe->downStream->operatorType == QUERY_NODE_PHYSICAL_PLAN_TABLE_SCAN;
+}
+
+static int32_t buildHJoinRuntimeFilter(SHJoinOperatorInfo* pJoin) {
+  int32_t keyNum = tSimpleHashGetSize(pJoin->pKeyHash);
+
+  SJoinRuntimeFilter* pFilter = taosMemoryCalloc(1, sizeof(SJoinRuntimeFilter));
+  if (NULL == pFilter) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  pFilter->pBloomFilter = tBloomFilterInit(keyNum, 0.01);
+  if (NULL == pFilter->pBloomFilter) {
+    taosMemoryFree(pFilter);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  SHJoinColInfo* pKey = &pJoin->pProbe->keyCols[0];
+  pFilter->slotId = pKey->srcSlot;
+  pFilter->type = pKey->type;
+  pFilter->primaryTs = pKey->primaryTs && pJoin->pBuild->keyCols[0].primaryTs;
+  pFilter->hasMinMax = IS_SIGNED_NUMERIC_TYPE(pKey->type) || IS_TIMESTAMP_TYPE(pKey->type);
+  pFilter->min = INT64_MAX;
+  pFilter->max = INT64_MIN;
+
+  void*   pIte = NULL;
+  int32_t iter = 0;
+  while ((pIte = tSimpleHashIterate(pJoin->pKeyHash, pIte, &iter)) != NULL) {
+    size_t keyLen = 0;
+    char*  pData = tSimpleHashGetKey(pIte, &keyLen);
+    tBloomFilterPut(pFilter->pBloomFilter, pData, keyLen);
+
+    if (pFilter->hasMinMax) {
+      int64_t v = 0;
+      GET_TYPED_DATA(v, int64_t, pKey->type, pData);
+      pFilter->min = TMIN(pFilter->min, v);
+      pFilter->max = TMAX(pFilter->max, v);
+    }
+  }
+
+  pJoin->pRuntimeFilter = pFilter;
+  return TSDB_CODE_SUCCESS;
+}
+
 static int32_t launchBlockHashJoin(struct SOperatorInfo* pOperator, SSDataBlock* pBlock) {
   SHJoinOperatorInfo* pJoin = pOperator->info;
   SHJoinTableInfo* pProbe = pJoin->pProbe;
@@ -775,6 +848,16 @@ static SSDataBlock* doHashJoin(struct SOperatorInfo* pOperator) {
       goto _return;
     }
 
+    if (hJoinRuntimeFilterApplicable(pJoin)) {
+      code = buildHJoinRuntimeFilter(pJoin);
+      if (code) {
+        pTaskInfo->code = code;
+        T_LONG_JMP(pTaskInfo->env, code);
+      }
+
+      tableScanSetRuntimeFilter(pJoin->pProbe->downStream, pJoin->pRuntimeFilter);
+    }
+
     //qTrace("build table rows:%" PRId64, getRowsNumOfKeyHash(pJoin->pKeyHash));
   }
 
@@ -86,6 +86,16 @@ void setOperatorInfo(SOperatorInfo* pOperator, const char* name, int32_t type, b
   pOperator->pTaskInfo = pTaskInfo;
 }
 
+// The memory taken from the arena is released as a whole when the operator is destroyed, and is charged to the task
+// arena, which applies the per query memory limit.
+SArena* getOperatorArena(SOperatorInfo* pOperator) {
+  if (pOperator->pArena == NULL) {
+    SArena* pParent = (pOperator->pTaskInfo != NULL) ? pOperator->pTaskInfo->pArena : NULL;
+    pOperator->pArena = taosArenaInit(pParent, TARENA_DEFAULT_CHUNK_SIZE, 0);
+  }
+  return pOperator->pArena;
+}
+
 // each operator should be set their own function to return total cost buffer
 int32_t optrDefaultBufFn(SOperatorInfo* pOperator) {
   if (pOperator->blocking) {
@@ -251,6 +261,8 @@ static ERetType doStopDataReader(SOperatorInfo* pOperator, STraverParam* pParam,
     if (pInfo->base.dataReader != NULL) {
       pAPI->tsdReader.tsdReaderNotifyClosing(pInfo->base.dataReader);
     }
+
+    tableScanNotifyClosing(pInfo, pAPI);
     return OPTR_FN_RET_ABORT;
   } else if (pOperator->operatorType == QUERY_NODE_PHYSICAL_PLAN_STREAM_SCAN) {
     SStreamScanInfo* pInfo = pOperator->info;
@@ -475,6 +487,12 @@ SOperatorInfo* createOperator(SPhysiNode* pPhyNode, SExecTaskInfo* pTaskInfo, SR
     } else {
       pOptr = createAggregateOperatorInfo(ops[0], pAggNode, pTaskInfo);
     }
+
+    // the hash aggregate does not rely on the order of input blocks, so the tables can be scanned in parallel
+    SPhysiNode* pChildNode = (SPhysiNode*)nodesListGetNode(pPhyNode->pChildren, 0);
+    if (pOptr != NULL && tsQueryScanThreads > 1 && QUERY_NODE_PHYSICAL_PLAN_TABLE_SCAN == nodeType(pChildNode)) {
+      tableScanEnableParallel(ops[0], (STableScanPhysiNode*)pChildNode, tsQueryScanThreads);
+    }
   } else if (QUERY_NODE_PHYSICAL_PLAN_HASH_INTERVAL == type) {
     SIntervalPhysiNode* pIntervalPhyNode = (SIntervalPhysiNode*)pPhyNode;
     pOptr = createIntervalOperatorInfo(ops[0], pIntervalPhyNode, pTaskInfo);
@@ -575,6 +593,7 @@ void destroyOperator(SOperatorInfo* pOperator) {
   }
 
   cleanupExprSupp(&pOperator->exprSupp);
+  taosArenaDestroy(pOperator->pArena);
   taosMemoryFreeClear(pOperator);
 }
 
@@ -30,6 +30,7 @@
 #include "query.h"
 #include "querytask.h"
 #include "storageapi.h"
+#include "tglobal.h"
 #include "thash.h"
 #include "ttypes.h"
 
@@ -58,7 +59,12 @@ SExecTaskInfo* doCreateTask(uint64_t queryId, uint64_t taskId, int32_t vgId, EOP
   pTaskInfo->id.str = taosMemoryMalloc(64);
   buildTaskId(taskId, queryId, pTaskInfo->id.str);
   pTaskInfo->schemaInfos = taosArrayInit(1, sizeof(SSchemaInfo));
-  
+  pTaskInfo->pArena = taosArenaInit(NULL, TARENA_DEFAULT_CHUNK_SIZE, tsQueryArenaLimit * 1048576LL);
+  if (pTaskInfo->pArena == NULL) {
+    doDestroyTask(pTaskInfo);
+    return NULL;
+  }
+
   return pTaskInfo;
 }
 
@@ -233,6 +239,10 @@ void doDestroyTask(SExecTaskInfo* pTaskInfo) {
   taosArrayDestroy(pTaskInfo->stopInfo.pStopInfo);
   taosMemoryFreeClear(pTaskInfo->sql);
   taosMemoryFreeClear(pTaskInfo->id.str);
+  if (pTaskInfo->pArena != NULL) {
+    qDebug("%s arena peak memory:%" PRId64, GET_TASKID(pTaskInfo), taosArenaGetPeak(pTaskInfo->pArena));
+    taosArenaDestroy(pTaskInfo->pArena);
+  }
   taosMemoryFreeClear(pTaskInfo);
 }
 
@@ -230,6 +230,25 @@ static bool doFilterByBlockSMA(SFilterInfo* pFilterInfo, SColumnDataAgg** pColsA
   return keep;
 }
 
+// Check the filter against the zone map of every segment of the block, and return the rows of the block that may
+// match, in the file order. An empty range means no row of the block matches.
+static void doFilterByBlockZoneMap(STableScanBase* pTableScanInfo, SFilterInfo* pFilterInfo, SSDataBlock* pBlock,
+                                   SExecTaskInfo* pTaskInfo, int32_t* pStart, int32_t* pEnd) {
+  SStorageAPI*     pAPI = &pTaskInfo->storageAPI;
+  int32_t          segRows = 0;
+  int32_t          numOfSegs = 0;
+  SColumnDataAgg** pSegAgg = NULL;
+
+  int32_t code = pAPI->tsdReader.tsdReaderRetrieveBlockZoneMap(pTableScanInfo->dataReader, pBlock, &segRows,
+                                                               &numOfSegs, &pSegAgg);
+  if (code != TSDB_CODE_SUCCESS) {
+    T_LONG_JMP(pTaskInfo->env, code);
+  }
+
+  filterRangeExecuteSegs(pFilterInfo, pSegAgg, taosArrayGetSize(pBlock->pDataBlock), pBlock->info.rows, segRows,
+                         numOfSegs, pStart, pEnd);
+}
+
 static bool doLoadBlockSMA(STableScanBase* pTableScanInfo, SSDataBlock* pBlock, SExecTaskInfo* pTaskInfo) {
   SStorageAPI* pAPI = &pTaskInfo->storageAPI;
 
@@ -293,6 +312,85 @@ bool applyLimitOffset(SLimitInfo* pLimitInfo, SSDataBlock* pBlock, SExecTaskInfo
   return false;
 }
 
+static bool runtimeFilterPruneBlock(SJoinRuntimeFilter* pFilter, const SDataBlockInfo* pBlockInfo) {
+  if (pFilter == NULL || !pFilter->primaryTs || !pFilter->hasMinMax) {
+    return false;
+  }
+
+  if (pBlockInfo->window.ekey < pFilter->min || pBlockInfo->window.skey > pFilter->max) {
+    pFilter->prunedBlocks += 1;
+    return true;
+  }
+
+  return false;
+}
+
+// remove the rows whose join key can not be found in the build side of hash join
+static int32_t applyRuntimeFilter(SJoinRuntimeFilter* pFilter, SSDataBlock* pBlock) {
+  if (pFilter == NULL || pBlock->info.rows == 0) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, pFilter->slotId);
+  int32_t          rows = pBlock->info.rows;
+
+  bool* pKeep = taosMemoryMalloc(rows * sizeof(bool));
+  if (pKeep == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  bool    isVar = IS_VAR_DATA_TYPE(pCol->info.type);
+  int32_t numOfKeep = 0;
+  for (int32_t i = 0; i < rows; ++i) {
+    // a NULL key never matches in an inner join
+    if (colDataIsNull_s(pCol, i)) {
+      pKeep[i] = false;
+      continue;
+    }
+
+    char* pData = colDataGetData(pCol, i);
+    if (pFilter->hasMinMax) {
+      int64_t v = 0;
+      GET_TYPED_DATA(v, int64_t, pCol->info.type, pData);
+      if (v < pFilter->min || v > pFilter->max) {
+        pKeep[i] = false;
+        continue;
+      }
+    }
+
+    uint32_t len = isVar ? varDataTLen(pData) : pCol->info.bytes;
+    pKeep[i] = (tBloomFilterNoContain(pFilter->pBloomFilter, pData, len) != TSDB_CODE_SUCCESS);
+    numOfKeep += pKeep[i] ? 1 : 0;
+  }
+
+  if (numOfKeep < rows) {
+    trimDataBlock(pBlock, rows, pKeep);
+    pFilter->filteredRows += (rows - numOfKeep);
+  }
+
+  taosMemoryFree(pKeep);
+  return TSDB_CODE_SUCCESS;
+}
+
+void tableScanSetRuntimeFilter(SOperatorInfo* pOperator, SJoinRuntimeFilter* pFilter) {
+  if (pOperator->operatorType != QUERY_NODE_PHYSICAL_PLAN_TABLE_SCAN) {
+    return;
+  }
+
+  STableScanInfo* pInfo = pOperator->info;
+  pInfo->base.pRuntimeFilter = pFilter;
+
+  // the reader is not opened yet, so the files and blocks out of the key range are skipped by tsdb directly
+  if (pFilter->primaryTs && pFilter->hasMinMax && pInfo->base.dataReader == NULL && pInfo->pParallel == NULL &&
+      pInfo->base.cond.type == TIMEWINDOW_RANGE_CONTAINED) {
+    STimeWindow* pWin = &pInfo->base.cond.twindows;
+    pWin->skey = TMAX(pWin->skey, pFilter->min);
+    pWin->ekey = TMIN(pWin->ekey, pFilter->max);
+    qDebug("%s time window narrowed by join runtime filter, range:%" PRId64 "-%" PRId64,
+           GET_TASKID(pOperator->pTaskInfo), pWin->skey, pWin->ekey);
+  }
+}
+
 static int32_t loadDataBlock(SOperatorInfo* pOperator, STableScanBase* pTableScanInfo, SSDataBlock* pBlock,
                              uint32_t* status) {
   SExecTaskInfo*          pTaskInfo = pOperator->pTaskInfo;
@@ -305,7 +403,7 @@ static int32_t loadDataBlock(SOperatorInfo* pOperator, STableScanBase* pTableSca
 
   bool loadSMA = false;
   *status = pTableScanInfo->dataBlockLoadFlag;
-  if (pOperator->exprSupp.pFilterInfo != NULL ||
+  if (pOperator->exprSupp.pFilterInfo != NULL || pTableScanInfo->pRuntimeFilter != NULL ||
       overlapWithTimeWindow(&pTableScanInfo->pdInfo.interval, &pBlock->info, pTableScanInfo->cond.order)) {
     (*status) = FUNC_DATA_REQUIRED_DATA_LOAD;
   }
@@ -313,6 +411,10 @@ static int32_t loadDataBlock(SOperatorInfo* pOperator, STableScanBase* pTableSca
   SDataBlockInfo* pBlockInfo = &pBlock->info;
   taosMemoryFreeClear(pBlock->pBlockAgg);
 
+  if (runtimeFilterPruneBlock(pTableScanInfo->pRuntimeFilter, pBlockInfo)) {
+    *status = FUNC_DATA_REQUIRED_FILTEROUT;
+  }
+
   if (*status == FUNC_DATA_REQUIRED_FILTEROUT) {
     qDebug("%s data block filter out, brange:%" PRId64 "-%" PRId64 ", rows:%" PRId64, GET_TASKID(pTaskInfo),
            pBlockInfo->window.skey, pBlockInfo->window.ekey, pBlockInfo->rows);
@@ -346,6 +448,11 @@ static int32_t loadDataBlock(SOperatorInfo* pOperator, STableScanBase* pTableSca
 
   ASSERT(*status == FUNC_DATA_REQUIRED_DATA_LOAD);
 
+  // rows of the block that may pass the filter, in the file order
+  int32_t zoneRows = pBlockInfo->rows;
+  int32_t zoneStart = 0;
+  int32_t zoneEnd = zoneRows;
+
   // try to filter data block according to sma info
   if (pOperator->exprSupp.pFilterInfo != NULL && (!loadSMA)) {
     bool success = doLoadBlockSMA(pTableScanInfo, pBlock, pTaskInfo);
@@ -361,6 +468,19 @@ static int32_t loadDataBlock(SOperatorInfo* pOperator, STableScanBase* pTableSca
         pAPI->tsdReader.tsdReaderReleaseDataBlock(pTableScanInfo->dataReader);
         return TSDB_CODE_SUCCESS;
       }
+
+      // the value range of the whole block overlaps with the filter, the segments may still not
+      doFilterByBlockZoneMap(pTableScanInfo, pOperator->exprSupp.pFilterInfo, pBlock, pTaskInfo, &zoneStart,
+                             &zoneEnd);
+      if (zoneStart >= zoneEnd) {
+        qDebug("%s data block filter out by zone map, brange:%" PRId64 "-%" PRId64 ", rows:%" PRId64,
+               GET_TASKID(pTaskInfo), pBlockInfo->window.skey, pBlockInfo->window.ekey, pBlockInfo->rows);
+        pCost->filterOutBlocks += 1;
+        (*status) = FUNC_DATA_REQUIRED_FILTEROUT;
+
+        pAPI->tsdReader.tsdReaderReleaseDataBlock(pTableScanInfo->dataReader);
+        return TSDB_CODE_SUCCESS;
+      }
     }
   }
 
@@ -398,6 +518,13 @@ static int32_t loadDataBlock(SOperatorInfo* pOperator, STableScanBase* pTableSca
   // restore the previous value
   pCost->totalRows -= pBlock->info.rows;
 
+  // drop the leading and trailing segments that can not match before the filter is evaluated row by row
+  if (zoneEnd - zoneStart < zoneRows && pBlock->info.rows == zoneRows) {
+    int32_t start = (pTableScanInfo->cond.order == TSDB_ORDER_ASC) ? zoneStart : zoneRows - zoneEnd;
+    blockDataTrimFirstRows(pBlock, start);
+    blockDataKeepFirstNRows(pBlock, zoneEnd - zoneStart);
+  }
+
   if (pOperator->exprSupp.pFilterInfo != NULL) {
     int32_t code = doFilter(pBlock, pOperator->exprSupp.pFilterInfo, &pTableScanInfo->matchInfo);
     if (code != TSDB_CODE_SUCCESS) return code;
@@ -415,6 +542,11 @@ static int32_t loadDataBlock(SOperatorInfo* pOperator, STableScanBase* pTableSca
     }
   }
 
+  if (pTableScanInfo->pRuntimeFilter != NULL) {
+    int32_t code = applyRuntimeFilter(pTableScanInfo->pRuntimeFilter, pBlock);
+    if (code != TSDB_CODE_SUCCESS) return code;
+  }
+
   bool limitReached = applyLimitOffset(&pTableScanInfo->limitInfo, pBlock, pTaskInfo);
   if (limitReached) {  // set operator flag is done
     setOperatorCompleted(pOperator);
@@ -613,9 +745,13 @@ int32_t addTagPseudoColumnData(SReadHandle* pHandle, const SExprInfo* pExpr, int
           }
           return code;
         }
-      } else {  // todo opt for json tag
-        for (int32_t i = 0; i < pBlock->info.rows; ++i) {
-          colDataSetVal(pColInfoData, i, data, false);
+      } else {  // the json tag is stored once and shared by all the rows
+        code = colDataCopyNItems(pColInfoData, 0, data, pBlock->info.rows, false);
+        if (code) {
+          if (freeReader) {
+            pHandle->api.metaReaderFn.clearReader(&mr);
+          }
+          return code;
         }
       }
     }
@@ -917,11 +1053,463 @@ static SSDataBlock* groupSeqTableScan(SOperatorInfo* pOperator) {
   return result;
 }
 
+static void destroyTableScanParallel(STableScanParallel* pParallel, TsdReader* pAPI) {
+  if (pParallel == NULL) {
+    return;
+  }
+
+  taosThreadMutexLock(&pParallel->lock);
+  pParallel->stop = true;
+  for (int32_t i = 0; i < pParallel->numOfWorkers; ++i) {
+    if (pParallel->pWorkers[i].dataReader != NULL) {
+      pAPI->tsdReaderNotifyClosing(pParallel->pWorkers[i].dataReader);
+    }
+  }
+  taosThreadCondBroadcast(&pParallel->notFull);
+  taosThreadCondBroadcast(&pParallel->notEmpty);
+  taosThreadMutexUnlock(&pParallel->lock);
+
+  for (int32_t i = 0; i < pParallel->numOfWorkers; ++i) {
+    STableScanWorker* pWorker = &pParallel->pWorkers[i];
+    if (pWorker->started) {
+      taosThreadJoin(pWorker->thread, NULL);
+    }
+
+    pAPI->tsdReaderClose(pWorker->dataReader);
+    blockDataDestroy(pWorker->pResBlock);
+    filterFreeInfo(pWorker->pFilterInfo);
+    taosHashCleanup(pWorker->pIgnoreTables);
+    taosLRUCacheCleanup(pWorker->metaCache.pTableMetaEntryCache);
+  }
+
+  for (int32_t i = 0; i < pParallel->queueSize; ++i) {
+    blockDataDestroy(pParallel->pQueue[(pParallel->queueHead + i) % pParallel->queueCap]);
+  }
+
+  for (int32_t i = 0; i < pParallel->numOfFree; ++i) {
+    blockDataDestroy(pParallel->pFreeList[i]);
+  }
+
+  blockDataDestroy(pParallel->pCurrent);
+  taosMemoryFree(pParallel->pQueue);
+  taosMemoryFree(pParallel->pFreeList);
+  taosMemoryFree(pParallel->pWorkers);
+
+  taosThreadCondDestroy(&pParallel->notFull);
+  taosThreadCondDestroy(&pParallel->notEmpty);
+  taosThreadMutexDestroy(&pParallel->lock);
+  taosMemoryFree(pParallel);
+}
+
+void tableScanEnableParallel(SOperatorInfo* pOperator, STableScanPhysiNode* pTableScanNode, int32_t numOfThreads) {
+  STableScanInfo* pInfo = pOperator->info;
+  SExecTaskInfo*  pTaskInfo = pOperator->pTaskInfo;
+
+  // only the plain one-pass scan, whose output order does not matter, is allowed to run in parallel.
+  if (numOfThreads <= 1 || pInfo->pParallel != NULL || pTableScanNode->scan.node.dynamicOp ||
+      pTableScanNode->groupSort || pInfo->scanInfo.numOfAsc != 1 || pInfo->scanInfo.numOfDesc != 0 ||
+      pInfo->sample.sampleRatio != 1 || pInfo->base.limitInfo.limit.limit >= 0 ||
+      pInfo->base.limitInfo.limit.offset > 0 || pInfo->base.limitInfo.slimit.limit >= 0 ||
+      pInfo->base.dataBlockLoadFlag != FUNC_DATA_REQUIRED_DATA_LOAD ||
+      pInfo->base.cond.type != TIMEWINDOW_RANGE_CONTAINED || pInfo->base.pdInfo.interval.interval > 0 ||
+      pInfo->countOnly) {
+    return;
+  }
+
+  int32_t numOfTables = tableListGetSize(pInfo->base.pTableListInfo);
+  if (numOfTables < numOfThreads * 2 || tableListGetOutputGroups(pInfo->base.pTableListInfo) > 1) {
+    return;
+  }
+
+  STableScanParallel* pParallel = taosMemoryCalloc(1, sizeof(STableScanParallel));
+  if (pParallel == NULL) {
+    return;
+  }
+
+  taosThreadMutexInit(&pParallel->lock, NULL);
+  taosThreadCondInit(&pParallel->notEmpty, NULL);
+  taosThreadCondInit(&pParallel->notFull, NULL);
+
+  pParallel->pOperator = pOperator;
+  pParallel->numOfWorkers = numOfThreads;
+  // several morsels for each worker, so that the workers can steal the remain tables from the slow ones.
+  pParallel->morselSize = TMAX(numOfTables / (numOfThreads * 4), 1);
+  pParallel->queueCap = numOfThreads * 2;
+  pParallel->pQueue = taosMemoryCalloc(pParallel->queueCap, POINTER_BYTES);
+  // the blocks in the queue, the one hold by the upstream operator and the ones being filled by the workers.
+  pParallel->freeCap = pParallel->queueCap + numOfThreads + 1;
+  pParallel->pFreeList = taosMemoryCalloc(pParallel->freeCap, POINTER_BYTES);
+  pParallel->pWorkers = taosMemoryCalloc(numOfThreads, sizeof(STableScanWorker));
+  if (pParallel->pQueue == NULL || pParallel->pFreeList == NULL || pParallel->pWorkers == NULL) {
+    destroyTableScanParallel(pParallel, &pInfo->base.readerAPI);
+    return;
+  }
+
+  for (int32_t i = 0; i < numOfThreads; ++i) {
+    STableScanWorker* pWorker = &pParallel->pWorkers[i];
+    pWorker->index = i;
+    pWorker->pParallel = pParallel;
+    pWorker->cond = pInfo->base.cond;
+    pWorker->pResBlock = createOneDataBlock(pInfo->pResBlock, false);
+    pWorker->metaCache.pTableMetaEntryCache = taosLRUCacheInit(1024 * 128, -1, .5);
+    int32_t code = filterInitFromNode((SNode*)pTableScanNode->scan.node.pConditions, &pWorker->pFilterInfo, 0);
+    if (pWorker->pResBlock == NULL || pWorker->metaCache.pTableMetaEntryCache == NULL || code != TSDB_CODE_SUCCESS) {
+      destroyTableScanParallel(pParallel, &pInfo->base.readerAPI);
+      return;
+    }
+
+    taosLRUCacheSetStrictCapacity(pWorker->metaCache.pTableMetaEntryCache, false);
+  }
+
+  qDebug("%s table scan in parallel, threads:%d, tables:%d, morsel size:%d", GET_TASKID(pTaskInfo), numOfThreads,
+         numOfTables, pParallel->morselSize);
+  pInfo->pParallel = pParallel;
+}
+
+static bool tableScanGetNextMorsel(STableScanParallel* pParallel, STableKeyInfo** pList, int32_t* num) {
+  STableScanInfo* pInfo = pParallel->pOperator->info;
+
+  taosThreadMutexLock(&pParallel->lock);
+  int32_t total = tableListGetSize(pInfo->base.pTableListInfo);
+  bool    hasMorsel = (!pParallel->stop) && (pParallel->nextTable < total);
+  if (hasMorsel) {
+    *pList = tableListGetInfo(pInfo->base.pTableListInfo, pParallel->nextTable);
+    *num = TMIN(pParallel->morselSize, total - pParallel->nextTable);
+    pParallel->nextTable += (*num);
+  }
+  taosThreadMutexUnlock(&pParallel->lock);
+
+  return hasMorsel;
+}
+
+// the caller should hold the lock
+static void tableScanParallelRecycle(STableScanParallel* pParallel, SSDataBlock* pBlock) {
+  if (pBlock == NULL) {
+    return;
+  }
+
+  if (pParallel->numOfFree < pParallel->freeCap) {
+    pParallel->pFreeList[pParallel->numOfFree++] = pBlock;
+  } else {
+    blockDataDestroy(pBlock);
+  }
+}
+
+static SSDataBlock* tableScanParallelGetFree(STableScanParallel* pParallel) {
+  STableScanInfo* pInfo = pParallel->pOperator->info;
+  SSDataBlock*    pBlock = NULL;
+
+  taosThreadMutexLock(&pParallel->lock);
+  if (pParallel->numOfFree > 0) {
+    pBlock = pParallel->pFreeList[--pParallel->numOfFree];
+  }
+  taosThreadMutexUnlock(&pParallel->lock);
+
+  if (pBlock == NULL) {
+    pBlock = createOneDataBlock(pInfo->pResBlock, false);
+  }
+  return pBlock;
+}
+
+// Move the loaded rows out of the block of the reader by swapping the column buffers, instead of copying them. The
+// column info structs of the reader block stay where they are, since the reader refers to them.
+static int32_t tableScanWorkerHandOver(SSDataBlock* pSrc, SSDataBlock* pDst) {
+  uint32_t capacity = pSrc->info.capacity;
+
+  size_t numOfCols = taosArrayGetSize(pSrc->pDataBlock);
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SColumnInfoData* pSrcCol = taosArrayGet(pSrc->pDataBlock, i);
+    SColumnInfoData* pDstCol = taosArrayGet(pDst->pDataBlock, i);
+    TSWAP(pSrcCol->pData, pDstCol->pData);
+    TSWAP(pSrcCol->varmeta, pDstCol->varmeta);
+    TSWAP(pSrcCol->hasNull, pDstCol->hasNull);
+    TSWAP(pSrcCol->reassigned, pDstCol->reassigned);
+  }
+
+  TSWAP(pSrc->info, pDst->info);
+  blockDataCleanup(pSrc);
+  return blockDataEnsureCapacity(pSrc, capacity);
+}
+
+static int32_t tableScanParallelPush(STableScanParallel* pParallel, SSDataBlock* pBlock) {
+  taosThreadMutexLock(&pParallel->lock);
+  while (pParallel->queueSize >= pParallel->queueCap && !pParallel->stop) {
+    taosThreadCondWait(&pParallel->notFull, &pParallel->lock);
+  }
+
+  if (pParallel->stop) {
+    tableScanParallelRecycle(pParallel, pBlock);
+    taosThreadMutexUnlock(&pParallel->lock);
+    return TSDB_CODE_TSC_QUERY_KILLED;
+  }
+
+  pParallel->pQueue[(pParallel->queueHead + pParallel->queueSize) % pParallel->queueCap] = pBlock;
+  pParallel->queueSize += 1;
+  taosThreadCondSignal(&pParallel->notEmpty);
+  taosThreadMutexUnlock(&pParallel->lock);
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t tableScanWorkerScanMorsel(STableScanWorker* pWorker, STableKeyInfo* pList, int32_t num) {
+  STableScanParallel* pParallel = pWorker->pParallel;
+  SOperatorInfo*      pOperator = pParallel->pOperator;
+  STableScanInfo*     pInfo = pOperator->info;
+  SExecTaskInfo*      pTaskInfo = pOperator->pTaskInfo;
+  TsdReader*          pAPI = &pInfo->base.readerAPI;
+  SSDataBlock*        pBlock = pWorker->pResBlock;
+  STsdbReader*        pReader = pWorker->dataReader;
+  int32_t             code = TSDB_CODE_SUCCESS;
+
+  if (pReader == NULL) {
+    code = pAPI->tsdReaderOpen(pInfo->base.readHandle.vnode, &pWorker->cond, pList, num, pBlock, (void**)&pReader,
+                               GET_TASKID(pTaskInfo), false, &pWorker->pIgnoreTables);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+
+    taosThreadMutexLock(&pParallel->lock);
+    pWorker->dataReader = pReader;
+    taosThreadMutexUnlock(&pParallel->lock);
+  } else {
+    // the following morsels are scanned with the snapshot taken when the reader is opened
+    code = pAPI->tsdSetQueryTableList(pReader, pList, num);
+    if (code == TSDB_CODE_SUCCESS) {
+      code = pAPI->tsdReaderResetStatus(pReader, &pWorker->cond);
+    }
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
+  while (1) {
+    bool hasNext = false;
+    code = pAPI->tsdNextDataBlock(pReader, &hasNext);
+    if (code != TSDB_CODE_SUCCESS || !hasNext) {
+      break;
+    }
+
+    if (isTaskKilled(pTaskInfo) || pParallel->stop) {
+      pAPI->tsdReaderReleaseDataBlock(pReader);
+      code = TSDB_CODE_TSC_QUERY_KILLED;
+      break;
+    }
+
+    if (pBlock->info.id.uid) {
+      pBlock->info.id.groupId = tableListGetTableGroupId(pInfo->base.pTableListInfo, pBlock->info.id.uid);
+    }
+
+    SFileBlockLoadRecorder* pCost = &pWorker->readRecorder;
+    pCost->totalBlocks += 1;
+    pCost->loadBlocks += 1;
+    pCost->totalCheckedRows += pBlock->info.rows;
+
+    if (pAPI->tsdReaderRetrieveDataBlock(pReader, NULL) == NULL) {
+      code = terrno;
+      break;
+    }
+
+    if (pInfo->base.pseudoSup.numOfExprs > 0) {
+      SExprSupp* pSup = &pInfo->base.pseudoSup;
+      code = addTagPseudoColumnData(&pInfo->base.readHandle, pSup->pExprInfo, pSup->numOfExprs, pBlock,
+                                    pBlock->info.rows, GET_TASKID(pTaskInfo), &pWorker->metaCache);
+      // ignore the table not exists error, since this table may have been dropped during the scan procedure.
+      if (code != TSDB_CODE_SUCCESS && code != TSDB_CODE_PAR_TABLE_NOT_EXIST) {
+        break;
+      }
+      code = TSDB_CODE_SUCCESS;
+    }
+
+    code = doFilter(pBlock, pWorker->pFilterInfo, &pInfo->base.matchInfo);
+    if (code != TSDB_CODE_SUCCESS) {
+      break;
+    }
+
+    if (pBlock->info.rows == 0) {
+      pCost->filterOutBlocks += 1;
+      continue;
+    }
+
+    pCost->totalRows += pBlock->info.rows;
+    pBlock->info.scanFlag = pInfo->base.scanFlag;
+
+    SSDataBlock* pOutput = tableScanParallelGetFree(pParallel);
+    if (pOutput == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      break;
+    }
+
+    code = tableScanWorkerHandOver(pBlock, pOutput);
+    if (code == TSDB_CODE_SUCCESS) {
+      code = tableScanParallelPush(pParallel, pOutput);
+    } else {
+      blockDataDestroy(pOutput);
+    }
+
+    if (code != TSDB_CODE_SUCCESS) {
+      break;
+    }
+  }
+
+  return code;
+}
+
+static void* tableScanWorkerThreadFp(void* param) {
+  STableScanWorker*   pWorker = param;
+  STableScanParallel* pParallel = pWorker->pParallel;
+  STableScanInfo*     pInfo = pParallel->pOperator->info;
+
+  setThreadName("query-scan");
+
+  int32_t        code = TSDB_CODE_SUCCESS;
+  STableKeyInfo* pList = NULL;
+  int32_t        num = 0;
+  while (code == TSDB_CODE_SUCCESS && tableScanGetNextMorsel(pParallel, &pList, &num)) {
+    code = tableScanWorkerScanMorsel(pWorker, pList, num);
+  }
+
+  taosThreadMutexLock(&pParallel->lock);
+  STsdbReader* pReader = pWorker->dataReader;
+  pWorker->dataReader = NULL;
+  taosThreadMutexUnlock(&pParallel->lock);
+
+  pInfo->base.readerAPI.tsdReaderClose(pReader);
+
+  taosThreadMutexLock(&pParallel->lock);
+  pInfo->base.metaCache.metaFetch += pWorker->metaCache.metaFetch;
+  pInfo->base.metaCache.cacheHit += pWorker->metaCache.cacheHit;
+
+  SFileBlockLoadRecorder* pDst = &pInfo->base.readRecorder;
+  SFileBlockLoadRecorder* pSrc = &pWorker->readRecorder;
+  pDst->totalBlocks += pSrc->totalBlocks;
+  pDst->loadBlocks += pSrc->loadBlocks;
+  pDst->filterOutBlocks += pSrc->filterOutBlocks;
+  pDst->totalRows += pSrc->totalRows;
+  pDst->totalCheckedRows += pSrc->totalCheckedRows;
+
+  if (code != TSDB_CODE_SUCCESS && pParallel->code == TSDB_CODE_SUCCESS && !pParallel->stop) {
+    pParallel->code = code;
+    pParallel->stop = true;
+    taosThreadCondBroadcast(&pParallel->notFull);
+  }
+
+  pParallel->runningWorkers -= 1;
+  taosThreadCondBroadcast(&pParallel->notEmpty);
+  taosThreadMutexUnlock(&pParallel->lock);
+  return NULL;
+}
+
+static int32_t startTableScanParallel(STableScanParallel* pParallel) {
+  TdThreadAttr thAttr;
+  taosThreadAttrInit(&thAttr);
+  taosThreadAttrSetDetachState(&thAttr, PTHREAD_CREATE_JOINABLE);
+
+  int32_t code = TSDB_CODE_SUCCESS;
+  taosThreadMutexLock(&pParallel->lock);
+  pParallel->started = true;
+  for (int32_t i = 0; i < pParallel->numOfWorkers; ++i) {
+    STableScanWorker* pWorker = &pParallel->pWorkers[i];
+    if (taosThreadCreate(&pWorker->thread, &thAttr, tableScanWorkerThreadFp, pWorker) != 0) {
+      code = TAOS_SYSTEM_ERROR(errno);
+      break;
+    }
+
+    pWorker->started = true;
+    pParallel->runningWorkers += 1;
+  }
+  taosThreadMutexUnlock(&pParallel->lock);
+
+  taosThreadAttrDestroy(&thAttr);
+  return code;
+}
+
+// The worker threads load and filter the data blocks of the table morsels, while the query thread only takes the
+// loaded blocks from the queue and hands them to the upstream operators. The returned block is recycled by the
+// workers in the next call.
+static SSDataBlock* doParallelTableScan(SOperatorInfo* pOperator) {
+  STableScanInfo*     pInfo = pOperator->info;
+  SExecTaskInfo*      pTaskInfo = pOperator->pTaskInfo;
+  STableScanParallel* pParallel = pInfo->pParallel;
+
+  if (pOperator->status == OP_EXEC_DONE) {
+    return NULL;
+  }
+
+  int64_t st = taosGetTimestampUs();
+  if (!pParallel->started) {
+    int32_t code = startTableScanParallel(pParallel);
+    if (code != TSDB_CODE_SUCCESS) {
+      qError("%s failed to start table scan threads, code:%s", GET_TASKID(pTaskInfo), tstrerror(code));
+      T_LONG_JMP(pTaskInfo->env, code);
+    }
+  }
+
+  taosThreadMutexLock(&pParallel->lock);
+  tableScanParallelRecycle(pParallel, pParallel->pCurrent);
+  pParallel->pCurrent = NULL;
+
+  while (pParallel->queueSize == 0 && pParallel->runningWorkers > 0 && pParallel->code == TSDB_CODE_SUCCESS &&
+         !pParallel->stop) {
+    taosThreadCondWait(&pParallel->notEmpty, &pParallel->lock);
+  }
+
+  // the scan is closing, what is left in the queue is not a complete result
+  int32_t code = pParallel->code;
+  if (code == TSDB_CODE_SUCCESS && pParallel->stop) {
+    code = TSDB_CODE_TSC_QUERY_KILLED;
+  }
+  if (code == TSDB_CODE_SUCCESS && pParallel->queueSize > 0) {
+    pParallel->pCurrent = pParallel->pQueue[pParallel->queueHead];
+    pParallel->queueHead = (pParallel->queueHead + 1) % pParallel->queueCap;
+    pParallel->queueSize -= 1;
+    taosThreadCondSignal(&pParallel->notFull);
+  }
+  taosThreadMutexUnlock(&pParallel->lock);
+
+  if (code != TSDB_CODE_SUCCESS) {
+    T_LONG_JMP(pTaskInfo->env, code);
+  }
+
+  pInfo->base.readRecorder.elapsedTime += (taosGetTimestampUs() - st) / 1000.0;
+  pOperator->cost.totalCost = pInfo->base.readRecorder.elapsedTime;
+
+  if (pParallel->pCurrent == NULL) {
+    setOperatorCompleted(pOperator);
+    return NULL;
+  }
+
+  pOperator->resultInfo.totalRows += pParallel->pCurrent->info.rows;
+  return pParallel->pCurrent;
+}
+
+void tableScanNotifyClosing(STableScanInfo* pInfo, SStorageAPI* pAPI) {
+  STableScanParallel* pParallel = pInfo->pParallel;
+  if (pParallel == NULL) {
+    return;
+  }
+
+  // the workers stop taking morsels and the ones waiting for room in the queue are woken up, they are joined when
+  // the operator is destroyed
+  taosThreadMutexLock(&pParallel->lock);
+  pParallel->stop = true;
+  for (int32_t i = 0; i < pParallel->numOfWorkers; ++i) {
+    if (pParallel->pWorkers[i].dataReader != NULL) {
+      pAPI->tsdReader.tsdReaderNotifyClosing(pParallel->pWorkers[i].dataReader);
+    }
+  }
+  taosThreadCondBroadcast(&pParallel->notFull);
+  taosThreadCondBroadcast(&pParallel->notEmpty);
+  taosThreadMutexUnlock(&pParallel->lock);
+}
+
 static SSDataBlock* doTableScan(SOperatorInfo* pOperator) {
   STableScanInfo* pInfo = pOperator->info;
   SExecTaskInfo*  pTaskInfo = pOperator->pTaskInfo;
   SStorageAPI*    pAPI = &pTaskInfo->storageAPI;
 
+  if (pInfo->pParallel != NULL) {
+    return doParallelTableScan(pOperator);
+  }
+
   if (pOperator->pOperatorGetParam) {
     pOperator->dynamicTask = true;
     int32_t code = createTableListInfoFromParam(pOperator);
@@ -1008,6 +1596,7 @@ static void destroyTableScanBase(STableScanBase* pBase, TsdReader* pAPI) {
 
 static void destroyTableScanOperatorInfo(void* param) {
   STableScanInfo* pTableScanInfo = (STableScanInfo*)param;
+  destroyTableScanParallel(pTableScanInfo->pParallel, &pTableScanInfo->base.readerAPI);
   blockDataDestroy(pTableScanInfo->pResBlock);
   taosHashCleanup(pTableScanInfo->pIgnoreTables);
   destroyTableScanBase(&pTableScanInfo->base, &pTableScanInfo->base.readerAPI);
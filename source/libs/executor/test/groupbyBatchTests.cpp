@@ -0,0 +1,299 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "executorInt.h"
+#include "functionMgt.h"
+#include "operator.h"
+#include "querytask.h"
+#include "tdatablock.h"
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+namespace {
+
+// select count(v), sum(v), k from t group by k. Blocks with 64 rows or more are aggregated by the vectorized path, the
+// smaller ones row by row, so the same rows split into large and small blocks exercise both paths.
+const int32_t kRows = 600;
+const int32_t kBatchBlockRows = 200;
+const int32_t kRowBlockRows = 20;
+const int32_t kVarKeyLen = 16;
+
+const int16_t kInputBlockId = 1;
+const int16_t kOutputBlockId = 2;
+
+struct SGroupRes {
+  int64_t count;
+  int64_t sum;
+  bool operator==(const SGroupRes& o) const { return count == o.count && sum == o.sum; }
+};
+
+// the key of the null group is an empty string, the other keys are prefixed with "k:"
+typedef std::map<std::string, SGroupRes>     SGroupResMap;
+typedef std::function<bool(int32_t, char*)> FGenKey;  // returns false for the null key
+
+struct SDummyInput {
+  std::vector<SSDataBlock*> blocks;
+  size_t                    index;
+};
+
+SSDataBlock* getNextDummyBlock(SOperatorInfo* pOperator) {
+  SDummyInput* pInput = (SDummyInput*)pOperator->info;
+  return (pInput->index < pInput->blocks.size()) ? pInput->blocks[pInput->index++] : NULL;
+}
+
+void destroyDummyInput(void* param) {
+  SDummyInput* pInput = (SDummyInput*)param;
+  for (auto pBlock : pInput->blocks) {
+    blockDataDestroy(pBlock);
+  }
+  delete pInput;
+}
+
+int32_t keyBytes(int8_t keyType) {
+  return IS_VAR_DATA_TYPE(keyType) ? kVarKeyLen + VARSTR_HEADER_SIZE : tDataTypes[keyType].bytes;
+}
+
+// input block: ts, k, v
+SOperatorInfo* createDummyInput(int8_t keyType, int32_t rowsPerBlock, const FGenKey& genKey) {
+  SDummyInput* pInput = new SDummyInput();
+  pInput->index = 0;
+
+  char key[kVarKeyLen + VARSTR_HEADER_SIZE] = {0};
+  for (int32_t start = 0; start < kRows; start += rowsPerBlock) {
+    int32_t      rows = TMIN(rowsPerBlock, kRows - start);
+    SSDataBlock* pBlock = createDataBlock();
+    pBlock->info.id.blockId = kInputBlockId;
+
+    SColumnInfoData ts = createColumnInfoData(TSDB_DATA_TYPE_TIMESTAMP, sizeof(int64_t), 0);
+    SColumnInfoData k = createColumnInfoData(keyType, keyBytes(keyType), 1);
+    SColumnInfoData v = createColumnInfoData(TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), 2);
+    blockDataAppendColInfo(pBlock, &ts);
+    blockDataAppendColInfo(pBlock, &k);
+    blockDataAppendColInfo(pBlock, &v);
+    blockDataEnsureCapacity(pBlock, rows);
+
+    SColumnInfoData* pTs = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 0);
+    SColumnInfoData* pKey = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 1);
+    SColumnInfoData* pVal = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 2);
+    for (int32_t j = 0; j < rows; ++j) {
+      int64_t i = start + j;
+      colDataSetVal(pTs, j, (const char*)&i, false);
+      colDataSetVal(pVal, j, (const char*)&i, false);
+      if (genKey(i, key)) {
+        colDataSetVal(pKey, j, key, false);
+      } else {
+        colDataSetNULL(pKey, j);
+      }
+    }
+
+    pBlock->info.rows = rows;
+    pInput->blocks.push_back(pBlock);
+  }
+
+  SOperatorInfo* pOperator = (SOperatorInfo*)taosMemoryCalloc(1, sizeof(SOperatorInfo));
+  pOperator->name = "DummyInput";
+  pOperator->info = pInput;
+  pOperator->fpSet.getNextFn = getNextDummyBlock;
+  pOperator->fpSet.closeFn = destroyDummyInput;
+  return pOperator;
+}
+
+SNode* makeColumn(int16_t slotId, int8_t type, int32_t bytes) {
+  SColumnNode* pCol = (SColumnNode*)nodesMakeNode(QUERY_NODE_COLUMN);
+  pCol->dataBlockId = kInputBlockId;
+  pCol->slotId = slotId;
+  pCol->colId = slotId + 1;
+  pCol->colType = COLUMN_TYPE_COLUMN;
+  pCol->node.resType.type = type;
+  pCol->node.resType.bytes = bytes;
+  return (SNode*)pCol;
+}
+
+SNode* makeTarget(int16_t slotId, SNode* pExpr) {
+  STargetNode* pTarget = (STargetNode*)nodesMakeNode(QUERY_NODE_TARGET);
+  pTarget->dataBlockId = kOutputBlockId;
+  pTarget->slotId = slotId;
+  pTarget->pExpr = pExpr;
+  return (SNode*)pTarget;
+}
+
+SNode* makeFunction(const char* pName, SNode* pParam) {
+  SFunctionNode* pFunc = (SFunctionNode*)nodesMakeNode(QUERY_NODE_FUNCTION);
+  strcpy(pFunc->functionName, pName);
+  nodesListMakeAppend(&pFunc->pParameterList, pParam);
+
+  char msg[128] = {0};
+  EXPECT_EQ(fmGetFuncInfo(pFunc, msg, sizeof(msg)), TSDB_CODE_SUCCESS);
+  return (SNode*)pFunc;
+}
+
+SNode* makeSlot(int16_t slotId, const SDataType& dataType) {
+  SSlotDescNode* pSlot = (SSlotDescNode*)nodesMakeNode(QUERY_NODE_SLOT_DESC);
+  pSlot->slotId = slotId;
+  pSlot->dataType = dataType;
+  pSlot->output = true;
+  return (SNode*)pSlot;
+}
+
+// output block in the layout of the planner: k, count(v), sum(v), _group_key(k)
+SAggPhysiNode* makeAggNode(int8_t keyType) {
+  SAggPhysiNode* pNode = (SAggPhysiNode*)nodesMakeNode(QUERY_NODE_PHYSICAL_PLAN_HASH_AGG);
+  pNode->node.inputTsOrder = ORDER_ASC;
+  pNode->node.outputTsOrder = ORDER_ASC;
+
+  nodesListMakeAppend(&pNode->pGroupKeys, makeTarget(0, makeColumn(1, keyType, keyBytes(keyType))));
+  nodesListMakeAppend(&pNode->pAggFuncs,
+                      makeTarget(1, makeFunction("count", makeColumn(2, TSDB_DATA_TYPE_BIGINT, sizeof(int64_t)))));
+  nodesListMakeAppend(&pNode->pAggFuncs,
+                      makeTarget(2, makeFunction("sum", makeColumn(2, TSDB_DATA_TYPE_BIGINT, sizeof(int64_t)))));
+  nodesListMakeAppend(&pNode->pAggFuncs,
+                      makeTarget(3, makeFunction("_group_key", makeColumn(1, keyType, keyBytes(keyType)))));
+
+  SDataBlockDescNode* pDesc = (SDataBlockDescNode*)nodesMakeNode(QUERY_NODE_DATABLOCK_DESC);
+  pDesc->dataBlockId = kOutputBlockId;
+  SNode* pTarget = NULL;
+  FOREACH(pTarget, pNode->pGroupKeys) {
+    SExprNode* pExpr = (SExprNode*)((STargetNode*)pTarget)->pExpr;
+    nodesListMakeAppend(&pDesc->pSlots, makeSlot(((STargetNode*)pTarget)->slotId, pExpr->resType));
+  }
+  FOREACH(pTarget, pNode->pAggFuncs) {
+    SExprNode* pExpr = (SExprNode*)((STargetNode*)pTarget)->pExpr;
+    nodesListMakeAppend(&pDesc->pSlots, makeSlot(((STargetNode*)pTarget)->slotId, pExpr->resType));
+  }
+  pNode->node.pOutputDataBlockDesc = pDesc;
+  return pNode;
+}
+
+std::string resultKey(SColumnInfoData* pCol, int32_t row) {
+  if (colDataIsNull_s(pCol, row)) {
+    return "";
+  }
+
+  const char* p = colDataGetData(pCol, row);
+  if (IS_VAR_DATA_TYPE(pCol->info.type)) {
+    return "k:" + std::string(varDataVal(p), varDataLen(p));
+  }
+  return "k:" + std::to_string(*(int32_t*)p);
+}
+
+SGroupResMap runGroupby(int8_t keyType, int32_t rowsPerBlock, const FGenKey& genKey) {
+  SExecTaskInfo* pTaskInfo = (SExecTaskInfo*)taosMemoryCalloc(1, sizeof(SExecTaskInfo));
+  pTaskInfo->id.str = taosStrdup("groupbyBatchTest");
+
+  SAggPhysiNode* pNode = makeAggNode(keyType);
+  SOperatorInfo* pOperator =
+      createGroupOperatorInfo(createDummyInput(keyType, rowsPerBlock, genKey), pNode, pTaskInfo);
+  EXPECT_NE(pOperator, nullptr);
+
+  SGroupResMap res;
+  while (pOperator != NULL) {
+    SSDataBlock* pBlock = pOperator->fpSet.getNextFn(pOperator);
+    if (pBlock == NULL) {
+      break;
+    }
+
+    SColumnInfoData* pCount = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 1);
+    SColumnInfoData* pSum = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 2);
+    SColumnInfoData* pKey = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 3);
+    for (int32_t i = 0; i < pBlock->info.rows; ++i) {
+      std::string key = resultKey(pKey, i);
+      EXPECT_EQ(res.count(key), 0);
+      res[key] = SGroupRes{*(int64_t*)colDataGetData(pCount, i), *(int64_t*)colDataGetData(pSum, i)};
+    }
+  }
+
+  destroyOperator(pOperator);
+  nodesDestroyNode((SNode*)pNode);
+  taosMemoryFree(pTaskInfo->id.str);
+  taosMemoryFree(pTaskInfo);
+  return res;
+}
+
+SGroupResMap expectedResult(int8_t keyType, const FGenKey& genKey) {
+  SGroupResMap res;
+  char         key[kVarKeyLen + VARSTR_HEADER_SIZE] = {0};
+  for (int32_t i = 0; i < kRows; ++i) {
+    std::string k;
+    if (genKey(i, key)) {
+      k = IS_VAR_DATA_TYPE(keyType) ? "k:" + std::string(varDataVal(key), varDataLen(key))
+                                    : "k:" + std::to_string(*(int32_t*)key);
+    }
+
+    SGroupRes& r = res[k];
+    r.count += 1;
+    r.sum += i;
+  }
+  return res;
+}
+
+void checkBothPaths(int8_t keyType, const FGenKey& genKey) {
+  ASSERT_EQ(fmFuncMgtInit(), TSDB_CODE_SUCCESS);
+
+  SGroupResMap expected = expectedResult(keyType, genKey);
+  SGroupResMap batch = runGroupby(keyType, kBatchBlockRows, genKey);
+  SGroupResMap rowwise = runGroupby(keyType, kRowBlockRows, genKey);
+
+  ASSERT_EQ(batch.size(), expected.size());
+  ASSERT_EQ(rowwise.size(), expected.size());
+  for (auto& iter : expected) {
+    ASSERT_EQ(batch.count(iter.first), 1) << iter.first;
+    ASSERT_EQ(rowwise.count(iter.first), 1) << iter.first;
+    ASSERT_TRUE(batch[iter.first] == iter.second) << iter.first;
+    ASSERT_TRUE(rowwise[iter.first] == iter.second) << iter.first;
+  }
+}
+
+bool setIntKey(int32_t v, char* key) {
+  *(int32_t*)key = v;
+  return true;
+}
+
+bool setVarKey(int32_t v, char* key) {
+  std::string s = "key_" + std::to_string(v);
+  memcpy(varDataVal(key), s.c_str(), s.size());
+  varDataSetLen(key, s.size());
+  return true;
+}
+
+}  // namespace
+
+// the keys are interleaved within each block, so the rows are gathered by group before aggregation
+TEST(groupbyBatchTest, gatherIntKeys) {
+  checkBothPaths(TSDB_DATA_TYPE_INT, [](int32_t i, char* key) { return (i % 11 != 0) && setIntKey(i % 7, key); });
+}
+
+// each key is a contiguous run within each block, and the groups continue across the blocks
+TEST(groupbyBatchTest, contiguousIntKeys) {
+  checkBothPaths(TSDB_DATA_TYPE_INT, [](int32_t i, char* key) { return (i / 50 != 3) && setIntKey(i / 50 % 5, key); });
+}
+
+TEST(groupbyBatchTest, gatherVarKeys) {
+  checkBothPaths(TSDB_DATA_TYPE_VARCHAR,
+                 [](int32_t i, char* key) { return (i % 13 != 0) && setVarKey(i * 7 % 100 % 9, key); });
+}
+
+TEST(groupbyBatchTest, contiguousVarKeys) {
+  checkBothPaths(TSDB_DATA_TYPE_VARCHAR, [](int32_t i, char* key) { return (i / 40 != 2) && setVarKey(i / 40, key); });
+}
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <map>
+#include "executorInt.h"
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+namespace {
+
+const int32_t kNumOfTables = 1000;
+
+// a few tables share one group, as with partition by tags
+uint64_t groupIdOf(uint64_t uid) { return (uid / 3) * 7919 + 17; }
+
+STableListInfo* buildTableList() {
+  STableListInfo* pList = tableListCreate();
+  for (uint64_t uid = 1; uid <= kNumOfTables; ++uid) {
+    tableListAddTableInfo(pList, uid, groupIdOf(uid));
+  }
+  return pList;
+}
+
+// uid -> the sub-task that keeps it
+void splitTables(int32_t numOfSubtasks, std::map<uint64_t, int32_t>* pOwner) {
+  for (int32_t i = 0; i < numOfSubtasks; ++i) {
+    SReadHandle     handle = {0};
+    STableListInfo* pList = buildTableList();
+    handle.subtaskId = i;
+    handle.numOfSubtasks = numOfSubtasks;
+    removeTablesOfOtherSubtasks(pList, &handle);
+
+    for (int32_t j = 0; j < tableListGetSize(pList); ++j) {
+      STableKeyInfo* p = tableListGetInfo(pList, j);
+      EXPECT_EQ(pOwner->count(p->uid), 0) << "uid " << p->uid << " kept by sub-task " << i << " and "
+                                          << (*pOwner)[p->uid];
+      (*pOwner)[p->uid] = i;
+      // the wal scan of the sub-task accepts the same groups
+      EXPECT_TRUE(isGroupOfSubtask(&handle, p->groupId));
+    }
+    tableListDestroy(pList);
+  }
+}
+
+}  // namespace
+
+TEST(subtaskTest, disjointAndCover) {
+  for (int32_t numOfSubtasks = 2; numOfSubtasks <= 8; numOfSubtasks *= 2) {
+    std::map<uint64_t, int32_t> owner;
+    splitTables(numOfSubtasks, &owner);
+    ASSERT_EQ(owner.size(), kNumOfTables);
+
+    // all tables of a group go to one sub-task, and no sub-task is left idle
+    std::map<uint64_t, int32_t> groupOwner;
+    std::map<int32_t, int32_t>  tablesOfSubtask;
+    for (auto& it : owner) {
+      uint64_t gid = groupIdOf(it.first);
+      if (groupOwner.count(gid) > 0) {
+        EXPECT_EQ(groupOwner[gid], it.second);
+      }
+      groupOwner[gid] = it.second;
+      tablesOfSubtask[it.second]++;
+    }
+    EXPECT_EQ(tablesOfSubtask.size(), numOfSubtasks);
+  }
+}
+
+TEST(subtaskTest, singleTask) {
+  SReadHandle     handle = {0};
+  STableListInfo* pList = buildTableList();
+  handle.numOfSubtasks = 1;
+  removeTablesOfOtherSubtasks(pList, &handle);
+  EXPECT_EQ(tableListGetSize(pList), kNumOfTables);
+  tableListDestroy(pList);
+}
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,330 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "executorInt.h"
+#include "executil.h"
+#include "functionMgt.h"
+#include "operator.h"
+#include "querytask.h"
+#include "tdatablock.h"
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+namespace {
+
+const int32_t kTables = 96;
+const int32_t kThreads = 4;
+const int32_t kBlocksPerTable = 3;
+const int32_t kRowsPerBlock = 10;
+const int32_t kCapacity = 64;
+const int16_t kValueCid = 2;
+const int16_t kTagCid = 3;
+
+std::atomic<int32_t> numOfOpen;
+std::atomic<int32_t> numOfReset;
+std::atomic<int32_t> numOfClose;
+
+std::map<uint64_t, STag*> tags;  // t1 is uid * 10, built before the scan and read only during the scan
+
+// each table has kBlocksPerTable blocks, the ts column is the row index, and the value column is the uid
+struct SFakeReader {
+  SQueryTableDataCond*  pCond;
+  SSDataBlock*          pBlock;
+  std::vector<uint64_t> uids;
+  int32_t               table;
+  int32_t               block;
+};
+
+void fakeSetTables(SFakeReader* pReader, void* pTableList, int32_t num) {
+  STableKeyInfo* pList = (STableKeyInfo*)pTableList;
+  pReader->uids.clear();
+  for (int32_t i = 0; i < num; ++i) {
+    pReader->uids.push_back(pList[i].uid);
+  }
+  pReader->table = 0;
+  pReader->block = 0;
+}
+
+int32_t fakeReaderOpen(void* pVnode, SQueryTableDataCond* pCond, void* pTableList, int32_t numOfTables,
+                       SSDataBlock* pResBlock, void** ppReader, const char* idstr, bool countOnly,
+                       SHashObj** pIgnoreTables) {
+  SFakeReader* pReader = new SFakeReader();
+  pReader->pCond = pCond;
+  pReader->pBlock = pResBlock;
+  fakeSetTables(pReader, pTableList, numOfTables);
+  blockDataEnsureCapacity(pResBlock, kCapacity);
+
+  numOfOpen += 1;
+  *ppReader = pReader;
+  return TSDB_CODE_SUCCESS;
+}
+
+void fakeReaderClose(SFakeReader* pReader) {
+  if (pReader != NULL) {
+    numOfClose += 1;
+    delete pReader;
+  }
+}
+
+int32_t fakeSetQueryTableList(SFakeReader* pReader, void* pTableList, int32_t num) {
+  fakeSetTables(pReader, pTableList, num);
+  return TSDB_CODE_SUCCESS;
+}
+
+int32_t fakeReaderResetStatus(SFakeReader* pReader, SQueryTableDataCond* pCond) {
+  numOfReset += 1;
+  pReader->table = 0;
+  pReader->block = 0;
+  return TSDB_CODE_SUCCESS;
+}
+
+int32_t fakeNextDataBlock(SFakeReader* pReader, bool* hasNext) {
+  if (pReader->block >= kBlocksPerTable) {
+    pReader->table += 1;
+    pReader->block = 0;
+  }
+
+  *hasNext = pReader->table < (int32_t)pReader->uids.size();
+  if (!(*hasNext)) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SSDataBlock* pBlock = pReader->pBlock;
+  EXPECT_GE(pBlock->info.capacity, kRowsPerBlock);
+
+  uint64_t uid = pReader->uids[pReader->table];
+  for (int32_t i = 0; i < pReader->pCond->numOfCols; ++i) {
+    SColumnInfoData* pCol = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, pReader->pCond->pSlotList[i]);
+    for (int32_t j = 0; j < kRowsPerBlock; ++j) {
+      if (pReader->pCond->colList[i].colId == PRIMARYKEY_TIMESTAMP_COL_ID) {
+        int64_t ts = pReader->block * kRowsPerBlock + j;
+        colDataSetVal(pCol, j, (const char*)&ts, false);
+      } else {
+        int32_t v = uid;
+        colDataSetVal(pCol, j, (const char*)&v, false);
+      }
+    }
+  }
+
+  pBlock->info.id.uid = uid;
+  pBlock->info.rows = kRowsPerBlock;
+  pReader->block += 1;
+  return TSDB_CODE_SUCCESS;
+}
+
+SSDataBlock* fakeRetrieveDataBlock(SFakeReader* pReader, SArray* pIdList) { return pReader->pBlock; }
+
+void fakeReaderNop(SFakeReader* pReader) {}
+
+void fakeInitMetaReader(SMetaReader* pReader, void* pVnode, int32_t flags, SStoreMeta* pAPI) {
+  memset(pReader, 0, sizeof(SMetaReader));
+}
+
+int32_t fakeGetEntryGetUidCache(SMetaReader* pReader, tb_uid_t uid) {
+  auto iter = tags.find(uid);
+  if (iter == tags.end()) {
+    terrno = TSDB_CODE_PAR_TABLE_NOT_EXIST;
+    return terrno;
+  }
+
+  pReader->me.type = TSDB_CHILD_TABLE;
+  pReader->me.uid = uid;
+  pReader->me.name = "ctb";
+  pReader->me.ctbEntry.pTags = (uint8_t*)iter->second;
+  return TSDB_CODE_SUCCESS;
+}
+
+void fakeMetaReaderNop(SMetaReader* pReader) {}
+
+const void* fakeExtractTagVal(const void* tag, int16_t type, STagVal* tagVal) {
+  return tTagGet((const STag*)tag, tagVal) ? tagVal : NULL;
+}
+
+void buildTags() {
+  for (uint64_t uid = 1; uid <= kTables; ++uid) {
+    SArray* pTagVals = taosArrayInit(1, sizeof(STagVal));
+    STagVal val = {0};
+    val.cid = kTagCid;
+    val.type = TSDB_DATA_TYPE_INT;
+    val.i64 = uid * 10;
+    taosArrayPush(pTagVals, &val);
+
+    STag* pTag = NULL;
+    ASSERT_EQ(tTagNew(pTagVals, 1, false, &pTag), TSDB_CODE_SUCCESS);
+    tags[uid] = pTag;
+    taosArrayDestroy(pTagVals);
+  }
+}
+
+void destroyTags() {
+  for (auto& iter : tags) {
+    tTagFree(iter.second);
+  }
+  tags.clear();
+}
+
+void setFakeStorageAPI(SStorageAPI* pAPI) {
+  TsdReader* pReader = &pAPI->tsdReader;
+  pReader->tsdReaderOpen = fakeReaderOpen;
+  pReader->tsdReaderClose = (void (*)())fakeReaderClose;
+  pReader->tsdSetQueryTableList = (int32_t(*)())fakeSetQueryTableList;
+  pReader->tsdNextDataBlock = (int32_t(*)())fakeNextDataBlock;
+  pReader->tsdReaderRetrieveDataBlock = (SSDataBlock * (*)()) fakeRetrieveDataBlock;
+  pReader->tsdReaderReleaseDataBlock = (void (*)())fakeReaderNop;
+  pReader->tsdReaderResetStatus = (int32_t(*)())fakeReaderResetStatus;
+  pReader->tsdReaderNotifyClosing = (void (*)())fakeReaderNop;
+
+  pAPI->metaReaderFn.initReader = fakeInitMetaReader;
+  pAPI->metaReaderFn.getEntryGetUidCache = fakeGetEntryGetUidCache;
+  pAPI->metaReaderFn.readerReleaseLock = fakeMetaReaderNop;
+  pAPI->metaReaderFn.clearReader = fakeMetaReaderNop;
+  pAPI->metaFn.extractTagVal = fakeExtractTagVal;
+}
+
+SNode* makeSlot(int16_t slotId, int8_t type) {
+  SSlotDescNode* pSlot = (SSlotDescNode*)nodesMakeNode(QUERY_NODE_SLOT_DESC);
+  pSlot->slotId = slotId;
+  pSlot->dataType.type = type;
+  pSlot->dataType.bytes = tDataTypes[type].bytes;
+  pSlot->output = true;
+  return (SNode*)pSlot;
+}
+
+SNode* makeTarget(int16_t slotId, int16_t colId, int8_t type, EColumnType colType) {
+  SColumnNode* pCol = (SColumnNode*)nodesMakeNode(QUERY_NODE_COLUMN);
+  pCol->dataBlockId = 1;
+  pCol->slotId = slotId;
+  pCol->colId = colId;
+  pCol->colType = colType;
+  pCol->node.resType.type = type;
+  pCol->node.resType.bytes = tDataTypes[type].bytes;
+
+  STargetNode* pTarget = (STargetNode*)nodesMakeNode(QUERY_NODE_TARGET);
+  pTarget->dataBlockId = 1;
+  pTarget->slotId = slotId;
+  pTarget->pExpr = (SNode*)pCol;
+  return (SNode*)pTarget;
+}
+
+// select ts, c1, t1 from st, c1 is the uid of the child table and t1 is uid * 10
+STableScanPhysiNode* makeTableScanNode() {
+  STableScanPhysiNode* pNode = (STableScanPhysiNode*)nodesMakeNode(QUERY_NODE_PHYSICAL_PLAN_TABLE_SCAN);
+  pNode->scanSeq[0] = 1;
+  pNode->scanRange = TSWINDOW_INITIALIZER;
+  pNode->ratio = 1.0;
+  pNode->dataRequired = FUNC_DATA_REQUIRED_DATA_LOAD;
+
+  SDataBlockDescNode* pDesc = (SDataBlockDescNode*)nodesMakeNode(QUERY_NODE_DATABLOCK_DESC);
+  pDesc->dataBlockId = 1;
+  nodesListMakeAppend(&pDesc->pSlots, makeSlot(0, TSDB_DATA_TYPE_TIMESTAMP));
+  nodesListMakeAppend(&pDesc->pSlots, makeSlot(1, TSDB_DATA_TYPE_INT));
+  nodesListMakeAppend(&pDesc->pSlots, makeSlot(2, TSDB_DATA_TYPE_INT));
+  pNode->scan.node.pOutputDataBlockDesc = pDesc;
+
+  nodesListMakeAppend(&pNode->scan.pScanCols,
+                      makeTarget(0, PRIMARYKEY_TIMESTAMP_COL_ID, TSDB_DATA_TYPE_TIMESTAMP, COLUMN_TYPE_COLUMN));
+  nodesListMakeAppend(&pNode->scan.pScanCols, makeTarget(1, kValueCid, TSDB_DATA_TYPE_INT, COLUMN_TYPE_COLUMN));
+  nodesListMakeAppend(&pNode->scan.pScanPseudoCols, makeTarget(2, kTagCid, TSDB_DATA_TYPE_INT, COLUMN_TYPE_TAG));
+  return pNode;
+}
+
+}  // namespace
+
+TEST(tableScanParallelTest, multiMorselsWithTags) {
+  buildTags();
+
+  SExecTaskInfo* pTaskInfo = (SExecTaskInfo*)taosMemoryCalloc(1, sizeof(SExecTaskInfo));
+  pTaskInfo->id.str = taosStrdup("tableScanParallelTest");
+  setFakeStorageAPI(&pTaskInfo->storageAPI);
+
+  SReadHandle handle = {0};
+  handle.api = pTaskInfo->storageAPI;
+
+  STableListInfo* pTableList = tableListCreate();
+  for (uint64_t uid = 1; uid <= kTables; ++uid) {
+    tableListAddTableInfo(pTableList, uid, 0);
+  }
+
+  STableScanPhysiNode* pNode = makeTableScanNode();
+  SOperatorInfo*       pOperator = createTableScanOperatorInfo(pNode, &handle, pTableList, pTaskInfo);
+  ASSERT_NE(pOperator, nullptr);
+
+  tableScanEnableParallel(pOperator, pNode, kThreads);
+  STableScanInfo*     pInfo = (STableScanInfo*)pOperator->info;
+  STableScanParallel* pParallel = pInfo->pParallel;
+  ASSERT_NE(pParallel, nullptr);
+  int32_t numOfMorsels = (kTables + pParallel->morselSize - 1) / pParallel->morselSize;
+  ASSERT_GT(numOfMorsels, kThreads);
+
+  std::map<uint64_t, int32_t>  rows;
+  std::set<const SSDataBlock*> blocks;
+  int32_t                      numOfBlocks = 0;
+  while (1) {
+    SSDataBlock* pBlock = pOperator->fpSet.getNextFn(pOperator);
+    if (pBlock == NULL) {
+      break;
+    }
+
+    numOfBlocks += 1;
+    blocks.insert(pBlock);
+    ASSERT_EQ(pBlock->info.rows, kRowsPerBlock);
+
+    SColumnInfoData* pTsCol = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 0);
+    SColumnInfoData* pValCol = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 1);
+    SColumnInfoData* pTagCol = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 2);
+    for (int32_t i = 0; i < pBlock->info.rows; ++i) {
+      int32_t uid = *(int32_t*)colDataGetData(pValCol, i);
+      ASSERT_EQ(uid, pBlock->info.id.uid);
+      ASSERT_EQ(*(int64_t*)colDataGetData(pTsCol, i) % kRowsPerBlock, i);
+      ASSERT_FALSE(colDataIsNull_s(pTagCol, i));
+      ASSERT_EQ(*(int32_t*)colDataGetData(pTagCol, i), uid * 10);
+    }
+    rows[pBlock->info.id.uid] += pBlock->info.rows;
+  }
+
+  ASSERT_EQ(rows.size(), kTables);
+  for (auto& iter : rows) {
+    ASSERT_EQ(iter.second, kBlocksPerTable * kRowsPerBlock);
+  }
+  ASSERT_EQ(numOfBlocks, kTables * kBlocksPerTable);
+
+  // one reader, and one snapshot, for each worker; the following morsels only reset the reader
+  ASSERT_LE(numOfOpen.load(), kThreads);
+  ASSERT_EQ(numOfOpen.load() + numOfReset.load(), numOfMorsels);
+  ASSERT_EQ(numOfClose.load(), numOfOpen.load());
+
+  // the returned blocks are recycled instead of being copied for each loaded block
+  ASSERT_LE(blocks.size(), pParallel->freeCap);
+
+  // the tag values are cached by each worker, and the statistics are merged when the workers exit
+  ASSERT_EQ(pInfo->base.metaCache.metaFetch, numOfBlocks);
+  ASSERT_EQ(pInfo->base.metaCache.metaFetch - pInfo->base.metaCache.cacheHit, kTables);
+
+  destroyOperator(pOperator);
+  nodesDestroyNode((SNode*)pNode);
+  taosMemoryFree((void*)pTaskInfo->id.str);
+  taosMemoryFree(pTaskInfo);
+  destroyTags();
+}
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include "executorInt.h"
+#include "tdatablock.h"
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+namespace {
+
+const int32_t kTagCid = 3;
+
+// a tag store of three child tables, t1 is uid * 10
+int32_t fakeGetTableTagCols(void* pVnode, uint64_t suid, SArray* pUidList, SSDataBlock* pBlock) {
+  SColumnInfoData* pCol = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 0);
+  if (pCol->info.colId != kTagCid) {
+    return TSDB_CODE_OPS_NOT_SUPPORT;
+  }
+
+  if (taosArrayGetSize(pUidList) == 0) {
+    for (uint64_t uid = 1; uid <= 3; ++uid) {
+      taosArrayPush(pUidList, &uid);
+    }
+  }
+
+  int32_t rows = taosArrayGetSize(pUidList);
+  blockDataEnsureCapacity(pBlock, rows);
+  for (int32_t i = 0; i < rows; ++i) {
+    int32_t v = *(uint64_t*)taosArrayGet(pUidList, i) * 10;
+    colDataSetVal(pCol, i, (const char*)&v, false);
+  }
+  pBlock->info.rows = rows;
+  return TSDB_CODE_SUCCESS;
+}
+
+SArray* makeColList(int16_t colId) {
+  SArray*     pColList = taosArrayInit(1, sizeof(SColumnInfo));
+  SColumnInfo info = {0};
+  info.colId = colId;
+  info.type = TSDB_DATA_TYPE_INT;
+  info.bytes = sizeof(int32_t);
+  taosArrayPush(pColList, &info);
+  return pColList;
+}
+
+}  // namespace
+
+TEST(tagStoreTest, allTables) {
+  SStorageAPI api = {0};
+  api.metaFn.getTableTagCols = fakeGetTableTagCols;
+
+  SArray*      pColList = makeColList(kTagCid);
+  SArray*      pUidTagList = taosArrayInit(8, sizeof(STUidTagInfo));
+  SSDataBlock* pBlock = NULL;
+  ASSERT_EQ(createTagValBlockFromStore(pColList, pUidTagList, NULL, 1, &pBlock, &api), TSDB_CODE_SUCCESS);
+
+  // the child tables are added into the empty list, in the order of the rows
+  ASSERT_EQ(taosArrayGetSize(pUidTagList), 3);
+  ASSERT_EQ(pBlock->info.rows, 3);
+  SColumnInfoData* pCol = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 0);
+  for (int32_t i = 0; i < 3; ++i) {
+    uint64_t uid = ((STUidTagInfo*)taosArrayGet(pUidTagList, i))->uid;
+    ASSERT_EQ(*(int32_t*)colDataGetData(pCol, i), uid * 10);
+  }
+
+  blockDataDestroy(pBlock);
+  taosArrayDestroy(pUidTagList);
+  taosArrayDestroy(pColList);
+}
+
+TEST(tagStoreTest, givenTables) {
+  SStorageAPI api = {0};
+  api.metaFn.getTableTagCols = fakeGetTableTagCols;
+
+  SArray* pColList = makeColList(kTagCid);
+  SArray* pUidTagList = taosArrayInit(8, sizeof(STUidTagInfo));
+  for (uint64_t uid : {3, 1}) {
+    STUidTagInfo info = {.uid = uid};
+    taosArrayPush(pUidTagList, &info);
+  }
+
+  SSDataBlock* pBlock = NULL;
+  ASSERT_EQ(createTagValBlockFromStore(pColList, pUidTagList, NULL, 1, &pBlock, &api), TSDB_CODE_SUCCESS);
+  ASSERT_EQ(taosArrayGetSize(pUidTagList), 2);
+  ASSERT_EQ(pBlock->info.rows, 2);
+  SColumnInfoData* pCol = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 0);
+  ASSERT_EQ(*(int32_t*)colDataGetData(pCol, 0), 30);
+  ASSERT_EQ(*(int32_t*)colDataGetData(pCol, 1), 10);
+
+  blockDataDestroy(pBlock);
+  taosArrayDestroy(pUidTagList);
+  taosArrayDestroy(pColList);
+}
+
+// the caller falls back to reading the tags of each table, the table list must be left untouched
+TEST(tagStoreTest, fallback) {
+  SStorageAPI  api = {0};
+  SArray*      pColList = makeColList(kTagCid);
+  SArray*      pUidTagList = taosArrayInit(8, sizeof(STUidTagInfo));
+  SSDataBlock* pBlock = NULL;
+
+  // no tag store
+  ASSERT_NE(createTagValBlockFromStore(pColList, pUidTagList, NULL, 1, &pBlock, &api), TSDB_CODE_SUCCESS);
+  ASSERT_EQ(pBlock, nullptr);
+  ASSERT_EQ(taosArrayGetSize(pUidTagList), 0);
+
+  // the columns are not served by the store
+  api.metaFn.getTableTagCols = fakeGetTableTagCols;
+  SArray* pOtherCols = makeColList(kTagCid + 1);
+  ASSERT_NE(createTagValBlockFromStore(pOtherCols, pUidTagList, NULL, 1, &pBlock, &api), TSDB_CODE_SUCCESS);
+  ASSERT_EQ(pBlock, nullptr);
+  ASSERT_EQ(taosArrayGetSize(pUidTagList), 0);
+
+  taosArrayDestroy(pOtherCols);
+  taosArrayDestroy(pUidTagList);
+  taosArrayDestroy(pColList);
+}
+
+#pragma GCC diagnostic pop
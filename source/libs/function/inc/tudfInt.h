@@ -34,8 +34,14 @@ enum {
   TSDB_UDF_CALL_SCALA_PROC,
 };
 
+#define UDF_SHM_NAME_LEN  64
+#define UDF_SHM_SLOT_NUM  4
+#define UDF_SHM_SLOT_SIZE (2 * 1024 * 1024)
+
 typedef struct SUdfSetupRequest {
-  char udfName[TSDB_FUNC_NAME_LEN + 1];
+  char    udfName[TSDB_FUNC_NAME_LEN + 1];
+  char    shmName[UDF_SHM_NAME_LEN];  // empty if the data blocks are sent through the pipe
+  int32_t shmSize;
 } SUdfSetupRequest;
 
 typedef struct SUdfSetupResponse {
@@ -43,11 +49,13 @@ typedef struct SUdfSetupResponse {
   int8_t  outputType;
   int32_t bytes;
   int32_t bufSize;
+  int8_t  shmAttached;
 } SUdfSetupResponse;
 
 typedef struct SUdfCallRequest {
   int64_t udfHandle;
   int8_t  callType;
+  int32_t shmSlot;  // -1 if the block is encoded in the request, otherwise the slot holding the block
 
   SSDataBlock  block;
   SUdfInterBuf interBuf;
@@ -57,6 +65,7 @@ typedef struct SUdfCallRequest {
 
 typedef struct SUdfCallResponse {
   int8_t       callType;
+  int8_t       resultInShm;  // scalar result is written to the slot of the request
   SSDataBlock  resultData;
   SUdfInterBuf resultBuf;
 } SUdfCallResponse;
@@ -110,6 +119,31 @@ int32_t convertDataBlockToUdfDataBlock(SSDataBlock *block, SUdfDataBlock *udfBlo
 int32_t convertUdfColumnToDataBlock(SUdfColumn *udfCol, SSDataBlock *block);
 
 int32_t getUdfdPipeName(char *pipeName, int32_t size);
+
+// Shared memory segment of one udfc session. The columns of the input blocks are written into a free slot by udfc and
+// read in place by udfd, the pipe only carries the slot number. udfd writes the scalar result back into the same slot.
+typedef struct SUdfShm {
+  char    name[UDF_SHM_NAME_LEN];
+  int32_t size;
+  int32_t slotSize;
+  int32_t slotNum;
+  char   *base;
+  int8_t  slotBusy[UDF_SHM_SLOT_NUM];  // only used by udfc
+} SUdfShm;
+
+int32_t udfShmCreate(SUdfShm **ppShm);
+int32_t udfShmAttach(const char *name, int32_t size, SUdfShm **ppShm);
+void    udfShmUnlink(SUdfShm *pShm);
+void    udfShmDetach(SUdfShm *pShm);
+
+int32_t udfShmAcquireSlot(SUdfShm *pShm);
+void    udfShmReleaseSlot(SUdfShm *pShm, int32_t slot);
+
+int32_t udfShmWriteDataBlock(SUdfShm *pShm, int32_t slot, const SSDataBlock *pBlock);
+int32_t udfShmWriteUdfColumn(SUdfShm *pShm, int32_t slot, const SUdfColumn *pCol);
+int32_t udfShmViewUdfDataBlock(SUdfShm *pShm, int32_t slot, SUdfDataBlock *pBlock);
+void    udfShmFreeUdfDataBlockView(SUdfDataBlock *pBlock);
+
 #ifdef __cplusplus
 }
 #endif
@@ -393,6 +393,8 @@ typedef struct SUdfcUvSession {
   int32_t bytes;
   int32_t bufSize;
 
+  SUdfShm *shm;  // NULL if the data blocks are sent through the pipe
+
   char udfName[TSDB_FUNC_NAME_LEN + 1];
 } SUdfcUvSession;
 
@@ -508,11 +510,15 @@ int32_t getUdfdPipeName(char *pipeName, int32_t size) {
 int32_t encodeUdfSetupRequest(void **buf, const SUdfSetupRequest *setup) {
   int32_t len = 0;
   len += taosEncodeBinary(buf, setup->udfName, TSDB_FUNC_NAME_LEN);
+  len += taosEncodeBinary(buf, setup->shmName, UDF_SHM_NAME_LEN);
+  len += taosEncodeFixedI32(buf, setup->shmSize);
   return len;
 }
 
 void *decodeUdfSetupRequest(const void *buf, SUdfSetupRequest *request) {
   buf = taosDecodeBinaryTo(buf, request->udfName, TSDB_FUNC_NAME_LEN);
+  buf = taosDecodeBinaryTo(buf, request->shmName, UDF_SHM_NAME_LEN);
+  buf = taosDecodeFixedI32(buf, &request->shmSize);
   return (void *)buf;
 }
 
@@ -535,12 +541,17 @@ int32_t encodeUdfCallRequest(void **buf, const SUdfCallRequest *call) {
   int32_t len = 0;
   len += taosEncodeFixedI64(buf, call->udfHandle);
   len += taosEncodeFixedI8(buf, call->callType);
+  len += taosEncodeFixedI32(buf, call->shmSlot);
   if (call->callType == TSDB_UDF_CALL_SCALA_PROC) {
-    len += tEncodeDataBlock(buf, &call->block);
+    if (call->shmSlot < 0) {
+      len += tEncodeDataBlock(buf, &call->block);
+    }
   } else if (call->callType == TSDB_UDF_CALL_AGG_INIT) {
     len += taosEncodeFixedI8(buf, call->initFirst);
   } else if (call->callType == TSDB_UDF_CALL_AGG_PROC) {
-    len += tEncodeDataBlock(buf, &call->block);
+    if (call->shmSlot < 0) {
+      len += tEncodeDataBlock(buf, &call->block);
+    }
     len += encodeUdfInterBuf(buf, &call->interBuf);
   } else if (call->callType == TSDB_UDF_CALL_AGG_MERGE) {
     len += encodeUdfInterBuf(buf, &call->interBuf);
@@ -554,15 +565,20 @@ int32_t encodeUdfCallRequest(void **buf, const SUdfCallRequest *call) {
 void *decodeUdfCallRequest(const void *buf, SUdfCallRequest *call) {
   buf = taosDecodeFixedI64(buf, &call->udfHandle);
   buf = taosDecodeFixedI8(buf, &call->callType);
+  buf = taosDecodeFixedI32(buf, &call->shmSlot);
   switch (call->callType) {
     case TSDB_UDF_CALL_SCALA_PROC:
-      buf = tDecodeDataBlock(buf, &call->block);
+      if (call->shmSlot < 0) {
+        buf = tDecodeDataBlock(buf, &call->block);
+      }
       break;
     case TSDB_UDF_CALL_AGG_INIT:
       buf = taosDecodeFixedI8(buf, &call->initFirst);
       break;
     case TSDB_UDF_CALL_AGG_PROC:
-      buf = tDecodeDataBlock(buf, &call->block);
+      if (call->shmSlot < 0) {
+        buf = tDecodeDataBlock(buf, &call->block);
+      }
       buf = decodeUdfInterBuf(buf, &call->interBuf);
       break;
     case TSDB_UDF_CALL_AGG_MERGE:
@@ -630,6 +646,7 @@ int32_t encodeUdfSetupResponse(void **buf, const SUdfSetupResponse *setupRsp) {
   len += taosEncodeFixedI8(buf, setupRsp->outputType);
   len += taosEncodeFixedI32(buf, setupRsp->bytes);
   len += taosEncodeFixedI32(buf, setupRsp->bufSize);
+  len += taosEncodeFixedI8(buf, setupRsp->shmAttached);
   return len;
 }
 
@@ -638,15 +655,19 @@ void *decodeUdfSetupResponse(const void *buf, SUdfSetupResponse *setupRsp) {
   buf = taosDecodeFixedI8(buf, &setupRsp->outputType);
   buf = taosDecodeFixedI32(buf, &setupRsp->bytes);
   buf = taosDecodeFixedI32(buf, &setupRsp->bufSize);
+  buf = taosDecodeFixedI8(buf, &setupRsp->shmAttached);
   return (void *)buf;
 }
 
 int32_t encodeUdfCallResponse(void **buf, const SUdfCallResponse *callRsp) {
   int32_t len = 0;
   len += taosEncodeFixedI8(buf, callRsp->callType);
+  len += taosEncodeFixedI8(buf, callRsp->resultInShm);
   switch (callRsp->callType) {
     case TSDB_UDF_CALL_SCALA_PROC:
-      len += tEncodeDataBlock(buf, &callRsp->resultData);
+      if (!callRsp->resultInShm) {
+        len += tEncodeDataBlock(buf, &callRsp->resultData);
+      }
       break;
     case TSDB_UDF_CALL_AGG_INIT:
       len += encodeUdfInterBuf(buf, &callRsp->resultBuf);
@@ -666,9 +687,12 @@ int32_t encodeUdfCallResponse(void **buf, const SUdfCallResponse *callRsp) {
 
 void *decodeUdfCallResponse(const void *buf, SUdfCallResponse *callRsp) {
   buf = taosDecodeFixedI8(buf, &callRsp->callType);
+  buf = taosDecodeFixedI8(buf, &callRsp->resultInShm);
   switch (callRsp->callType) {
     case TSDB_UDF_CALL_SCALA_PROC:
-      buf = tDecodeDataBlock(buf, &callRsp->resultData);
+      if (!callRsp->resultInShm) {
+        buf = tDecodeDataBlock(buf, &callRsp->resultData);
+      }
       break;
     case TSDB_UDF_CALL_AGG_INIT:
       buf = decodeUdfInterBuf(buf, &callRsp->resultBuf);
@@ -1803,6 +1827,12 @@ int32_t doSetupUdf(char udfName[], UdfcFuncHandle *funcHandle) {
     return TSDB_CODE_UDF_PIPE_CONNECT_ERR;
   }
 
+  SUdfShm *shm = NULL;
+  if (udfShmCreate(&shm) == TSDB_CODE_SUCCESS) {
+    tstrncpy(req->shmName, shm->name, UDF_SHM_NAME_LEN);
+    req->shmSize = shm->size;
+  }
+
   udfcRunUdfUvTask(task, UV_TASK_REQ_RSP);
 
   SUdfSetupResponse *rsp = &task->_setup.rsp;
@@ -1811,6 +1841,14 @@ int32_t doSetupUdf(char udfName[], UdfcFuncHandle *funcHandle) {
   task->session->bytes = rsp->bytes;
   task->session->bufSize = rsp->bufSize;
   strncpy(task->session->udfName, udfName, TSDB_FUNC_NAME_LEN);
+  if (shm != NULL) {
+    udfShmUnlink(shm);
+    if (task->errCode == 0 && rsp->shmAttached) {
+      task->session->shm = shm;
+    } else {
+      udfShmDetach(shm);
+    }
+  }
   if (task->errCode != 0) {
     fnError("failed to setup udf. udfname: %s, err: %d", udfName, task->errCode)
   } else {
@@ -1838,6 +1876,18 @@ int32_t callUdf(UdfcFuncHandle handle, int8_t callType, SSDataBlock *input, SUdf
   SUdfCallRequest *req = &task->_call.req;
   req->udfHandle = task->session->severHandle;
   req->callType = callType;
+  req->shmSlot = -1;
+
+  // write the input block into a free slot of the shared memory, udfd reads it in place. If all the slots are in use
+  // or the block does not fit into a slot, the block is encoded into the request as before.
+  if (session->shm != NULL && input != NULL &&
+      (callType == TSDB_UDF_CALL_AGG_PROC || callType == TSDB_UDF_CALL_SCALA_PROC)) {
+    req->shmSlot = udfShmAcquireSlot(session->shm);
+    if (req->shmSlot >= 0 && udfShmWriteDataBlock(session->shm, req->shmSlot, input) != TSDB_CODE_SUCCESS) {
+      udfShmReleaseSlot(session->shm, req->shmSlot);
+      req->shmSlot = -1;
+    }
+  }
 
   switch (callType) {
     case TSDB_UDF_CALL_AGG_INIT: {
@@ -1888,11 +1938,22 @@ int32_t callUdf(UdfcFuncHandle handle, int8_t callType, SSDataBlock *input, SUdf
         break;
       }
       case TSDB_UDF_CALL_SCALA_PROC: {
+        if (rsp->resultInShm) {
+          SUdfDataBlock result = {0};
+          task->errCode = udfShmViewUdfDataBlock(session->shm, req->shmSlot, &result);
+          if (task->errCode == TSDB_CODE_SUCCESS) {
+            convertUdfColumnToDataBlock(result.udfCols[0], &rsp->resultData);
+            udfShmFreeUdfDataBlockView(&result);
+          }
+        }
         *output = rsp->resultData;
         break;
       }
     }
   };
+  if (req->shmSlot >= 0) {
+    udfShmReleaseSlot(session->shm, req->shmSlot);
+  }
   int err = task->errCode;
   taosMemoryFree(task);
   return err;
@@ -1951,6 +2012,7 @@ int32_t doTeardownUdf(UdfcFuncHandle handle) {
 
   if (session->udfUvPipe == NULL) {
     fnError("tear down udf. pipe to udfd does not exist. udf name: %s", session->udfName);
+    udfShmDetach(session->shm);
     taosMemoryFree(session);
     return TSDB_CODE_UDF_PIPE_NOT_EXIST;
   }
@@ -1977,6 +2039,7 @@ int32_t doTeardownUdf(UdfcFuncHandle handle) {
     conn->session = NULL;
   }
   uv_mutex_unlock(&gUdfcProxy.udfcUvMutex);
+  udfShmDetach(session->shm);
   taosMemoryFree(session);
   taosMemoryFree(task);
 
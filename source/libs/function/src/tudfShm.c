@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#define ALLOW_FORBID_FUNC
+#include "os.h"
+#include "fnLog.h"
+#include "tdatablock.h"
+#include "tudf.h"
+#include "tudfInt.h"
+
+#define UDF_SHM_ALIGN(_len)       (((_len) + 7) & ~((int64_t)7))
+#define UDF_SHM_SLOT(_shm, _slot) ((_shm)->base + (int64_t)(_slot) * (_shm)->slotSize)
+
+typedef struct SUdfShmBlockHead {
+  int32_t numOfRows;
+  int32_t numOfCols;
+} SUdfShmBlockHead;
+
+typedef struct SUdfShmColHead {
+  int16_t type;
+  uint8_t precision;
+  uint8_t scale;
+  int32_t bytes;
+  int8_t  hasNull;
+  int32_t metaLen;  // null bitmap of fixed length column or offsets of var length column
+  int32_t dataLen;
+} SUdfShmColHead;
+
+static int64_t gUdfShmSeqNum = 0;
+
+#ifdef WINDOWS
+int32_t udfShmCreate(SUdfShm **ppShm) { return TSDB_CODE_OPS_NOT_SUPPORT; }
+int32_t udfShmAttach(const char *name, int32_t size, SUdfShm **ppShm) { return TSDB_CODE_OPS_NOT_SUPPORT; }
+void    udfShmUnlink(SUdfShm *pShm) {}
+void    udfShmDetach(SUdfShm *pShm) {}
+#else
+static int32_t udfShmMap(SUdfShm *pShm, int fd) {
+  pShm->base = mmap(NULL, pShm->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (pShm->base == MAP_FAILED) {
+    pShm->base = NULL;
+    return TAOS_SYSTEM_ERROR(errno);
+  }
+  pShm->slotNum = UDF_SHM_SLOT_NUM;
+  pShm->slotSize = pShm->size / UDF_SHM_SLOT_NUM;
+  return TSDB_CODE_SUCCESS;
+}
+
+int32_t udfShmCreate(SUdfShm **ppShm) {
+  SUdfShm *pShm = taosMemoryCalloc(1, sizeof(SUdfShm));
+  if (pShm == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  snprintf(pShm->name, sizeof(pShm->name), "/taosudf.%d.%" PRId64, taosGetPId(),
+           atomic_add_fetch_64(&gUdfShmSeqNum, 1));
+  pShm->size = UDF_SHM_SLOT_NUM * UDF_SHM_SLOT_SIZE;
+
+  int fd = shm_open(pShm->name, O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0) {
+    int32_t code = TAOS_SYSTEM_ERROR(errno);
+    fnError("udfc create shm %s failed, since %s", pShm->name, tstrerror(code));
+    taosMemoryFree(pShm);
+    return code;
+  }
+
+  int32_t code = TSDB_CODE_SUCCESS;
+  if (ftruncate(fd, pShm->size) != 0) {
+    code = TAOS_SYSTEM_ERROR(errno);
+  } else {
+    code = udfShmMap(pShm, fd);
+  }
+  close(fd);
+
+  if (code != TSDB_CODE_SUCCESS) {
+    fnError("udfc map shm %s failed, since %s", pShm->name, tstrerror(code));
+    shm_unlink(pShm->name);
+    taosMemoryFree(pShm);
+    return code;
+  }
+
+  *ppShm = pShm;
+  return TSDB_CODE_SUCCESS;
+}
+
+int32_t udfShmAttach(const char *name, int32_t size, SUdfShm **ppShm) {
+  if (size < UDF_SHM_SLOT_NUM * (int32_t)sizeof(SUdfShmBlockHead)) {
+    return TSDB_CODE_INVALID_PARA;
+  }
+
+  SUdfShm *pShm = taosMemoryCalloc(1, sizeof(SUdfShm));
+  if (pShm == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  tstrncpy(pShm->name, name, sizeof(pShm->name));
+  pShm->size = size;
+
+  int fd = shm_open(pShm->name, O_RDWR, 0600);
+  if (fd < 0) {
+    int32_t code = TAOS_SYSTEM_ERROR(errno);
+    fnError("udfd open shm %s failed, since %s", pShm->name, tstrerror(code));
+    taosMemoryFree(pShm);
+    return code;
+  }
+
+  int32_t code = udfShmMap(pShm, fd);
+  close(fd);
+  if (code != TSDB_CODE_SUCCESS) {
+    fnError("udfd map shm %s failed, since %s", pShm->name, tstrerror(code));
+    taosMemoryFree(pShm);
+    return code;
+  }
+
+  *ppShm = pShm;
+  return TSDB_CODE_SUCCESS;
+}
+
+// the mapping stays valid after unlink, so udfc unlinks the name as soon as udfd has attached to it. No shm is left
+// behind if either process crashes.
+void udfShmUnlink(SUdfShm *pShm) {
+  if (pShm != NULL && pShm->name[0] != 0) {
+    shm_unlink(pShm->name);
+    pShm->name[0] = 0;
+  }
+}
+
+void udfShmDetach(SUdfShm *pShm) {
+  if (pShm == NULL) {
+    return;
+  }
+  udfShmUnlink(pShm);
+  if (pShm->base != NULL) {
+    munmap(pShm->base, pShm->size);
+  }
+  taosMemoryFree(pShm);
+}
+#endif
+
+int32_t udfShmAcquireSlot(SUdfShm *pShm) {
+  for (int32_t i = 0; i < pShm->slotNum; ++i) {
+    if (atomic_val_compare_exchange_8(&pShm->slotBusy[i], 0, 1) == 0) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+void udfShmReleaseSlot(SUdfShm *pShm, int32_t slot) {
+  if (slot >= 0 && slot < pShm->slotNum) {
+    atomic_store_8(&pShm->slotBusy[slot], 0);
+  }
+}
+
+static int32_t udfShmVarColGetLength(const SColumnInfoData *pCol, int32_t numOfRows) {
+  if (!pCol->reassigned) {
+    return colDataGetLength(pCol, numOfRows);
+  }
+
+  int32_t len = 0;
+  for (int32_t row = 0; row < numOfRows; ++row) {
+    if (pCol->varmeta.offset[row] == -1) {
+      continue;
+    }
+    char *pData = pCol->pData + pCol->varmeta.offset[row];
+    len += (pCol->info.type == TSDB_DATA_TYPE_JSON) ? getJsonValueLen(pData) : varDataTLen(pData);
+  }
+  return len;
+}
+
+static char *udfShmWriteVarCol(char *pMeta, const SColumnInfoData *pCol, int32_t numOfRows, int32_t metaLen) {
+  char *pData = pMeta + UDF_SHM_ALIGN(metaLen);
+  if (!pCol->reassigned) {
+    memcpy(pMeta, pCol->varmeta.offset, metaLen);
+    int32_t len = colDataGetLength(pCol, numOfRows);
+    memcpy(pData, pCol->pData, len);
+    return pData + UDF_SHM_ALIGN(len);
+  }
+
+  // the rows of a reassigned column share the payload, compact them while copying
+  int32_t *offsets = (int32_t *)pMeta;
+  int32_t  len = 0;
+  for (int32_t row = 0; row < numOfRows; ++row) {
+    if (pCol->varmeta.offset[row] == -1) {
+      offsets[row] = -1;
+      continue;
+    }
+    char   *pVal = pCol->pData + pCol->varmeta.offset[row];
+    int32_t valLen = (pCol->info.type == TSDB_DATA_TYPE_JSON) ? getJsonValueLen(pVal) : varDataTLen(pVal);
+    memcpy(pData + len, pVal, valLen);
+    offsets[row] = len;
+    len += valLen;
+  }
+  return pData + UDF_SHM_ALIGN(len);
+}
+
+int32_t udfShmWriteDataBlock(SUdfShm *pShm, int32_t slot, const SSDataBlock *pBlock) {
+  int32_t numOfRows = pBlock->info.rows;
+  int32_t numOfCols = taosArrayGetSize(pBlock->pDataBlock);
+
+  int64_t len = UDF_SHM_ALIGN(sizeof(SUdfShmBlockHead));
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SColumnInfoData *pCol = taosArrayGet(pBlock->pDataBlock, i);
+    bool             isVar = IS_VAR_DATA_TYPE(pCol->info.type);
+    int32_t          metaLen = isVar ? sizeof(int32_t) * numOfRows : BitmapLen(numOfRows);
+    int32_t          dataLen = isVar ? udfShmVarColGetLength(pCol, numOfRows) : colDataGetLength(pCol, numOfRows);
+    len += UDF_SHM_ALIGN(sizeof(SUdfShmColHead)) + UDF_SHM_ALIGN(metaLen) + UDF_SHM_ALIGN(dataLen);
+  }
+  if (len > pShm->slotSize) {
+    return TSDB_CODE_OUT_OF_RANGE;
+  }
+
+  char             *pStart = UDF_SHM_SLOT(pShm, slot);
+  SUdfShmBlockHead *pHead = (SUdfShmBlockHead *)pStart;
+  pHead->numOfRows = numOfRows;
+  pHead->numOfCols = numOfCols;
+
+  char *p = pStart + UDF_SHM_ALIGN(sizeof(SUdfShmBlockHead));
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SColumnInfoData *pCol = taosArrayGet(pBlock->pDataBlock, i);
+    SUdfShmColHead  *pColHead = (SUdfShmColHead *)p;
+    bool             isVar = IS_VAR_DATA_TYPE(pCol->info.type);
+
+    pColHead->type = pCol->info.type;
+    pColHead->precision = pCol->info.precision;
+    pColHead->scale = pCol->info.scale;
+    pColHead->bytes = pCol->info.bytes;
+    pColHead->hasNull = pCol->hasNull;
+    pColHead->metaLen = isVar ? sizeof(int32_t) * numOfRows : BitmapLen(numOfRows);
+
+    char *pMeta = p + UDF_SHM_ALIGN(sizeof(SUdfShmColHead));
+    if (isVar) {
+      pColHead->dataLen = udfShmVarColGetLength(pCol, numOfRows);
+      p = udfShmWriteVarCol(pMeta, pCol, numOfRows, pColHead->metaLen);
+    } else {
+      pColHead->dataLen = colDataGetLength(pCol, numOfRows);
+      memcpy(pMeta, pCol->nullbitmap, pColHead->metaLen);
+      char *pData = pMeta + UDF_SHM_ALIGN(pColHead->metaLen);
+      memcpy(pData, pCol->pData, pColHead->dataLen);
+      p = pData + UDF_SHM_ALIGN(pColHead->dataLen);
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+int32_t udfShmWriteUdfColumn(SUdfShm *pShm, int32_t slot, const SUdfColumn *pCol) {
+  const SUdfColumnData *pColData = &pCol->colData;
+  bool                  isVar = IS_VAR_DATA_TYPE(pCol->colMeta.type);
+  int32_t               numOfRows = pColData->numOfRows;
+  int32_t               metaLen = isVar ? sizeof(int32_t) * numOfRows : BitmapLen(numOfRows);
+  int32_t               dataLen = isVar ? pColData->varLenCol.payloadLen : pCol->colMeta.bytes * numOfRows;
+
+  int64_t len = UDF_SHM_ALIGN(sizeof(SUdfShmBlockHead)) + UDF_SHM_ALIGN(sizeof(SUdfShmColHead)) +
+                UDF_SHM_ALIGN(metaLen) + UDF_SHM_ALIGN(dataLen);
+  if (len > pShm->slotSize) {
+    return TSDB_CODE_OUT_OF_RANGE;
+  }
+
+  char             *pStart = UDF_SHM_SLOT(pShm, slot);
+  SUdfShmBlockHead *pHead = (SUdfShmBlockHead *)pStart;
+  pHead->numOfRows = numOfRows;
+  pHead->numOfCols = 1;
+
+  SUdfShmColHead *pColHead = (SUdfShmColHead *)(pStart + UDF_SHM_ALIGN(sizeof(SUdfShmBlockHead)));
+  pColHead->type = pCol->colMeta.type;
+  pColHead->precision = pCol->colMeta.precision;
+  pColHead->scale = pCol->colMeta.scale;
+  pColHead->bytes = pCol->colMeta.bytes;
+  pColHead->hasNull = pCol->hasNull;
+  pColHead->metaLen = metaLen;
+  pColHead->dataLen = dataLen;
+
+  char *pMeta = (char *)pColHead + UDF_SHM_ALIGN(sizeof(SUdfShmColHead));
+  char *pData = pMeta + UDF_SHM_ALIGN(metaLen);
+  if (isVar) {
+    memcpy(pMeta, pColData->varLenCol.varOffsets, metaLen);
+    memcpy(pData, pColData->varLenCol.payload, dataLen);
+  } else {
+    memcpy(pMeta, pColData->fixLenCol.nullBitmap, metaLen);
+    memcpy(pData, pColData->fixLenCol.data, dataLen);
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// The columns of the view point into the slot, nothing is copied. The view must be released by
+// udfShmFreeUdfDataBlockView before the slot is written again.
+int32_t udfShmViewUdfDataBlock(SUdfShm *pShm, int32_t slot, SUdfDataBlock *pBlock) {
+  char             *pStart = UDF_SHM_SLOT(pShm, slot);
+  char             *pEnd = pStart + pShm->slotSize;
+  SUdfShmBlockHead *pHead = (SUdfShmBlockHead *)pStart;
+
+  pBlock->numOfRows = pHead->numOfRows;
+  pBlock->numOfCols = pHead->numOfCols;
+  pBlock->udfCols = taosMemoryCalloc(pBlock->numOfCols, sizeof(SUdfColumn *) + sizeof(SUdfColumn));
+  if (pBlock->udfCols == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  SUdfColumn *pCols = (SUdfColumn *)(pBlock->udfCols + pBlock->numOfCols);
+  char       *p = pStart + UDF_SHM_ALIGN(sizeof(SUdfShmBlockHead));
+  for (int32_t i = 0; i < pBlock->numOfCols; ++i) {
+    SUdfShmColHead *pColHead = (SUdfShmColHead *)p;
+    char           *pMeta = p + UDF_SHM_ALIGN(sizeof(SUdfShmColHead));
+    char           *pData = pMeta + UDF_SHM_ALIGN(pColHead->metaLen);
+    p = pData + UDF_SHM_ALIGN(pColHead->dataLen);
+    if (p > pEnd) {
+      udfShmFreeUdfDataBlockView(pBlock);
+      return TSDB_CODE_UDF_INVALID_INPUT;
+    }
+
+    SUdfColumn *pCol = &pCols[i];
+    pCol->colMeta.type = pColHead->type;
+    pCol->colMeta.bytes = pColHead->bytes;
+    pCol->colMeta.precision = pColHead->precision;
+    pCol->colMeta.scale = pColHead->scale;
+    pCol->hasNull = pColHead->hasNull;
+    pCol->colData.numOfRows = pBlock->numOfRows;
+    if (IS_VAR_DATA_TYPE(pCol->colMeta.type)) {
+      pCol->colData.varLenCol.varOffsetsLen = pColHead->metaLen;
+      pCol->colData.varLenCol.varOffsets = (int32_t *)pMeta;
+      pCol->colData.varLenCol.payloadLen = pColHead->dataLen;
+      pCol->colData.varLenCol.payload = pData;
+    } else {
+      pCol->colData.fixLenCol.nullBitmapLen = pColHead->metaLen;
+      pCol->colData.fixLenCol.nullBitmap = pMeta;
+      pCol->colData.fixLenCol.dataLen = pColHead->dataLen;
+      pCol->colData.fixLenCol.data = pData;
+    }
+    pBlock->udfCols[i] = pCol;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+void udfShmFreeUdfDataBlockView(SUdfDataBlock *pBlock) {
+  taosMemoryFree(pBlock->udfCols);
+  pBlock->udfCols = NULL;
+  pBlock->numOfCols = 0;
+}
@@ -282,7 +282,8 @@ typedef struct SUdf {
 } SUdf;
 
 typedef struct SUdfcFuncHandle {
-  SUdf *udf;
+  SUdf    *udf;
+  SUdfShm *shm;  // shared memory of the udfc session, NULL if the data blocks are sent through the pipe
 } SUdfcFuncHandle;
 
 typedef enum EUdfdRpcReqRspType {
@@ -645,6 +646,13 @@ void udfdProcessSetupRequest(SUvUdfWork *uvUdf, SUdfRequest *request) {
   }
   SUdfcFuncHandle *handle = taosMemoryMalloc(sizeof(SUdfcFuncHandle));
   handle->udf = udf;
+  handle->shm = NULL;
+  if (code == 0 && setup->shmName[0] != 0) {
+    int32_t shmCode = udfShmAttach(setup->shmName, setup->shmSize, &handle->shm);
+    if (shmCode != TSDB_CODE_SUCCESS) {
+      fnWarn("udfd attach shm %s failed, send data blocks through pipe, since %s", setup->shmName, tstrerror(shmCode));
+    }
+  }
 
   SUdfResponse rsp;
   rsp.seqNum = request->seqNum;
@@ -654,6 +662,7 @@ void udfdProcessSetupRequest(SUvUdfWork *uvUdf, SUdfRequest *request) {
   rsp.setupRsp.outputType = udf->outputType;
   rsp.setupRsp.bytes = udf->outputLen;
   rsp.setupRsp.bufSize = udf->bufSize;
+  rsp.setupRsp.shmAttached = (handle->shm != NULL);
 
   int32_t len = encodeUdfResponse(NULL, &rsp);
   rsp.msgLen = len;
@@ -667,6 +676,25 @@ void udfdProcessSetupRequest(SUvUdfWork *uvUdf, SUdfRequest *request) {
   return;
 }
 
+static int32_t udfdGetCallInput(SUdfcFuncHandle *handle, SUdfCallRequest *call, SUdfDataBlock *input) {
+  if (call->shmSlot < 0) {
+    return convertDataBlockToUdfDataBlock(&call->block, input);
+  }
+  if (handle->shm == NULL || call->shmSlot >= handle->shm->slotNum) {
+    fnError("udfd invalid shm slot %d of handle %p", call->shmSlot, handle);
+    return TSDB_CODE_UDF_INVALID_INPUT;
+  }
+  return udfShmViewUdfDataBlock(handle->shm, call->shmSlot, input);
+}
+
+static void udfdFreeCallInput(SUdfCallRequest *call, SUdfDataBlock *input) {
+  if (call->shmSlot < 0) {
+    freeUdfDataDataBlock(input);
+  } else {
+    udfShmFreeUdfDataBlockView(input);
+  }
+}
+
 void udfdProcessCallRequest(SUvUdfWork *uvUdf, SUdfRequest *request) {
   SUdfCallRequest *call = &request->call;
   fnDebug("call request. call type %d, handle: %" PRIx64 ", seq num %" PRId64, call->callType, call->udfHandle,
@@ -680,18 +708,27 @@ void udfdProcessCallRequest(SUvUdfWork *uvUdf, SUdfRequest *request) {
   int32_t code = TSDB_CODE_SUCCESS;
   switch (call->callType) {
     case TSDB_UDF_CALL_SCALA_PROC: {
+      SUdfDataBlock input = {0};
+      code = udfdGetCallInput(handle, call, &input);
+      if (code != TSDB_CODE_SUCCESS) {
+        break;
+      }
+
       SUdfColumn output = {0};
       output.colMeta.bytes = udf->outputLen;
       output.colMeta.type = udf->outputType;
       output.colMeta.precision = 0;
       output.colMeta.scale = 0;
-      udfColEnsureCapacity(&output, call->block.info.rows);
+      udfColEnsureCapacity(&output, input.numOfRows);
 
-      SUdfDataBlock input = {0};
-      convertDataBlockToUdfDataBlock(&call->block, &input);
       code = udf->scriptPlugin->udfScalarProcFunc(&input, &output, udf->scriptUdfCtx);
-      freeUdfDataDataBlock(&input);
-      convertUdfColumnToDataBlock(&output, &response.callRsp.resultData);
+      udfdFreeCallInput(call, &input);
+      // the input in the slot is not used any more, the result can be written over it
+      if (call->shmSlot >= 0 && udfShmWriteUdfColumn(handle->shm, call->shmSlot, &output) == TSDB_CODE_SUCCESS) {
+        subRsp->resultInShm = 1;
+      } else {
+        convertUdfColumnToDataBlock(&output, &response.callRsp.resultData);
+      }
       freeUdfColumn(&output);
       break;
     }
@@ -703,11 +740,15 @@ void udfdProcessCallRequest(SUvUdfWork *uvUdf, SUdfRequest *request) {
     }
     case TSDB_UDF_CALL_AGG_PROC: {
       SUdfDataBlock input = {0};
-      convertDataBlockToUdfDataBlock(&call->block, &input);
+      code = udfdGetCallInput(handle, call, &input);
+      if (code != TSDB_CODE_SUCCESS) {
+        freeUdfInterBuf(&call->interBuf);
+        break;
+      }
       SUdfInterBuf outBuf = {.buf = taosMemoryMalloc(udf->bufSize), .bufLen = udf->bufSize, .numOfResult = 0};
       code = udf->scriptPlugin->udfAggProcFunc(&input, &call->interBuf, &outBuf, udf->scriptUdfCtx);
       freeUdfInterBuf(&call->interBuf);
-      freeUdfDataDataBlock(&input);
+      udfdFreeCallInput(call, &input);
       subRsp->resultBuf = outBuf;
 
       break;
@@ -798,6 +839,7 @@ void udfdProcessTeardownRequest(SUvUdfWork *uvUdf, SUdfRequest *request) {
     fnDebug("udfd destroy function returns %d", code);
     taosMemoryFree(udf);
   }
+  udfShmDetach(handle->shm);
   taosMemoryFree(handle);
 
   SUdfResponse  response = {0};
@@ -0,0 +1,166 @@
+// Compare the cost of moving data blocks from udfc to udfd through the pipe (encode, write, read, decode, convert)
+// with the shared memory data plane (write into a slot, view in place).
+//
+// usage: udfShmBench [numOfBlocks] [rowsPerBlock]
+#define ALLOW_FORBID_FUNC
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "os.h"
+#include "tdatablock.h"
+#include "tudf.h"
+#include "tudfInt.h"
+
+#define BENCH_PIPE_CHUNK (32 * 1024)
+#define BENCH_VAR_LEN    32
+
+static SSDataBlock *createBenchBlock(int32_t rows) {
+  SSDataBlock    *pBlock = createDataBlock();
+  SColumnInfoData c1 = createColumnInfoData(TSDB_DATA_TYPE_INT, sizeof(int32_t), 1);
+  SColumnInfoData c2 = createColumnInfoData(TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), 2);
+  SColumnInfoData c3 = createColumnInfoData(TSDB_DATA_TYPE_DOUBLE, sizeof(double), 3);
+  SColumnInfoData c4 = createColumnInfoData(TSDB_DATA_TYPE_VARCHAR, BENCH_VAR_LEN + VARSTR_HEADER_SIZE, 4);
+  blockDataAppendColInfo(pBlock, &c1);
+  blockDataAppendColInfo(pBlock, &c2);
+  blockDataAppendColInfo(pBlock, &c3);
+  blockDataAppendColInfo(pBlock, &c4);
+  blockDataEnsureCapacity(pBlock, rows);
+
+  char buf[BENCH_VAR_LEN + VARSTR_HEADER_SIZE];
+  for (int32_t i = 0; i < rows; ++i) {
+    int32_t v1 = i;
+    int64_t v2 = (int64_t)i * 1000;
+    double  v3 = i * 0.5;
+    colDataSetVal(taosArrayGet(pBlock->pDataBlock, 0), i, (const char *)&v1, false);
+    colDataSetVal(taosArrayGet(pBlock->pDataBlock, 1), i, (const char *)&v2, false);
+    colDataSetVal(taosArrayGet(pBlock->pDataBlock, 2), i, (const char *)&v3, false);
+    int32_t len = snprintf(varDataVal(buf), BENCH_VAR_LEN, "value_%d", i);
+    varDataSetLen(buf, len);
+    colDataSetVal(taosArrayGet(pBlock->pDataBlock, 3), i, buf, false);
+  }
+  pBlock->info.rows = rows;
+  return pBlock;
+}
+
+// touch the input the way a udf does, so that both paths pay for reading the data
+static int64_t consumeUdfBlock(SUdfDataBlock *pBlock) {
+  int64_t     sum = 0;
+  SUdfColumn *pCol = pBlock->udfCols[1];
+  for (int32_t i = 0; i < pBlock->numOfRows; ++i) {
+    sum += *(int64_t *)udfColDataGetData(pCol, i);
+  }
+  return sum;
+}
+
+static int32_t pipeTransfer(int fds[2], const char *src, char *dst, int32_t len) {
+  int32_t off = 0;
+  while (off < len) {
+    int32_t chunk = TMIN(BENCH_PIPE_CHUNK, len - off);
+    if (write(fds[1], src + off, chunk) != chunk) return -1;
+    int32_t got = 0;
+    while (got < chunk) {
+      ssize_t n = read(fds[0], dst + off + got, chunk - got);
+      if (n <= 0) return -1;
+      got += n;
+    }
+    off += chunk;
+  }
+  return 0;
+}
+
+static int64_t benchPipe(SSDataBlock *pBlock, int32_t numOfBlocks, int64_t *pBytes) {
+  int fds[2];
+  if (pipe(fds) != 0) {
+    return -1;
+  }
+
+  int32_t len = tEncodeDataBlock(NULL, pBlock);
+  char   *sendBuf = taosMemoryMalloc(len);
+  char   *recvBuf = taosMemoryMalloc(len);
+  int64_t sum = 0;
+
+  int64_t st = taosGetTimestampUs();
+  for (int32_t i = 0; i < numOfBlocks; ++i) {
+    void *p = sendBuf;
+    tEncodeDataBlock(&p, pBlock);
+    if (pipeTransfer(fds, sendBuf, recvBuf, len) != 0) {
+      break;
+    }
+
+    SSDataBlock   decoded = {0};
+    SUdfDataBlock input = {0};
+    tDecodeDataBlock(recvBuf, &decoded);
+    convertDataBlockToUdfDataBlock(&decoded, &input);
+    sum += consumeUdfBlock(&input);
+    freeUdfDataDataBlock(&input);
+    blockDataFreeRes(&decoded);
+  }
+  int64_t cost = taosGetTimestampUs() - st;
+
+  *pBytes = (int64_t)len * numOfBlocks;
+  taosMemoryFree(sendBuf);
+  taosMemoryFree(recvBuf);
+  close(fds[0]);
+  close(fds[1]);
+  printf("pipe checksum: %" PRId64 "\n", sum);
+  return cost;
+}
+
+static int64_t benchShm(SSDataBlock *pBlock, int32_t numOfBlocks) {
+  SUdfShm *pClient = NULL;
+  SUdfShm *pServer = NULL;
+  if (udfShmCreate(&pClient) != 0 || udfShmAttach(pClient->name, pClient->size, &pServer) != 0) {
+    udfShmDetach(pClient);
+    return -1;
+  }
+  udfShmUnlink(pClient);
+
+  int64_t sum = 0;
+  int64_t st = taosGetTimestampUs();
+  for (int32_t i = 0; i < numOfBlocks; ++i) {
+    int32_t slot = udfShmAcquireSlot(pClient);
+    if (udfShmWriteDataBlock(pClient, slot, pBlock) != 0) {
+      printf("block does not fit into a shm slot of %d bytes\n", pClient->slotSize);
+      udfShmReleaseSlot(pClient, slot);
+      break;
+    }
+
+    SUdfDataBlock input = {0};
+    udfShmViewUdfDataBlock(pServer, slot, &input);
+    sum += consumeUdfBlock(&input);
+    udfShmFreeUdfDataBlockView(&input);
+    udfShmReleaseSlot(pClient, slot);
+  }
+  int64_t cost = taosGetTimestampUs() - st;
+
+  udfShmDetach(pServer);
+  udfShmDetach(pClient);
+  printf("shm  checksum: %" PRId64 "\n", sum);
+  return cost;
+}
+
+int main(int argc, char *argv[]) {
+  int32_t numOfBlocks = (argc > 1) ? atoi(argv[1]) : 2000;
+  int32_t rows = (argc > 2) ? atoi(argv[2]) : 4096;
+
+  SSDataBlock *pBlock = createBenchBlock(rows);
+  int64_t      bytes = 0;
+  int64_t      pipeCost = benchPipe(pBlock, numOfBlocks, &bytes);
+  int64_t      shmCost = benchShm(pBlock, numOfBlocks);
+  blockDataDestroy(pBlock);
+
+  if (pipeCost <= 0 || shmCost <= 0) {
+    printf("benchmark failed\n");
+    return 1;
+  }
+
+  double mb = bytes / 1024.0 / 1024.0;
+  printf("%d blocks of %d rows, %.1f MB\n", numOfBlocks, rows, mb);
+  printf("pipe: %8.1f ms, %8.1f MB/s, %10.0f rows/s\n", pipeCost / 1000.0, mb * 1000000 / pipeCost,
+         (double)numOfBlocks * rows * 1000000 / pipeCost);
+  printf("shm : %8.1f ms, %8.1f MB/s, %10.0f rows/s\n", shmCost / 1000.0, mb * 1000000 / shmCost,
+         (double)numOfBlocks * rows * 1000000 / shmCost);
+  return 0;
+}
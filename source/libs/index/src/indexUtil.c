@@ -62,6 +62,9 @@ void iIntersection(SArray *in, SArray *out) {
       } else {
         has = false;
       }
+      if (has == false) {
+        break;
+      }
     }
     if (has == true) {
       taosArrayPush(out, &tgt);
@@ -365,3 +365,69 @@ TEST_F(UtilEnv, testDictComm) {
     EXPECT_EQ(COMMON_INPUTS[v], i);
   }
 }
+TEST_F(UtilEnv, intersectMismatchFirst) {
+  clearSourceArray(src);
+  clearFinalArray(rslt);
+
+  uint64_t arr1[] = {1, 2, 3};
+  uint64_t arr2[] = {2, 3};
+  uint64_t arr3[] = {1, 3};
+  SArray  *f = (SArray *)taosArrayGetP(src, 0);
+  for (int i = 0; i < sizeof(arr1) / sizeof(arr1[0]); i++) taosArrayPush(f, &arr1[i]);
+  f = (SArray *)taosArrayGetP(src, 1);
+  for (int i = 0; i < sizeof(arr2) / sizeof(arr2[0]); i++) taosArrayPush(f, &arr2[i]);
+  f = (SArray *)taosArrayGetP(src, 2);
+  for (int i = 0; i < sizeof(arr3) / sizeof(arr3[0]); i++) taosArrayPush(f, &arr3[i]);
+
+  iIntersection(src, rslt);
+  EXPECT_EQ(taosArrayGetSize(rslt), 1);
+  EXPECT_EQ(*(uint64_t *)taosArrayGet(rslt, 0), 3);
+}
+
+// uids of the tables of a super table, with the layout of tGenIdPI64 and one table created every 256ms
+static uint64_t genSparseUid(int64_t hashId, int64_t pid, int64_t i) {
+  int64_t ts = 1700000000000LL / 256 + i;
+  return ((hashId & 0x07FF) << 52) | ((pid & 0x0F) << 48) | ((ts & 0x3FFFFFF) << 20) | ((i * 13) & 0xFFFFF);
+}
+
+TEST_F(UtilEnv, mergeLargeSparseLists) {
+  clearSourceArray(src);
+  clearFinalArray(rslt);
+
+  const int64_t num = 200000;
+  SArray       *f0 = (SArray *)taosArrayGetP(src, 0);
+  SArray       *f1 = (SArray *)taosArrayGetP(src, 1);
+  SArray       *f2 = (SArray *)taosArrayGetP(src, 2);
+  int64_t       numOfF1 = 0;
+  int64_t       numOfF12 = 0;
+  for (int64_t i = 0; i < num; i++) {
+    uint64_t uid = genSparseUid(1023, 7, i);
+    taosArrayPush(f0, &uid);
+    if (i % 7 == 0) {
+      taosArrayPush(f1, &uid);
+      numOfF1++;
+    }
+    if (i % 7 == 0 && i % 3 == 0) {
+      taosArrayPush(f2, &uid);
+      numOfF12++;
+    }
+  }
+
+  // a uid of another vnode, only in f2
+  uint64_t other = genSparseUid(1, 2, 0);
+  taosArrayInsert(f2, 0, &other);
+
+  iIntersection(src, rslt);
+  EXPECT_EQ(taosArrayGetSize(rslt), numOfF12);
+  for (int32_t i = 1; i < taosArrayGetSize(rslt); i++) {
+    EXPECT_LT(*(uint64_t *)taosArrayGet(rslt, i - 1), *(uint64_t *)taosArrayGet(rslt, i));
+  }
+
+  clearFinalArray(rslt);
+  iUnion(src, rslt);
+  EXPECT_EQ(taosArrayGetSize(rslt), num + 1);
+  EXPECT_EQ(*(uint64_t *)taosArrayGet(rslt, 0), other);
+  for (int32_t i = 1; i < taosArrayGetSize(rslt); i++) {
+    EXPECT_EQ(*(uint64_t *)taosArrayGet(rslt, i), *(uint64_t *)taosArrayGet(f0, i - 1));
+  }
+}
@@ -46,6 +46,9 @@ typedef struct {
   SMonBmInfo    bmInfo;
 } SMonitor;
 
+int32_t monStartMetricsServer(const char *fqdn, uint16_t port);
+void    monStopMetricsServer();
+
 #ifdef __cplusplus
 }
 #endif
@@ -108,10 +108,15 @@ int32_t monInit(const SMonCfg *pCfg) {
   tsLogFp = monRecordLog;
   tsMonitor.lastTime = taosGetTimestampMs();
   taosThreadMutexInit(&tsMonitor.lock, NULL);
+
+  if (pCfg->metricsPort > 0 && monStartMetricsServer(pCfg->metricsFqdn, pCfg->metricsPort) != 0) {
+    uError("failed to start metrics server since %s", terrstr());
+  }
   return 0;
 }
 
 void monCleanup() {
+  monStopMetricsServer();
   tsLogFp = NULL;
   taosArrayDestroy(tsMonitor.logs);
   tsMonitor.logs = NULL;
@@ -404,6 +409,17 @@ static void monGenDnodeJson(SMonInfo *pMonitor) {
   tjsonAddDoubleToObject(pJson, "has_mnode", pInfo->has_mnode);
   tjsonAddDoubleToObject(pJson, "has_qnode", pInfo->has_qnode);
   tjsonAddDoubleToObject(pJson, "has_snode", pInfo->has_snode);
+
+  SMemAllocStats allocStats = {0};
+  if (taosMemoryGetAllocStats(&allocStats) == 0) {
+    tjsonAddStringToObject(pJson, "mem_allocator", taosMemoryAllocatorName());
+    tjsonAddDoubleToObject(pJson, "mem_allocated", allocStats.allocated);
+    tjsonAddDoubleToObject(pJson, "mem_active", allocStats.active);
+    tjsonAddDoubleToObject(pJson, "mem_resident", allocStats.resident);
+    tjsonAddDoubleToObject(pJson, "mem_mapped", allocStats.mapped);
+    tjsonAddDoubleToObject(pJson, "mem_retained", allocStats.retained);
+    tjsonAddDoubleToObject(pJson, "mem_arenas", allocStats.numOfArenas);
+  }
 }
 
 static void monGenDiskJson(SMonInfo *pMonitor) {
@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _DEFAULT_SOURCE
+#include <uv.h>
+#include "monInt.h"
+#include "taoserror.h"
+#include "tmetrics.h"
+
+#define METRICS_MAX_REQ_LEN 4096
+
+typedef struct {
+  uv_tcp_t   tcp;
+  uv_write_t req;
+  uv_buf_t   wbuf[2];
+  char      *pBody;
+  char       header[256];
+  int32_t    reqLen;
+  char       reqBuf[METRICS_MAX_REQ_LEN];
+} SMetricsConn;
+
+typedef struct {
+  bool       inited;
+  TdThread   thread;
+  uv_loop_t  loop;
+  uv_tcp_t   server;
+  uv_async_t stop;
+} SMetricsServer;
+
+static SMetricsServer tsMetricsServer = {0};
+
+static void monMetricsConnCloseCb(uv_handle_t *handle) {
+  SMetricsConn *pConn = handle->data;
+  taosMemoryFree(pConn->pBody);
+  taosMemoryFree(pConn);
+}
+
+static void monMetricsCloseConn(SMetricsConn *pConn) {
+  if (!uv_is_closing((uv_handle_t *)&pConn->tcp)) {
+    uv_close((uv_handle_t *)&pConn->tcp, monMetricsConnCloseCb);
+  }
+}
+
+static void monMetricsWriteCb(uv_write_t *req, int32_t status) {
+  SMetricsConn *pConn = req->data;
+  if (status != 0) {
+    uWarn("metrics failed to send response since %s", uv_strerror(status));
+  }
+  monMetricsCloseConn(pConn);
+}
+
+static void monMetricsRespond(SMetricsConn *pConn) {
+  int32_t     bodyLen = 0;
+  const char *status = "404 Not Found";
+
+  if (strncmp(pConn->reqBuf, "GET /metrics", 12) == 0 &&
+      (pConn->reqBuf[12] == ' ' || pConn->reqBuf[12] == '?')) {
+    if (taosMetricsDump(&pConn->pBody, &bodyLen) == 0) {
+      status = "200 OK";
+    } else {
+      status = "500 Internal Server Error";
+    }
+  }
+
+  int32_t headerLen = snprintf(pConn->header, sizeof(pConn->header),
+                               "HTTP/1.1 %s\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: %d\r\n"
+                               "Connection: close\r\n\r\n",
+                               status, bodyLen);
+  pConn->wbuf[0] = uv_buf_init(pConn->header, headerLen);
+  pConn->wbuf[1] = uv_buf_init(pConn->pBody, bodyLen);
+  pConn->req.data = pConn;
+
+  int32_t code = uv_write(&pConn->req, (uv_stream_t *)&pConn->tcp, pConn->wbuf, bodyLen > 0 ? 2 : 1, monMetricsWriteCb);
+  if (code != 0) {
+    uWarn("metrics failed to send response since %s", uv_strerror(code));
+    monMetricsCloseConn(pConn);
+  }
+}
+
+static void monMetricsAllocCb(uv_handle_t *handle, size_t suggested_size, uv_buf_t *buf) {
+  SMetricsConn *pConn = handle->data;
+  buf->base = pConn->reqBuf + pConn->reqLen;
+  buf->len = METRICS_MAX_REQ_LEN - 1 - pConn->reqLen;
+}
+
+static void monMetricsReadCb(uv_stream_t *stream, ssize_t nread, const uv_buf_t *buf) {
+  SMetricsConn *pConn = stream->data;
+  if (nread < 0) {
+    monMetricsCloseConn(pConn);
+    return;
+  }
+
+  pConn->reqLen += nread;
+  pConn->reqBuf[pConn->reqLen] = 0;
+  if (strstr(pConn->reqBuf, "\r\n\r\n") == NULL && pConn->reqLen < METRICS_MAX_REQ_LEN - 1) {
+    return;  // wait for the rest of the header
+  }
+
+  uv_read_stop(stream);
+  monMetricsRespond(pConn);
+}
+
+static void monMetricsConnectCb(uv_stream_t *server, int32_t status) {
+  if (status != 0) {
+    uWarn("metrics failed to accept connection since %s", uv_strerror(status));
+    return;
+  }
+
+  SMetricsConn *pConn = taosMemoryCalloc(1, sizeof(SMetricsConn));
+  if (pConn == NULL) return;
+
+  uv_tcp_init(server->loop, &pConn->tcp);
+  pConn->tcp.data = pConn;
+  if (uv_accept(server, (uv_stream_t *)&pConn->tcp) != 0 ||
+      uv_read_start((uv_stream_t *)&pConn->tcp, monMetricsAllocCb, monMetricsReadCb) != 0) {
+    monMetricsCloseConn(pConn);
+  }
+}
+
+static void monMetricsWalkCb(uv_handle_t *handle, void *arg) {
+  if (uv_is_closing(handle)) return;
+
+  // the accepted connections are freed when closed, the server and the async handle are static
+  bool isConn = (handle->type == UV_TCP && handle != (uv_handle_t *)&tsMetricsServer.server);
+  uv_close(handle, isConn ? monMetricsConnCloseCb : NULL);
+}
+
+static void monMetricsStopCb(uv_async_t *handle) { uv_walk(handle->loop, monMetricsWalkCb, NULL); }
+
+static void *monMetricsThreadFp(void *param) {
+  setThreadName("metrics-srv");
+  uv_run(&tsMetricsServer.loop, UV_RUN_DEFAULT);
+  return NULL;
+}
+
+int32_t monStartMetricsServer(const char *fqdn, uint16_t port) {
+  if (port == 0) return 0;
+
+  uint32_t ip = taosGetIpv4FromFqdn(fqdn);
+  if (ip == 0xffffffff) {
+    uError("metrics failed to resolve fqdn:%s", fqdn);
+    terrno = TSDB_CODE_RPC_FQDN_ERROR;
+    return -1;
+  }
+
+  char ipStr[64] = {0};
+  tinet_ntoa(ipStr, ip);
+  struct sockaddr_in addr;
+  uv_ip4_addr(ipStr, port, &addr);
+
+  uv_loop_init(&tsMetricsServer.loop);
+  uv_async_init(&tsMetricsServer.loop, &tsMetricsServer.stop, monMetricsStopCb);
+  uv_tcp_init(&tsMetricsServer.loop, &tsMetricsServer.server);
+
+  int32_t code = uv_tcp_bind(&tsMetricsServer.server, (const struct sockaddr *)&addr, 0);
+  if (code == 0) {
+    code = uv_listen((uv_stream_t *)&tsMetricsServer.server, 128, monMetricsConnectCb);
+  }
+  if (code != 0) {
+    uError("metrics failed to listen on %s:%u since %s", ipStr, port, uv_strerror(code));
+    uv_walk(&tsMetricsServer.loop, monMetricsWalkCb, NULL);
+    uv_run(&tsMetricsServer.loop, UV_RUN_DEFAULT);
+    uv_loop_close(&tsMetricsServer.loop);
+    terrno = TSDB_CODE_RPC_PORT_EADDRINUSE;
+    return -1;
+  }
+
+  TdThreadAttr thAttr;
+  taosThreadAttrInit(&thAttr);
+  taosThreadAttrSetDetachState(&thAttr, PTHREAD_CREATE_JOINABLE);
+  code = taosThreadCreate(&tsMetricsServer.thread, &thAttr, monMetricsThreadFp, NULL);
+  taosThreadAttrDestroy(&thAttr);
+  if (code != 0) {
+    uv_walk(&tsMetricsServer.loop, monMetricsWalkCb, NULL);
+    uv_run(&tsMetricsServer.loop, UV_RUN_DEFAULT);
+    uv_loop_close(&tsMetricsServer.loop);
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    return -1;
+  }
+
+  tsMetricsServer.inited = true;
+  uInfo("metrics server is listening on %s:%u", ipStr, port);
+  return 0;
+}
+
+void monStopMetricsServer() {
+  if (!tsMetricsServer.inited) return;
+
+  uv_async_send(&tsMetricsServer.stop);
+  taosThreadJoin(tsMetricsServer.thread, NULL);
+  uv_loop_close(&tsMetricsServer.loop);
+  tsMetricsServer.inited = false;
+  uInfo("metrics server is stopped");
+}
@@ -436,6 +436,7 @@ static int32_t logicJoinCopy(const SJoinLogicNode* pSrc, SJoinLogicNode* pDst) {
   CLONE_NODE_FIELD(pOtherOnCond);
   COPY_SCALAR_FIELD(isSingleTableJoin);
   COPY_SCALAR_FIELD(hasSubQuery);
+  COPY_OBJECT_FIELD(inputStat, sizeof(pSrc->inputStat));
   return TSDB_CODE_SUCCESS;
 }
 
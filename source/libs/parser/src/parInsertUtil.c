@@ -747,3 +747,74 @@ int rawBlockBindData(SQuery* query, STableMeta* pTableMeta, void* data, SVCreate
 end:
   return ret;
 }
+
+// the column data and rows of the raw submit data refer to the buffer of the tmq rsp, only the arrays and the cloned
+// create table req are owned here
+static void destroyRawSubmitVgDataCxtList(SArray* pVgCxtList) {
+  size_t size = taosArrayGetSize(pVgCxtList);
+  for (int32_t i = 0; i < size; i++) {
+    SVgroupDataCxt* pVgCxt = taosArrayGetP(pVgCxtList, i);
+    int32_t         nTbData = taosArrayGetSize(pVgCxt->pData->aSubmitTbData);
+    for (int32_t j = 0; j < nTbData; j++) {
+      SSubmitTbData* pTbData = taosArrayGet(pVgCxt->pData->aSubmitTbData, j);
+      if (pTbData->pCreateTbReq) {
+        tdDestroySVCreateTbReq(pTbData->pCreateTbReq);
+        taosMemoryFreeClear(pTbData->pCreateTbReq);
+      }
+    }
+    tDestroySubmitReq(pVgCxt->pData, TSDB_MSG_FLG_DECODE);
+    taosMemoryFree(pVgCxt->pData);
+    taosMemoryFree(pVgCxt);
+  }
+
+  taosArrayDestroy(pVgCxtList);
+}
+
+int32_t rawSubmitBindData(SQuery* query, int32_t vgId, SSubmitTbData* pTbData) {
+  SVnodeModifyOpStmt* pStmt = (SVnodeModifyOpStmt*)query->pRoot;
+  if (NULL == pStmt->pVgDataBlocks) {
+    pStmt->pVgDataBlocks = taosArrayInit(4, POINTER_BYTES);
+    if (NULL == pStmt->pVgDataBlocks) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    pStmt->freeArrayFunc = destroyRawSubmitVgDataCxtList;
+  }
+
+  SVgroupDataCxt* pVgCxt = NULL;
+  for (int32_t i = 0; i < taosArrayGetSize(pStmt->pVgDataBlocks); i++) {
+    SVgroupDataCxt* p = taosArrayGetP(pStmt->pVgDataBlocks, i);
+    if (p->vgId == vgId) {
+      pVgCxt = p;
+      break;
+    }
+  }
+
+  if (NULL == pVgCxt) {
+    pVgCxt = taosMemoryCalloc(1, sizeof(SVgroupDataCxt));
+    if (NULL == pVgCxt) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    pVgCxt->vgId = vgId;
+    pVgCxt->pData = taosMemoryCalloc(1, sizeof(SSubmitReq2));
+    if (NULL != pVgCxt->pData) {
+      pVgCxt->pData->aSubmitTbData = taosArrayInit(16, sizeof(SSubmitTbData));
+    }
+    if (NULL == pVgCxt->pData || NULL == pVgCxt->pData->aSubmitTbData ||
+        NULL == taosArrayPush(pStmt->pVgDataBlocks, &pVgCxt)) {
+      if (pVgCxt->pData) taosArrayDestroy(pVgCxt->pData->aSubmitTbData);
+      taosMemoryFree(pVgCxt->pData);
+      taosMemoryFree(pVgCxt);
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+
+  if (NULL == taosArrayPush(pVgCxt->pData->aSubmitTbData, pTbData)) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+int32_t rawSubmitBuildOutput(SQuery* query, SHashObj* pVgHash) {
+  SVnodeModifyOpStmt* pStmt = (SVnodeModifyOpStmt*)query->pRoot;
+  return insBuildVgDataBlocks(pVgHash, pStmt->pVgDataBlocks, &pStmt->pDataBlocks);
+}
@@ -332,6 +332,10 @@ class MockCatalogServiceImpl {
     info.dstVgId = pReq->dstVgId;
     genEpSet(&info.epSet);
     info.expr = taosStrdup(pReq->expr);
+    // same defaults as the mnode, the mock databases are all millisecond precision
+    info.watermark = pReq->watermark;
+    info.maxDelay = pReq->maxDelay < TSDB_MIN_ROLLUP_MAX_DELAY ? TMAX(pReq->interval, TSDB_MIN_ROLLUP_MAX_DELAY)
+                                                                : pReq->maxDelay;
     auto it = index_.find(pReq->stb);
     if (index_.end() == it) {
       index_.insert(std::make_pair(string(pReq->stb), std::vector<STableIndexInfo>{info}));
@@ -54,6 +54,9 @@ bool        isPartTableWinodw(SWindowLogicNode* pWindow);
 bool        keysHasCol(SNodeList* pKeys);
 bool        keysHasTbname(SNodeList* pKeys);
 
+int64_t planEstimateRows(SLogicNode* pNode);
+int32_t planEstimateRowSize(SLogicNode* pNode);
+
 #define CLONE_LIMIT 1
 #define CLONE_SLIMIT 1 << 1
 #define CLONE_LIMIT_SLIMIT (CLONE_LIMIT | CLONE_SLIMIT)
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "planInt.h"
+
+// The planner has no table statistics, so the cardinality is estimated from the shape of the plan: table type,
+// number of vgroups, time range and the predicates. The numbers only need to be good enough to compare the two
+// inputs of a join, they are not meant to be accurate.
+#define PLAN_EST_ROWS_PER_TABLE       100000
+#define PLAN_EST_TABLES_PER_VGROUP    1000
+#define PLAN_EST_SYS_TABLE_ROWS       1000
+#define PLAN_EST_TIME_RANGE_SEL       0.1
+#define PLAN_EST_EQUAL_SEL            0.1
+#define PLAN_EST_RANGE_SEL            0.33
+#define PLAN_EST_DEFAULT_SEL          0.5
+#define PLAN_EST_GROUP_SEL            0.1
+
+static double estimateCondSelectivity(SNode* pCond) {
+  if (NULL == pCond) {
+    return 1.0;
+  }
+
+  switch (nodeType(pCond)) {
+    case QUERY_NODE_LOGIC_CONDITION: {
+      SLogicConditionNode* pLogicCond = (SLogicConditionNode*)pCond;
+      SNode*               pNode = NULL;
+      if (LOGIC_COND_TYPE_AND == pLogicCond->condType) {
+        double sel = 1.0;
+        FOREACH(pNode, pLogicCond->pParameterList) { sel *= estimateCondSelectivity(pNode); }
+        return sel;
+      }
+      if (LOGIC_COND_TYPE_OR == pLogicCond->condType) {
+        double sel = 0.0;
+        FOREACH(pNode, pLogicCond->pParameterList) { sel += estimateCondSelectivity(pNode); }
+        return TMIN(sel, 1.0);
+      }
+      return PLAN_EST_DEFAULT_SEL;
+    }
+    case QUERY_NODE_OPERATOR: {
+      switch (((SOperatorNode*)pCond)->opType) {
+        case OP_TYPE_EQUAL:
+        case OP_TYPE_IN:
+        case OP_TYPE_IS_NULL:
+          return PLAN_EST_EQUAL_SEL;
+        case OP_TYPE_GREATER_THAN:
+        case OP_TYPE_GREATER_EQUAL:
+        case OP_TYPE_LOWER_THAN:
+        case OP_TYPE_LOWER_EQUAL:
+        case OP_TYPE_LIKE:
+        case OP_TYPE_MATCH:
+          return PLAN_EST_RANGE_SEL;
+        default:
+          return PLAN_EST_DEFAULT_SEL;
+      }
+    }
+    default:
+      break;
+  }
+
+  return PLAN_EST_DEFAULT_SEL;
+}
+
+static int64_t estimateScanRows(SScanLogicNode* pScan) {
+  int64_t numOfVgroups = (NULL != pScan->pVgroupList && pScan->pVgroupList->numOfVgroups > 0)
+                             ? pScan->pVgroupList->numOfVgroups
+                             : 1;
+  int64_t numOfTables = (TSDB_SUPER_TABLE == pScan->tableType) ? numOfVgroups * PLAN_EST_TABLES_PER_VGROUP : 1;
+  double  rows = 0;
+
+  switch (pScan->scanType) {
+    case SCAN_TYPE_TAG:
+      rows = numOfTables * estimateCondSelectivity(pScan->pTagCond);
+      break;
+    case SCAN_TYPE_SYSTEM_TABLE:
+      rows = PLAN_EST_SYS_TABLE_ROWS;
+      break;
+    case SCAN_TYPE_LAST_ROW:
+    case SCAN_TYPE_TABLE_COUNT:
+    case SCAN_TYPE_BLOCK_INFO:
+      rows = numOfTables * estimateCondSelectivity(pScan->pTagCond);
+      break;
+    default: {
+      rows = (double)numOfTables * PLAN_EST_ROWS_PER_TABLE * estimateCondSelectivity(pScan->pTagCond);
+      if (TSWINDOW_IS_EQUAL(pScan->scanRange, TSWINDOW_DESC_INITIALIZER)) {
+        rows = 0;
+      } else if (pScan->scanRange.skey != INT64_MIN || pScan->scanRange.ekey != INT64_MAX) {
+        rows *= PLAN_EST_TIME_RANGE_SEL;
+      }
+      break;
+    }
+  }
+
+  return (int64_t)rows;
+}
+
+static int64_t estimateChildRows(SLogicNode* pNode, int32_t idx) {
+  SLogicNode* pChild = (SLogicNode*)nodesListGetNode(pNode->pChildren, idx);
+  return (NULL == pChild) ? 0 : planEstimateRows(pChild);
+}
+
+static int64_t estimateJoinRows(SJoinLogicNode* pJoin) {
+  int64_t leftRows = estimateChildRows((SLogicNode*)pJoin, 0);
+  int64_t rightRows = estimateChildRows((SLogicNode*)pJoin, 1);
+
+  switch (pJoin->joinType) {
+    case JOIN_TYPE_LEFT:
+      return leftRows;
+    case JOIN_TYPE_RIGHT:
+      return rightRows;
+    default:
+      // equi join on the primary key or on tags, each row of the smaller input matches at most a few rows
+      return TMIN(leftRows, rightRows);
+  }
+}
+
+static int64_t estimateSumOfChildRows(SLogicNode* pNode) {
+  int64_t rows = 0;
+  SNode*  pChild = NULL;
+  FOREACH(pChild, pNode->pChildren) { rows += planEstimateRows((SLogicNode*)pChild); }
+  return rows;
+}
+
+int64_t planEstimateRows(SLogicNode* pNode) {
+  double rows = 0;
+
+  switch (nodeType(pNode)) {
+    case QUERY_NODE_LOGIC_PLAN_SCAN:
+      rows = estimateScanRows((SScanLogicNode*)pNode);
+      break;
+    case QUERY_NODE_LOGIC_PLAN_JOIN:
+      rows = estimateJoinRows((SJoinLogicNode*)pNode);
+      break;
+    case QUERY_NODE_LOGIC_PLAN_AGG: {
+      SAggLogicNode* pAgg = (SAggLogicNode*)pNode;
+      rows = (NULL == pAgg->pGroupKeys) ? 1 : estimateChildRows(pNode, 0) * PLAN_EST_GROUP_SEL;
+      break;
+    }
+    case QUERY_NODE_LOGIC_PLAN_WINDOW:
+      rows = estimateChildRows(pNode, 0) * PLAN_EST_GROUP_SEL;
+      break;
+    case QUERY_NODE_LOGIC_PLAN_MERGE:
+      rows = estimateSumOfChildRows(pNode);
+      break;
+    default:
+      rows = estimateChildRows(pNode, 0);
+      break;
+  }
+
+  rows *= estimateCondSelectivity(pNode->pConditions);
+  if (NULL != pNode->pLimit) {
+    SLimitNode* pLimit = (SLimitNode*)pNode->pLimit;
+    rows = TMIN(rows, pLimit->limit + pLimit->offset);
+  }
+
+  return TMAX((int64_t)rows, (rows > 0 ? 1 : 0));
+}
+
+int32_t planEstimateRowSize(SLogicNode* pNode) {
+  int32_t rowSize = 0;
+  SNode*  pTarget = NULL;
+  FOREACH(pTarget, pNode->pTargets) { rowSize += ((SExprNode*)pTarget)->resType.bytes; }
+  return rowSize;
+}
@@ -1337,6 +1337,11 @@ static int32_t sortPriKeyOptGetSequencingNodesImpl(SLogicNode* pNode, bool group
       return nodesListMakeAppend(pSequencingNodes, (SNode*)pNode);
     }
     case QUERY_NODE_LOGIC_PLAN_JOIN: {
+      // the output order of a hash join is decided by the probe side, which is only chosen by the executor
+      if (JOIN_ALGO_HASH == ((SJoinLogicNode*)pNode)->joinAlgo) {
+        *pNotOptimize = true;
+        return TSDB_CODE_SUCCESS;
+      }
       int32_t code = sortPriKeyOptGetSequencingNodesImpl((SLogicNode*)nodesListGetNode(pNode->pChildren, 0), groupSort,
                                                          sortOrder, pNotOptimize, pSequencingNodes);
       if (TSDB_CODE_SUCCESS == code) {
@@ -1631,6 +1636,220 @@ static int32_t smaIndexOptApplyIndex(SLogicSubplan* pLogicSubplan, SScanLogicNod
   return code;
 }
 
+// An index with a finer interval can still answer the query if every index window lies in whole query windows, then
+// the query windows are computed again over the index rows, e.g. a 1d dashboard over a 1h index.
+static bool smaIndexOptCanRollup(SScanLogicNode* pScan, SWindowLogicNode* pWindow, STableIndexInfo* pIndex) {
+  if (NULL != pScan->pGroupTags || IS_CALENDAR_TIME_DURATION(pWindow->intervalUnit) || IS_CALENDAR_TIME_DURATION(pWindow->slidingUnit) ||
+      IS_CALENDAR_TIME_DURATION(pIndex->intervalUnit) || pIndex->interval <= 0 ||
+      pIndex->sliding != pIndex->interval || pWindow->interval <= pIndex->interval ||
+      0 != pWindow->interval % pIndex->interval || 0 != pWindow->sliding % pIndex->interval) {
+    return false;
+  }
+
+  SInterval index = {.interval = pIndex->interval,
+                     .intervalUnit = pIndex->intervalUnit,
+                     .offset = pIndex->offset,
+                     .offsetUnit = TIME_UNIT_MILLISECOND,
+                     .sliding = pIndex->sliding,
+                     .slidingUnit = pIndex->slidingUnit,
+                     .precision = pScan->node.precision};
+  SInterval query = {.interval = pWindow->interval,
+                     .intervalUnit = pWindow->intervalUnit,
+                     .offset = pWindow->offset,
+                     .offsetUnit = TIME_UNIT_MILLISECOND,
+                     .sliding = pWindow->sliding,
+                     .slidingUnit = pWindow->slidingUnit,
+                     .precision = pScan->node.precision};
+
+  // the windows are periodic, if one query window starts at an index window so do all of them
+  int64_t start = taosTimeTruncate(IS_TSWINDOW_SPECIFIED(pScan->scanRange) ? pScan->scanRange.skey : 0, &query);
+  if (start != taosTimeTruncate(start, &index)) {
+    return false;
+  }
+  if (!IS_TSWINDOW_SPECIFIED(pScan->scanRange) || INT64_MAX == pScan->scanRange.ekey ||
+      pScan->scanRange.skey != taosTimeTruncate(pScan->scanRange.skey, &index) ||
+      pScan->scanRange.ekey + 1 != taosTimeTruncate(pScan->scanRange.ekey + 1, &index)) {
+    return false;
+  }
+
+  // The index stream only writes a window once it is closed by the watermark and flushed within max delay, so the
+  // newest windows are not in the index yet. Rolling up over them would silently drop rows, and merging a raw scan in
+  // would need a second interval aggregation, so such ranges are left to the raw scan.
+  if (pIndex->watermark < 0 || pIndex->maxDelay < 0) {
+    return false;
+  }
+  int64_t lag = convertTimePrecision(pIndex->watermark + pIndex->maxDelay, TSDB_TIME_PRECISION_MILLI,
+                                     pScan->node.precision);
+  return pScan->scanRange.ekey < taosTimeTruncate(taosGetTimestamp(pScan->node.precision) - lag, &index);
+}
+
+static const char* smaIndexOptRollupFuncName(SFunctionNode* pFunc) {
+  switch (pFunc->funcType) {
+    case FUNCTION_TYPE_COUNT:
+    case FUNCTION_TYPE_SUM:
+      return "sum";
+    case FUNCTION_TYPE_MIN:
+      return "min";
+    case FUNCTION_TYPE_MAX:
+      return "max";
+    case FUNCTION_TYPE_FIRST:
+      return "first";
+    case FUNCTION_TYPE_LAST:
+      return "last";
+    default:
+      break;
+  }
+  return NULL;
+}
+
+static SNode* smaIndexOptCreateRollupCol(SDataType* pType, uint64_t tableId, int32_t colId) {
+  SColumnNode* pCol = (SColumnNode*)nodesMakeNode(QUERY_NODE_COLUMN);
+  if (NULL == pCol) {
+    return NULL;
+  }
+  pCol->tableId = tableId;
+  pCol->tableType = TSDB_SUPER_TABLE;
+  pCol->colId = colId;
+  pCol->colType = COLUMN_TYPE_COLUMN;
+  snprintf(pCol->colName, sizeof(pCol->colName), "#rollup_%d", colId);
+  pCol->node.resType = *pType;
+  strcpy(pCol->node.aliasName, pCol->colName);
+  return (SNode*)pCol;
+}
+
+static SNode* smaIndexOptFindRollupCol(SNodeList* pCols, int32_t colId) {
+  SNode* pCol = NULL;
+  FOREACH(pCol, pCols) {
+    if (((SColumnNode*)pCol)->colId == colId) {
+      return pCol;
+    }
+  }
+  return NULL;
+}
+
+static int32_t smaIndexOptCreateRollupFunc(SFunctionNode* pQueryFunc, SNode* pSmaFunc, int32_t colId, uint64_t tableId,
+                                           SNodeList** pCols, SNode** pOutput) {
+  const char* pName = smaIndexOptRollupFuncName(pQueryFunc);
+  if (NULL == pName) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SNode* pCol = smaIndexOptFindRollupCol(*pCols, colId);
+  if (NULL == pCol) {
+    pCol = smaIndexOptCreateRollupCol(&((SExprNode*)pSmaFunc)->resType, tableId, colId);
+    if (TSDB_CODE_SUCCESS != nodesListMakeStrictAppend(pCols, pCol)) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+
+  SFunctionNode* pFunc = (SFunctionNode*)nodesMakeNode(QUERY_NODE_FUNCTION);
+  if (NULL == pFunc) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  snprintf(pFunc->functionName, sizeof(pFunc->functionName), "%s", pName);
+  strcpy(pFunc->node.aliasName, pQueryFunc->node.aliasName);
+  strcpy(pFunc->node.userAlias, pQueryFunc->node.userAlias);
+  int32_t code = nodesListMakeStrictAppend(&pFunc->pParameterList, nodesCloneNode(pCol));
+  if (TSDB_CODE_SUCCESS == code) {
+    code = fmGetFuncInfo(pFunc, NULL, 0);
+  }
+  // the rolled up value must keep the type of the original one, e.g. sum(count) stays bigint
+  if (TSDB_CODE_SUCCESS == code && pFunc->node.resType.type == pQueryFunc->node.resType.type) {
+    *pOutput = (SNode*)pFunc;
+  } else {
+    nodesDestroyNode((SNode*)pFunc);
+  }
+  return code;
+}
+
+static int32_t smaIndexOptCreateRollupFuncs(SNodeList* pQueryFuncs, uint64_t tableId, SNodeList* pSmaFuncs,
+                                            SNodeList** pCols, SNodeList** pFuncs) {
+  SNode* pWsNode = smaIndexOptFindWStartFunc(pSmaFuncs);
+  if (NULL == pWsNode) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SNode*  pTsCol = smaIndexOptCreateRollupCol(&((SExprNode*)pWsNode)->resType, tableId, PRIMARYKEY_TIMESTAMP_COL_ID);
+  int32_t code = nodesListMakeStrictAppend(pCols, pTsCol);
+  SNode*  pQueryFunc = NULL;
+  FOREACH(pQueryFunc, pQueryFuncs) {
+    if (TSDB_CODE_SUCCESS != code) {
+      break;
+    }
+
+    SNode* pFunc = NULL;
+    if (fmIsWindowPseudoColumnFunc(((SFunctionNode*)pQueryFunc)->funcId)) {
+      pFunc = nodesCloneNode(pQueryFunc);
+    } else {
+      int32_t smaFuncIndex = smaIndexOptFindSmaFunc(pQueryFunc, pSmaFuncs);
+      if (smaFuncIndex < 0) {
+        break;
+      }
+      code = smaIndexOptCreateRollupFunc((SFunctionNode*)pQueryFunc, nodesListGetNode(pSmaFuncs, smaFuncIndex),
+                                         smaFuncIndex + 1, tableId, pCols, &pFunc);
+    }
+    if (TSDB_CODE_SUCCESS == code) {
+      if (NULL == pFunc) {
+        break;
+      }
+      code = nodesListMakeStrictAppend(pFuncs, pFunc);
+    }
+  }
+
+  if (TSDB_CODE_SUCCESS != code || LIST_LENGTH(*pFuncs) != LIST_LENGTH(pQueryFuncs)) {
+    nodesDestroyList(*pCols);
+    *pCols = NULL;
+    nodesDestroyList(*pFuncs);
+    *pFuncs = NULL;
+  }
+  return code;
+}
+
+static int32_t smaIndexOptCouldRollupIndex(SScanLogicNode* pScan, STableIndexInfo* pIndex, SNodeList** pCols,
+                                           SNodeList** pFuncs) {
+  SWindowLogicNode* pWindow = (SWindowLogicNode*)pScan->node.pParent;
+  if (!smaIndexOptCanRollup(pScan, pWindow, pIndex)) {
+    return TSDB_CODE_SUCCESS;
+  }
+  SNodeList* pSmaFuncs = NULL;
+  int32_t    code = nodesStringToList(pIndex->expr, &pSmaFuncs);
+  if (TSDB_CODE_SUCCESS == code) {
+    code = smaIndexOptCreateRollupFuncs(pWindow->pFuncs, pIndex->dstTbUid, pSmaFuncs, pCols, pFuncs);
+  }
+  nodesDestroyList(pSmaFuncs);
+  return code;
+}
+
+// keep the window and let it aggregate the index rows instead of the original rows
+static int32_t smaIndexOptRollupIndex(SLogicSubplan* pLogicSubplan, SScanLogicNode* pScan, STableIndexInfo* pIndex,
+                                      SNodeList* pSmaCols, SNodeList* pFuncs) {
+  SWindowLogicNode* pWindow = (SWindowLogicNode*)pScan->node.pParent;
+  SNode*            pTspk = nodesCloneNode(nodesListGetNode(pSmaCols, 0));
+  SLogicNode*       pSmaScan = NULL;
+  if (NULL == pTspk) {
+    nodesDestroyList(pSmaCols);
+    nodesDestroyList(pFuncs);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  int32_t code = smaIndexOptCreateSmaScan(pScan, pIndex, pSmaCols, &pSmaScan);
+  if (TSDB_CODE_SUCCESS == code) {
+    code = replaceLogicNode(pLogicSubplan, (SLogicNode*)pScan, pSmaScan);
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    nodesDestroyNode(pWindow->pTspk);
+    pWindow->pTspk = pTspk;
+    nodesDestroyList(pWindow->pFuncs);
+    pWindow->pFuncs = pFuncs;
+    nodesDestroyNode((SNode*)pScan);
+  } else {
+    nodesDestroyNode(pTspk);
+    nodesDestroyNode((SNode*)pSmaScan);
+    nodesDestroyList(pFuncs);
+  }
+  return code;
+}
+
 static int32_t smaIndexOptimizeImpl(SOptimizeContext* pCxt, SLogicSubplan* pLogicSubplan, SScanLogicNode* pScan) {
   int32_t code = TSDB_CODE_SUCCESS;
   int32_t nindexes = taosArrayGetSize(pScan->pSmaIndexes);
@@ -1641,8 +1860,40 @@ static int32_t smaIndexOptimizeImpl(SOptimizeContext* pCxt, SLogicSubplan* pLogi
     if (TSDB_CODE_SUCCESS == code && NULL != pSmaCols) {
       code = smaIndexOptApplyIndex(pLogicSubplan, pScan, pIndex, pSmaCols);
       pCxt->optimized = true;
-      break;
+      return code;
     }
+    if (TSDB_CODE_SUCCESS != code) {
+      return code;
+    }
+  }
+
+  // no index with the same interval, roll up the coarsest one that fits, it has the fewest rows to read
+  STableIndexInfo* pRollupIndex = NULL;
+  SNodeList*       pRollupCols = NULL;
+  SNodeList*       pRollupFuncs = NULL;
+  for (int32_t i = 0; TSDB_CODE_SUCCESS == code && i < nindexes; ++i) {
+    STableIndexInfo* pIndex = taosArrayGet(pScan->pSmaIndexes, i);
+    if (NULL != pRollupIndex && pIndex->interval <= pRollupIndex->interval) {
+      continue;
+    }
+    SNodeList* pSmaCols = NULL;
+    SNodeList* pFuncs = NULL;
+    code = smaIndexOptCouldRollupIndex(pScan, pIndex, &pSmaCols, &pFuncs);
+    if (TSDB_CODE_SUCCESS == code && NULL != pSmaCols) {
+      nodesDestroyList(pRollupCols);
+      nodesDestroyList(pRollupFuncs);
+      pRollupIndex = pIndex;
+      pRollupCols = pSmaCols;
+      pRollupFuncs = pFuncs;
+    }
+  }
+
+  if (TSDB_CODE_SUCCESS == code && NULL != pRollupIndex) {
+    code = smaIndexOptRollupIndex(pLogicSubplan, pScan, pRollupIndex, pRollupCols, pRollupFuncs);
+    pCxt->optimized = true;
+  } else {
+    nodesDestroyList(pRollupCols);
+    nodesDestroyList(pRollupFuncs);
   }
   return code;
 }
@@ -3158,6 +3409,47 @@ static int32_t sortNonPriKeyOptimize(SOptimizeContext* pCxt, SLogicSubplan* pLog
   return TSDB_CODE_SUCCESS;
 }
 
+// An inner join of two single tables on the primary key only is run as a hash join when one input is estimated to be
+// much smaller than the other. The build side then publishes a runtime filter to the table scan of the probe side, see
+// hashjoinoperator.c, so the blocks and rows of the large table without any match are skipped. The parent must not
+// depend on the output order, since which input is probed is only decided by the executor.
+#define HASH_JOIN_OPT_MIN_ROWS_RATIO 8
+
+static bool hashJoinOptShouldBeUsed(SJoinLogicNode* pJoin) {
+  if (JOIN_TYPE_INNER != pJoin->joinType || !pJoin->isSingleTableJoin || pJoin->hasSubQuery || pJoin->isLowLevelJoin ||
+      NULL == pJoin->pPrimKeyEqCond || NULL != pJoin->pColEqCond || NULL != pJoin->pTagEqCond ||
+      2 != LIST_LENGTH(pJoin->node.pChildren)) {
+    return false;
+  }
+
+  if (NULL != pJoin->node.pParent && DATA_ORDER_LEVEL_NONE != pJoin->node.pParent->requireDataOrder) {
+    return false;
+  }
+
+  int64_t rows[2] = {0};
+  for (int32_t i = 0; i < 2; ++i) {
+    SLogicNode* pChild = (SLogicNode*)nodesListGetNode(pJoin->node.pChildren, i);
+    if (QUERY_NODE_LOGIC_PLAN_SCAN != nodeType(pChild) || SCAN_TYPE_TABLE != ((SScanLogicNode*)pChild)->scanType) {
+      return false;
+    }
+    rows[i] = planEstimateRows(pChild);
+  }
+
+  int64_t minRows = TMIN(rows[0], rows[1]);
+  int64_t maxRows = TMAX(rows[0], rows[1]);
+  return minRows > 0 && minRows * HASH_JOIN_OPT_MIN_ROWS_RATIO <= maxRows;
+}
+
+static void hashJoinOptSetAlgo(SJoinLogicNode* pJoin) {
+  pJoin->joinAlgo = JOIN_ALGO_HASH;
+  pJoin->node.resultDataOrder = DATA_ORDER_LEVEL_NONE;
+  for (int32_t i = 0; i < 2; ++i) {
+    SLogicNode* pChild = (SLogicNode*)nodesListGetNode(pJoin->node.pChildren, i);
+    pJoin->inputStat[i].inputRowNum = planEstimateRows(pChild);
+    pJoin->inputStat[i].inputRowSize = planEstimateRowSize(pChild);
+  }
+}
+
 static bool stbJoinOptShouldBeOptimized(SLogicNode* pNode) {
   if (QUERY_NODE_LOGIC_PLAN_JOIN != nodeType(pNode)) {
     return false;
@@ -3167,7 +3459,11 @@ static bool stbJoinOptShouldBeOptimized(SLogicNode* pNode) {
   if (pJoin->isSingleTableJoin || NULL == pJoin->pTagEqCond || NULL != pJoin->pTagOnCond || pNode->pChildren->length != 2 
       || pJoin->hasSubQuery || pJoin->joinAlgo != JOIN_ALGO_UNKNOWN || pJoin->isLowLevelJoin) {
     if (pJoin->joinAlgo == JOIN_ALGO_UNKNOWN) {
-      pJoin->joinAlgo = JOIN_ALGO_MERGE;
+      if (hashJoinOptShouldBeUsed(pJoin)) {
+        hashJoinOptSetAlgo(pJoin);
+      } else {
+        pJoin->joinAlgo = JOIN_ALGO_MERGE;
+      }
     }
     return false;
   }
@@ -3301,6 +3597,12 @@ static int32_t stbJoinOptCreateTagHashJoinNode(SLogicNode* pOrig, SNodeList* pCh
   }
 
   if (TSDB_CODE_SUCCESS == code) {
+    // estimated here because the tag scans are replaced by exchanges when the plan is split
+    for (int32_t i = 0; i < 2; ++i) {
+      SLogicNode* pChild = (SLogicNode*)nodesListGetNode(pChildren, i);
+      pJoin->inputStat[i].inputRowNum = planEstimateRows(pChild);
+      pJoin->inputStat[i].inputRowSize = planEstimateRowSize(pChild);
+    }
     *ppLogic = (SLogicNode*)pJoin;
   } else {
     nodesDestroyNode((SNode*)pJoin);
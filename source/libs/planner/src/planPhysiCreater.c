@@ -955,6 +955,11 @@ static int32_t createHashJoinPhysiNode(SPhysiPlanContext* pCxt, SNodeList* pChil
   pJoin->joinType = pJoinLogicNode->joinType;
   pJoin->node.inputTsOrder = pJoinLogicNode->node.inputTsOrder;
 
+  // the executor builds the hash table on the input with fewer estimated rows
+  memcpy(pJoin->inputStat, pJoinLogicNode->inputStat, sizeof(pJoin->inputStat));
+  planDebug("hash join input estimated rows, left:%" PRId64 ", right:%" PRId64, pJoin->inputStat[0].inputRowNum,
+            pJoin->inputStat[1].inputRowNum);
+
   code = setNodeSlotId(pCxt, pLeftDesc->dataBlockId, pRightDesc->dataBlockId, pJoinLogicNode->pPrimKeyEqCond, &pJoin->pPrimKeyCond);
   if (TSDB_CODE_SUCCESS == code) {
     code = setNodeSlotId(pCxt, pLeftDesc->dataBlockId, pRightDesc->dataBlockId, pJoinLogicNode->pColEqCond, &pJoin->pColEqCond);
@@ -20,6 +20,42 @@ using namespace std;
 
 class PlanJoinTest : public PlannerTestBase {};
 
+static SHashJoinPhysiNode* findHashJoin(SPhysiNode* pNode) {
+  if (QUERY_NODE_PHYSICAL_PLAN_HASH_JOIN == nodeType(pNode)) {
+    return (SHashJoinPhysiNode*)pNode;
+  }
+  SNode* pChild = nullptr;
+  FOREACH(pChild, pNode->pChildren) {
+    SHashJoinPhysiNode* pJoin = findHashJoin((SPhysiNode*)pChild);
+    if (nullptr != pJoin) {
+      return pJoin;
+    }
+  }
+  return nullptr;
+}
+
+static SHashJoinPhysiNode* findHashJoin(const SQueryPlan* pPlan) {
+  SNode* pLevel = nullptr;
+  FOREACH(pLevel, pPlan->pSubplans) {
+    SNode* pSubplan = nullptr;
+    FOREACH(pSubplan, ((SNodeListNode*)pLevel)->pNodeList) {
+      SHashJoinPhysiNode* pJoin = findHashJoin(((SSubplan*)pSubplan)->pNode);
+      if (nullptr != pJoin) {
+        return pJoin;
+      }
+    }
+  }
+  return nullptr;
+}
+
+// the hash join operator builds its hash table on the input with fewer estimated rows
+static void checkHashJoinBuildSide(const SQueryPlan* pPlan, int32_t buildIdx) {
+  SHashJoinPhysiNode* pJoin = findHashJoin(pPlan);
+  ASSERT_NE(pJoin, nullptr);
+  ASSERT_GT(pJoin->inputStat[buildIdx].inputRowNum, 0);
+  ASSERT_LT(pJoin->inputStat[buildIdx].inputRowNum, pJoin->inputStat[1 - buildIdx].inputRowNum);
+}
+
 TEST_F(PlanJoinTest, basic) {
   useDb("root", "test");
 
@@ -58,3 +94,34 @@ TEST_F(PlanJoinTest, multiJoin) {
 
   run("SELECT t1.c1, t2.c1 FROM st1s1 t1 JOIN st1s2 t2 ON t1.ts = t2.ts JOIN st1s3 t3 ON t1.ts = t3.ts");
 }
+
+TEST_F(PlanJoinTest, stableJoinWithTagCond) {
+  useDb("root", "test");
+
+  // the tag filter makes the filtered side the build side of the tag hash join
+  run("SELECT t1.c1, t2.c1 FROM st1 t1 JOIN st1 t2 ON t1.ts = t2.ts AND t1.tag1 = t2.tag1 WHERE t2.tag2 = 'beijing'",
+      [](const SQueryPlan* pPlan) { checkHashJoinBuildSide(pPlan, 1); });
+
+  run("SELECT t1.c1, t2.c1 FROM st1 t1 JOIN st1 t2 ON t1.ts = t2.ts AND t1.tag1 = t2.tag1 WHERE t1.tag2 = 'beijing'",
+      [](const SQueryPlan* pPlan) { checkHashJoinBuildSide(pPlan, 0); });
+}
+
+TEST_F(PlanJoinTest, singleTableHashJoin) {
+  useDb("root", "test");
+
+  // the filtered table is much smaller, so it is hashed and the other table gets its runtime filter
+  run("SELECT t1.c1, t2.c1 FROM st1s1 t1 JOIN st1s2 t2 ON t1.ts = t2.ts WHERE t1.c1 = 10 AND t1.c2 = 'abc'",
+      [](const SQueryPlan* pPlan) { checkHashJoinBuildSide(pPlan, 0); });
+
+  run("SELECT t1.c1, t2.c1 FROM st1s1 t1 JOIN st1s2 t2 ON t1.ts = t2.ts WHERE t2.c1 = 10 AND t2.c2 = 'abc'",
+      [](const SQueryPlan* pPlan) { checkHashJoinBuildSide(pPlan, 1); });
+
+  // inputs of the same estimated size keep the merge join
+  run("SELECT t1.c1, t2.c1 FROM st1s1 t1 JOIN st1s2 t2 ON t1.ts = t2.ts",
+      [](const SQueryPlan* pPlan) { ASSERT_EQ(findHashJoin(pPlan), nullptr); });
+
+  // the interval needs the rows in time order, which the hash join does not promise
+  run("SELECT _WSTART, COUNT(*) FROM st1s1 t1 JOIN st1s2 t2 ON t1.ts = t2.ts WHERE t1.c1 = 10 AND t1.c2 = 'abc' "
+      "INTERVAL(10s)",
+      [](const SQueryPlan* pPlan) { ASSERT_EQ(findHashJoin(pPlan), nullptr); });
+}
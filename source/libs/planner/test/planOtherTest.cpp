@@ -21,6 +21,43 @@ using namespace std;
 
 class PlanOtherTest : public PlannerTestBase {};
 
+static SPhysiNode* findPhysiNode(SPhysiNode* pNode, ENodeType type) {
+  if (type == nodeType(pNode)) {
+    return pNode;
+  }
+  SNode* pChild = nullptr;
+  FOREACH(pChild, pNode->pChildren) {
+    SPhysiNode* pFound = findPhysiNode((SPhysiNode*)pChild, type);
+    if (nullptr != pFound) {
+      return pFound;
+    }
+  }
+  return nullptr;
+}
+
+static SPhysiNode* findPhysiNode(const SQueryPlan* pPlan, ENodeType type) {
+  SNode* pLevel = nullptr;
+  FOREACH(pLevel, pPlan->pSubplans) {
+    SNode* pSubplan = nullptr;
+    FOREACH(pSubplan, ((SNodeListNode*)pLevel)->pNodeList) {
+      SPhysiNode* pFound = findPhysiNode(((SSubplan*)pSubplan)->pNode, type);
+      if (nullptr != pFound) {
+        return pFound;
+      }
+    }
+  }
+  return nullptr;
+}
+
+// the index is read as a super table, the raw data of t1 as a normal table
+static void checkSmaIndexScan(const SQueryPlan* pPlan, bool useIndex, bool hasInterval) {
+  STableScanPhysiNode* pScan =
+      (STableScanPhysiNode*)findPhysiNode(pPlan, QUERY_NODE_PHYSICAL_PLAN_TABLE_SCAN);
+  ASSERT_NE(pScan, nullptr);
+  ASSERT_EQ(pScan->scan.tableType, useIndex ? TSDB_SUPER_TABLE : TSDB_NORMAL_TABLE);
+  ASSERT_EQ(findPhysiNode(pPlan, QUERY_NODE_PHYSICAL_PLAN_HASH_INTERVAL) != nullptr, hasInterval);
+}
+
 TEST_F(PlanOtherTest, createTopic) {
   useDb("root", "test");
 
@@ -51,17 +88,43 @@ TEST_F(PlanOtherTest, createStreamUseSTable) {
 TEST_F(PlanOtherTest, createSmaIndex) {
   useDb("root", "test");
 
+  tsQuerySmaOptimize = 1;
   run("CREATE SMA INDEX idx1 ON t1 FUNCTION(MAX(c1), MIN(c3 + 10), SUM(c4)) INTERVAL(10s) DELETE_MARK 1000s");
 
-  run("SELECT SUM(c4) FROM t1 INTERVAL(10s)");
+  run("SELECT SUM(c4) FROM t1 INTERVAL(10s)",
+      [](const SQueryPlan* pPlan) { checkSmaIndexScan(pPlan, true, false); });
+
+  run("SELECT _WSTART, MIN(c3 + 10) FROM t1 "
+      "WHERE ts BETWEEN TIMESTAMP '2022-04-01 00:00:00' AND TIMESTAMP '2022-04-30 23:59:59.999' INTERVAL(10s)",
+      [](const SQueryPlan* pPlan) { checkSmaIndexScan(pPlan, true, false); });
+
+  run("SELECT SUM(c4), MAX(c3) FROM t1 INTERVAL(10s)",
+      [](const SQueryPlan* pPlan) { checkSmaIndexScan(pPlan, false, true); });
+
+  // the range has no end, the newest windows are not in the index yet
+  run("SELECT _WSTART, SUM(c4), MAX(c1) FROM t1 INTERVAL(1m)",
+      [](const SQueryPlan* pPlan) { checkSmaIndexScan(pPlan, false, true); });
+
+  run("SELECT _WSTART, MIN(c3 + 10) FROM t1 "
+      "WHERE ts BETWEEN TIMESTAMP '2022-04-01 00:00:00' AND TIMESTAMP '2022-04-30 23:59:59.999' INTERVAL(1h)",
+      [](const SQueryPlan* pPlan) { checkSmaIndexScan(pPlan, true, true); });
+
+  // the range ends after the index watermark
+  run("SELECT _WSTART, MIN(c3 + 10) FROM t1 "
+      "WHERE ts BETWEEN TIMESTAMP '2100-04-01 00:00:00' AND TIMESTAMP '2100-04-30 23:59:59.999' INTERVAL(1h)",
+      [](const SQueryPlan* pPlan) { checkSmaIndexScan(pPlan, false, true); });
 
+  // the range is not aligned to the index windows
   run("SELECT _WSTART, MIN(c3 + 10) FROM t1 "
-      "WHERE ts BETWEEN TIMESTAMP '2022-04-01 00:00:00' AND TIMESTAMP '2022-04-30 23:59:59.999' INTERVAL(10s)");
+      "WHERE ts BETWEEN TIMESTAMP '2022-04-01 00:00:05' AND TIMESTAMP '2022-04-30 23:59:59.999' INTERVAL(1h)",
+      [](const SQueryPlan* pPlan) { checkSmaIndexScan(pPlan, false, true); });
 
-  run("SELECT SUM(c4), MAX(c3) FROM t1 INTERVAL(10s)");
+  run("SELECT SUM(c4) FROM t1 INTERVAL(15s)",
+      [](const SQueryPlan* pPlan) { checkSmaIndexScan(pPlan, false, true); });
 
   tsQuerySmaOptimize = 0;
-  run("SELECT SUM(c4) FROM t1 INTERVAL(10s)");
+  run("SELECT SUM(c4) FROM t1 INTERVAL(10s)",
+      [](const SQueryPlan* pPlan) { checkSmaIndexScan(pPlan, false, true); });
 }
 
 TEST_F(PlanOtherTest, explain) {
@@ -103,7 +103,7 @@ class PlannerTestBaseImpl {
     caseEnv_.numOfLimitSql_ = g_limitSql;
   }
 
-  void run(const string& sql) {
+  void run(const string& sql, const PlannerTestBase::PhysiPlanChecker& checker = nullptr) {
     ++sqlNo_;
     if (caseEnv_.numOfSkipSql_ > 0) {
       --(caseEnv_.numOfSkipSql_);
@@ -118,17 +118,17 @@ class PlannerTestBaseImpl {
       case QUERY_POLICY_VNODE:
       case QUERY_POLICY_HYBRID:
       case QUERY_POLICY_QNODE:
-        runImpl(sql, g_queryPolicy);
+        runImpl(sql, g_queryPolicy, checker);
         break;
       default:
-        runImpl(sql, QUERY_POLICY_VNODE);
-        runImpl(sql, QUERY_POLICY_HYBRID);
-        runImpl(sql, QUERY_POLICY_QNODE);
+        runImpl(sql, QUERY_POLICY_VNODE, checker);
+        runImpl(sql, QUERY_POLICY_HYBRID, checker);
+        runImpl(sql, QUERY_POLICY_QNODE, checker);
         break;
     }
   }
 
-  void runImpl(const string& sql, int32_t queryPolicy) {
+  void runImpl(const string& sql, int32_t queryPolicy, const PlannerTestBase::PhysiPlanChecker& checker) {
     int64_t allocatorId = 0;
     if (g_useNodeAllocator) {
       nodesCreateAllocator(sqlNo_, 32 * 1024, &allocatorId);
@@ -164,6 +164,10 @@ class PlannerTestBaseImpl {
       unique_ptr<SQueryPlan, void (*)(SQueryPlan*)> plan(pPlan, (void (*)(SQueryPlan*))nodesDestroyNode);
 
       dump(g_dumpModule);
+
+      if (checker) {
+        checker(pPlan);
+      }
     } catch (...) {
       dump(DUMP_MODULE_ALL);
       nodesReleaseAllocator(allocatorId);
@@ -528,6 +532,10 @@ void PlannerTestBase::useDb(const std::string& user, const std::string& db) { im
 
 void PlannerTestBase::run(const std::string& sql) { return impl_->run(sql); }
 
+void PlannerTestBase::run(const std::string& sql, const PhysiPlanChecker& checker) {
+  return impl_->run(sql, checker);
+}
+
 void PlannerTestBase::prepare(const std::string& sql) { return impl_->prepare(sql); }
 
 void PlannerTestBase::bindParams(TAOS_MULTI_BIND* pParams, int32_t colIdx) {
@@ -18,6 +18,8 @@
 
 #include <gtest/gtest.h>
 
+#include <functional>
+
 #define ALLOW_FORBID_FUNC
 
 #include "planInt.h"
@@ -27,11 +29,14 @@ struct TAOS_MULTI_BIND;
 
 class PlannerTestBase : public testing::Test {
  public:
+  typedef std::function<void(const SQueryPlan*)> PhysiPlanChecker;
+
   PlannerTestBase();
   virtual ~PlannerTestBase();
 
   void useDb(const std::string& user, const std::string& db);
   void run(const std::string& sql);
+  void run(const std::string& sql, const PhysiPlanChecker& checker);
   // stmt mode APIs
   void prepare(const std::string& sql);
   void bindParams(TAOS_MULTI_BIND* pParams, int32_t colIdx);
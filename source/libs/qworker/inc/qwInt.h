@@ -24,6 +24,7 @@ extern "C" {
 #include "osDef.h"
 #include "plannodes.h"
 #include "qworker.h"
+#include "tmetrics.h"
 #include "tlockfree.h"
 #include "tref.h"
 #include "trpc.h"
@@ -136,6 +137,7 @@ typedef struct SQWTaskCtx {
   bool    explainRsped;
   int32_t rspCode;
   int64_t affectedRows;  // for insert ...select stmt
+  int64_t arenaPeak;     // peak arena memory of the task, reported to the scheduler by hb
 
   SRpcHandleInfo ctrlConnInfo;
   SRpcHandleInfo dataConnInfo;
@@ -200,6 +202,8 @@ typedef struct SQWorker {
   SMsgCb    msgCb;
   SQWStat   stat;
   int32_t  *destroyed;
+  SMetric  *pExecUs;          // one round of task execution
+  SMetric  *pQueueWaitUs[2];  // time in the query and fetch queue
 
   int8_t    nodeStopped;
 } SQWorker;
@@ -394,6 +398,8 @@ int32_t qwDropTask(QW_FPARAMS_DEF);
 void    qwSaveTbVersionInfo(qTaskInfo_t pTaskInfo, SQWTaskCtx *ctx);
 int32_t qwOpenRef(void);
 void    qwSetHbParam(int64_t refId, SQWHbParam **pParam);
+void    qwInitMetrics(SQWorker *mgmt);
+void    qwCleanupMetrics(SQWorker *mgmt);
 int32_t qwUpdateTimeInQueue(SQWorker *mgmt, int64_t ts, EQueueType type);
 int64_t qwGetTimeInQueue(SQWorker *mgmt, EQueueType type);
 void    qwClearExpiredSch(SQWorker *mgmt, SArray *pExpiredSch);
@@ -580,6 +580,7 @@ void qwDestroyImpl(void *pMgmt) {
   }
   taosHashCleanup(mgmt->schHash);
 
+  qwCleanupMetrics(mgmt);
   *mgmt->destroyed = 1;
 
   taosMemoryFree(mgmt);
@@ -607,6 +608,32 @@ int32_t qwOpenRef(void) {
   return TSDB_CODE_SUCCESS;
 }
 
+void qwInitMetrics(SQWorker *mgmt) {
+  char labels[32];
+  if (mgmt->nodeType == NODE_TYPE_VNODE) {
+    snprintf(labels, sizeof(labels), "vgId=\"%d\"", mgmt->nodeId);
+  } else if (mgmt->nodeType == NODE_TYPE_QNODE) {
+    snprintf(labels, sizeof(labels), "qnodeId=\"%d\"", mgmt->nodeId);
+  } else {
+    return;
+  }
+
+  mgmt->pExecUs = taosMetricsAcquire(METRIC_HISTOGRAM, "taosd_query_exec_us", "one round of task execution", labels);
+  mgmt->pQueueWaitUs[0] =
+      taosMetricsAcquire(METRIC_HISTOGRAM, "taosd_query_queue_wait_us", "time in the query queue", labels);
+  mgmt->pQueueWaitUs[1] =
+      taosMetricsAcquire(METRIC_HISTOGRAM, "taosd_fetch_queue_wait_us", "time in the fetch queue", labels);
+}
+
+void qwCleanupMetrics(SQWorker *mgmt) {
+  taosMetricsRelease(mgmt->pExecUs);
+  taosMetricsRelease(mgmt->pQueueWaitUs[0]);
+  taosMetricsRelease(mgmt->pQueueWaitUs[1]);
+  mgmt->pExecUs = NULL;
+  mgmt->pQueueWaitUs[0] = NULL;
+  mgmt->pQueueWaitUs[1] = NULL;
+}
+
 int32_t qwUpdateTimeInQueue(SQWorker *mgmt, int64_t ts, EQueueType type) {
   if (ts <= 0) {
     return TSDB_CODE_SUCCESS;
@@ -617,10 +644,12 @@ int32_t qwUpdateTimeInQueue(SQWorker *mgmt, int64_t ts, EQueueType type) {
     case QUERY_QUEUE:
       ++mgmt->stat.msgStat.waitTime[0].num;
       mgmt->stat.msgStat.waitTime[0].total += duration;
+      taosMetricsObserve(mgmt->pQueueWaitUs[0], duration);
       break;
     case FETCH_QUEUE:
       ++mgmt->stat.msgStat.waitTime[1].num;
       mgmt->stat.msgStat.waitTime[1].total += duration;
+      taosMetricsObserve(mgmt->pQueueWaitUs[1], duration);
       break;
     default:
       qError("unsupported queue type %d", type);
@@ -150,7 +150,9 @@ int32_t qwExecTask(QW_FPARAMS_DEF, SQWTaskCtx *ctx, bool *queryStop) {
     if (taskHandle) {
       qwDbgSimulateSleep();
 
+      int64_t startUs = taosGetTimestampUs();
       code = qExecTaskOpt(taskHandle, pResList, &useconds, &hasMore, &localFetch);
+      METRICS_OBSERVE_SINCE(mgmt->pExecUs, startUs);
       if (code) {
         if (code != TSDB_CODE_OPS_NOT_SUPPORT) {
           QW_TASK_ELOG("qExecTask failed, code:%x - %s", code, tstrerror(code));
@@ -159,6 +161,8 @@ int32_t qwExecTask(QW_FPARAMS_DEF, SQWTaskCtx *ctx, bool *queryStop) {
         }
         QW_ERR_JRET(code);
       }
+
+      atomic_store_64(&ctx->arenaPeak, qGetTaskArenaPeak(taskHandle));
     }
 
     ++execNum;
@@ -268,11 +272,16 @@ int32_t qwGenerateSchHbRsp(SQWorker *mgmt, SQWSchStatus *sch, SQWHbInfo *hbInfo)
     SQWTaskStatus *taskStatus = (SQWTaskStatus *)pIter;
     key = taosHashGetKey(pIter, &keyLen);
 
-    // TODO GET EXECUTOR API TO GET MORE INFO
-
     QW_GET_QTID(key, status.queryId, status.taskId, status.execId);
     status.status = taskStatus->status;
     status.refId = taskStatus->refId;
+    status.arenaPeak = 0;
+
+    SQWTaskCtx *ctx = taosHashAcquire(mgmt->ctxHash, key, keyLen);
+    if (ctx) {
+      status.arenaPeak = atomic_load_64(&ctx->arenaPeak);
+      qwReleaseTaskCtx(mgmt, ctx);
+    }
 
     taosArrayPush(hbInfo->rsp.taskStatus, &status);
 
@@ -1290,6 +1299,7 @@ int32_t qWorkerInit(int8_t nodeType, int32_t nodeId, void **qWorkerMgmt, const S
 
   mgmt->nodeType = nodeType;
   mgmt->nodeId = nodeId;
+  qwInitMetrics(mgmt);
   if (pMsgCb) {
     mgmt->msgCb = *pMsgCb;
   } else {
@@ -1325,6 +1335,7 @@ _return:
     taosHashCleanup(mgmt->schHash);
     taosHashCleanup(mgmt->ctxHash);
     taosTmrCleanUp(mgmt->timer);
+    qwCleanupMetrics(mgmt);
     taosMemoryFreeClear(mgmt);
 
     atomic_sub_fetch_32(&gQwMgmt.qwNum, 1);
@@ -3891,6 +3891,36 @@ bool filterRangeExecute(SFilterInfo *info, SColumnDataAgg **pDataStatis, int32_t
   return ret;
 }
 
+/*
+ * Check the filter against the statistics of every segRows rows of a block, pSegAgg holds numOfCols statistics for each
+ * segment. The rows from the first to the last segment that may match are returned in [*pStart, *pEnd), the range is
+ * empty when no segment matches and covers the block when there are no segments.
+ */
+void filterRangeExecuteSegs(SFilterInfo *info, SColumnDataAgg **pSegAgg, int32_t numOfCols, int32_t numOfRows,
+                            int32_t segRows, int32_t numOfSegs, int32_t *pStart, int32_t *pEnd) {
+  int32_t first = -1;
+  int32_t last = -1;
+
+  *pStart = 0;
+  *pEnd = numOfRows;
+  if (numOfSegs <= 0 || segRows <= 0) {
+    return;
+  }
+
+  for (int32_t i = 0; i < numOfSegs; ++i) {
+    int32_t segStart = i * segRows;
+    if (filterRangeExecute(info, pSegAgg + i * numOfCols, numOfCols, TMIN(segRows, numOfRows - segStart))) {
+      if (first < 0) {
+        first = i;
+      }
+      last = i;
+    }
+  }
+
+  *pStart = (first < 0) ? 0 : first * segRows;
+  *pEnd = (first < 0) ? 0 : TMIN((last + 1) * segRows, numOfRows);
+}
+
 int32_t filterGetTimeRangeImpl(SFilterInfo *info, STimeWindow *win, bool *isStrict) {
   SFilterRange     ra = {0};
   SFilterRangeCtx *prev = filterInitRangeCtx(TSDB_DATA_TYPE_TIMESTAMP, FLT_OPTION_TIMESTAMP);
@@ -1646,6 +1646,13 @@ void vectorBitOr(SScalarParam *pLeft, SScalarParam *pRight, SScalarParam *pOut,
   doReleaseVec(pRightCol, rightConvert);
 }
 
+// the rows of a var column sharing the value with the previous row, e.g. tags and tbname, compare the same with a
+// constant, so they take the result of the previous row
+static FORCE_INLINE bool sclIsSameVarAsPrev(SColumnInfoData *pCol, int32_t index, int32_t prevIndex) {
+  return prevIndex >= 0 && IS_VAR_DATA_TYPE(pCol->info.type) &&
+         pCol->varmeta.offset[index] == pCol->varmeta.offset[prevIndex];
+}
+
 int32_t doVectorCompareImpl(SScalarParam *pLeft, SScalarParam *pRight, SScalarParam *pOut, int32_t startIndex,
                             int32_t numOfRows, int32_t step, __compar_fn_t fp, int32_t optr) {
   int32_t num = 0;
@@ -1687,6 +1694,8 @@ int32_t doVectorCompareImpl(SScalarParam *pLeft, SScalarParam *pRight, SScalarPa
     }
   } else {
     //  if (GET_PARAM_TYPE(pLeft) == TSDB_DATA_TYPE_JSON || GET_PARAM_TYPE(pRight) == TSDB_DATA_TYPE_JSON) {
+    int32_t prevIndex = -1;
+    bool    prevRes = false;
     for (int32_t i = startIndex; i < numOfRows && i >= startIndex; i += step) {
       int32_t leftIndex = (i >= pLeft->numOfRows) ? 0 : i;
       int32_t rightIndex = (i >= pRight->numOfRows) ? 0 : i;
@@ -1697,6 +1706,12 @@ int32_t doVectorCompareImpl(SScalarParam *pLeft, SScalarParam *pRight, SScalarPa
         continue;
       }
 
+      if (pRight->numOfRows == 1 && sclIsSameVarAsPrev(pLeft->columnData, leftIndex, prevIndex)) {
+        colDataSetInt8(pOut->columnData, i, (int8_t *)&prevRes);
+        num += prevRes;
+        continue;
+      }
+
       char   *pLeftData = colDataGetData(pLeft->columnData, leftIndex);
       char   *pRightData = colDataGetData(pRight->columnData, rightIndex);
       int64_t leftOut = 0;
@@ -1718,12 +1733,14 @@ int32_t doVectorCompareImpl(SScalarParam *pLeft, SScalarParam *pRight, SScalarPa
       if (!result) {
         colDataSetInt8(pOut->columnData, i, (int8_t *)&result);
       } else {
-        bool res = filterDoCompare(fp, optr, pLeftData, pRightData);
-        colDataSetInt8(pOut->columnData, i, (int8_t *)&res);
-        if (res) {
+        result = filterDoCompare(fp, optr, pLeftData, pRightData);
+        colDataSetInt8(pOut->columnData, i, (int8_t *)&result);
+        if (result) {
           ++num;
         }
       }
+      prevIndex = leftIndex;
+      prevRes = result;
 
       if (freeLeft) {
         taosMemoryFreeClear(pLeftData);
@@ -1763,15 +1780,20 @@ void doVectorCompare(SScalarParam *pLeft, SScalarParam *pRight, SScalarParam *pO
   }
 
   if (pRight->pHashFilter != NULL) {
+    int32_t prevIndex = -1;
+    bool    res = false;
     for (; i >= 0 && i < pLeft->numOfRows; i += step) {
       if (IS_HELPER_NULL(pLeft->columnData, i)) {
-        bool res = false;
-        colDataSetInt8(pOut->columnData, i, (int8_t *)&res);
+        bool nullRes = false;
+        colDataSetInt8(pOut->columnData, i, (int8_t *)&nullRes);
         continue;
       }
 
-      char *pLeftData = colDataGetData(pLeft->columnData, i);
-      bool  res = filterDoCompare(fp, optr, pLeftData, pRight->pHashFilter);
+      if (!sclIsSameVarAsPrev(pLeft->columnData, i, prevIndex)) {
+        char *pLeftData = colDataGetData(pLeft->columnData, i);
+        res = filterDoCompare(fp, optr, pLeftData, pRight->pHashFilter);
+        prevIndex = i;
+      }
       colDataSetInt8(pOut->columnData, i, (int8_t *)&res);
       if (res) {
         pOut->numOfQualified++;
@@ -345,6 +345,63 @@ TEST(timerangeTest, greater_and_lower_not_strict) {
   nodesDestroyNode(logicNode1);
 }
 
+TEST(columnTest, bigint_column_greater_segment_range) {
+  SNode  *pLeft = NULL, *pRight = NULL, *opNode = NULL;
+  int64_t rightv = 100;
+  flttMakeColumnNode(&pLeft, NULL, TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), 0, NULL);
+  flttMakeValueNode(&pRight, TSDB_DATA_TYPE_BIGINT, &rightv);
+  flttMakeOpNode(&opNode, OP_TYPE_GREATER_THAN, TSDB_DATA_TYPE_BOOL, pLeft, pRight);
+
+  SFilterInfo *filter = NULL;
+  int32_t      code = filterInitFromNode(opNode, &filter, 0);
+  ASSERT_EQ(code, 0);
+
+  // 4 segments of 8 rows and a last one of 6 rows, one statistics per segment
+  const int32_t   segRows = 8, numOfSegs = 5, rowNum = 38;
+  int16_t         colId = ((SColumnNode *)pLeft)->colId;
+  SColumnDataAgg  segs[numOfSegs] = {0};
+  SColumnDataAgg *pSegAgg[numOfSegs] = {0};
+  for (int32_t i = 0; i < numOfSegs; ++i) {
+    segs[i].colId = colId;
+    segs[i].min = 0;
+    segs[i].max = 50;
+    pSegAgg[i] = &segs[i];
+  }
+
+  // no segment matches
+  int32_t start = -1, end = -1;
+  filterRangeExecuteSegs(filter, pSegAgg, 1, rowNum, segRows, numOfSegs, &start, &end);
+  ASSERT_EQ(start, end);
+
+  // the leading and trailing segments that can not match are trimmed
+  segs[1].max = 150;
+  segs[3].min = 120;
+  segs[3].max = 200;
+  filterRangeExecuteSegs(filter, pSegAgg, 1, rowNum, segRows, numOfSegs, &start, &end);
+  ASSERT_EQ(start, 8);
+  ASSERT_EQ(end, 32);
+
+  // the last segment is shorter
+  segs[4].max = 101;
+  filterRangeExecuteSegs(filter, pSegAgg, 1, rowNum, segRows, numOfSegs, &start, &end);
+  ASSERT_EQ(start, 8);
+  ASSERT_EQ(end, rowNum);
+
+  // a null segment does not match
+  segs[1].numOfNull = segRows;
+  filterRangeExecuteSegs(filter, pSegAgg, 1, rowNum, segRows, numOfSegs, &start, &end);
+  ASSERT_EQ(start, 24);
+  ASSERT_EQ(end, rowNum);
+
+  // without zone maps the whole block is kept
+  filterRangeExecuteSegs(filter, NULL, 1, rowNum, 0, 0, &start, &end);
+  ASSERT_EQ(start, 0);
+  ASSERT_EQ(end, rowNum);
+
+  filterFreeInfo(filter);
+  nodesDestroyNode(opNode);
+}
+
 #if 0
 TEST(columnTest, smallint_column_greater_double_value) {
   SNode       *pLeft = NULL, *pRight = NULL, *opNode = NULL;
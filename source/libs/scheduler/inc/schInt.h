@@ -248,6 +248,7 @@ typedef struct SSchTask {
   SArray         *parents;         // the data destination tasks, get data from current task, element is SQueryTask*
   void           *handle;          // task send handle
   bool            registerdHb;     // registered in hb
+  int64_t         arenaPeak;       // peak arena memory of the task reported by hb
 } SSchTask;
 
 typedef struct SSchJobAttr {
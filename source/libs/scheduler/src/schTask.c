@@ -928,6 +928,8 @@ int32_t schProcessOnTaskStatusRsp(SQueryNodeEpId *pEpId, SArray *pStatusList) {
       continue;
     }
 
+    pTask->arenaPeak = TMAX(pTask->arenaPeak, pStatus->arenaPeak);
+
     if (pStatus->status == JOB_TASK_STATUS_FAIL) {
       // RECORD AND HANDLE ERROR!!!!
       schProcessOnCbEnd(pJob, pTask, 0);
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _STREAM_CHKP_STORE_H_
+#define _STREAM_CHKP_STORE_H_
+
+#include "tstream.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Content addressed store of the checkpoint files. Every file is kept once in objects/ under the md5 and size of
+ * its content, and each checkpoint is a manifest in manifest/ listing the objects it is made of. An object is
+ * removed as soon as no manifest refers to it any more.
+ */
+typedef struct SStreamChkpStore {
+  char*         path;
+  char*         prefix;     // object name prefix in the remote store
+  SHashObj*     pObjRefs;   // object key -> number of manifest entries referring to it
+  SHashObj*     pLastFiles; // file name -> SChkpStoreFile, of the latest commit of the current backend
+  int64_t       lastChkpId;
+  TdThreadMutex mutex;
+
+  // statistics of the latest commit
+  int32_t numOfNewObjs;
+  int64_t newBytes;
+  int64_t totalBytes;
+} SStreamChkpStore;
+
+SStreamChkpStore* streamChkpStoreOpen(const char* path, const char* prefix);
+void              streamChkpStoreClose(SStreamChkpStore* pStore);
+void              streamChkpStoreResetBackend(SStreamChkpStore* pStore);
+int32_t           streamChkpStoreCommit(SStreamChkpStore* pStore, const char* chkpDir, int64_t chkpId);
+int32_t           streamChkpStoreRemove(SStreamChkpStore* pStore, int64_t chkpId);
+int32_t           streamChkpStoreRecover(SStreamChkpStore* pStore, int64_t chkpId, const char* dst);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*_STREAM_CHKP_STORE_H_*/
@@ -32,7 +32,7 @@ extern "C" {
 #define MAX_RETRY_LAUNCH_HISTORY_TASK  40
 #define RETRY_LAUNCH_INTERVAL_INC_RATE 1.2
 
-#define MAX_BLOCK_NAME_NUM             1024
+#define MAX_BLOCK_NAME_NUM             8192  // capacity of the lru name cache of shuffle dispatch
 #define DISPATCH_RETRY_INTERVAL_MS     300
 #define MAX_CONTINUE_RETRY_COUNT       5
 
@@ -92,6 +92,7 @@ extern int32_t streamBackendCfWrapperId;
 void        streamRetryDispatchData(SStreamTask* pTask, int64_t waitDuration);
 int32_t     streamDispatchStreamBlock(SStreamTask* pTask);
 void        destroyDispatchMsg(SStreamDispatchReq* pReq, int32_t numOfVgroups);
+int32_t     doBuildDispatchMsg(SStreamTask* pTask, const SStreamDataBlock* pData);
 int32_t     getNumOfDispatchBranch(SStreamTask* pTask);
 
 int32_t           streamProcessCheckpointBlock(SStreamTask* pTask, SStreamDataBlock* pBlock);
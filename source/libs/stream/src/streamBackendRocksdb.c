@@ -15,6 +15,7 @@
 
 #include "streamBackendRocksdb.h"
 #include "executor.h"
+#include "streamChkpStore.h"
 #include "query.h"
 #include "streamInt.h"
 #include "tcommon.h"
@@ -392,7 +393,6 @@ bool isValidCheckpoint(const char* dir) { return true; }
 
 int32_t copyFiles(const char* src, const char* dst) {
   int32_t code = 0;
-  // opt later, just hard link
   int32_t sLen = strlen(src);
   int32_t dLen = strlen(dst);
   char*   srcName = taosMemoryCalloc(1, sLen + 64);
@@ -413,7 +413,13 @@ int32_t copyFiles(const char* src, const char* dst) {
     sprintf(srcName, "%s%s%s", src, TD_DIRSEP, name);
     sprintf(dstName, "%s%s%s", dst, TD_DIRSEP, name);
     if (!taosDirEntryIsDir(de)) {
-      code = taosCopyFile(srcName, dstName);
+      // sst files are never modified in place, share them with the checkpoint instead of copying
+      int32_t nLen = strlen(name);
+      if (nLen > 4 && strcmp(name + nLen - 4, ".sst") == 0 && taosLinkFile(srcName, dstName) == 0) {
+        code = 0;
+      } else {
+        code = taosCopyFile(srcName, dstName);
+      }
       if (code == -1) {
         goto _err;
       }
@@ -723,6 +729,7 @@ int32_t delObsoleteCheckpoint(void* arg, const char* path) {
     if (taosIsDir(tbuf)) {
       taosRemoveDir(tbuf);
     }
+    streamChkpStoreRemove(pMeta->pChkpStore, id);
   }
   taosArrayDestroy(chkpDel);
   return 0;
@@ -1002,6 +1009,12 @@ int32_t streamBackendDoCheckpoint(void* arg, uint64_t checkpointId) {
     taosReleaseRef(streamBackendCfWrapperId, id);
   }
   if (code == 0) {
+    // only the files not in the previous checkpoints are put into the store
+    if (streamChkpStoreCommit(pMeta->pChkpStore, pChkpIdDir, (int64_t)checkpointId) != 0) {
+      stWarn("stream backend:%p failed to put checkpoint:%" PRId64 " into store, only kept at:%s", pHandle,
+             (int64_t)checkpointId, pChkpIdDir);
+    }
+
     taosWLockLatch(&pMeta->chkpDirLock);
     taosArrayPush(pMeta->chkpSaved, &checkpointId);
     taosWUnLockLatch(&pMeta->chkpDirLock);
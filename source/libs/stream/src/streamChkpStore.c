@@ -0,0 +1,665 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "streamChkpStore.h"
+#include "streamInt.h"
+#include "tmd5.h"
+
+#define CHKP_STORE_KEY_LEN     64
+#define CHKP_STORE_NAME_LEN    128
+#define CHKP_STORE_READ_BLOCK  (64 * 1024)
+#define CHKP_STORE_OBJS_DIR    "objects"
+#define CHKP_STORE_MANIFEST_DIR "manifest"
+
+typedef struct SChkpStoreFile {
+  char    name[CHKP_STORE_NAME_LEN];
+  char    key[CHKP_STORE_KEY_LEN];
+  int64_t size;
+} SChkpStoreFile;
+
+static SStreamChkpStoreOps gChkpRemote = {0};
+
+void streamChkpStoreSetRemote(const SStreamChkpStoreOps* pOps) {
+  if (pOps == NULL) {
+    memset(&gChkpRemote, 0, sizeof(gChkpRemote));
+  } else {
+    gChkpRemote = *pOps;
+  }
+}
+
+static bool chkpStoreHasRemote() { return gChkpRemote.putFp != NULL && gChkpRemote.getFp != NULL; }
+
+// sst files are never modified once written, a file of the same name and size as the last time is the same content
+static bool chkpStoreIsImmutable(const char* name) {
+  int32_t len = strlen(name);
+  return len > 4 && strcmp(name + len - 4, ".sst") == 0;
+}
+
+static void chkpStoreObjPath(SStreamChkpStore* pStore, const char* key, char* buf) {
+  sprintf(buf, "%s%s%s%s%s", pStore->path, TD_DIRSEP, CHKP_STORE_OBJS_DIR, TD_DIRSEP, key);
+}
+
+static void chkpStoreManifestPath(SStreamChkpStore* pStore, int64_t chkpId, char* buf) {
+  sprintf(buf, "%s%s%s%scheckpoint%" PRId64, pStore->path, TD_DIRSEP, CHKP_STORE_MANIFEST_DIR, TD_DIRSEP, chkpId);
+}
+
+static void chkpStoreRemoteObjName(SStreamChkpStore* pStore, const char* key, char* buf) {
+  sprintf(buf, "%s/%s", pStore->prefix, key);
+}
+
+static void chkpStoreRemoteManifestName(SStreamChkpStore* pStore, int64_t chkpId, char* buf) {
+  sprintf(buf, "%s/checkpoint%" PRId64 ".manifest", pStore->prefix, chkpId);
+}
+
+// hard link the file if possible, the files of a checkpoint are not modified afterwards
+static int32_t chkpStoreLinkFile(const char* src, const char* dst) {
+  if (taosLinkFile(src, dst) == 0) {
+    return 0;
+  }
+  return taosCopyFile(src, dst) < 0 ? -1 : 0;
+}
+
+static int32_t chkpStoreGenKey(const char* file, int64_t size, char* key) {
+  TdFilePtr pFile = taosOpenFile(file, TD_FILE_READ);
+  if (pFile == NULL) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    return -1;
+  }
+
+  uint8_t* buf = taosMemoryMalloc(CHKP_STORE_READ_BLOCK);
+  if (buf == NULL) {
+    taosCloseFile(&pFile);
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  T_MD5_CTX ctx;
+  tMD5Init(&ctx);
+
+  int64_t nread = 0;
+  while ((nread = taosReadFile(pFile, buf, CHKP_STORE_READ_BLOCK)) > 0) {
+    tMD5Update(&ctx, buf, (uint32_t)nread);
+  }
+  tMD5Final(&ctx);
+  taosMemoryFree(buf);
+  taosCloseFile(&pFile);
+
+  if (nread < 0) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    return -1;
+  }
+
+  int32_t len = 0;
+  for (int32_t i = 0; i < tListLen(ctx.digest); ++i) {
+    len += sprintf(key + len, "%02x", ctx.digest[i]);
+  }
+  sprintf(key + len, "-%" PRId64, size);
+  return 0;
+}
+
+static int32_t chkpStoreLoadManifest(const char* path, SArray* pFiles) {
+  int64_t size = 0;
+  if (taosStatFile(path, &size, NULL, NULL) < 0) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    return -1;
+  }
+
+  TdFilePtr pFile = taosOpenFile(path, TD_FILE_READ);
+  if (pFile == NULL) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    return -1;
+  }
+
+  char* buf = taosMemoryCalloc(1, size + 1);
+  if (buf == NULL) {
+    taosCloseFile(&pFile);
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  int64_t nread = taosReadFile(pFile, buf, size);
+  taosCloseFile(&pFile);
+  if (nread != size) {
+    taosMemoryFree(buf);
+    terrno = TSDB_CODE_FILE_CORRUPTED;
+    return -1;
+  }
+
+  char* saveptr = NULL;
+  for (char* line = strtok_r(buf, "\n", &saveptr); line != NULL; line = strtok_r(NULL, "\n", &saveptr)) {
+    SChkpStoreFile f = {0};
+    if (sscanf(line, "%127s %" PRId64 " %63s", f.name, &f.size, f.key) != 3) {
+      taosMemoryFree(buf);
+      terrno = TSDB_CODE_FILE_CORRUPTED;
+      return -1;
+    }
+    taosArrayPush(pFiles, &f);
+  }
+
+  taosMemoryFree(buf);
+  return 0;
+}
+
+static int32_t chkpStoreSaveManifest(const char* path, SArray* pFiles) {
+  int32_t size = taosArrayGetSize(pFiles);
+  char*   buf = taosMemoryMalloc((int64_t)size * (CHKP_STORE_NAME_LEN + CHKP_STORE_KEY_LEN + 32) + 1);
+  if (buf == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  int64_t len = 0;
+  for (int32_t i = 0; i < size; ++i) {
+    SChkpStoreFile* pFile = taosArrayGet(pFiles, i);
+    len += sprintf(buf + len, "%s %" PRId64 " %s\n", pFile->name, pFile->size, pFile->key);
+  }
+
+  // the manifest is the commit point of a checkpoint, write it aside and rename
+  char tpath[PATH_MAX] = {0};
+  snprintf(tpath, sizeof(tpath), "%s.tmp", path);
+
+  int32_t   code = -1;
+  TdFilePtr pFile = taosOpenFile(tpath, TD_FILE_CREATE | TD_FILE_WRITE | TD_FILE_TRUNC);
+  if (pFile == NULL) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+  } else if (taosWriteFile(pFile, buf, len) != len || taosFsyncFile(pFile) < 0) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    taosCloseFile(&pFile);
+  } else {
+    taosCloseFile(&pFile);
+    code = taosRenameFile(tpath, path);
+    if (code != 0) {
+      terrno = TAOS_SYSTEM_ERROR(errno);
+    }
+  }
+
+  if (code != 0) {
+    taosRemoveFile(tpath);
+  }
+  taosMemoryFree(buf);
+  return code;
+}
+
+static void chkpStoreAddRefs(SStreamChkpStore* pStore, SArray* pFiles) {
+  for (int32_t i = 0; i < taosArrayGetSize(pFiles); ++i) {
+    SChkpStoreFile* pFile = taosArrayGet(pFiles, i);
+    int32_t*        pRef = taosHashGet(pStore->pObjRefs, pFile->key, strlen(pFile->key));
+    int32_t         ref = (pRef == NULL) ? 1 : (*pRef + 1);
+    taosHashPut(pStore->pObjRefs, pFile->key, strlen(pFile->key), &ref, sizeof(ref));
+  }
+}
+
+static void chkpStoreSetLastFiles(SStreamChkpStore* pStore, SArray* pFiles, int64_t chkpId) {
+  taosHashClear(pStore->pLastFiles);
+  for (int32_t i = 0; i < taosArrayGetSize(pFiles); ++i) {
+    SChkpStoreFile* pFile = taosArrayGet(pFiles, i);
+    taosHashPut(pStore->pLastFiles, pFile->name, strlen(pFile->name), pFile, sizeof(SChkpStoreFile));
+  }
+  pStore->lastChkpId = chkpId;
+}
+
+// drop the objects that are not referred by any manifest, left by a commit that did not finish
+static void chkpStoreRemoveOrphans(SStreamChkpStore* pStore) {
+  char path[PATH_MAX] = {0};
+  snprintf(path, sizeof(path), "%s%s%s", pStore->path, TD_DIRSEP, CHKP_STORE_OBJS_DIR);
+
+  TdDirPtr pDir = taosOpenDir(path);
+  if (pDir == NULL) {
+    return;
+  }
+
+  TdDirEntryPtr de = NULL;
+  while ((de = taosReadDir(pDir)) != NULL) {
+    char* name = taosGetDirEntryName(de);
+    if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0 || taosDirEntryIsDir(de)) continue;
+
+    if (taosHashGet(pStore->pObjRefs, name, strlen(name)) == NULL) {
+      char obj[PATH_MAX] = {0};
+      chkpStoreObjPath(pStore, name, obj);
+      taosRemoveFile(obj);
+      stDebug("chkp store:%s remove orphan object %s", pStore->path, name);
+    }
+  }
+  taosCloseDir(&pDir);
+}
+
+static int32_t chkpStoreLoad(SStreamChkpStore* pStore) {
+  char path[PATH_MAX] = {0};
+  snprintf(path, sizeof(path), "%s%s%s", pStore->path, TD_DIRSEP, CHKP_STORE_MANIFEST_DIR);
+
+  TdDirPtr pDir = taosOpenDir(path);
+  if (pDir == NULL) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    return -1;
+  }
+
+  int32_t       code = 0;
+  int64_t       lastId = -1;
+  SArray*       pFiles = taosArrayInit(64, sizeof(SChkpStoreFile));
+  TdDirEntryPtr de = NULL;
+  while ((de = taosReadDir(pDir)) != NULL) {
+    char*   name = taosGetDirEntryName(de);
+    int64_t chkpId = 0;
+    char    manifest[PATH_MAX] = {0};
+    snprintf(manifest, sizeof(manifest), "%s%s%s", path, TD_DIRSEP, name);
+
+    int32_t len = strlen(name);
+    if (len > 4 && strcmp(name + len - 4, ".tmp") == 0) {
+      taosRemoveFile(manifest);
+      continue;
+    }
+    if (sscanf(name, "checkpoint%" PRId64, &chkpId) != 1) continue;
+
+    taosArrayClear(pFiles);
+    if (chkpStoreLoadManifest(manifest, pFiles) != 0) {
+      stError("chkp store:%s failed to load manifest %s since %s", pStore->path, name, terrstr());
+      code = -1;
+      break;
+    }
+
+    // the files of the loaded manifests were written by a previous backend, their keys are not reused
+    chkpStoreAddRefs(pStore, pFiles);
+    if (chkpId > lastId) {
+      pStore->lastChkpId = chkpId;
+      lastId = chkpId;
+    }
+  }
+
+  taosArrayDestroy(pFiles);
+  taosCloseDir(&pDir);
+  return code;
+}
+
+SStreamChkpStore* streamChkpStoreOpen(const char* path, const char* prefix) {
+  SStreamChkpStore* pStore = taosMemoryCalloc(1, sizeof(SStreamChkpStore));
+  if (pStore == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  pStore->path = taosStrdup(path);
+  pStore->prefix = taosStrdup(prefix);
+  pStore->lastChkpId = -1;
+  pStore->pObjRefs = taosHashInit(256, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), true, HASH_NO_LOCK);
+  pStore->pLastFiles = taosHashInit(256, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), true, HASH_NO_LOCK);
+  taosThreadMutexInit(&pStore->mutex, NULL);
+
+  char dir[PATH_MAX] = {0};
+  snprintf(dir, sizeof(dir), "%s%s%s", path, TD_DIRSEP, CHKP_STORE_OBJS_DIR);
+  if (taosMulMkDir(dir) != 0) {
+    goto _err;
+  }
+  snprintf(dir, sizeof(dir), "%s%s%s", path, TD_DIRSEP, CHKP_STORE_MANIFEST_DIR);
+  if (taosMulMkDir(dir) != 0) {
+    goto _err;
+  }
+
+  if (chkpStoreLoad(pStore) != 0) {
+    goto _err;
+  }
+  chkpStoreRemoveOrphans(pStore);
+
+  stInfo("chkp store:%s opened, objects:%d, latest checkpoint:%" PRId64 ", remote:%s", path,
+         taosHashGetSize(pStore->pObjRefs), pStore->lastChkpId, chkpStoreHasRemote() ? prefix : "none");
+  return pStore;
+
+_err:
+  stError("failed to open chkp store:%s since %s", path, terrstr());
+  streamChkpStoreClose(pStore);
+  return NULL;
+}
+
+void streamChkpStoreResetBackend(SStreamChkpStore* pStore) {
+  if (pStore == NULL) return;
+
+  taosThreadMutexLock(&pStore->mutex);
+  taosHashClear(pStore->pLastFiles);
+  taosThreadMutexUnlock(&pStore->mutex);
+}
+
+void streamChkpStoreClose(SStreamChkpStore* pStore) {
+  if (pStore == NULL) return;
+
+  taosHashCleanup(pStore->pObjRefs);
+  taosHashCleanup(pStore->pLastFiles);
+  taosThreadMutexDestroy(&pStore->mutex);
+  taosMemoryFree(pStore->path);
+  taosMemoryFree(pStore->prefix);
+  taosMemoryFree(pStore);
+}
+
+static int32_t chkpStoreListFiles(SStreamChkpStore* pStore, const char* chkpDir, SArray* pFiles) {
+  TdDirPtr pDir = taosOpenDir(chkpDir);
+  if (pDir == NULL) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    return -1;
+  }
+
+  int32_t       code = 0;
+  TdDirEntryPtr de = NULL;
+  while ((de = taosReadDir(pDir)) != NULL) {
+    char* name = taosGetDirEntryName(de);
+    if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0 || taosDirEntryIsDir(de)) continue;
+
+    SChkpStoreFile f = {0};
+    char           file[PATH_MAX] = {0};
+    tstrncpy(f.name, name, sizeof(f.name));
+    snprintf(file, sizeof(file), "%s%s%s", chkpDir, TD_DIRSEP, name);
+    if (taosStatFile(file, &f.size, NULL, NULL) < 0) {
+      terrno = TAOS_SYSTEM_ERROR(errno);
+      code = -1;
+      break;
+    }
+
+    // rocksdb never reuses a file number within a db, so an immutable file committed before by the same backend is
+    // known without reading it again
+    SChkpStoreFile* pLast = taosHashGet(pStore->pLastFiles, name, strlen(name));
+    if (pLast != NULL && pLast->size == f.size && chkpStoreIsImmutable(name)) {
+      tstrncpy(f.key, pLast->key, sizeof(f.key));
+    } else if (chkpStoreGenKey(file, f.size, f.key) != 0) {
+      code = -1;
+      break;
+    }
+
+    taosArrayPush(pFiles, &f);
+  }
+
+  taosCloseDir(&pDir);
+  return code;
+}
+
+static int32_t chkpStorePutObj(SStreamChkpStore* pStore, const char* file, const char* key) {
+  char obj[PATH_MAX] = {0};
+  chkpStoreObjPath(pStore, key, obj);
+
+  taosRemoveFile(obj);
+  if (chkpStoreLinkFile(file, obj) != 0) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    return -1;
+  }
+
+  if (chkpStoreHasRemote()) {
+    char name[PATH_MAX] = {0};
+    chkpStoreRemoteObjName(pStore, key, name);
+    if (gChkpRemote.putFp(obj, name) != 0) {
+      taosRemoveFile(obj);
+      terrno = TSDB_CODE_APP_ERROR;
+      return -1;
+    }
+  }
+  return 0;
+}
+
+static void chkpStoreDelObjs(SStreamChkpStore* pStore, SArray* pKeys, const char* pManifest) {
+  int32_t size = taosArrayGetSize(pKeys);
+  for (int32_t i = 0; i < size; ++i) {
+    char obj[PATH_MAX] = {0};
+    chkpStoreObjPath(pStore, taosArrayGetP(pKeys, i), obj);
+    taosRemoveFile(obj);
+  }
+
+  if (!chkpStoreHasRemote() || gChkpRemote.delFp == NULL || (size == 0 && pManifest == NULL)) {
+    return;
+  }
+
+  const char** names = taosMemoryCalloc(size + 1, POINTER_BYTES);
+  if (names == NULL) return;
+
+  int32_t num = 0;
+  for (int32_t i = 0; i < size; ++i) {
+    char* name = taosMemoryCalloc(1, PATH_MAX);
+    if (name == NULL) break;
+    chkpStoreRemoteObjName(pStore, taosArrayGetP(pKeys, i), name);
+    names[num++] = name;
+  }
+  if (pManifest != NULL) {
+    names[num++] = pManifest;
+  }
+
+  gChkpRemote.delFp(names, num);
+
+  for (int32_t i = 0; i < num; ++i) {
+    if (names[i] != pManifest) taosMemoryFree((void*)names[i]);
+  }
+  taosMemoryFree(names);
+}
+
+static int32_t chkpStoreRemoveImpl(SStreamChkpStore* pStore, int64_t chkpId) {
+  char manifest[PATH_MAX] = {0};
+  chkpStoreManifestPath(pStore, chkpId, manifest);
+  if (!taosCheckExistFile(manifest)) {
+    return 0;
+  }
+
+  SArray* pFiles = taosArrayInit(64, sizeof(SChkpStoreFile));
+  if (chkpStoreLoadManifest(manifest, pFiles) != 0) {
+    stError("chkp store:%s failed to load manifest of checkpoint:%" PRId64 " since %s", pStore->path, chkpId,
+            terrstr());
+    taosArrayDestroy(pFiles);
+    return -1;
+  }
+
+  // the manifest goes first, the objects left by a failure in between are removed as orphans at next open
+  taosRemoveFile(manifest);
+
+  SArray* pDelKeys = taosArrayInit(16, POINTER_BYTES);
+
+  for (int32_t i = 0; i < taosArrayGetSize(pFiles); ++i) {
+    SChkpStoreFile* pFile = taosArrayGet(pFiles, i);
+    int32_t*        pRef = taosHashGet(pStore->pObjRefs, pFile->key, strlen(pFile->key));
+    if (pRef == NULL) continue;
+
+    if (--(*pRef) == 0) {
+      char* key = pFile->key;
+      taosArrayPush(pDelKeys, &key);
+    }
+  }
+
+  char name[PATH_MAX] = {0};
+  chkpStoreRemoteManifestName(pStore, chkpId, name);
+  chkpStoreDelObjs(pStore, pDelKeys, name);
+
+  for (int32_t i = 0; i < taosArrayGetSize(pDelKeys); ++i) {
+    char* key = taosArrayGetP(pDelKeys, i);
+    taosHashRemove(pStore->pObjRefs, key, strlen(key));
+  }
+
+  stDebug("chkp store:%s remove checkpoint:%" PRId64 ", objects removed:%d, left:%d", pStore->path, chkpId,
+          (int32_t)taosArrayGetSize(pDelKeys), taosHashGetSize(pStore->pObjRefs));
+
+  taosArrayDestroy(pDelKeys);
+  taosArrayDestroy(pFiles);
+  return 0;
+}
+
+int32_t streamChkpStoreCommit(SStreamChkpStore* pStore, const char* chkpDir, int64_t chkpId) {
+  if (pStore == NULL) return 0;
+
+  int32_t code = -1;
+  int64_t st = taosGetTimestampMs();
+  SArray* pFiles = taosArrayInit(64, sizeof(SChkpStoreFile));
+  SArray* pNewKeys = taosArrayInit(16, POINTER_BYTES);
+
+  taosThreadMutexLock(&pStore->mutex);
+  pStore->numOfNewObjs = 0;
+  pStore->newBytes = 0;
+  pStore->totalBytes = 0;
+
+  // the checkpoint of the same id is redone
+  if (chkpStoreRemoveImpl(pStore, chkpId) != 0) {
+    goto _end;
+  }
+
+  if (chkpStoreListFiles(pStore, chkpDir, pFiles) != 0) {
+    goto _end;
+  }
+
+  // only the objects not referred by any of the previous checkpoints are put into the store
+  for (int32_t i = 0; i < taosArrayGetSize(pFiles); ++i) {
+    SChkpStoreFile* pFile = taosArrayGet(pFiles, i);
+    pStore->totalBytes += pFile->size;
+    if (taosHashGet(pStore->pObjRefs, pFile->key, strlen(pFile->key)) != NULL) {
+      continue;
+    }
+
+    char file[PATH_MAX] = {0};
+    snprintf(file, sizeof(file), "%s%s%s", chkpDir, TD_DIRSEP, pFile->name);
+    if (chkpStorePutObj(pStore, file, pFile->key) != 0) {
+      stError("chkp store:%s failed to put %s of checkpoint:%" PRId64 " since %s", pStore->path, pFile->name, chkpId,
+              terrstr());
+      goto _end;
+    }
+
+    int32_t ref = 0;
+    char*   key = pFile->key;
+    taosHashPut(pStore->pObjRefs, key, strlen(key), &ref, sizeof(ref));
+    taosArrayPush(pNewKeys, &key);
+    pStore->numOfNewObjs += 1;
+    pStore->newBytes += pFile->size;
+  }
+
+  char manifest[PATH_MAX] = {0};
+  chkpStoreManifestPath(pStore, chkpId, manifest);
+  if (chkpStoreSaveManifest(manifest, pFiles) != 0) {
+    stError("chkp store:%s failed to save manifest of checkpoint:%" PRId64 " since %s", pStore->path, chkpId,
+            terrstr());
+    goto _end;
+  }
+
+  if (chkpStoreHasRemote()) {
+    char name[PATH_MAX] = {0};
+    chkpStoreRemoteManifestName(pStore, chkpId, name);
+    if (gChkpRemote.putFp(manifest, name) != 0) {
+      stError("chkp store:%s failed to upload manifest of checkpoint:%" PRId64, pStore->path, chkpId);
+      taosRemoveFile(manifest);
+      terrno = TSDB_CODE_APP_ERROR;
+      goto _end;
+    }
+  }
+
+  chkpStoreAddRefs(pStore, pFiles);
+  chkpStoreSetLastFiles(pStore, pFiles, chkpId);
+  taosArrayClear(pNewKeys);
+  code = 0;
+
+  stInfo("chkp store:%s commit checkpoint:%" PRId64 ", files:%d, new objects:%d, new bytes:%" PRId64
+         ", total bytes:%" PRId64 ", elapsed time:%" PRId64 "ms",
+         pStore->path, chkpId, (int32_t)taosArrayGetSize(pFiles), pStore->numOfNewObjs, pStore->newBytes,
+         pStore->totalBytes, taosGetTimestampMs() - st);
+
+_end:
+  // roll back the objects put by the failed commit
+  for (int32_t i = 0; i < taosArrayGetSize(pNewKeys); ++i) {
+    char* key = taosArrayGetP(pNewKeys, i);
+    taosHashRemove(pStore->pObjRefs, key, strlen(key));
+  }
+  chkpStoreDelObjs(pStore, pNewKeys, NULL);
+
+  taosThreadMutexUnlock(&pStore->mutex);
+  taosArrayDestroy(pNewKeys);
+  taosArrayDestroy(pFiles);
+  return code;
+}
+
+int32_t streamChkpStoreRemove(SStreamChkpStore* pStore, int64_t chkpId) {
+  if (pStore == NULL) return 0;
+
+  taosThreadMutexLock(&pStore->mutex);
+  int32_t code = chkpStoreRemoveImpl(pStore, chkpId);
+  taosThreadMutexUnlock(&pStore->mutex);
+  return code;
+}
+
+static int32_t chkpStoreRecoverImpl(SStreamChkpStore* pStore, int64_t chkpId, const char* dst) {
+  char manifest[PATH_MAX] = {0};
+  chkpStoreManifestPath(pStore, chkpId, manifest);
+
+  bool fetched = false;
+  if (!taosCheckExistFile(manifest)) {
+    char name[PATH_MAX] = {0};
+    chkpStoreRemoteManifestName(pStore, chkpId, name);
+    if (!chkpStoreHasRemote() || !gChkpRemote.getFp(name, manifest)) {
+      terrno = TSDB_CODE_FILE_CORRUPTED;
+      return -1;
+    }
+    fetched = true;
+  }
+
+  SArray* pFiles = taosArrayInit(64, sizeof(SChkpStoreFile));
+  if (chkpStoreLoadManifest(manifest, pFiles) != 0) {
+    taosArrayDestroy(pFiles);
+    return -1;
+  }
+
+  if (taosMulMkDir(dst) != 0) {
+    taosArrayDestroy(pFiles);
+    return -1;
+  }
+
+  int32_t code = 0;
+  for (int32_t i = 0; i < taosArrayGetSize(pFiles) && code == 0; ++i) {
+    SChkpStoreFile* pFile = taosArrayGet(pFiles, i);
+    char            obj[PATH_MAX] = {0};
+    char            file[PATH_MAX] = {0};
+    chkpStoreObjPath(pStore, pFile->key, obj);
+    snprintf(file, sizeof(file), "%s%s%s", dst, TD_DIRSEP, pFile->name);
+
+    if (!taosCheckExistFile(obj)) {
+      char name[PATH_MAX] = {0};
+      chkpStoreRemoteObjName(pStore, pFile->key, name);
+      if (!chkpStoreHasRemote() || !gChkpRemote.getFp(name, obj)) {
+        terrno = TSDB_CODE_FILE_CORRUPTED;
+        code = -1;
+        break;
+      }
+    }
+
+    if (chkpStoreLinkFile(obj, file) != 0) {
+      terrno = TAOS_SYSTEM_ERROR(errno);
+      code = -1;
+    }
+  }
+
+  if (code == 0 && fetched) {
+    chkpStoreAddRefs(pStore, pFiles);
+    if (chkpId > pStore->lastChkpId) {
+      pStore->lastChkpId = chkpId;
+    }
+  } else if (code != 0) {
+    taosRemoveDir(dst);
+    if (fetched) taosRemoveFile(manifest);
+  }
+
+  taosArrayDestroy(pFiles);
+  return code;
+}
+
+int32_t streamChkpStoreRecover(SStreamChkpStore* pStore, int64_t chkpId, const char* dst) {
+  if (pStore == NULL || chkpId == 0 || taosIsDir(dst)) {
+    return 0;
+  }
+
+  taosThreadMutexLock(&pStore->mutex);
+  int32_t code = chkpStoreRecoverImpl(pStore, chkpId, dst);
+  taosThreadMutexUnlock(&pStore->mutex);
+
+  if (code != 0) {
+    stError("chkp store:%s failed to recover checkpoint:%" PRId64 " to %s since %s", pStore->path, chkpId, dst,
+            terrstr());
+  } else {
+    stInfo("chkp store:%s recover checkpoint:%" PRId64 " to %s", pStore->path, chkpId, dst);
+  }
+  return code;
+}
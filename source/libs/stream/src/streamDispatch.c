@@ -23,6 +23,12 @@ typedef struct SBlockName {
   char     parTbName[TSDB_TABLE_NAME_LEN];
 } SBlockName;
 
+typedef struct SVgHashRange {
+  uint32_t hashBegin;
+  uint32_t hashEnd;
+  int32_t  index;  // position in pVgroupInfos
+} SVgHashRange;
+
 typedef struct {
   int32_t upStreamTaskId;
   SEpSet  upstreamNodeEpset;
@@ -34,6 +40,10 @@ static int32_t doSendDispatchMsg(SStreamTask* pTask, const SStreamDispatchReq* p
 static int32_t streamAddBlockIntoDispatchMsg(const SSDataBlock* pBlock, SStreamDispatchReq* pReq);
 static int32_t streamSearchAndAddBlock(SStreamTask* pTask, SStreamDispatchReq* pReqs, SSDataBlock* pDataBlock,
                                        int32_t vgSz, int64_t groupId);
+static int32_t streamScatterDeleteBlock(SStreamTask* pTask, SStreamDispatchReq* pReqs, const SSDataBlock* pDataBlock,
+                                        int32_t vgSz);
+static int32_t streamAddBlockIntoVgroupReq(SStreamTask* pTask, SStreamDispatchReq* pReqs, const SSDataBlock* pDataBlock,
+                                           int32_t index);
 static int32_t doDispatchScanHistoryFinishMsg(SStreamTask* pTask, const SStreamScanHistoryFinishReq* pReq, int32_t vgId,
                                               SEpSet* pEpSet);
 
@@ -291,7 +301,7 @@ int32_t getNumOfDispatchBranch(SStreamTask* pTask) {
              : taosArrayGetSize(pTask->outputInfo.shuffleDispatcher.dbInfo.pVgroupInfos);
 }
 
-static int32_t doBuildDispatchMsg(SStreamTask* pTask, const SStreamDataBlock* pData) {
+int32_t doBuildDispatchMsg(SStreamTask* pTask, const SStreamDataBlock* pData) {
   int32_t code = 0;
   int32_t numOfBlocks = taosArrayGetSize(pData->blocks);
   ASSERT(numOfBlocks != 0 && pTask->msgInfo.pData == NULL);
@@ -342,20 +352,24 @@ static int32_t doBuildDispatchMsg(SStreamTask* pTask, const SStreamDataBlock* pD
     for (int32_t i = 0; i < numOfBlocks; i++) {
       SSDataBlock* pDataBlock = taosArrayGet(pData->blocks, i);
 
-      // TODO: do not use broadcast
+      // the rows of a delete block are sent to the vgroups owning their tables only
+      if (pDataBlock->info.type == STREAM_DELETE_RESULT && pDataBlock->info.rows > 0) {
+        code = streamScatterDeleteBlock(pTask, pReqs, pDataBlock, numOfVgroups);
+        if (code != 0) {
+          destroyDispatchMsg(pReqs, numOfVgroups);
+          return code;
+        }
+
+        continue;
+      }
+
       if (pDataBlock->info.type == STREAM_DELETE_RESULT || pDataBlock->info.type == STREAM_CHECKPOINT || pDataBlock->info.type == STREAM_TRANS_STATE) {
         for (int32_t j = 0; j < numOfVgroups; j++) {
-          code = streamAddBlockIntoDispatchMsg(pDataBlock, &pReqs[j]);
+          code = streamAddBlockIntoVgroupReq(pTask, pReqs, pDataBlock, j);
           if (code != 0) {
             destroyDispatchMsg(pReqs, numOfVgroups);
             return code;
           }
-
-          if (pReqs[j].blockNum == 0) {
-            atomic_add_fetch_32(&pTask->outputInfo.shuffleDispatcher.waitingRspCnt, 1);
-          }
-
-          pReqs[j].blockNum++;
         }
 
         continue;
@@ -505,71 +519,241 @@ void streamRetryDispatchData(SStreamTask* pTask, int64_t waitDuration) {
   }
 }
 
+static int32_t vgHashRangeComp(const void* p1, const void* p2) {
+  const SVgHashRange* pLeft = p1;
+  const SVgHashRange* pRight = p2;
+  if (pLeft->hashBegin == pRight->hashBegin) {
+    return 0;
+  }
+  return pLeft->hashBegin < pRight->hashBegin ? -1 : 1;
+}
+
+// the hash ranges of the downstream vgroups never change during the life of a task, so they are sorted once and
+// then binary searched for each dispatched table.
+static int32_t streamTaskBuildVgRanges(SStreamTask* pTask) {
+  SArray* vgInfo = pTask->outputInfo.shuffleDispatcher.dbInfo.pVgroupInfos;
+  int32_t numOfVgroups = taosArrayGetSize(vgInfo);
+
+  SArray* pRanges = taosArrayInit(numOfVgroups, sizeof(SVgHashRange));
+  if (pRanges == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  for (int32_t i = 0; i < numOfVgroups; ++i) {
+    SVgroupInfo* pVgInfo = taosArrayGet(vgInfo, i);
+    ASSERT(pVgInfo->vgId > 0);
+
+    SVgHashRange range = {.hashBegin = pVgInfo->hashBegin, .hashEnd = pVgInfo->hashEnd, .index = i};
+    taosArrayPush(pRanges, &range);
+  }
+
+  taosArraySort(pRanges, vgHashRangeComp);
+  pTask->pVgRanges = pRanges;
+  return 0;
+}
+
+static int32_t streamGetVgroupIndex(SStreamTask* pTask, uint32_t hashValue) {
+  if (pTask->pVgRanges == NULL && streamTaskBuildVgRanges(pTask) != 0) {
+    return -1;
+  }
+
+  // the last range starting no later than the hash value
+  SArray* pRanges = pTask->pVgRanges;
+  int32_t low = 0;
+  int32_t high = taosArrayGetSize(pRanges) - 1;
+  int32_t pos = -1;
+  while (low <= high) {
+    int32_t       mid = low + ((high - low) >> 1);
+    SVgHashRange* pRange = taosArrayGet(pRanges, mid);
+    if (pRange->hashBegin <= hashValue) {
+      pos = mid;
+      low = mid + 1;
+    } else {
+      high = mid - 1;
+    }
+  }
+
+  if (pos >= 0) {
+    SVgHashRange* pRange = taosArrayGet(pRanges, pos);
+    if (hashValue <= pRange->hashEnd) {
+      return pRange->index;
+    }
+  }
+
+  stError("s-task:%s no downstream vgroup for hash value:%u", pTask->id.idStr, hashValue);
+  terrno = TSDB_CODE_APP_ERROR;
+  return -1;
+}
+
+static uint32_t streamGetTbHashVal(SStreamTask* pTask, const char* tbName) {
+  SUseDbRsp* pDbInfo = &pTask->outputInfo.shuffleDispatcher.dbInfo;
+  char       ctbName[TSDB_TABLE_FNAME_LEN] = {0};
+  snprintf(ctbName, TSDB_TABLE_NAME_LEN, "%s.%s", pDbInfo->db, tbName);
+  return taosGetTbHashVal(ctbName, strlen(ctbName), pDbInfo->hashMethod, pDbInfo->hashPrefix, pDbInfo->hashSuffix);
+}
+
+static void freeBlockName(const void* key, size_t keyLen, void* value, void* ud) { taosMemoryFree(value); }
+
+// Get the hash value of the child table of a group, and the table name too if parTbName is empty. The names of the
+// recently dispatched groups are kept in a lru cache, the cold ones are evicted once the cache is full.
+static int32_t streamGetGroupTbName(SStreamTask* pTask, int64_t groupId, char* parTbName, uint32_t* pHashValue) {
+  if (pTask->pNameMap == NULL) {
+    pTask->pNameMap = taosLRUCacheInit(MAX_BLOCK_NAME_NUM * sizeof(SBlockName), 0, .5);
+    if (pTask->pNameMap == NULL) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      return -1;
+    }
+  }
+
+  LRUHandle* h = taosLRUCacheLookup(pTask->pNameMap, &groupId, sizeof(int64_t));
+  if (h != NULL) {
+    SBlockName* pBln = taosLRUCacheValue(pTask->pNameMap, h);
+    *pHashValue = pBln->hashValue;
+    if (!parTbName[0]) {
+      tstrncpy(parTbName, pBln->parTbName, TSDB_TABLE_NAME_LEN);
+    }
+    taosLRUCacheRelease(pTask->pNameMap, h, false);
+    return 0;
+  }
+
+  if (!parTbName[0]) {
+    buildCtbNameByGroupIdImpl(pTask->outputInfo.shuffleDispatcher.stbFullName, groupId, parTbName);
+  }
+  *pHashValue = streamGetTbHashVal(pTask, parTbName);
+
+  // failing to cache the name only costs building it again next time
+  SBlockName* pBln = taosMemoryCalloc(1, sizeof(SBlockName));
+  if (pBln != NULL) {
+    pBln->hashValue = *pHashValue;
+    tstrncpy(pBln->parTbName, parTbName, TSDB_TABLE_NAME_LEN);
+    taosLRUCacheInsert(pTask->pNameMap, &groupId, sizeof(int64_t), pBln, sizeof(SBlockName), freeBlockName, NULL,
+                       TAOS_LRU_PRIORITY_LOW, NULL);
+  }
+  return 0;
+}
+
+static int32_t streamAddBlockIntoVgroupReq(SStreamTask* pTask, SStreamDispatchReq* pReqs, const SSDataBlock* pDataBlock,
+                                           int32_t index) {
+  if (streamAddBlockIntoDispatchMsg(pDataBlock, &pReqs[index]) < 0) {
+    return -1;
+  }
+
+  if (pReqs[index].blockNum == 0) {
+    atomic_add_fetch_32(&pTask->outputInfo.shuffleDispatcher.waitingRspCnt, 1);
+  }
+
+  pReqs[index].blockNum++;
+  return 0;
+}
+
 int32_t streamSearchAndAddBlock(SStreamTask* pTask, SStreamDispatchReq* pReqs, SSDataBlock* pDataBlock, int32_t vgSz,
                                 int64_t groupId) {
   uint32_t hashValue = 0;
-  SArray*  vgInfo = pTask->outputInfo.shuffleDispatcher.dbInfo.pVgroupInfos;
-  if (pTask->pNameMap == NULL) {
-    pTask->pNameMap = tSimpleHashInit(1024, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT));
+  if (streamGetGroupTbName(pTask, groupId, pDataBlock->info.parTbName, &hashValue) != 0) {
+    return -1;
   }
 
-  void* pVal = tSimpleHashGet(pTask->pNameMap, &groupId, sizeof(int64_t));
-  if (pVal) {
-    SBlockName* pBln = (SBlockName*)pVal;
-    hashValue = pBln->hashValue;
-    if (!pDataBlock->info.parTbName[0]) {
-      memset(pDataBlock->info.parTbName, 0, TSDB_TABLE_NAME_LEN);
-      memcpy(pDataBlock->info.parTbName, pBln->parTbName, strlen(pBln->parTbName));
-    }
-  } else {
-    char* ctbName = taosMemoryCalloc(1, TSDB_TABLE_FNAME_LEN);
-    if (ctbName == NULL) {
-      return -1;
+  int32_t index = streamGetVgroupIndex(pTask, hashValue);
+  if (index < 0) {
+    return -1;
+  }
+
+  ASSERT(index < vgSz);
+  return streamAddBlockIntoVgroupReq(pTask, pReqs, pDataBlock, index);
+}
+
+// The rows of a delete block may come from many groups. Each row is routed to the vgroup owning its table, and the
+// rows of the same vgroup are gathered into one block, all in one pass over the block.
+static int32_t streamScatterDeleteBlock(SStreamTask* pTask, SStreamDispatchReq* pReqs, const SSDataBlock* pDataBlock,
+                                        int32_t vgSz) {
+  int32_t       code = -1;
+  int32_t       numOfRows = pDataBlock->info.rows;
+  int32_t       numOfCols = taosArrayGetSize(pDataBlock->pDataBlock);
+  int32_t*      pDstIndex = taosMemoryMalloc(numOfRows * sizeof(int32_t));
+  int32_t*      pNumOfRows = taosMemoryCalloc(vgSz, sizeof(int32_t));
+  SSDataBlock** pBlocks = taosMemoryCalloc(vgSz, POINTER_BYTES);
+  if (pDstIndex == NULL || pNumOfRows == NULL || pBlocks == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    goto _end;
+  }
+
+  SColumnInfoData* pGidCol = taosArrayGet(pDataBlock->pDataBlock, GROUPID_COLUMN_INDEX);
+  SColumnInfoData* pTbNameCol = NULL;
+  if (numOfCols > TABLE_NAME_COLUMN_INDEX) {
+    pTbNameCol = taosArrayGet(pDataBlock->pDataBlock, TABLE_NAME_COLUMN_INDEX);
+  }
+
+  // the table name of a row is the same one the sink task is going to delete from, see tqBuildDeleteReq. Without a
+  // table name that is the default name of the group, so the cached name, which may come from a subtable expression of
+  // the data blocks, must not be used.
+  for (int32_t row = 0; row < numOfRows; ++row) {
+    char     tbName[TSDB_TABLE_NAME_LEN] = {0};
+    uint32_t hashValue = 0;
+    void*    varTbName = NULL;
+    if (pTbNameCol != NULL && !colDataIsNull(pTbNameCol, numOfRows, row, NULL)) {
+      varTbName = colDataGetVarData(pTbNameCol, row);
     }
 
-    if (pDataBlock->info.parTbName[0]) {
-      snprintf(ctbName, TSDB_TABLE_NAME_LEN, "%s.%s", pTask->outputInfo.shuffleDispatcher.dbInfo.db, pDataBlock->info.parTbName);
+    if (varTbName != NULL && varTbName != (void*)-1) {
+      memcpy(tbName, varDataVal(varTbName), TMIN(varDataLen(varTbName), TSDB_TABLE_NAME_LEN - 1));
+      hashValue = streamGetTbHashVal(pTask, tbName);
     } else {
-      buildCtbNameByGroupIdImpl(pTask->outputInfo.shuffleDispatcher.stbFullName, groupId, pDataBlock->info.parTbName);
-      snprintf(ctbName, TSDB_TABLE_NAME_LEN, "%s.%s", pTask->outputInfo.shuffleDispatcher.dbInfo.db, pDataBlock->info.parTbName);
+      int64_t groupId = *(int64_t*)colDataGetData(pGidCol, row);
+      buildCtbNameByGroupIdImpl(pTask->outputInfo.shuffleDispatcher.stbFullName, groupId, tbName);
+      hashValue = streamGetTbHashVal(pTask, tbName);
     }
 
-    /*uint32_t hashValue = MurmurHash3_32(ctbName, strlen(ctbName));*/
-    SUseDbRsp* pDbInfo = &pTask->outputInfo.shuffleDispatcher.dbInfo;
-    hashValue =
-        taosGetTbHashVal(ctbName, strlen(ctbName), pDbInfo->hashMethod, pDbInfo->hashPrefix, pDbInfo->hashSuffix);
-    taosMemoryFree(ctbName);
-    SBlockName bln = {0};
-    bln.hashValue = hashValue;
-    memcpy(bln.parTbName, pDataBlock->info.parTbName, strlen(pDataBlock->info.parTbName));
-    if (tSimpleHashGetSize(pTask->pNameMap) < MAX_BLOCK_NAME_NUM) {
-      tSimpleHashPut(pTask->pNameMap, &groupId, sizeof(int64_t), &bln, sizeof(SBlockName));
+    pDstIndex[row] = streamGetVgroupIndex(pTask, hashValue);
+    if (pDstIndex[row] < 0) {
+      goto _end;
     }
+    pNumOfRows[pDstIndex[row]] += 1;
   }
 
-  bool found = false;
-  // TODO: optimize search
-  int32_t j;
-  for (j = 0; j < vgSz; j++) {
-    SVgroupInfo* pVgInfo = taosArrayGet(vgInfo, j);
-    ASSERT(pVgInfo->vgId > 0);
+  for (int32_t i = 0; i < vgSz; ++i) {
+    if (pNumOfRows[i] == 0) {
+      continue;
+    }
 
-    if (hashValue >= pVgInfo->hashBegin && hashValue <= pVgInfo->hashEnd) {
-      if (streamAddBlockIntoDispatchMsg(pDataBlock, &pReqs[j]) < 0) {
-        return -1;
-      }
+    pBlocks[i] = createOneDataBlock(pDataBlock, false);
+    if (pBlocks[i] == NULL || blockDataEnsureCapacity(pBlocks[i], pNumOfRows[i]) != TSDB_CODE_SUCCESS) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      goto _end;
+    }
+  }
 
-      if (pReqs[j].blockNum == 0) {
-        atomic_add_fetch_32(&pTask->outputInfo.shuffleDispatcher.waitingRspCnt, 1);
-      }
+  for (int32_t row = 0; row < numOfRows; ++row) {
+    SSDataBlock* pBlock = pBlocks[pDstIndex[row]];
+    for (int32_t i = 0; i < numOfCols; ++i) {
+      SColumnInfoData* pSrc = taosArrayGet(pDataBlock->pDataBlock, i);
+      SColumnInfoData* pDst = taosArrayGet(pBlock->pDataBlock, i);
+      bool             isNull = colDataIsNull_s(pSrc, row);
+      colDataSetVal(pDst, pBlock->info.rows, isNull ? NULL : colDataGetData(pSrc, row), isNull);
+    }
+    pBlock->info.rows += 1;
+  }
 
-      pReqs[j].blockNum++;
-      found = true;
-      break;
+  for (int32_t i = 0; i < vgSz; ++i) {
+    if (pBlocks[i] != NULL && streamAddBlockIntoVgroupReq(pTask, pReqs, pBlocks[i], i) != 0) {
+      goto _end;
     }
   }
-  ASSERT(found);
-  return 0;
+
+  stDebug("s-task:%s scatter %d rows of delete block to downstream vgroups", pTask->id.idStr, numOfRows);
+  code = 0;
+
+_end:
+  if (pBlocks != NULL) {
+    for (int32_t i = 0; i < vgSz; ++i) {
+      blockDataDestroy(pBlocks[i]);
+    }
+  }
+
+  taosMemoryFree(pBlocks);
+  taosMemoryFree(pNumOfRows);
+  taosMemoryFree(pDstIndex);
+  return code;
 }
 
 int32_t streamDispatchStreamBlock(SStreamTask* pTask) {
@@ -15,6 +15,7 @@
 
 #include "executor.h"
 #include "streamBackendRocksdb.h"
+#include "streamChkpStore.h"
 #include "streamInt.h"
 #include "tmisce.h"
 #include "tref.h"
@@ -29,6 +30,7 @@ int32_t streamBackendCfWrapperId = 0;
 int32_t streamMetaId = 0;
 
 static int64_t streamGetLatestCheckpointId(SStreamMeta* pMeta);
+static void    streamMetaRecoverCheckpoint(SStreamMeta* pMeta);
 static void    metaHbToMnode(void* param, void* tmrId);
 static void    streamMetaClear(SStreamMeta* pMeta);
 static int32_t streamMetaBegin(SStreamMeta* pMeta);
@@ -107,6 +109,28 @@ int32_t metaRefMgtAdd(int64_t vgId, int64_t* rid) {
   return 0;
 }
 
+static void* streamMetaOpenChkpStore(SStreamMeta* pMeta) {
+  char path[PATH_MAX] = {0};
+  char prefix[TSDB_FQDN_LEN + 64] = {0};
+  snprintf(path, sizeof(path), "%s%s%s%s%s", pMeta->path, TD_DIRSEP, "checkpoints", TD_DIRSEP, "store");
+  if (pMeta->vgId == SNODE_HANDLE) {
+    snprintf(prefix, sizeof(prefix), "stream/%s/snode", tsLocalFqdn);
+  } else {
+    snprintf(prefix, sizeof(prefix), "stream/%s/vnode%d", tsLocalFqdn, pMeta->vgId);
+  }
+  return streamChkpStoreOpen(path, prefix);
+}
+
+// rebuild the checkpoint dir from the checkpoint store if it is gone
+static void streamMetaRecoverCheckpoint(SStreamMeta* pMeta) {
+  if (pMeta->chkpId == 0) return;
+
+  char path[PATH_MAX] = {0};
+  snprintf(path, sizeof(path), "%s%s%s%scheckpoint%" PRId64, pMeta->path, TD_DIRSEP, "checkpoints", TD_DIRSEP,
+           pMeta->chkpId);
+  streamChkpStoreRecover(pMeta->pChkpStore, pMeta->chkpId, path);
+}
+
 SStreamMeta* streamMetaOpen(const char* path, void* ahandle, FTaskExpand expandFunc, int32_t vgId, int64_t stage) {
   int32_t      code = -1;
   SStreamMeta* pMeta = taosMemoryCalloc(1, sizeof(SStreamMeta));
@@ -189,6 +213,9 @@ SStreamMeta* streamMetaOpen(const char* path, void* ahandle, FTaskExpand expandF
   taosInitRWLatch(&pMeta->chkpDirLock);
 
   pMeta->chkpId = streamGetLatestCheckpointId(pMeta);
+  pMeta->pChkpStore = streamMetaOpenChkpStore(pMeta);
+  streamMetaRecoverCheckpoint(pMeta);
+
   pMeta->streamBackend = streamBackendInit(pMeta->path, pMeta->chkpId);
   while (pMeta->streamBackend == NULL) {
     taosMsleep(100);
@@ -256,6 +283,9 @@ int32_t streamMetaReopen(SStreamMeta* pMeta) {
     }
   }
 
+  // the new backend numbers its files on its own, the file keys of the previous one must not be reused
+  streamChkpStoreResetBackend(pMeta->pChkpStore);
+  streamMetaRecoverCheckpoint(pMeta);
   pMeta->streamBackend = streamBackendInit(pMeta->path, pMeta->chkpId);
   while (pMeta->streamBackend == NULL) {
     taosMsleep(100);
@@ -346,6 +376,7 @@ void streamMetaCloseImpl(void* arg) {
   taosMemoryFree(pMeta->pHbInfo);
   taosMemoryFree(pMeta->path);
   taosThreadMutexDestroy(&pMeta->backendMutex);
+  streamChkpStoreClose(pMeta->pChkpStore);
 
   pMeta->role = NODE_ROLE_UNINIT;
   taosMemoryFree(pMeta);
@@ -154,6 +154,8 @@ int32_t tEncodeStreamTask(SEncoder* pEncoder, const SStreamTask* pTask) {
   }
   if (tEncodeI64(pEncoder, pTask->info.triggerParam) < 0) return -1;
   if (tEncodeCStrWithLen(pEncoder, pTask->reserve, sizeof(pTask->reserve) - 1) < 0) return -1;
+  if (tEncodeI32(pEncoder, pTask->info.subtaskId) < 0) return -1;
+  if (tEncodeI32(pEncoder, pTask->info.numOfSubtasks) < 0) return -1;
 
   tEndEncode(pEncoder);
   return pEncoder->pos;
@@ -236,6 +238,10 @@ int32_t tDecodeStreamTask(SDecoder* pDecoder, SStreamTask* pTask) {
   }
   if (tDecodeI64(pDecoder, &pTask->info.triggerParam) < 0) return -1;
   if (tDecodeCStrTo(pDecoder, pTask->reserve) < 0) return -1;
+  if (!tDecodeIsEnd(pDecoder)) {
+    if (tDecodeI32(pDecoder, &pTask->info.subtaskId) < 0) return -1;
+    if (tDecodeI32(pDecoder, &pTask->info.numOfSubtasks) < 0) return -1;
+  }
 
   tEndDecode(pDecoder);
   return 0;
@@ -384,9 +390,12 @@ void tFreeStreamTask(SStreamTask* pTask) {
   }
 
   if (pTask->pNameMap) {
-    tSimpleHashCleanup(pTask->pNameMap);
+    taosLRUCacheEraseUnrefEntries(pTask->pNameMap);
+    taosLRUCacheCleanup(pTask->pNameMap);
   }
 
+  pTask->pVgRanges = taosArrayDestroy(pTask->pVgRanges);
+
   if (pTask->pRspMsgList != NULL) {
     taosArrayDestroyEx(pTask->pRspMsgList, freeItem);
     pTask->pRspMsgList = NULL;
@@ -26,6 +26,8 @@
 #define FLUSH_NUM                      4
 #define DEFAULT_MAX_STREAM_BUFFER_SIZE (128 * 1024 * 1024)
 #define MIN_NUM_OF_ROW_BUFF            10240
+#define ROW_BUFF_CHUNK_SIZE            (1024 * 1024)
+#define FLUSH_BATCH_SIZE               (4 * 1024 * 1024)
 
 struct SStreamFileState {
   SList*   usedBuffs;
@@ -42,6 +44,9 @@ struct SStreamFileState {
   TSKEY    flushMark;
   uint64_t maxRowCount;
   uint64_t curRowCount;
+  SArray*  pRowBuffChunks;  // row buffers are cut from these chunks and never freed one by one
+  char*    pChunkFree;
+  int64_t  chunkFreeSize;
   GetTsFun getTs;
   char*    id;
   char*    cfName;
@@ -131,6 +136,7 @@ SStreamFileState* streamFileStateInit(int64_t memSize, uint32_t keySize, uint32_
   pFileState->maxRowCount = TMAX((uint64_t)memSize / rowSize, FLUSH_NUM * 2);
   pFileState->usedBuffs = tdListNew(POINTER_BYTES);
   pFileState->freeBuffs = tdListNew(POINTER_BYTES);
+  pFileState->pRowBuffChunks = taosArrayInit(16, POINTER_BYTES);
   _hash_fn_t hashFn = taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY);
   int32_t    cap = TMIN(MIN_NUM_OF_ROW_BUFF, pFileState->maxRowCount);
   if (type == STREAM_STATE_BUFF_HASH) {
@@ -157,7 +163,7 @@ SStreamFileState* streamFileStateInit(int64_t memSize, uint32_t keySize, uint32_
     pFileState->cfName = taosStrdup("sess");
   }
 
-  if (!pFileState->usedBuffs || !pFileState->freeBuffs || !pFileState->rowStateBuff) {
+  if (!pFileState->usedBuffs || !pFileState->freeBuffs || !pFileState->rowStateBuff || !pFileState->pRowBuffChunks) {
     goto _error;
   }
 
@@ -185,9 +191,9 @@ _error:
   return NULL;
 }
 
+// the row buffer belongs to the chunks of the file state, it must have been put back into the free list before
 void destroyRowBuffPos(SRowBuffPos* pPos) {
   taosMemoryFreeClear(pPos->pKey);
-  taosMemoryFreeClear(pPos->pRowBuff);
   taosMemoryFree(pPos);
 }
 
@@ -209,11 +215,32 @@ void destroyRowBuffAllPosPtr(void* ptr) {
   destroyRowBuffPos(pPos);
 }
 
-void destroyRowBuff(void* ptr) {
-  if (!ptr) {
-    return;
+static void* allocRowBuff(SStreamFileState* pFileState) {
+  if (pFileState->curRowCount >= pFileState->maxRowCount) {
+    return NULL;
   }
-  taosMemoryFree(*(void**)ptr);
+
+  int32_t rowSize = pFileState->rowSize;
+  if (pFileState->chunkFreeSize < rowSize) {
+    int64_t numOfRows = TMAX(ROW_BUFF_CHUNK_SIZE / rowSize, 1);
+    numOfRows = TMIN(numOfRows, pFileState->maxRowCount - pFileState->curRowCount);
+    char* pChunk = taosMemoryCalloc(numOfRows, rowSize);
+    if (pChunk == NULL) {
+      return NULL;
+    }
+    if (taosArrayPush(pFileState->pRowBuffChunks, &pChunk) == NULL) {
+      taosMemoryFree(pChunk);
+      return NULL;
+    }
+    pFileState->pChunkFree = pChunk;
+    pFileState->chunkFreeSize = numOfRows * rowSize;
+  }
+
+  void* pBuff = pFileState->pChunkFree;
+  pFileState->pChunkFree += rowSize;
+  pFileState->chunkFreeSize -= rowSize;
+  pFileState->curRowCount++;
+  return pBuff;
 }
 
 void streamFileStateDestroy(SStreamFileState* pFileState) {
@@ -224,7 +251,8 @@ void streamFileStateDestroy(SStreamFileState* pFileState) {
   taosMemoryFree(pFileState->id);
   taosMemoryFree(pFileState->cfName);
   tdListFreeP(pFileState->usedBuffs, destroyRowBuffAllPosPtr);
-  tdListFreeP(pFileState->freeBuffs, destroyRowBuff);
+  tdListFree(pFileState->freeBuffs);
+  taosArrayDestroyP(pFileState->pRowBuffChunks, taosMemoryFree);
   pFileState->stateBuffCleanupFn(pFileState->rowStateBuff);
   taosMemoryFree(pFileState);
 }
@@ -384,13 +412,10 @@ SRowBuffPos* getNewRowPos(SStreamFileState* pFileState) {
     goto _end;
   }
 
-  if (pFileState->curRowCount < pFileState->maxRowCount) {
-    pBuff = taosMemoryCalloc(1, pFileState->rowSize);
-    if (pBuff) {
-      pPos->pRowBuff = pBuff;
-      pFileState->curRowCount++;
-      goto _end;
-    }
+  pBuff = allocRowBuff(pFileState);
+  if (pBuff) {
+    pPos->pRowBuff = pBuff;
+    goto _end;
   }
 
   int32_t code = clearRowBuff(pFileState);
@@ -473,10 +498,8 @@ int32_t getRowBuffByPos(SStreamFileState* pFileState, SRowBuffPos* pPos, void**
 
   pPos->pRowBuff = getFreeBuff(pFileState);
   if (!pPos->pRowBuff) {
-    if (pFileState->curRowCount < pFileState->maxRowCount) {
-      pPos->pRowBuff = taosMemoryCalloc(1, pFileState->rowSize);
-      pFileState->curRowCount++;
-    } else {
+    pPos->pRowBuff = allocRowBuff(pFileState);
+    if (!pPos->pRowBuff) {
       int32_t code = clearRowBuff(pFileState);
       ASSERT(code == 0);
       pPos->pRowBuff = getFreeBuff(pFileState);
@@ -521,8 +544,6 @@ int32_t flushSnapshot(SStreamFileState* pFileState, SStreamSnapshot* pSnapshot,
   SListIter iter = {0};
   tdListInitIter(pSnapshot, &iter, TD_LIST_FORWARD);
 
-  const int32_t BATCH_LIMIT = 256;
-
   int64_t    st = taosGetTimestampMs();
   int32_t    numOfElems = listNEles(pSnapshot);
   SListNode* pNode = NULL;
@@ -532,7 +553,9 @@ int32_t flushSnapshot(SStreamFileState* pFileState, SStreamSnapshot* pSnapshot,
   int32_t len = pFileState->rowSize + sizeof(uint64_t) + sizeof(int32_t) + 1;
   char*   buf = taosMemoryCalloc(1, len);
 
-  void* batch = streamStateCreateBatch();
+  int64_t batchSize = 0;
+  int32_t numOfBatch = 0;
+  void*   batch = streamStateCreateBatch();
   while ((pNode = tdListNext(&iter)) != NULL && code == TSDB_CODE_SUCCESS) {
     SRowBuffPos* pPos = *(SRowBuffPos**)pNode->data;
     if (pPos->beFlushed || !pPos->pRowBuff) {
@@ -541,9 +564,11 @@ int32_t flushSnapshot(SStreamFileState* pFileState, SStreamSnapshot* pSnapshot,
     pPos->beFlushed = true;
 
     qDebug("===stream===flushed start:%" PRId64, pFileState->getTs(pPos->pKey));
-    if (streamStateGetBatchSize(batch) >= BATCH_LIMIT) {
+    if (batchSize >= FLUSH_BATCH_SIZE) {
       streamStatePutBatch_rocksdb(pFileState->pFileStore, batch);
       streamStateClearBatch(batch);
+      batchSize = 0;
+      numOfBatch++;
     }
 
     void* pSKey = pFileState->stateBuffCreateStateKeyFn(pPos, ((SStreamState*)pFileState->pFileStore)->number);
@@ -552,19 +577,17 @@ int32_t flushSnapshot(SStreamFileState* pFileState, SStreamSnapshot* pSnapshot,
     taosMemoryFreeClear(pSKey);
     // todo handle failure
     memset(buf, 0, len);
+    batchSize += pFileState->keyLen + pFileState->rowSize;
   }
   taosMemoryFree(buf);
 
-  if (streamStateGetBatchSize(batch) > 0) {
+  // at checkpoint the flush mark goes into the same batch as the last rows
+  if (!flushState && streamStateGetBatchSize(batch) > 0) {
     streamStatePutBatch_rocksdb(pFileState->pFileStore, batch);
+    streamStateClearBatch(batch);
+    numOfBatch++;
   }
 
-  streamStateClearBatch(batch);
-
-  int64_t elapsed = taosGetTimestampMs() - st;
-  qDebug("%s flush to disk in batch model completed, rows:%d, batch size:%d, elapsed time:%" PRId64 "ms",
-         pFileState->id, numOfElems, BATCH_LIMIT, elapsed);
-
   if (flushState) {
     const char* taskKey = "streamFileState";
     {
@@ -585,8 +608,13 @@ int32_t flushSnapshot(SStreamFileState* pFileState, SStreamSnapshot* pSnapshot,
       code = streamStatePutBatch(pFileState->pFileStore, "default", batch, keyBuf, valBuf, len, 0);
     }
     streamStatePutBatch_rocksdb(pFileState->pFileStore, batch);
+    numOfBatch++;
   }
 
+  int64_t elapsed = taosGetTimestampMs() - st;
+  qDebug("%s flush to disk in batch model completed, rows:%d, batches:%d, elapsed time:%" PRId64 "ms", pFileState->id,
+         numOfElems, numOfBatch, elapsed);
+
   streamStateDestroyBatch(batch);
   return code;
 }
@@ -688,6 +716,7 @@ int32_t recoverSnapshot(SStreamFileState* pFileState, int64_t ckId) {
     SRowBuffPos* pNewPos = getNewRowPosForWrite(pFileState);
     code = streamStateGetKVByCur_rocksdb(pCur, pNewPos->pKey, (const void**)&pVal, &vlen);
     if (code != TSDB_CODE_SUCCESS || pFileState->getTs(pNewPos->pKey) < pFileState->flushMark) {
+      putFreeBuff(pFileState, pNewPos);
       destroyRowBuffPos(pNewPos);
       SListNode* pNode = tdListPopTail(pFileState->usedBuffs);
       taosMemoryFreeClear(pNode);
@@ -700,6 +729,7 @@ int32_t recoverSnapshot(SStreamFileState* pFileState, int64_t ckId) {
     pNewPos->beFlushed = true;
     code = tSimpleHashPut(pFileState->rowStateBuff, pNewPos->pKey, pFileState->keyLen, &pNewPos, POINTER_BYTES);
     if (code != TSDB_CODE_SUCCESS) {
+      putFreeBuff(pFileState, pNewPos);
       destroyRowBuffPos(pNewPos);
       break;
     }
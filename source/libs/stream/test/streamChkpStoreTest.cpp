@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "streamChkpStore.h"
+
+static const char *storePath = TD_TMP_DIR_PATH "chkpStoreTest" TD_DIRSEP "store";
+static const char *chkpPath = TD_TMP_DIR_PATH "chkpStoreTest" TD_DIRSEP "checkpoint";
+static const char *remotePath = TD_TMP_DIR_PATH "chkpStoreTest" TD_DIRSEP "remote";
+
+// a directory standing in for the S3 bucket
+static void remoteObjPath(const char *object, char *buf) {
+  int32_t len = sprintf(buf, "%s%s", remotePath, TD_DIRSEP);
+  for (const char *p = object; *p; ++p) {
+    buf[len++] = (*p == '/') ? '_' : *p;
+  }
+  buf[len] = 0;
+}
+
+static int32_t remotePut(const char *file, const char *object) {
+  char path[PATH_MAX] = {0};
+  remoteObjPath(object, path);
+  return taosCopyFile(file, path) < 0 ? -1 : 0;
+}
+
+static bool remoteGet(const char *object, const char *file) {
+  char path[PATH_MAX] = {0};
+  remoteObjPath(object, path);
+  return taosCopyFile(path, file) >= 0;
+}
+
+static void remoteDel(const char *object[], int32_t num) {
+  for (int32_t i = 0; i < num; ++i) {
+    char path[PATH_MAX] = {0};
+    remoteObjPath(object[i], path);
+    taosRemoveFile(path);
+  }
+}
+
+static int32_t countFiles(const char *dir) {
+  int32_t  num = 0;
+  TdDirPtr pDir = taosOpenDir(dir);
+  if (pDir == NULL) return -1;
+
+  TdDirEntryPtr de = NULL;
+  while ((de = taosReadDir(pDir)) != NULL) {
+    char *name = taosGetDirEntryName(de);
+    if (strcmp(name, ".") != 0 && strcmp(name, "..") != 0) ++num;
+  }
+  taosCloseDir(&pDir);
+  return num;
+}
+
+static void writeFile(int64_t chkpId, const char *name, const char *content) {
+  char path[PATH_MAX] = {0};
+  sprintf(path, "%s%" PRId64, chkpPath, chkpId);
+  taosMulMkDir(path);
+  sprintf(path + strlen(path), "%s%s", TD_DIRSEP, name);
+
+  TdFilePtr pFile = taosOpenFile(path, TD_FILE_CREATE | TD_FILE_WRITE | TD_FILE_TRUNC);
+  ASSERT_NE(pFile, nullptr);
+  taosWriteFile(pFile, content, strlen(content));
+  taosCloseFile(&pFile);
+}
+
+static std::string readFile(const char *dir, const char *name) {
+  char path[PATH_MAX] = {0};
+  sprintf(path, "%s%s%s", dir, TD_DIRSEP, name);
+
+  char      buf[256] = {0};
+  TdFilePtr pFile = taosOpenFile(path, TD_FILE_READ);
+  if (pFile == NULL) return "";
+  taosReadFile(pFile, buf, sizeof(buf) - 1);
+  taosCloseFile(&pFile);
+  return buf;
+}
+
+class ChkpStoreTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    taosRemoveDir(TD_TMP_DIR_PATH "chkpStoreTest");
+    taosMulMkDir(remotePath);
+    SStreamChkpStoreOps ops = {remotePut, remoteGet, remoteDel};
+    streamChkpStoreSetRemote(&ops);
+  }
+  void TearDown() override {
+    streamChkpStoreSetRemote(NULL);
+    taosRemoveDir(TD_TMP_DIR_PATH "chkpStoreTest");
+  }
+};
+
+TEST_F(ChkpStoreTest, dedup) {
+  char objs[PATH_MAX] = {0};
+  char dir[PATH_MAX] = {0};
+  sprintf(objs, "%s%sobjects", storePath, TD_DIRSEP);
+
+  SStreamChkpStore *pStore = streamChkpStoreOpen(storePath, "stream/test/vnode2");
+  ASSERT_NE(pStore, nullptr);
+
+  writeFile(1, "000001.sst", "aaaaaaaa");
+  writeFile(1, "000002.sst", "bbbbbbbb");
+  writeFile(1, "CURRENT", "MANIFEST-000005\n");
+  writeFile(1, "MANIFEST-000005", "manifest v1");
+  sprintf(dir, "%s1", chkpPath);
+  ASSERT_EQ(streamChkpStoreCommit(pStore, dir, 1), 0);
+  EXPECT_EQ(pStore->numOfNewObjs, 4);
+  EXPECT_EQ(countFiles(objs), 4);
+
+  // one sst is compacted away and a new one is flushed, only the changed files are put
+  writeFile(2, "000001.sst", "aaaaaaaa");
+  writeFile(2, "000003.sst", "cccccccccccc");
+  writeFile(2, "CURRENT", "MANIFEST-000005\n");
+  writeFile(2, "MANIFEST-000005", "manifest v2");
+  sprintf(dir, "%s2", chkpPath);
+  ASSERT_EQ(streamChkpStoreCommit(pStore, dir, 2), 0);
+  EXPECT_EQ(pStore->numOfNewObjs, 2);
+  EXPECT_EQ(pStore->newBytes, 12 + 11);
+  EXPECT_EQ(countFiles(objs), 6);
+
+  // the objects only referred by the removed checkpoint are gone, locally and remotely
+  int32_t remoteObjs = countFiles(remotePath);
+  ASSERT_EQ(streamChkpStoreRemove(pStore, 1), 0);
+  EXPECT_EQ(countFiles(objs), 4);
+  EXPECT_EQ(countFiles(remotePath), remoteObjs - 3);
+  streamChkpStoreClose(pStore);
+
+  // the references are rebuilt from the manifests, objects not referred are dropped
+  char junk[PATH_MAX] = {0};
+  sprintf(junk, "%s%sjunk", objs, TD_DIRSEP);
+  TdFilePtr pFile = taosOpenFile(junk, TD_FILE_CREATE | TD_FILE_WRITE);
+  taosCloseFile(&pFile);
+
+  pStore = streamChkpStoreOpen(storePath, "stream/test/vnode2");
+  ASSERT_NE(pStore, nullptr);
+  EXPECT_EQ(taosHashGetSize(pStore->pObjRefs), 4);
+  EXPECT_EQ(pStore->lastChkpId, 2);
+  EXPECT_EQ(countFiles(objs), 4);
+  streamChkpStoreClose(pStore);
+}
+
+TEST_F(ChkpStoreTest, recover) {
+  char dir[PATH_MAX] = {0};
+  char dst[PATH_MAX] = {0};
+  sprintf(dir, "%s1", chkpPath);
+  sprintf(dst, "%s%srecovered", TD_TMP_DIR_PATH "chkpStoreTest", TD_DIRSEP);
+
+  SStreamChkpStore *pStore = streamChkpStoreOpen(storePath, "stream/test/vnode3");
+  ASSERT_NE(pStore, nullptr);
+  writeFile(1, "000007.sst", "sst content");
+  writeFile(1, "CURRENT", "MANIFEST-000008\n");
+  ASSERT_EQ(streamChkpStoreCommit(pStore, dir, 1), 0);
+
+  ASSERT_EQ(streamChkpStoreRecover(pStore, 1, dst), 0);
+  EXPECT_EQ(readFile(dst, "000007.sst"), "sst content");
+  EXPECT_EQ(readFile(dst, "CURRENT"), "MANIFEST-000008\n");
+  EXPECT_EQ(streamChkpStoreRecover(pStore, 5, TD_TMP_DIR_PATH "chkpStoreTest" TD_DIRSEP "none"), -1);
+  streamChkpStoreClose(pStore);
+
+  // the local store is lost, everything comes from the remote one
+  taosRemoveDir(storePath);
+  taosRemoveDir(dst);
+  pStore = streamChkpStoreOpen(storePath, "stream/test/vnode3");
+  ASSERT_NE(pStore, nullptr);
+  ASSERT_EQ(streamChkpStoreRecover(pStore, 1, dst), 0);
+  EXPECT_EQ(readFile(dst, "000007.sst"), "sst content");
+  EXPECT_EQ(taosHashGetSize(pStore->pObjRefs), 2);
+  streamChkpStoreClose(pStore);
+}
+
+TEST_F(ChkpStoreTest, keysOfPreviousBackend) {
+  char dir[PATH_MAX] = {0};
+  char dst[PATH_MAX] = {0};
+  sprintf(dst, "%s%srecovered", TD_TMP_DIR_PATH "chkpStoreTest", TD_DIRSEP);
+
+  SStreamChkpStore *pStore = streamChkpStoreOpen(storePath, "stream/test/vnode4");
+  ASSERT_NE(pStore, nullptr);
+  writeFile(1, "000009.sst", "old content");
+  sprintf(dir, "%s1", chkpPath);
+  ASSERT_EQ(streamChkpStoreCommit(pStore, dir, 1), 0);
+
+  // the same backend never rewrites an sst, its key is reused without hashing the file
+  writeFile(2, "000009.sst", "old content");
+  sprintf(dir, "%s2", chkpPath);
+  ASSERT_EQ(streamChkpStoreCommit(pStore, dir, 2), 0);
+  EXPECT_EQ(pStore->numOfNewObjs, 0);
+
+  // a new backend numbers its files from scratch, a file of the same name and size is hashed again
+  streamChkpStoreResetBackend(pStore);
+  writeFile(3, "000009.sst", "new content");
+  sprintf(dir, "%s3", chkpPath);
+  ASSERT_EQ(streamChkpStoreCommit(pStore, dir, 3), 0);
+  EXPECT_EQ(pStore->numOfNewObjs, 1);
+  streamChkpStoreClose(pStore);
+
+  // as does the backend of a restarted node
+  pStore = streamChkpStoreOpen(storePath, "stream/test/vnode4");
+  ASSERT_NE(pStore, nullptr);
+  writeFile(4, "000009.sst", "old content");
+  sprintf(dir, "%s4", chkpPath);
+  ASSERT_EQ(streamChkpStoreCommit(pStore, dir, 4), 0);
+
+  ASSERT_EQ(streamChkpStoreRecover(pStore, 4, dst), 0);
+  EXPECT_EQ(readFile(dst, "000009.sst"), "old content");
+  streamChkpStoreClose(pStore);
+}
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "streamInt.h"
+#include "tdatablock.h"
+
+static const char   *dbFName = "1.db";
+static const char   *stbFullName = "1.db.st";
+static const int32_t numOfVgroups = 4;
+
+static uint32_t tbHashVal(const char *tbName) {
+  char name[TSDB_TABLE_FNAME_LEN] = {0};
+  snprintf(name, sizeof(name), "%s.%s", dbFName, tbName);
+  return taosGetTbHashVal(name, strlen(name), 1, 0, 0);
+}
+
+static int32_t vgroupIndexOf(SStreamTask *pTask, const char *tbName) {
+  uint32_t hashValue = tbHashVal(tbName);
+  SArray  *pVgroups = pTask->outputInfo.shuffleDispatcher.dbInfo.pVgroupInfos;
+  for (int32_t i = 0; i < (int32_t)taosArrayGetSize(pVgroups); ++i) {
+    SVgroupInfo *pVg = (SVgroupInfo *)taosArrayGet(pVgroups, i);
+    if (hashValue >= pVg->hashBegin && hashValue <= pVg->hashEnd) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+static SStreamTask *createShuffleTask() {
+  SStreamTask *pTask = (SStreamTask *)taosMemoryCalloc(1, sizeof(SStreamTask));
+  pTask->pMeta = (SStreamMeta *)taosMemoryCalloc(1, sizeof(SStreamMeta));
+  pTask->id.idStr = taosStrdup("0x1");
+  pTask->outputInfo.type = TASK_OUTPUT__SHUFFLE_DISPATCH;
+
+  STaskDispatcherShuffle *pDispatcher = &pTask->outputInfo.shuffleDispatcher;
+  tstrncpy(pDispatcher->stbFullName, stbFullName, sizeof(pDispatcher->stbFullName));
+  tstrncpy(pDispatcher->dbInfo.db, dbFName, sizeof(pDispatcher->dbInfo.db));
+  pDispatcher->dbInfo.hashMethod = 1;
+  pDispatcher->dbInfo.pVgroupInfos = taosArrayInit(numOfVgroups, sizeof(SVgroupInfo));
+
+  // listed in reverse order of the hash ranges
+  uint32_t step = UINT32_MAX / numOfVgroups;
+  for (int32_t i = numOfVgroups - 1; i >= 0; --i) {
+    SVgroupInfo vg = {0};
+    vg.vgId = i + 2;
+    vg.hashBegin = step * i;
+    vg.hashEnd = (i == numOfVgroups - 1) ? UINT32_MAX : step * (i + 1) - 1;
+    vg.taskId = 100 + i;
+    taosArrayPush(pDispatcher->dbInfo.pVgroupInfos, &vg);
+  }
+  return pTask;
+}
+
+static void destroyShuffleTask(SStreamTask *pTask) {
+  if (pTask->msgInfo.pData != NULL) {
+    destroyDispatchMsg((SStreamDispatchReq *)pTask->msgInfo.pData, numOfVgroups);
+  }
+  if (pTask->pNameMap != NULL) {
+    taosLRUCacheEraseUnrefEntries(pTask->pNameMap);
+    taosLRUCacheCleanup(pTask->pNameMap);
+  }
+  taosArrayDestroy(pTask->pVgRanges);
+  taosArrayDestroy(pTask->outputInfo.shuffleDispatcher.dbInfo.pVgroupInfos);
+  taosMemoryFree((void *)pTask->id.idStr);
+  taosMemoryFree(pTask->pMeta);
+  taosMemoryFree(pTask);
+}
+
+static void appendDeleteRow(SSDataBlock *pBlock, int64_t groupId, const char *tbName) {
+  int32_t row = pBlock->info.rows;
+  TSKEY   ts = 1700000000000;
+  int64_t uid = 0;
+  colDataSetVal((SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, START_TS_COLUMN_INDEX), row, (char *)&ts, false);
+  colDataSetVal((SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, END_TS_COLUMN_INDEX), row, (char *)&ts, false);
+  colDataSetVal((SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, UID_COLUMN_INDEX), row, (char *)&uid, false);
+  colDataSetVal((SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, GROUPID_COLUMN_INDEX), row, (char *)&groupId,
+                false);
+  colDataSetNULL((SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, CALCULATE_START_TS_COLUMN_INDEX), row);
+  colDataSetNULL((SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, CALCULATE_END_TS_COLUMN_INDEX), row);
+
+  SColumnInfoData *pTbNameCol = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, TABLE_NAME_COLUMN_INDEX);
+  if (tbName == NULL) {
+    colDataSetNULL(pTbNameCol, row);
+  } else {
+    char varTbName[VARSTR_HEADER_SIZE + TSDB_TABLE_NAME_LEN] = {0};
+    STR_TO_VARSTR(varTbName, tbName);
+    colDataSetVal(pTbNameCol, row, varTbName, false);
+  }
+  pBlock->info.rows += 1;
+}
+
+// The data block of a group carries the name of a subtable expression, which is cached for the group. A delete row of
+// the group without a table name is removed from the default table of the group by the sink task, so it must be routed
+// by the default name instead of the cached one.
+TEST(streamDispatchTest, deleteWithSubtableName) {
+  SStreamTask *pTask = createShuffleTask();
+  int64_t      groupId = 12345;
+
+  char defaultName[TSDB_TABLE_NAME_LEN] = {0};
+  buildCtbNameByGroupIdImpl(stbFullName, groupId, defaultName);
+  int32_t defaultIndex = vgroupIndexOf(pTask, defaultName);
+  ASSERT_GE(defaultIndex, 0);
+
+  // a subtable name landing in another vgroup than the default one
+  char subName[TSDB_TABLE_NAME_LEN] = {0};
+  for (int32_t i = 0; i < 100; ++i) {
+    snprintf(subName, sizeof(subName), "sub_%d", i);
+    if (vgroupIndexOf(pTask, subName) != defaultIndex) break;
+  }
+  int32_t subIndex = vgroupIndexOf(pTask, subName);
+  ASSERT_NE(subIndex, defaultIndex);
+
+  SSDataBlock *pDataBlock = createDataBlock();
+  SColumnInfoData tsCol = createColumnInfoData(TSDB_DATA_TYPE_TIMESTAMP, sizeof(TSKEY), 1);
+  blockDataAppendColInfo(pDataBlock, &tsCol);
+  blockDataEnsureCapacity(pDataBlock, 1);
+  TSKEY ts = 1700000000000;
+  colDataSetVal((SColumnInfoData *)taosArrayGet(pDataBlock->pDataBlock, 0), 0, (char *)&ts, false);
+  pDataBlock->info.rows = 1;
+  pDataBlock->info.type = STREAM_NORMAL;
+  pDataBlock->info.id.groupId = groupId;
+  tstrncpy(pDataBlock->info.parTbName, subName, TSDB_TABLE_NAME_LEN);
+
+  // one row without a table name and one with the name of the subtable
+  SSDataBlock *pDelBlock = createSpecialDataBlock(STREAM_DELETE_RESULT);
+  blockDataEnsureCapacity(pDelBlock, 2);
+  appendDeleteRow(pDelBlock, groupId, NULL);
+  appendDeleteRow(pDelBlock, groupId, subName);
+
+  SStreamDataBlock data = {0};
+  data.type = STREAM_INPUT__DATA_BLOCK;
+  data.blocks = taosArrayInit(2, sizeof(SSDataBlock));
+  taosArrayPush(data.blocks, pDataBlock);
+  taosArrayPush(data.blocks, pDelBlock);
+
+  ASSERT_EQ(doBuildDispatchMsg(pTask, &data), 0);
+
+  SStreamDispatchReq *pReqs = (SStreamDispatchReq *)pTask->msgInfo.pData;
+  for (int32_t i = 0; i < numOfVgroups; ++i) {
+    if (i == subIndex) {
+      // the data block and the delete row of the subtable
+      EXPECT_EQ(pReqs[i].blockNum, 2);
+    } else if (i == defaultIndex) {
+      EXPECT_EQ(pReqs[i].blockNum, 1);
+    } else {
+      EXPECT_EQ(pReqs[i].blockNum, 0);
+    }
+  }
+  EXPECT_EQ(pTask->outputInfo.shuffleDispatcher.waitingRspCnt, 2);
+
+  // the array holds shallow copies of the blocks
+  taosArrayDestroy(data.blocks);
+  blockDataDestroy(pDataBlock);
+  blockDataDestroy(pDelBlock);
+  destroyShuffleTask(pTask);
+}
@@ -22,6 +22,7 @@ extern "C" {
 
 #include "sync.h"
 #include "taosdef.h"
+#include "tmetrics.h"
 #include "trpc.h"
 #include "ttimer.h"
 
@@ -223,6 +224,8 @@ typedef struct SSyncNode {
   int32_t hbrSlowNum;
   int32_t tmrRoutineNum;
 
+  SMetric* pCommitUs;
+
   bool isStart;
 
 } SSyncNode;
@@ -45,6 +45,7 @@ typedef struct SSyncLogBufEntry {
   SSyncRaftEntry* pItem;
   SyncIndex       prevLogIndex;
   SyncTerm        prevLogTerm;
+  int64_t         appendUs;  // when the leader appended it, 0 if it is received from the leader
 } SSyncLogBufEntry;
 
 typedef struct SSyncLogBuffer {
@@ -860,6 +860,10 @@ SSyncNode* syncNodeOpen(SSyncInfo* pSyncInfo, int32_t vnodeVersion) {
 
     // init by SSyncInfo
   pSyncNode->vgId = pSyncInfo->vgId;
+  char labels[32];
+  snprintf(labels, sizeof(labels), "vgId=\"%d\"", pSyncNode->vgId);
+  pSyncNode->pCommitUs =
+      taosMetricsAcquire(METRIC_HISTOGRAM, "taosd_sync_commit_us", "duration from propose to apply on leader", labels);
   SSyncCfg* pCfg = &pSyncNode->raftCfg.cfg;
   bool      updated = false;
   sInfo("vgId:%d, start to open sync node, totalReplicaNum:%d replicaNum:%d selfIndex:%d", pSyncNode->vgId,
@@ -1303,6 +1307,7 @@ void syncNodeClose(SSyncNode* pSyncNode) {
   }
 
   raftStoreClose(pSyncNode);
+  taosMetricsRelease(pSyncNode->pCommitUs);
 
   taosMemoryFree(pSyncNode);
 }
@@ -81,7 +81,10 @@ int32_t syncLogBufferAppend(SSyncLogBuffer* pBuf, SSyncNode* pNode, SSyncRaftEnt
   ASSERT(pMatch->index + 1 == index);
   ASSERT(pMatch->term <= pEntry->term);
 
-  SSyncLogBufEntry tmp = {.pItem = pEntry, .prevLogIndex = pMatch->index, .prevLogTerm = pMatch->term};
+  SSyncLogBufEntry tmp = {.pItem = pEntry,
+                          .prevLogIndex = pMatch->index,
+                          .prevLogTerm = pMatch->term,
+                          .appendUs = taosGetTimestampUs()};
   pBuf->entries[index % pBuf->size] = tmp;
   pBuf->endIndex = index + 1;
 
@@ -634,6 +637,12 @@ int32_t syncLogBufferCommit(SSyncLogBuffer* pBuf, SSyncNode* pNode, int64_t comm
     }
     pBuf->commitIndex = index;
 
+    // from the proposal on the leader to the apply, i.e. replication, quorum and fsm execution
+    int64_t appendUs = inBuf ? pBuf->entries[index % pBuf->size].appendUs : 0;
+    if (appendUs > 0) {
+      METRICS_OBSERVE_SINCE(pNode->pCommitUs, appendUs);
+    }
+
     sTrace("vgId:%d, committed index:%" PRId64 ", term:%" PRId64 ", role:%d, current term:%" PRId64 "", pNode->vgId,
            pEntry->index, pEntry->term, role, currentTerm);
 
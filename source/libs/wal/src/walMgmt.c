@@ -143,6 +143,12 @@ SWal *walOpen(const char *path, SWalCfg *pCfg) {
   pWal->writeHead.head.protoVer = WAL_PROTO_VER;
   pWal->writeHead.magic = WAL_MAGIC;
 
+  // init metrics, the wal still works without them
+  char labels[32];
+  snprintf(labels, sizeof(labels), "vgId=\"%d\"", pWal->cfg.vgId);
+  pWal->pAppendUs = taosMetricsAcquire(METRIC_HISTOGRAM, "taosd_wal_append_us", "duration of a wal append", labels);
+  pWal->pAppendBytes = taosMetricsAcquire(METRIC_COUNTER, "taosd_wal_append_bytes", "bytes appended to wal", labels);
+
   // load meta
   (void)walLoadMeta(pWal);
 
@@ -168,6 +174,8 @@ SWal *walOpen(const char *path, SWalCfg *pCfg) {
   return pWal;
 
 _err:
+  taosMetricsRelease(pWal->pAppendUs);
+  taosMetricsRelease(pWal->pAppendBytes);
   taosArrayDestroy(pWal->fileInfoSet);
   taosHashCleanup(pWal->pRefHash);
   taosThreadMutexDestroy(&pWal->mutex);
@@ -239,6 +247,8 @@ static void walFreeObj(void *wal) {
   SWal *pWal = wal;
   wDebug("vgId:%d, wal:%p is freed", pWal->cfg.vgId, pWal);
 
+  taosMetricsRelease(pWal->pAppendUs);
+  taosMetricsRelease(pWal->pAppendBytes);
   taosThreadMutexDestroy(&pWal->mutex);
   taosMemoryFreeClear(pWal);
 }
@@ -484,6 +484,7 @@ static int32_t walWriteIndex(SWal *pWal, int64_t ver, int64_t offset) {
 static FORCE_INLINE int32_t walWriteImpl(SWal *pWal, int64_t index, tmsg_t msgType, SWalSyncInfo syncMeta,
                                          const void *body, int32_t bodyLen) {
   int64_t code = 0;
+  int64_t startUs = taosGetTimestampUs();
 
   int64_t       offset = walGetCurFileOffset(pWal);
   SWalFileInfo *pFileInfo = walGetCurFileInfo(pWal);
@@ -531,6 +532,8 @@ static FORCE_INLINE int32_t walWriteImpl(SWal *pWal, int64_t index, tmsg_t msgTy
   pFileInfo->lastVer = index;
   pFileInfo->fileSize += sizeof(SWalCkHead) + bodyLen;
 
+  METRICS_OBSERVE_SINCE(pWal->pAppendUs, startUs);
+  taosMetricsAdd(pWal->pAppendBytes, sizeof(SWalCkHead) + bodyLen);
   return 0;
 
 END:
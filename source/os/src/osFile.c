@@ -213,6 +213,14 @@ int32_t taosRenameFile(const char *oldName, const char *newName) {
 #endif
 }
 
+int32_t taosLinkFile(const char *src, const char *dst) {
+#ifdef WINDOWS
+  return CreateHardLink(dst, src, NULL) ? 0 : -1;
+#else
+  return link(src, dst);
+#endif
+}
+
 int32_t taosStatFile(const char *path, int64_t *size, int32_t *mtime, int32_t *atime) {
 #ifdef WINDOWS
   struct _stati64 fileStat;
@@ -20,6 +20,9 @@
 #include <malloc.h>
 #endif
 #include "os.h"
+#ifdef TD_JEMALLOC_ENABLED
+#include "jemalloc/jemalloc.h"
+#endif
 
 #if defined(USE_TD_MEMORY) || defined(USE_ADDR2LINE)
 
@@ -377,6 +380,10 @@ void taosMemoryTrim(int32_t size) {
 #if defined(WINDOWS) || defined(DARWIN) || defined(_ALPINE)
   // do nothing
   return;
+#elif defined(TD_JEMALLOC_ENABLED)
+  char cmd[64];
+  snprintf(cmd, sizeof(cmd), "arena.%d.purge", MALLCTL_ARENAS_ALL);
+  mallctl(cmd, NULL, NULL, NULL, 0);
 #else
   malloc_trim(size);
 #endif
@@ -394,3 +401,104 @@ void *taosMemoryMallocAlign(uint32_t alignment, int64_t size) {
 #endif
 #endif
 }
+
+const char *taosMemoryAllocatorName() {
+#if defined(TD_JEMALLOC_ENABLED)
+  return "jemalloc";
+#elif defined(WINDOWS)
+  return "msvcrt";
+#elif defined(_TD_DARWIN_64)
+  return "libmalloc";
+#elif defined(__GLIBC__)
+  return "glibc";
+#else
+  return "libc";
+#endif
+}
+
+int32_t taosMemoryGetAllocStats(SMemAllocStats *pStats) {
+  memset(pStats, 0, sizeof(SMemAllocStats));
+
+#if defined(TD_JEMALLOC_ENABLED)
+  // the statistics are cached by jemalloc, refresh them first
+  uint64_t epoch = 1;
+  size_t   len = sizeof(epoch);
+  mallctl("epoch", &epoch, &len, &epoch, len);
+
+  size_t val = 0;
+  len = sizeof(val);
+  if (mallctl("stats.allocated", &val, &len, NULL, 0) == 0) pStats->allocated = val;
+  if (mallctl("stats.active", &val, &len, NULL, 0) == 0) pStats->active = val;
+  if (mallctl("stats.resident", &val, &len, NULL, 0) == 0) pStats->resident = val;
+  if (mallctl("stats.mapped", &val, &len, NULL, 0) == 0) pStats->mapped = val;
+  if (mallctl("stats.retained", &val, &len, NULL, 0) == 0) pStats->retained = val;
+
+  unsigned narenas = 0;
+  len = sizeof(narenas);
+  if (mallctl("arenas.narenas", &narenas, &len, NULL, 0) == 0) pStats->numOfArenas = narenas;
+  return 0;
+#elif defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+  // glibc has no notion of active pages or arena count, the free chunks kept in the heap are the fragmentation
+  struct mallinfo2 mi = mallinfo2();
+  pStats->allocated = mi.uordblks + mi.hblkhd;
+  pStats->active = mi.arena + mi.hblkhd;
+  pStats->resident = pStats->active;
+  pStats->mapped = pStats->active;
+  return 0;
+#else
+  return TSDB_CODE_OPS_NOT_SUPPORT;
+#endif
+}
+
+#ifdef TD_JEMALLOC_ENABLED
+#define TD_MEMORY_MAX_NAMED_ARENAS 64
+
+typedef struct {
+  char    name[64];
+  int32_t arena;
+} SNamedArena;
+
+static TdThreadMutex tsNamedArenaMutex = TD_PTHREAD_MUTEX_INITIALIZER;
+static SNamedArena   tsNamedArenas[TD_MEMORY_MAX_NAMED_ARENAS];
+static int32_t       tsNumOfNamedArenas = 0;
+#endif
+
+// Threads doing the same kind of work share one allocator arena, so that the memory they free is reused by the same
+// pool instead of being scattered over the per thread arenas. Returns -1 if the allocator has no explicit arenas or
+// the arena table is full, the caller then stays on the default arena.
+int32_t taosMemoryGetNamedArena(const char *name) {
+#ifdef TD_JEMALLOC_ENABLED
+  int32_t arena = -1;
+  taosThreadMutexLock(&tsNamedArenaMutex);
+  for (int32_t i = 0; i < tsNumOfNamedArenas; ++i) {
+    if (strcmp(tsNamedArenas[i].name, name) == 0) {
+      arena = tsNamedArenas[i].arena;
+      break;
+    }
+  }
+
+  if (arena < 0 && tsNumOfNamedArenas < TD_MEMORY_MAX_NAMED_ARENAS) {
+    unsigned id = 0;
+    size_t   len = sizeof(id);
+    if (mallctl("arenas.create", &id, &len, NULL, 0) == 0) {
+      SNamedArena *pArena = &tsNamedArenas[tsNumOfNamedArenas++];
+      tstrncpy(pArena->name, name, sizeof(pArena->name));
+      pArena->arena = (int32_t)id;
+      arena = pArena->arena;
+    }
+  }
+  taosThreadMutexUnlock(&tsNamedArenaMutex);
+  return arena;
+#else
+  return -1;
+#endif
+}
+
+void taosMemoryBindArena(int32_t arena) {
+#ifdef TD_JEMALLOC_ENABLED
+  if (arena >= 0) {
+    unsigned id = (unsigned)arena;
+    mallctl("thread.arena", NULL, NULL, &id, sizeof(id));
+  }
+#endif
+}
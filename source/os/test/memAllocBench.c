@@ -0,0 +1,143 @@
+// Soak the allocator with a mixed write/query pattern and report how far the process RSS drifts from the bytes that
+// are really live. Write threads keep a ring of long lived small objects (cache entries) next to short lived row
+// buffers, query threads allocate and free large transient blocks. Run the same binary against glibc and jemalloc
+// (build with -DJEMALLOC_ENABLED=ON, or LD_PRELOAD libjemalloc.so) to compare the fragmentation.
+//
+// usage: memAllocBench [seconds] [writeThreads] [queryThreads]
+#include "os.h"
+
+#define BENCH_RING_SIZE    (64 * 1024)
+#define BENCH_REPORT_MS    5000
+#define BENCH_QUERY_BLOCKS 16
+
+typedef struct {
+  int32_t  id;
+  bool     query;
+  uint64_t seed;
+  int64_t  live;
+  int64_t  ops;
+} SBenchThread;
+
+static volatile bool tsBenchStop = false;
+
+static uint64_t benchRand(uint64_t *seed) {
+  uint64_t x = *seed;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  *seed = x;
+  return x;
+}
+
+static void *benchWriteFp(void *param) {
+  SBenchThread *pThread = param;
+  void        **ring = taosMemoryCalloc(BENCH_RING_SIZE, sizeof(void *));
+  int32_t      *sizes = taosMemoryCalloc(BENCH_RING_SIZE, sizeof(int32_t));
+  taosMemoryBindArena(taosMemoryGetNamedArena("bench-write"));
+
+  while (!tsBenchStop) {
+    // replace a random cache entry, sizes vary so that the holes left behind do not fit the next request exactly
+    int32_t slot = benchRand(&pThread->seed) % BENCH_RING_SIZE;
+    int32_t size = 16 + benchRand(&pThread->seed) % 2048;
+    taosMemoryFree(ring[slot]);
+    pThread->live -= sizes[slot];
+    ring[slot] = taosMemoryMalloc(size);
+    memset(ring[slot], 1, size);
+    sizes[slot] = size;
+    pThread->live += size;
+
+    // short lived row buffer
+    int32_t rowSize = 4096 + benchRand(&pThread->seed) % (64 * 1024);
+    char   *pRow = taosMemoryMalloc(rowSize);
+    memset(pRow, 2, rowSize);
+    taosMemoryFree(pRow);
+    pThread->ops += 2;
+  }
+
+  for (int32_t i = 0; i < BENCH_RING_SIZE; ++i) {
+    taosMemoryFree(ring[i]);
+  }
+  taosMemoryFree(ring);
+  taosMemoryFree(sizes);
+  pThread->live = 0;
+  return NULL;
+}
+
+static void *benchQueryFp(void *param) {
+  SBenchThread *pThread = param;
+  void         *blocks[BENCH_QUERY_BLOCKS] = {0};
+  taosMemoryBindArena(taosMemoryGetNamedArena("bench-query"));
+
+  while (!tsBenchStop) {
+    int32_t num = 1 + benchRand(&pThread->seed) % BENCH_QUERY_BLOCKS;
+    for (int32_t i = 0; i < num; ++i) {
+      int32_t size = 64 * 1024 + benchRand(&pThread->seed) % (1024 * 1024);
+      blocks[i] = taosMemoryMalloc(size);
+      memset(blocks[i], 3, size);
+    }
+    for (int32_t i = 0; i < num; ++i) {
+      taosMemoryFree(blocks[i]);
+    }
+    pThread->ops += num;
+  }
+  return NULL;
+}
+
+static void benchReport(const char *stage, SBenchThread *pThreads, int32_t numOfThreads) {
+  int64_t live = 0;
+  int64_t ops = 0;
+  for (int32_t i = 0; i < numOfThreads; ++i) {
+    live += pThreads[i].live;
+    ops += pThreads[i].ops;
+  }
+
+  int64_t        rssKB = 0;
+  SMemAllocStats stats = {0};
+  taosGetProcMemory(&rssKB);
+  taosMemoryGetAllocStats(&stats);
+  printf("%-8s live:%8.1f MB, rss:%8.1f MB, rss/live:%5.2f, allocator resident:%8.1f MB, arenas:%d, ops:%" PRId64
+         "\n",
+         stage, live / 1048576.0, rssKB / 1024.0, live > 0 ? rssKB * 1024.0 / live : 0, stats.resident / 1048576.0,
+         stats.numOfArenas, ops);
+}
+
+int main(int argc, char *argv[]) {
+  int32_t seconds = (argc > 1) ? atoi(argv[1]) : 60;
+  int32_t numOfWrite = (argc > 2) ? atoi(argv[2]) : 8;
+  int32_t numOfQuery = (argc > 3) ? atoi(argv[3]) : 4;
+  int32_t numOfThreads = numOfWrite + numOfQuery;
+
+  taosGetSystemInfo();
+  printf("allocator:%s, %d seconds, %d write threads, %d query threads\n", taosMemoryAllocatorName(), seconds,
+         numOfWrite, numOfQuery);
+
+  SBenchThread *pThreads = taosMemoryCalloc(numOfThreads, sizeof(SBenchThread));
+  TdThread     *pIds = taosMemoryCalloc(numOfThreads, sizeof(TdThread));
+  for (int32_t i = 0; i < numOfThreads; ++i) {
+    pThreads[i].id = i;
+    pThreads[i].query = (i >= numOfWrite);
+    pThreads[i].seed = 0x9E3779B97F4A7C15ULL * (i + 1);
+    taosThreadCreate(&pIds[i], NULL, pThreads[i].query ? benchQueryFp : benchWriteFp, &pThreads[i]);
+  }
+
+  int64_t end = taosGetTimestampMs() + seconds * 1000LL;
+  while (taosGetTimestampMs() < end) {
+    taosMsleep(BENCH_REPORT_MS);
+    benchReport("running", pThreads, numOfThreads);
+  }
+
+  tsBenchStop = true;
+  for (int32_t i = 0; i < numOfThreads; ++i) {
+    taosThreadJoin(pIds[i], NULL);
+  }
+
+  // what the process keeps after all the memory is given back is the cost of the fragmentation
+  benchReport("freed", pThreads, numOfThreads);
+  taosMemoryTrim(0);
+  taosMsleep(1000);
+  benchReport("trimmed", pThreads, numOfThreads);
+
+  taosMemoryFree(pIds);
+  taosMemoryFree(pThreads);
+  return 0;
+}
@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _DEFAULT_SOURCE
+#include "tarena.h"
+#include "taoserror.h"
+#include "tlog.h"
+
+#define ARENA_ALIGN           8
+#define ARENA_ALIGN_SIZE(_s)  (((_s) + ARENA_ALIGN - 1) & ~((int64_t)ARENA_ALIGN - 1))
+
+typedef struct SArenaChunk {
+  int64_t             size;  // usable bytes of the chunk
+  int64_t             used;  // bytes handed out
+  struct SArenaChunk *pNext;
+  char                buf[];
+} SArenaChunk;
+
+struct SArena {
+  SArena      *pParent;
+  int32_t      chunkSize;
+  int64_t      limit;  // 0 means no limit
+  int64_t      used;   // bytes of chunks held by this arena and all its children
+  int64_t      peak;
+  SArenaChunk *pChunks;  // the current chunk is the head of the list
+};
+
+static void arenaUpdatePeak(SArena *pArena, int64_t used) {
+  int64_t peak = atomic_load_64(&pArena->peak);
+  while (used > peak) {
+    int64_t old = atomic_val_compare_exchange_64(&pArena->peak, peak, used);
+    if (old == peak) {
+      break;
+    }
+    peak = old;
+  }
+}
+
+static void arenaRelease(SArena *pArena, int64_t size) {
+  for (SArena *p = pArena; p != NULL; p = p->pParent) {
+    atomic_sub_fetch_64(&p->used, size);
+  }
+}
+
+static int32_t arenaCharge(SArena *pArena, int64_t size) {
+  for (SArena *p = pArena; p != NULL; p = p->pParent) {
+    int64_t used = atomic_add_fetch_64(&p->used, size);
+    if (p->limit > 0 && used > p->limit) {
+      // roll back what has been charged so far, including this level
+      for (SArena *q = pArena; q != p->pParent; q = q->pParent) {
+        atomic_sub_fetch_64(&q->used, size);
+      }
+      uDebug("arena:%p, alloc %" PRId64 " bytes exceeds limit %" PRId64 " of arena:%p", pArena, size, p->limit, p);
+      return TSDB_CODE_QRY_NOT_ENOUGH_BUFFER;
+    }
+    arenaUpdatePeak(p, used);
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+static SArenaChunk *arenaNewChunk(SArena *pArena, int64_t size) {
+  int32_t code = arenaCharge(pArena, size);
+  if (code != TSDB_CODE_SUCCESS) {
+    terrno = code;
+    return NULL;
+  }
+
+  SArenaChunk *pChunk = taosMemoryMalloc(sizeof(SArenaChunk) + size);
+  if (pChunk == NULL) {
+    arenaRelease(pArena, size);
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  pChunk->size = size;
+  pChunk->used = 0;
+  return pChunk;
+}
+
+SArena *taosArenaInit(SArena *pParent, int32_t chunkSize, int64_t limit) {
+  SArena *pArena = taosMemoryCalloc(1, sizeof(SArena));
+  if (pArena == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  pArena->pParent = pParent;
+  pArena->chunkSize = (chunkSize > 0) ? ARENA_ALIGN_SIZE(chunkSize) : TARENA_DEFAULT_CHUNK_SIZE;
+  pArena->limit = TMAX(limit, 0);
+  return pArena;
+}
+
+void *taosArenaAlloc(SArena *pArena, int64_t size) {
+  if (size <= 0) {
+    return NULL;
+  }
+
+  size = ARENA_ALIGN_SIZE(size);
+  SArenaChunk *pChunk = pArena->pChunks;
+  if (pChunk != NULL && pChunk->used + size <= pChunk->size) {
+    void *p = pChunk->buf + pChunk->used;
+    pChunk->used += size;
+    return p;
+  }
+
+  if (size > pArena->chunkSize / 2) {
+    // big request gets a chunk of its own behind the current one, so the space left in the current chunk is kept
+    pChunk = arenaNewChunk(pArena, size);
+    if (pChunk == NULL) {
+      return NULL;
+    }
+    pChunk->used = size;
+    if (pArena->pChunks == NULL) {
+      pChunk->pNext = NULL;
+      pArena->pChunks = pChunk;
+    } else {
+      pChunk->pNext = pArena->pChunks->pNext;
+      pArena->pChunks->pNext = pChunk;
+    }
+    return pChunk->buf;
+  }
+
+  pChunk = arenaNewChunk(pArena, pArena->chunkSize);
+  if (pChunk == NULL) {
+    return NULL;
+  }
+  pChunk->used = size;
+  pChunk->pNext = pArena->pChunks;
+  pArena->pChunks = pChunk;
+  return pChunk->buf;
+}
+
+void *taosArenaCalloc(SArena *pArena, int64_t num, int64_t size) {
+  void *p = taosArenaAlloc(pArena, num * size);
+  if (p != NULL) {
+    memset(p, 0, num * size);
+  }
+  return p;
+}
+
+void taosArenaReset(SArena *pArena) {
+  if (pArena == NULL || pArena->pChunks == NULL) {
+    return;
+  }
+
+  // keep the head chunk if it is a regular one, so that a per block reset does not go back to the system allocator
+  SArenaChunk *pKeep = pArena->pChunks;
+  SArenaChunk *pChunk = pKeep->pNext;
+  if (pKeep->size != pArena->chunkSize) {
+    pChunk = pKeep;
+    pKeep = NULL;
+  }
+
+  int64_t released = 0;
+  while (pChunk != NULL) {
+    SArenaChunk *pNext = pChunk->pNext;
+    released += pChunk->size;
+    taosMemoryFree(pChunk);
+    pChunk = pNext;
+  }
+  if (released > 0) {
+    arenaRelease(pArena, released);
+  }
+
+  if (pKeep != NULL) {
+    pKeep->used = 0;
+    pKeep->pNext = NULL;
+  }
+  pArena->pChunks = pKeep;
+}
+
+void taosArenaDestroy(SArena *pArena) {
+  if (pArena == NULL) {
+    return;
+  }
+
+  int64_t      released = 0;
+  SArenaChunk *pChunk = pArena->pChunks;
+  while (pChunk != NULL) {
+    SArenaChunk *pNext = pChunk->pNext;
+    released += pChunk->size;
+    taosMemoryFree(pChunk);
+    pChunk = pNext;
+  }
+  if (released > 0 && pArena->pParent != NULL) {
+    arenaRelease(pArena->pParent, released);
+  }
+
+  taosMemoryFree(pArena);
+}
+
+int64_t taosArenaGetUsed(const SArena *pArena) { return atomic_load_64((int64_t *)&pArena->used); }
+
+int64_t taosArenaGetPeak(const SArena *pArena) { return atomic_load_64((int64_t *)&pArena->peak); }
@@ -0,0 +1,363 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _DEFAULT_SOURCE
+#include "tmetrics.h"
+#include "taos.h"
+#include "tdef.h"
+#include "taoserror.h"
+#include "thash.h"
+#include "tlog.h"
+#include "tstrbuild.h"
+
+#define METRIC_STRIPES      4
+#define METRIC_CACHE_LINE   64
+#define METRIC_NAME_LEN     64
+#define METRIC_HELP_LEN     128
+#define METRIC_LABELS_LEN   64
+#define METRIC_KEY_LEN      (METRIC_NAME_LEN + METRIC_LABELS_LEN + 2)
+#define METRIC_SUB_BITS     3
+#define METRIC_SUB_BUCKETS  (1 << METRIC_SUB_BITS)
+#define METRIC_MAX_SHIFT    32  // values up to 2^35, about 9.5 hours in microseconds
+#define METRIC_BUCKETS      ((METRIC_MAX_SHIFT + 2) * METRIC_SUB_BUCKETS)
+#define METRIC_EXPORT_SHIFT (METRIC_MAX_SHIFT + METRIC_SUB_BITS)
+
+typedef struct {
+  int64_t val;
+  char    pad[56];  // one stripe per cache line
+} SMetricCell;
+
+typedef struct {
+  int64_t count;
+  int64_t sum;
+  int64_t buckets[METRIC_BUCKETS];
+  char    pad[METRIC_CACHE_LINE - (METRIC_BUCKETS + 2) * sizeof(int64_t) % METRIC_CACHE_LINE];
+} SMetricHistStripe;  // allocated cache line aligned, so that no two stripes share a line
+
+struct SMetric {
+  EMetricType type;
+  int32_t     refCount;
+  char        name[METRIC_NAME_LEN];
+  char        help[METRIC_HELP_LEN];
+  char        labels[METRIC_LABELS_LEN];
+  char        key[METRIC_KEY_LEN];
+  union {
+    SMetricCell        cells[METRIC_STRIPES];
+    SMetricHistStripe *pHist;  // METRIC_STRIPES stripes
+  };
+};
+
+typedef struct {
+  TdThreadMutex lock;
+  SHashObj     *pMetrics;  // key -> SMetric*
+} SMetricsMgmt;
+
+static SMetricsMgmt        tsMetrics = {0};
+static TdThreadOnce        tsMetricsInit = PTHREAD_ONCE_INIT;
+static threadlocal int32_t tsMetricsStripe = -1;
+static int32_t             tsMetricsNextStripe = 0;
+
+static void metricsInitOnce() {
+  taosThreadMutexInit(&tsMetrics.lock, NULL);
+  tsMetrics.pMetrics = taosHashInit(64, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), true, HASH_NO_LOCK);
+  if (tsMetrics.pMetrics == NULL) {
+    uError("failed to init metrics registry since %s", terrstr());
+  }
+}
+
+static FORCE_INLINE int32_t metricsGetStripe() {
+  if (tsMetricsStripe < 0) {
+    tsMetricsStripe = atomic_fetch_add_32(&tsMetricsNextStripe, 1) % METRIC_STRIPES;
+  }
+  return tsMetricsStripe;
+}
+
+static FORCE_INLINE int32_t metricsGetBucket(int64_t val) {
+  if (val < METRIC_SUB_BUCKETS) {
+    return (val < 0) ? 0 : (int32_t)val;
+  }
+
+  int32_t msb = 63 - __builtin_clzll((uint64_t)val);
+  int32_t shift = msb - METRIC_SUB_BITS;
+  if (shift > METRIC_MAX_SHIFT) {
+    return METRIC_BUCKETS - 1;
+  }
+  return (shift + 1) * METRIC_SUB_BUCKETS + (int32_t)((val >> shift) & (METRIC_SUB_BUCKETS - 1));
+}
+
+// the largest value that falls into the bucket
+static int64_t metricsGetBucketUpper(int32_t bucket) {
+  if (bucket < METRIC_SUB_BUCKETS) {
+    return bucket;
+  }
+
+  int32_t shift = bucket / METRIC_SUB_BUCKETS - 1;
+  int64_t sub = bucket % METRIC_SUB_BUCKETS;
+  return ((METRIC_SUB_BUCKETS + sub + 1) << shift) - 1;
+}
+
+static void metricsDestroy(SMetric *pMetric) {
+  if (pMetric->type == METRIC_HISTOGRAM) {
+    taosMemoryFree(pMetric->pHist);
+  }
+  taosMemoryFree(pMetric);
+}
+
+SMetric *taosMetricsAcquire(EMetricType type, const char *name, const char *help, const char *labels) {
+  taosThreadOnce(&tsMetricsInit, metricsInitOnce);
+  if (tsMetrics.pMetrics == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  char key[METRIC_KEY_LEN] = {0};
+  snprintf(key, sizeof(key), "%s{%s}", name, labels ? labels : "");
+  int32_t keyLen = strlen(key);
+
+  SMetric *pMetric = NULL;
+  taosThreadMutexLock(&tsMetrics.lock);
+  SMetric **ppMetric = taosHashGet(tsMetrics.pMetrics, key, keyLen);
+  if (ppMetric != NULL) {
+    pMetric = *ppMetric;
+    if (pMetric->type != type) {
+      taosThreadMutexUnlock(&tsMetrics.lock);
+      uError("metric:%s, acquired as type:%d, but registered as type:%d", key, type, pMetric->type);
+      terrno = TSDB_CODE_INVALID_PARA;
+      return NULL;
+    }
+    pMetric->refCount++;
+    taosThreadMutexUnlock(&tsMetrics.lock);
+    return pMetric;
+  }
+
+  pMetric = taosMemoryCalloc(1, sizeof(SMetric));
+  if (pMetric != NULL && type == METRIC_HISTOGRAM) {
+    pMetric->pHist = taosMemoryMallocAlign(METRIC_CACHE_LINE, METRIC_STRIPES * sizeof(SMetricHistStripe));
+    if (pMetric->pHist == NULL) {
+      taosMemoryFreeClear(pMetric);
+    } else {
+      memset(pMetric->pHist, 0, METRIC_STRIPES * sizeof(SMetricHistStripe));
+    }
+  }
+  if (pMetric == NULL) {
+    taosThreadMutexUnlock(&tsMetrics.lock);
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  pMetric->type = type;
+  pMetric->refCount = 1;
+  tstrncpy(pMetric->name, name, sizeof(pMetric->name));
+  tstrncpy(pMetric->help, help ? help : "", sizeof(pMetric->help));
+  tstrncpy(pMetric->labels, labels ? labels : "", sizeof(pMetric->labels));
+  tstrncpy(pMetric->key, key, sizeof(pMetric->key));
+
+  if (taosHashPut(tsMetrics.pMetrics, key, keyLen, &pMetric, POINTER_BYTES) != 0) {
+    taosThreadMutexUnlock(&tsMetrics.lock);
+    metricsDestroy(pMetric);
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return NULL;
+  }
+  taosThreadMutexUnlock(&tsMetrics.lock);
+
+  uDebug("metric:%s, is registered", key);
+  return pMetric;
+}
+
+void taosMetricsRelease(SMetric *pMetric) {
+  if (pMetric == NULL) return;
+
+  taosThreadMutexLock(&tsMetrics.lock);
+  if (--pMetric->refCount > 0) {
+    taosThreadMutexUnlock(&tsMetrics.lock);
+    return;
+  }
+  taosHashRemove(tsMetrics.pMetrics, pMetric->key, strlen(pMetric->key));
+  taosThreadMutexUnlock(&tsMetrics.lock);
+
+  uDebug("metric:%s, is unregistered", pMetric->key);
+  metricsDestroy(pMetric);
+}
+
+void taosMetricsAdd(SMetric *pMetric, int64_t val) {
+  if (pMetric == NULL || pMetric->type != METRIC_COUNTER) return;
+  atomic_add_fetch_64(&pMetric->cells[metricsGetStripe()].val, val);
+}
+
+void taosMetricsObserve(SMetric *pMetric, int64_t val) {
+  if (pMetric == NULL || pMetric->type != METRIC_HISTOGRAM) return;
+
+  SMetricHistStripe *pStripe = &pMetric->pHist[metricsGetStripe()];
+  atomic_add_fetch_64(&pStripe->buckets[metricsGetBucket(val)], 1);
+  atomic_add_fetch_64(&pStripe->sum, val);
+  atomic_add_fetch_64(&pStripe->count, 1);
+}
+
+int64_t taosMetricsGetCount(SMetric *pMetric) {
+  if (pMetric == NULL) return 0;
+
+  int64_t count = 0;
+  for (int32_t i = 0; i < METRIC_STRIPES; ++i) {
+    if (pMetric->type == METRIC_COUNTER) {
+      count += atomic_load_64(&pMetric->cells[i].val);
+    } else {
+      count += atomic_load_64(&pMetric->pHist[i].count);
+    }
+  }
+  return count;
+}
+
+int64_t taosMetricsGetSum(SMetric *pMetric) {
+  if (pMetric == NULL || pMetric->type != METRIC_HISTOGRAM) return taosMetricsGetCount(pMetric);
+
+  int64_t sum = 0;
+  for (int32_t i = 0; i < METRIC_STRIPES; ++i) {
+    sum += atomic_load_64(&pMetric->pHist[i].sum);
+  }
+  return sum;
+}
+
+static void metricsMergeBuckets(SMetric *pMetric, int64_t *buckets) {
+  memset(buckets, 0, sizeof(int64_t) * METRIC_BUCKETS);
+  for (int32_t i = 0; i < METRIC_STRIPES; ++i) {
+    for (int32_t j = 0; j < METRIC_BUCKETS; ++j) {
+      buckets[j] += atomic_load_64(&pMetric->pHist[i].buckets[j]);
+    }
+  }
+}
+
+int64_t taosMetricsGetQuantile(SMetric *pMetric, double quantile) {
+  if (pMetric == NULL || pMetric->type != METRIC_HISTOGRAM) return 0;
+
+  int64_t buckets[METRIC_BUCKETS];
+  int64_t total = 0;
+  metricsMergeBuckets(pMetric, buckets);
+  for (int32_t j = 0; j < METRIC_BUCKETS; ++j) {
+    total += buckets[j];
+  }
+  if (total == 0) return 0;
+
+  int64_t rank = (int64_t)ceil(quantile * total);
+  int64_t seen = 0;
+  for (int32_t j = 0; j < METRIC_BUCKETS; ++j) {
+    seen += buckets[j];
+    if (seen >= rank && buckets[j] > 0) {
+      return metricsGetBucketUpper(j);
+    }
+  }
+  return metricsGetBucketUpper(METRIC_BUCKETS - 1);
+}
+
+static void metricsDumpSample(SStringBuilder *sb, const char *name, const char *suffix, const char *labels,
+                              const char *extra, int64_t val) {
+  char line[512];
+  int32_t len = 0;
+  if (labels[0] == 0 && extra == NULL) {
+    len = snprintf(line, sizeof(line), "%s%s %" PRId64 "\n", name, suffix, val);
+  } else {
+    len = snprintf(line, sizeof(line), "%s%s{%s%s%s} %" PRId64 "\n", name, suffix, labels,
+                   (labels[0] != 0 && extra != NULL) ? "," : "", extra ? extra : "", val);
+  }
+  taosStringBuilderAppendStringLen(sb, line, TMIN(len, sizeof(line) - 1));
+}
+
+// Prometheus histogram with power of 2 buckets, the fine buckets are folded, since they all lie within one power of 2
+static void metricsDumpHistogram(SStringBuilder *sb, SMetric *pMetric) {
+  int64_t buckets[METRIC_BUCKETS];
+  metricsMergeBuckets(pMetric, buckets);
+
+  int64_t cumulative = 0;
+  int32_t bucket = 0;
+  char    le[32];
+  for (int32_t shift = 1; shift <= METRIC_EXPORT_SHIFT; ++shift) {
+    int64_t upper = (1LL << shift) - 1;
+    while (bucket < METRIC_BUCKETS && metricsGetBucketUpper(bucket) <= upper) {
+      cumulative += buckets[bucket++];
+    }
+    snprintf(le, sizeof(le), "le=\"%" PRId64 "\"", upper);
+    metricsDumpSample(sb, pMetric->name, "_bucket", pMetric->labels, le, cumulative);
+  }
+  while (bucket < METRIC_BUCKETS) {
+    cumulative += buckets[bucket++];
+  }
+  metricsDumpSample(sb, pMetric->name, "_bucket", pMetric->labels, "le=\"+Inf\"", cumulative);
+  metricsDumpSample(sb, pMetric->name, "_sum", pMetric->labels, NULL, taosMetricsGetSum(pMetric));
+  metricsDumpSample(sb, pMetric->name, "_count", pMetric->labels, NULL, cumulative);
+}
+
+static int32_t metricsCompare(const void *p1, const void *p2) {
+  return strcmp((*(SMetric **)p1)->key, (*(SMetric **)p2)->key);
+}
+
+int32_t taosMetricsDump(char **ppBuf, int32_t *pLen) {
+  taosThreadOnce(&tsMetricsInit, metricsInitOnce);
+  *ppBuf = NULL;
+  *pLen = 0;
+  if (tsMetrics.pMetrics == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  SStringBuilder sb = {0};
+  SMetric      **volatile pList = NULL;  // read after longjmp
+  if (taosStringBuilderSetJmp(&sb) != 0) {
+    taosThreadMutexUnlock(&tsMetrics.lock);
+    taosMemoryFree(pList);
+    taosStringBuilderDestroy(&sb);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  taosThreadMutexLock(&tsMetrics.lock);
+  int32_t num = taosHashGetSize(tsMetrics.pMetrics);
+  pList = taosMemoryMalloc(POINTER_BYTES * (num + 1));
+  if (pList == NULL) {
+    taosThreadMutexUnlock(&tsMetrics.lock);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  int32_t i = 0;
+  void   *pIter = taosHashIterate(tsMetrics.pMetrics, NULL);
+  while (pIter != NULL && i < num) {
+    pList[i++] = *(SMetric **)pIter;
+    pIter = taosHashIterate(tsMetrics.pMetrics, pIter);
+  }
+  taosHashCancelIterate(tsMetrics.pMetrics, pIter);
+  num = i;
+
+  // the samples of one metric family must be written together
+  taosSort(pList, num, POINTER_BYTES, metricsCompare);
+
+  for (i = 0; i < num; ++i) {
+    SMetric *pMetric = pList[i];
+    if (i == 0 || strcmp(pMetric->name, pList[i - 1]->name) != 0) {
+      char line[256];
+      int32_t len = snprintf(line, sizeof(line), "# HELP %s %s\n# TYPE %s %s\n", pMetric->name, pMetric->help,
+                             pMetric->name, pMetric->type == METRIC_COUNTER ? "counter" : "histogram");
+      taosStringBuilderAppendStringLen(&sb, line, TMIN(len, sizeof(line) - 1));
+    }
+
+    if (pMetric->type == METRIC_COUNTER) {
+      metricsDumpSample(&sb, pMetric->name, "", pMetric->labels, NULL, taosMetricsGetCount(pMetric));
+    } else {
+      metricsDumpHistogram(&sb, pMetric);
+    }
+  }
+  taosThreadMutexUnlock(&tsMetrics.lock);
+  taosMemoryFree(pList);
+
+  size_t len = 0;
+  *ppBuf = taosStringBuilderGetResult(&sb, &len);
+  *pLen = (int32_t)len;
+  return 0;
+}
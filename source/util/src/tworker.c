@@ -74,6 +74,7 @@ static void *tQWorkerThreadFp(SQueueWorker *worker) {
 
   taosBlockSIGPIPE();
   setThreadName(pool->name);
+  taosMemoryBindArena(taosMemoryGetNamedArena(pool->name));
   worker->pid = taosGetSelfPthreadId();
   uInfo("worker:%s:%d is running, thread:%08" PRId64, pool->name, worker->id, worker->pid);
 
@@ -188,6 +189,7 @@ static void *tAutoQWorkerThreadFp(SQueueWorker *worker) {
 
   taosBlockSIGPIPE();
   setThreadName(pool->name);
+  taosMemoryBindArena(taosMemoryGetNamedArena(pool->name));
   worker->pid = taosGetSelfPthreadId();
   uInfo("worker:%s:%d is running, thread:%08" PRId64, pool->name, worker->id, worker->pid);
 
@@ -327,6 +329,7 @@ static void *tWWorkerThreadFp(SWWorker *worker) {
 
   taosBlockSIGPIPE();
   setThreadName(pool->name);
+  taosMemoryBindArena(taosMemoryGetNamedArena(pool->name));
   worker->pid = taosGetSelfPthreadId();
   uInfo("worker:%s:%d is running, thread:%08" PRId64, pool->name, worker->id, worker->pid);
 
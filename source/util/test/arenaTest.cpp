@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include "taoserror.h"
+#include "tarena.h"
+
+TEST(arenaTest, bumpAlloc) {
+  SArena *pArena = taosArenaInit(NULL, 1024, 0);
+  ASSERT_NE(pArena, nullptr);
+
+  char *p1 = (char *)taosArenaAlloc(pArena, 10);
+  char *p2 = (char *)taosArenaAlloc(pArena, 10);
+  ASSERT_NE(p1, nullptr);
+  ASSERT_NE(p2, nullptr);
+  EXPECT_EQ(p2 - p1, 16);
+  EXPECT_EQ(taosArenaGetUsed(pArena), 1024);
+
+  int32_t *pInts = (int32_t *)taosArenaCalloc(pArena, 100, sizeof(int32_t));
+  for (int32_t i = 0; i < 100; ++i) {
+    EXPECT_EQ(pInts[i], 0);
+  }
+
+  // a big request gets its own chunk
+  void *pBig = taosArenaAlloc(pArena, 4096);
+  ASSERT_NE(pBig, nullptr);
+  memset(pBig, 1, 4096);
+  EXPECT_EQ(taosArenaGetUsed(pArena), 1024 + 4096);
+
+  // the current chunk is still used after a big request
+  char *p3 = (char *)taosArenaAlloc(pArena, 8);
+  EXPECT_EQ(p3 - p2, 16 + 400);
+
+  taosArenaReset(pArena);
+  EXPECT_EQ(taosArenaGetUsed(pArena), 1024);
+  EXPECT_EQ(taosArenaGetPeak(pArena), 1024 + 4096);
+  EXPECT_EQ(taosArenaAlloc(pArena, 10), p1);
+
+  taosArenaDestroy(pArena);
+}
+
+TEST(arenaTest, subArena) {
+  SArena *pRoot = taosArenaInit(NULL, 0, 0);
+  SArena *pSub1 = taosArenaInit(pRoot, 1024, 0);
+  SArena *pSub2 = taosArenaInit(pRoot, 1024, 0);
+
+  for (int32_t i = 0; i < 20; ++i) {
+    ASSERT_NE(taosArenaAlloc(pSub1, 512), nullptr);
+  }
+  for (int32_t i = 0; i < 5; ++i) {
+    ASSERT_NE(taosArenaAlloc(pSub2, 100), nullptr);
+  }
+  EXPECT_EQ(taosArenaGetUsed(pSub1), 10 * 1024);
+  EXPECT_EQ(taosArenaGetUsed(pSub2), 1024);
+  EXPECT_EQ(taosArenaGetUsed(pRoot), 11 * 1024);
+
+  taosArenaDestroy(pSub1);
+  EXPECT_EQ(taosArenaGetUsed(pRoot), 1024);
+  EXPECT_EQ(taosArenaGetPeak(pRoot), 11 * 1024);
+
+  taosArenaDestroy(pSub2);
+  EXPECT_EQ(taosArenaGetUsed(pRoot), 0);
+  taosArenaDestroy(pRoot);
+}
+
+TEST(arenaTest, limit) {
+  SArena *pRoot = taosArenaInit(NULL, 0, 4096);
+  SArena *pSub = taosArenaInit(pRoot, 1024, 0);
+
+  for (int32_t i = 0; i < 8; ++i) {
+    ASSERT_NE(taosArenaAlloc(pSub, 512), nullptr);
+  }
+  EXPECT_EQ(taosArenaAlloc(pSub, 512), nullptr);
+  EXPECT_EQ(terrno, TSDB_CODE_QRY_NOT_ENOUGH_BUFFER);
+  EXPECT_EQ(taosArenaGetUsed(pSub), 4096);
+  EXPECT_EQ(taosArenaGetUsed(pRoot), 4096);
+
+  taosArenaReset(pSub);
+  EXPECT_NE(taosArenaAlloc(pSub, 512), nullptr);
+
+  taosArenaDestroy(pSub);
+  taosArenaDestroy(pRoot);
+}
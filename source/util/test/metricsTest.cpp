@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include "taoserror.h"
+#include "tmetrics.h"
+
+TEST(metricsTest, counter) {
+  SMetric *pMetric = taosMetricsAcquire(METRIC_COUNTER, "test_counter", "counter for test", "vgId=\"2\"");
+  ASSERT_NE(pMetric, nullptr);
+
+  // the same name and labels give the same metric, a different type is refused
+  EXPECT_EQ(taosMetricsAcquire(METRIC_COUNTER, "test_counter", "counter for test", "vgId=\"2\""), pMetric);
+  EXPECT_EQ(taosMetricsAcquire(METRIC_HISTOGRAM, "test_counter", "counter for test", "vgId=\"2\""), nullptr);
+  taosMetricsRelease(pMetric);
+
+  taosMetricsAdd(pMetric, 3);
+  taosMetricsAdd(pMetric, 4);
+  EXPECT_EQ(taosMetricsGetCount(pMetric), 7);
+
+  // updates of a failed acquire are dropped
+  taosMetricsAdd(NULL, 1);
+  taosMetricsObserve(NULL, 1);
+
+  taosMetricsRelease(pMetric);
+}
+
+static void *metricsAddFp(void *param) {
+  for (int32_t i = 0; i < 100000; ++i) {
+    taosMetricsAdd((SMetric *)param, 1);
+  }
+  return NULL;
+}
+
+TEST(metricsTest, concurrentAdd) {
+  SMetric *pMetric = taosMetricsAcquire(METRIC_COUNTER, "test_concurrent", "", NULL);
+  ASSERT_NE(pMetric, nullptr);
+
+  TdThread threads[8];
+  for (int32_t i = 0; i < 8; ++i) {
+    taosThreadCreate(&threads[i], NULL, metricsAddFp, pMetric);
+  }
+  for (int32_t i = 0; i < 8; ++i) {
+    taosThreadJoin(threads[i], NULL);
+  }
+  EXPECT_EQ(taosMetricsGetCount(pMetric), 800000);
+
+  taosMetricsRelease(pMetric);
+}
+
+TEST(metricsTest, histogram) {
+  SMetric *pMetric = taosMetricsAcquire(METRIC_HISTOGRAM, "test_latency_us", "latency for test", NULL);
+  ASSERT_NE(pMetric, nullptr);
+
+  int64_t sum = 0;
+  for (int64_t v = 1; v <= 10000; ++v) {
+    taosMetricsObserve(pMetric, v);
+    sum += v;
+  }
+  EXPECT_EQ(taosMetricsGetCount(pMetric), 10000);
+  EXPECT_EQ(taosMetricsGetSum(pMetric), sum);
+
+  // the bucket bound is never below the real quantile and at most 1/8 above it
+  int64_t p50 = taosMetricsGetQuantile(pMetric, 0.5);
+  int64_t p99 = taosMetricsGetQuantile(pMetric, 0.99);
+  EXPECT_GE(p50, 5000);
+  EXPECT_LE(p50, 5000 + 5000 / 8);
+  EXPECT_GE(p99, 9900);
+  EXPECT_LE(p99, 9900 + 9900 / 8);
+  EXPECT_EQ(taosMetricsGetQuantile(pMetric, 0), 1);
+
+  // small values are exact, huge ones are clamped to the last bucket
+  taosMetricsObserve(pMetric, 0);
+  taosMetricsObserve(pMetric, INT64_MAX);
+  EXPECT_EQ(taosMetricsGetQuantile(pMetric, 0), 0);
+  EXPECT_GT(taosMetricsGetQuantile(pMetric, 1), 10000);
+
+  taosMetricsRelease(pMetric);
+}
+
+TEST(metricsTest, dump) {
+  SMetric *pCounter1 = taosMetricsAcquire(METRIC_COUNTER, "test_dump_bytes", "bytes written", "vgId=\"3\"");
+  SMetric *pCounter2 = taosMetricsAcquire(METRIC_COUNTER, "test_dump_bytes", "bytes written", "vgId=\"4\"");
+  SMetric *pHist = taosMetricsAcquire(METRIC_HISTOGRAM, "test_dump_us", "duration", "vgId=\"3\"");
+  taosMetricsAdd(pCounter1, 100);
+  taosMetricsAdd(pCounter2, 200);
+  taosMetricsObserve(pHist, 5);
+  taosMetricsObserve(pHist, 500);
+
+  char   *pBuf = NULL;
+  int32_t len = 0;
+  ASSERT_EQ(taosMetricsDump(&pBuf, &len), 0);
+  ASSERT_NE(pBuf, nullptr);
+  EXPECT_EQ(strlen(pBuf), len);
+
+  // one HELP/TYPE per family
+  const char *p = strstr(pBuf, "# TYPE test_dump_bytes counter\n");
+  ASSERT_NE(p, nullptr);
+  EXPECT_EQ(strstr(p + 1, "# TYPE test_dump_bytes counter\n"), nullptr);
+  EXPECT_NE(strstr(pBuf, "test_dump_bytes{vgId=\"3\"} 100\n"), nullptr);
+  EXPECT_NE(strstr(pBuf, "test_dump_bytes{vgId=\"4\"} 200\n"), nullptr);
+
+  EXPECT_NE(strstr(pBuf, "# TYPE test_dump_us histogram\n"), nullptr);
+  EXPECT_NE(strstr(pBuf, "test_dump_us_bucket{vgId=\"3\",le=\"3\"} 0\n"), nullptr);
+  EXPECT_NE(strstr(pBuf, "test_dump_us_bucket{vgId=\"3\",le=\"7\"} 1\n"), nullptr);
+  EXPECT_NE(strstr(pBuf, "test_dump_us_bucket{vgId=\"3\",le=\"511\"} 2\n"), nullptr);
+  EXPECT_NE(strstr(pBuf, "test_dump_us_bucket{vgId=\"3\",le=\"+Inf\"} 2\n"), nullptr);
+  EXPECT_NE(strstr(pBuf, "test_dump_us_sum{vgId=\"3\"} 505\n"), nullptr);
+  EXPECT_NE(strstr(pBuf, "test_dump_us_count{vgId=\"3\"} 2\n"), nullptr);
+  taosMemoryFree(pBuf);
+
+  // released metrics are no longer exported
+  taosMetricsRelease(pCounter1);
+  taosMetricsRelease(pCounter2);
+  taosMetricsRelease(pHist);
+  ASSERT_EQ(taosMetricsDump(&pBuf, &len), 0);
+  EXPECT_EQ(strstr(pBuf, "test_dump_bytes"), nullptr);
+  taosMemoryFree(pBuf);
+}
@@ -0,0 +1,764 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Throughput and latency of the util primitives: thash, tsimplehash, tlrucache, tskiplist, tqueue/tworker handoff
+// and the tcompression codecs, for a list of thread counts and data shapes.
+// usage: utilBench [-b hash,shash,lru,skiplist,queue,compress] [-t 1,2,4,8] [-n ops] [-f text|csv|json]
+//   -b  benchmarks to run, all of them by default
+//   -t  thread counts to run each benchmark with
+//   -n  number of operations of each run, spread over the threads
+//   -f  output format, csv and json (one object per line) are meant to be compared between builds
+
+#include "os.h"
+#include "taoserror.h"
+#include "tcompare.h"
+#include "tcompression.h"
+#include "thash.h"
+#include "tlog.h"
+#include "tlrucache.h"
+#include "tsimplehash.h"
+#include "tskiplist.h"
+#include "tworker.h"
+
+#define BENCH_MAX_THREADS     64
+#define BENCH_SAMPLE_INTERVAL 64  // every n-th op is timed on its own for the latency percentiles
+#define BENCH_BINARY_KEY_LEN  32
+#define BENCH_CMPR_ROWS       4096
+#define BENCH_QITEM_SIZE      64
+
+typedef enum {
+  BENCH_FMT_TEXT = 0,
+  BENCH_FMT_CSV,
+  BENCH_FMT_JSON,
+} EBenchFmt;
+
+typedef struct {
+  const char *benches;
+  int32_t     threads[BENCH_MAX_THREADS];
+  int32_t     numOfThreads;
+  int64_t     ops;
+  EBenchFmt   fmt;
+} SBenchConf;
+
+typedef struct {
+  const char *bench;
+  const char *shape;
+  int32_t     threads;
+  int64_t     ops;
+  int64_t     elapsedNs;
+  int64_t     bytes;  // bytes processed, for the codecs
+  double      ratio;  // compression ratio, for the codecs
+  int64_t    *samples;
+  int64_t     numOfSamples;
+} SBenchResult;
+
+typedef struct SBenchThread SBenchThread;
+typedef void (*FBenchOp)(SBenchThread *pThread, int64_t i);
+typedef int32_t (*FBenchInit)(SBenchThread *pThread);
+
+typedef struct {
+  const char *bench;
+  const char *shape;
+  FBenchInit  initFp;  // prepares pLocal of each thread before the clock starts, optional
+  FBenchOp    opFp;
+  void       *param;
+} SBenchTask;
+
+struct SBenchThread {
+  const SBenchTask *pTask;
+  TdThread          thread;
+  int32_t           tid;
+  int64_t           begin;
+  int64_t           end;
+  uint64_t          seed;
+  int64_t           startNs;
+  int64_t           endNs;
+  int64_t          *samples;
+  int64_t           numOfSamples;
+  int64_t           bytes;
+  double            ratio;
+  void             *pLocal;
+};
+
+static SBenchConf tsBenchConf = {.benches = NULL, .numOfThreads = 0, .ops = 1000000, .fmt = BENCH_FMT_TEXT};
+
+static uint64_t benchMix(uint64_t x) {
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+static uint64_t benchRand(uint64_t *seed) {
+  *seed ^= *seed << 13;
+  *seed ^= *seed >> 7;
+  *seed ^= *seed << 17;
+  return *seed;
+}
+
+static int64_t benchIntKey(const char *shape, int64_t i) {
+  return (shape[0] == 's') ? i : (int64_t)(benchMix(i) >> 1);
+}
+
+static void benchBinaryKey(int64_t i, char *key) {
+  snprintf(key, BENCH_BINARY_KEY_LEN + 1, "%016" PRIx64 "%016" PRIx64, benchMix(i), benchMix(~i));
+}
+
+static int32_t benchCompareSample(const void *p1, const void *p2) {
+  int64_t v1 = *(const int64_t *)p1;
+  int64_t v2 = *(const int64_t *)p2;
+  return (v1 == v2) ? 0 : ((v1 < v2) ? -1 : 1);
+}
+
+static int64_t benchPercentile(const SBenchResult *pRes, double q) {
+  if (pRes->numOfSamples == 0) return 0;
+  return pRes->samples[(int64_t)(q * (pRes->numOfSamples - 1))];
+}
+
+static void benchReport(SBenchResult *pRes) {
+  static bool headerPrinted = false;
+
+  taosSort(pRes->samples, pRes->numOfSamples, sizeof(int64_t), benchCompareSample);
+  double  sec = (pRes->elapsedNs > 0 ? pRes->elapsedNs : 1) / 1000000000.0;
+  double  opsPerSec = pRes->ops / sec;
+  double  mbPerSec = pRes->bytes / 1024.0 / 1024.0 / sec;
+  int64_t p50 = benchPercentile(pRes, 0.5);
+  int64_t p99 = benchPercentile(pRes, 0.99);
+  int64_t p999 = benchPercentile(pRes, 0.999);
+  int64_t max = benchPercentile(pRes, 1);
+
+  if (tsBenchConf.fmt == BENCH_FMT_JSON) {
+    printf("{\"bench\":\"%s\",\"shape\":\"%s\",\"threads\":%d,\"ops\":%" PRId64
+           ",\"seconds\":%.6f,\"opsPerSec\":%.1f,\"mbPerSec\":%.2f,\"ratio\":%.3f,\"p50Ns\":%" PRId64
+           ",\"p99Ns\":%" PRId64 ",\"p999Ns\":%" PRId64 ",\"maxNs\":%" PRId64 "}\n",
+           pRes->bench, pRes->shape, pRes->threads, pRes->ops, sec, opsPerSec, mbPerSec, pRes->ratio, p50, p99, p999,
+           max);
+  } else if (tsBenchConf.fmt == BENCH_FMT_CSV) {
+    if (!headerPrinted) {
+      printf("bench,shape,threads,ops,seconds,opsPerSec,mbPerSec,ratio,p50Ns,p99Ns,p999Ns,maxNs\n");
+    }
+    printf("%s,%s,%d,%" PRId64 ",%.6f,%.1f,%.2f,%.3f,%" PRId64 ",%" PRId64 ",%" PRId64 ",%" PRId64 "\n", pRes->bench,
+           pRes->shape, pRes->threads, pRes->ops, sec, opsPerSec, mbPerSec, pRes->ratio, p50, p99, p999, max);
+  } else {
+    if (!headerPrinted) {
+      printf("%-16s %-14s %7s %10s %12s %9s %7s %9s %9s %9s %10s\n", "bench", "shape", "threads", "ops", "ops/s",
+             "MB/s", "ratio", "p50(ns)", "p99(ns)", "p999(ns)", "max(ns)");
+    }
+    printf("%-16s %-14s %7d %10" PRId64 " %12.0f %9.2f %7.3f %9" PRId64 " %9" PRId64 " %9" PRId64 " %10" PRId64 "\n",
+           pRes->bench, pRes->shape, pRes->threads, pRes->ops, opsPerSec, mbPerSec, pRes->ratio, p50, p99, p999, max);
+  }
+
+  headerPrinted = true;
+  fflush(stdout);
+}
+
+static void *benchThreadFp(void *param) {
+  SBenchThread *pThread = param;
+  FBenchOp      opFp = pThread->pTask->opFp;
+
+  pThread->startNs = taosGetTimestampNs();
+  for (int64_t i = pThread->begin; i < pThread->end; ++i) {
+    if (i % BENCH_SAMPLE_INTERVAL == 0) {
+      int64_t start = taosGetTimestampNs();
+      (*opFp)(pThread, i);
+      pThread->samples[pThread->numOfSamples++] = taosGetTimestampNs() - start;
+    } else {
+      (*opFp)(pThread, i);
+    }
+  }
+  pThread->endNs = taosGetTimestampNs();
+  return NULL;
+}
+
+// The ops [0, ops) are split into one contiguous range per thread, so an op index is a stable key for the
+// shapes which look up what a previous task has put.
+static int32_t benchRun(const SBenchTask *pTask, int32_t threads, int64_t ops) {
+  int32_t       code = -1;
+  int32_t       numOfRunning = 0;
+  SBenchResult  res = {.bench = pTask->bench, .shape = pTask->shape, .threads = threads, .ops = ops};
+  SBenchThread *pThreads = taosMemoryCalloc(threads, sizeof(SBenchThread));
+  res.samples = taosMemoryCalloc(ops / BENCH_SAMPLE_INTERVAL + threads + 1, sizeof(int64_t));
+  if (pThreads == NULL || res.samples == NULL) goto _end;
+
+  int64_t begin = 0;
+  for (int32_t t = 0; t < threads; ++t) {
+    SBenchThread *pThread = &pThreads[t];
+    pThread->pTask = pTask;
+    pThread->tid = t;
+    pThread->begin = begin;
+    pThread->end = begin + ops / threads + (t < ops % threads ? 1 : 0);
+    pThread->seed = benchMix(t + 1);
+    pThread->samples = res.samples + res.numOfSamples;
+    res.numOfSamples += (pThread->end - pThread->begin) / BENCH_SAMPLE_INTERVAL + 1;
+    begin = pThread->end;
+
+    if (pTask->initFp != NULL && (*pTask->initFp)(pThread) != 0) goto _end;
+  }
+
+  for (; numOfRunning < threads; ++numOfRunning) {
+    if (taosThreadCreate(&pThreads[numOfRunning].thread, NULL, benchThreadFp, &pThreads[numOfRunning]) != 0) {
+      goto _end;
+    }
+  }
+
+  int64_t startNs = INT64_MAX;
+  int64_t endNs = 0;
+  int64_t numOfSamples = 0;
+  for (int32_t t = 0; t < threads; ++t) {
+    SBenchThread *pThread = &pThreads[t];
+    taosThreadJoin(pThread->thread, NULL);
+    startNs = TMIN(startNs, pThread->startNs);
+    endNs = TMAX(endNs, pThread->endNs);
+    res.bytes += pThread->bytes;
+    res.ratio += pThread->ratio / threads;
+
+    // compact the samples of all threads to the front
+    memmove(res.samples + numOfSamples, pThread->samples, pThread->numOfSamples * sizeof(int64_t));
+    numOfSamples += pThread->numOfSamples;
+  }
+  numOfRunning = 0;
+
+  res.numOfSamples = numOfSamples;
+  res.elapsedNs = endNs - startNs;
+  benchReport(&res);
+  code = 0;
+
+_end:
+  if (pThreads != NULL) {
+    for (int32_t t = 0; t < numOfRunning; ++t) {
+      taosThreadJoin(pThreads[t].thread, NULL);
+    }
+    for (int32_t t = 0; t < threads; ++t) {
+      taosMemoryFree(pThreads[t].pLocal);
+    }
+  }
+  taosMemoryFree(pThreads);
+  taosMemoryFree(res.samples);
+  if (code != 0) {
+    printf("failed to run %s %s with %d threads\n", pTask->bench, pTask->shape, threads);
+  }
+  return code;
+}
+
+/*************************************************************************
+ *                  thash / tsimplehash
+ *************************************************************************/
+static void benchHashPut(SBenchThread *pThread, int64_t i) {
+  const SBenchTask *pTask = pThread->pTask;
+  if (pTask->shape[0] == 'b') {
+    char key[BENCH_BINARY_KEY_LEN + 1];
+    benchBinaryKey(i, key);
+    taosHashPut(pTask->param, key, BENCH_BINARY_KEY_LEN, &i, sizeof(int64_t));
+  } else {
+    int64_t key = benchIntKey(pTask->shape, i);
+    taosHashPut(pTask->param, &key, sizeof(int64_t), &i, sizeof(int64_t));
+  }
+}
+
+static void benchHashGet(SBenchThread *pThread, int64_t i) {
+  const SBenchTask *pTask = pThread->pTask;
+  void             *p = NULL;
+  if (pTask->shape[0] == 'b') {
+    char key[BENCH_BINARY_KEY_LEN + 1];
+    benchBinaryKey(i, key);
+    p = taosHashGet(pTask->param, key, BENCH_BINARY_KEY_LEN);
+  } else {
+    int64_t key = benchIntKey(pTask->shape, i);
+    p = taosHashGet(pTask->param, &key, sizeof(int64_t));
+  }
+  ASSERT(p != NULL);
+}
+
+static void benchHashRemove(SBenchThread *pThread, int64_t i) {
+  const SBenchTask *pTask = pThread->pTask;
+  if (pTask->shape[0] == 'b') {
+    char key[BENCH_BINARY_KEY_LEN + 1];
+    benchBinaryKey(i, key);
+    taosHashRemove(pTask->param, key, BENCH_BINARY_KEY_LEN);
+  } else {
+    int64_t key = benchIntKey(pTask->shape, i);
+    taosHashRemove(pTask->param, &key, sizeof(int64_t));
+  }
+}
+
+static void benchSHashPut(SBenchThread *pThread, int64_t i) {
+  const SBenchTask *pTask = pThread->pTask;
+  if (pTask->shape[0] == 'b') {
+    char key[BENCH_BINARY_KEY_LEN + 1];
+    benchBinaryKey(i, key);
+    tSimpleHashPut(pTask->param, key, BENCH_BINARY_KEY_LEN, &i, sizeof(int64_t));
+  } else {
+    int64_t key = benchIntKey(pTask->shape, i);
+    tSimpleHashPut(pTask->param, &key, sizeof(int64_t), &i, sizeof(int64_t));
+  }
+}
+
+static void benchSHashGet(SBenchThread *pThread, int64_t i) {
+  const SBenchTask *pTask = pThread->pTask;
+  void             *p = NULL;
+  if (pTask->shape[0] == 'b') {
+    char key[BENCH_BINARY_KEY_LEN + 1];
+    benchBinaryKey(i, key);
+    p = tSimpleHashGet(pTask->param, key, BENCH_BINARY_KEY_LEN);
+  } else {
+    int64_t key = benchIntKey(pTask->shape, i);
+    p = tSimpleHashGet(pTask->param, &key, sizeof(int64_t));
+  }
+  ASSERT(p != NULL);
+}
+
+static void benchHash(int32_t threads, int64_t ops) {
+  const char *shapes[] = {"seq.int64", "rand.int64", "binary32"};
+  for (int32_t s = 0; s < tListLen(shapes); ++s) {
+    _hash_fn_t fn = taosGetDefaultHashFunction(shapes[s][0] == 'b' ? TSDB_DATA_TYPE_BINARY : TSDB_DATA_TYPE_BIGINT);
+    SHashObj  *pHash = taosHashInit(1024, fn, true, threads > 1 ? HASH_ENTRY_LOCK : HASH_NO_LOCK);
+    if (pHash == NULL) return;
+
+    // the table starts small, so the put ones include the cost of resizing
+    SBenchTask put = {.bench = "hash.put", .shape = shapes[s], .opFp = benchHashPut, .param = pHash};
+    SBenchTask get = {.bench = "hash.get", .shape = shapes[s], .opFp = benchHashGet, .param = pHash};
+    SBenchTask remove = {.bench = "hash.remove", .shape = shapes[s], .opFp = benchHashRemove, .param = pHash};
+    if (benchRun(&put, threads, ops) == 0 && benchRun(&get, threads, ops) == 0) {
+      benchRun(&remove, threads, ops);
+    }
+    taosHashCleanup(pHash);
+  }
+}
+
+static void benchSHash(int32_t threads, int64_t ops) {
+  // not thread safe, it is only measured single threaded
+  if (threads != 1) return;
+
+  const char *shapes[] = {"seq.int64", "rand.int64", "binary32"};
+  for (int32_t s = 0; s < tListLen(shapes); ++s) {
+    _hash_fn_t fn = taosGetDefaultHashFunction(shapes[s][0] == 'b' ? TSDB_DATA_TYPE_BINARY : TSDB_DATA_TYPE_BIGINT);
+    SSHashObj *pHash = tSimpleHashInit(1024, fn);
+    if (pHash == NULL) return;
+
+    SBenchTask put = {.bench = "shash.put", .shape = shapes[s], .opFp = benchSHashPut, .param = pHash};
+    SBenchTask get = {.bench = "shash.get", .shape = shapes[s], .opFp = benchSHashGet, .param = pHash};
+    if (benchRun(&put, threads, ops) == 0) {
+      benchRun(&get, threads, ops);
+    }
+    tSimpleHashCleanup(pHash);
+  }
+}
+
+/*************************************************************************
+ *                  tlrucache
+ *************************************************************************/
+// the key space is twice the capacity, "uniform" draws from all of it and "hot" sends 90% of the lookups to a
+// tenth of it, the misses insert the key and evict the cold ones.
+static void benchLRULookup(SBenchThread *pThread, int64_t i) {
+  const SBenchTask *pTask = pThread->pTask;
+  SLRUCache        *pCache = pTask->param;
+  int64_t           keySpace = taosLRUCacheGetCapacity(pCache) * 2;
+  uint64_t          r = benchRand(&pThread->seed);
+  int64_t           key = 0;
+  if (pTask->shape[0] == 'h' && r % 10 != 0) {
+    key = (r >> 8) % (keySpace / 10 + 1);
+  } else {
+    key = (r >> 8) % keySpace;
+  }
+
+  LRUHandle *h = taosLRUCacheLookup(pCache, &key, sizeof(int64_t));
+  if (h != NULL) {
+    taosLRUCacheRelease(pCache, h, false);
+  } else {
+    taosLRUCacheInsert(pCache, &key, sizeof(int64_t), (void *)pCache, 1, NULL, NULL, TAOS_LRU_PRIORITY_LOW, NULL);
+  }
+}
+
+static void benchLRU(int32_t threads, int64_t ops) {
+  const char *shapes[] = {"uniform", "hot"};
+  for (int32_t s = 0; s < tListLen(shapes); ++s) {
+    // every entry is charged 1, so the capacity is the number of entries
+    SLRUCache *pCache = taosLRUCacheInit(TMAX(ops / 4, 1024), -1, .5);
+    if (pCache == NULL) return;
+
+    SBenchTask lookup = {.bench = "lru.lookup", .shape = shapes[s], .opFp = benchLRULookup, .param = pCache};
+    benchRun(&lookup, threads, ops);
+    taosLRUCacheEraseUnrefEntries(pCache);
+    taosLRUCacheCleanup(pCache);
+  }
+}
+
+/*************************************************************************
+ *                  tskiplist
+ *************************************************************************/
+typedef struct {
+  SSkipList *pSkipList;
+  int64_t   *keys;  // the skip list keeps pointers to the data put, not copies
+} SBenchSkipList;
+
+static char *benchSkipListKey(const void *data) { return (char *)data; }
+
+static void benchSkipListPut(SBenchThread *pThread, int64_t i) {
+  SBenchSkipList *p = pThread->pTask->param;
+  p->keys[i] = benchIntKey(pThread->pTask->shape, i);
+  tSkipListPut(p->pSkipList, &p->keys[i]);
+}
+
+static void benchSkipListGet(SBenchThread *pThread, int64_t i) {
+  SBenchSkipList *p = pThread->pTask->param;
+  SArray         *pNodes = tSkipListGet(p->pSkipList, (SSkipListKey)&p->keys[i]);
+  ASSERT(taosArrayGetSize(pNodes) == 1);
+  taosArrayDestroy(pNodes);
+}
+
+static void benchSkipList(int32_t threads, int64_t ops) {
+  const char *shapes[] = {"seq.int64", "rand.int64"};
+  for (int32_t s = 0; s < tListLen(shapes); ++s) {
+    SBenchSkipList sl = {0};
+    uint8_t        flags = SL_DISCARD_DUP_KEY | (threads > 1 ? SL_THREAD_SAFE : 0);
+    sl.pSkipList = tSkipListCreate(MAX_SKIP_LIST_LEVEL, TSDB_DATA_TYPE_BIGINT, sizeof(int64_t),
+                                   getKeyComparFunc(TSDB_DATA_TYPE_BIGINT, TSDB_ORDER_ASC), flags, benchSkipListKey);
+    sl.keys = taosMemoryCalloc(ops, sizeof(int64_t));
+    if (sl.pSkipList != NULL && sl.keys != NULL) {
+      SBenchTask put = {.bench = "skiplist.put", .shape = shapes[s], .opFp = benchSkipListPut, .param = &sl};
+      SBenchTask get = {.bench = "skiplist.get", .shape = shapes[s], .opFp = benchSkipListGet, .param = &sl};
+      if (benchRun(&put, threads, ops) == 0) {
+        benchRun(&get, threads, ops);
+      }
+    }
+    tSkipListDestroy(sl.pSkipList);
+    taosMemoryFree(sl.keys);
+  }
+}
+
+/*************************************************************************
+ *                  tqueue / tworker handoff
+ *************************************************************************/
+// One producer writes the items, the workers of the pool take them. The latency is from the write of an item to
+// the call of the worker fp on it.
+typedef struct {
+  int64_t writeNs;
+  int64_t seq;
+} SBenchQItem;
+
+typedef struct {
+  int64_t  ops;
+  int64_t  numOfDone;
+  int64_t  lastNs;
+  int64_t *samples;
+  int64_t  numOfSamples;
+} SBenchQueue;
+
+static void benchQueueDone(SBenchQueue *pQueue, SBenchQItem *pItem) {
+  int64_t now = taosGetTimestampNs();
+  if (pItem->seq % BENCH_SAMPLE_INTERVAL == 0) {
+    int64_t pos = atomic_fetch_add_64(&pQueue->numOfSamples, 1);
+    pQueue->samples[pos] = now - pItem->writeNs;
+  }
+  taosFreeQitem(pItem);
+
+  if (atomic_add_fetch_64(&pQueue->numOfDone, 1) == pQueue->ops) {
+    atomic_store_64(&pQueue->lastNs, now);
+  }
+}
+
+static void benchQWorkerFp(SQueueInfo *pInfo, void *pItem) { benchQueueDone(pInfo->ahandle, pItem); }
+
+static void benchWWorkerFp(SQueueInfo *pInfo, STaosQall *qall, int32_t numOfItems) {
+  for (int32_t i = 0; i < numOfItems; ++i) {
+    void *pItem = NULL;
+    if (taosGetQitem(qall, &pItem) == 0) break;
+    benchQueueDone(pInfo->ahandle, pItem);
+  }
+}
+
+static void benchQueueRun(const char *shape, int32_t threads, STaosQueue **pQueues, int32_t numOfQueues,
+                          SBenchQueue *pQueue) {
+  int64_t startNs = taosGetTimestampNs();
+  for (int64_t i = 0; i < pQueue->ops; ++i) {
+    SBenchQItem *pItem = taosAllocateQitem(BENCH_QITEM_SIZE, DEF_QITEM, 0);
+    if (pItem == NULL) {
+      printf("failed to allocate queue item\n");
+      return;
+    }
+    pItem->seq = i;
+    pItem->writeNs = taosGetTimestampNs();
+    taosWriteQitem(pQueues[i % numOfQueues], pItem);
+  }
+
+  while (atomic_load_64(&pQueue->numOfDone) < pQueue->ops) {
+    taosUsleep(100);
+  }
+
+  SBenchResult res = {.bench = "queue.handoff",
+                      .shape = shape,
+                      .threads = threads,
+                      .ops = pQueue->ops,
+                      .elapsedNs = atomic_load_64(&pQueue->lastNs) - startNs,
+                      .samples = pQueue->samples,
+                      .numOfSamples = pQueue->numOfSamples};
+  benchReport(&res);
+}
+
+static void benchQueue(int32_t threads, int64_t ops) {
+  SBenchQueue queue = {.ops = ops};
+  queue.samples = taosMemoryCalloc(ops / BENCH_SAMPLE_INTERVAL + 1, sizeof(int64_t));
+  if (queue.samples == NULL) return;
+
+  // all the workers of a query pool share one queue set
+  SQWorkerPool qpool = {.name = "bench-q", .min = threads, .max = threads};
+  if (tQWorkerInit(&qpool) == 0) {
+    STaosQueue *pQueue = tQWorkerAllocQueue(&qpool, &queue, benchQWorkerFp);
+    if (pQueue != NULL) {
+      benchQueueRun("qworker", threads, &pQueue, 1, &queue);
+      tQWorkerFreeQueue(&qpool, pQueue);
+    }
+    tQWorkerCleanup(&qpool);
+  }
+
+  // a write worker owns its queues and takes their items in batches, one queue per worker here
+  queue.numOfDone = 0;
+  queue.lastNs = 0;
+  queue.numOfSamples = 0;
+  SWWorkerPool wpool = {.name = "bench-w", .max = threads};
+  STaosQueue  *pQueues[BENCH_MAX_THREADS] = {0};
+  if (tWWorkerInit(&wpool) == 0) {
+    int32_t numOfQueues = 0;
+    for (; numOfQueues < threads; ++numOfQueues) {
+      pQueues[numOfQueues] = tWWorkerAllocQueue(&wpool, &queue, benchWWorkerFp);
+      if (pQueues[numOfQueues] == NULL) break;
+    }
+    if (numOfQueues == threads) {
+      benchQueueRun("wworker", threads, pQueues, numOfQueues, &queue);
+    }
+    for (int32_t i = 0; i < numOfQueues; ++i) {
+      tWWorkerFreeQueue(&wpool, pQueues[i]);
+    }
+    tWWorkerCleanup(&wpool);
+  }
+
+  taosMemoryFree(queue.samples);
+}
+
+/*************************************************************************
+ *                  tcompression
+ *************************************************************************/
+// Each op compresses or decompresses one block of BENCH_CMPR_ROWS values, every thread works on its own block.
+typedef int32_t (*FBenchCodec)(void *pIn, int32_t nIn, int32_t nEle, void *pOut, int32_t nOut, uint8_t cmprAlg,
+                               void *pBuf, int32_t nBuf);
+
+typedef struct {
+  const char *shape;
+  int8_t      type;
+  FBenchCodec compressFp;
+  FBenchCodec decompressFp;
+} SBenchCodec;
+
+typedef struct {
+  const SBenchCodec *pCodec;
+  uint8_t            cmprAlg;
+} SBenchCodecParam;
+
+typedef struct {
+  int32_t rawLen;
+  int32_t cmprLen;
+  int32_t bufLen;
+  char   *raw;
+  char   *cmpr;
+  char   *out;
+  char   *buf;
+  char    data[];
+} SBenchCodecLocal;
+
+static void benchGenData(const char *shape, uint64_t *seed, char *raw) {
+  int64_t *i64 = (int64_t *)raw;
+  double  *d = (double *)raw;
+  int64_t  ts = 1700000000000;
+  double   v = 100;
+  for (int32_t i = 0; i < BENCH_CMPR_ROWS; ++i) {
+    uint64_t r = benchRand(seed);
+    if (strcmp(shape, "ts.regular") == 0) {
+      i64[i] = ts + i * 1000;
+    } else if (strcmp(shape, "ts.jitter") == 0) {
+      i64[i] = ts + i * 1000 + (int64_t)(r % 50);
+    } else if (strcmp(shape, "bigint.small") == 0) {
+      i64[i] = (int64_t)(r % 1000);
+    } else if (strcmp(shape, "bigint.rand") == 0) {
+      i64[i] = (int64_t)(r >> 1);
+    } else {
+      v += ((int64_t)(r % 2001) - 1000) / 1000.0;
+      d[i] = v;
+    }
+  }
+}
+
+static int32_t benchCodecInit(SBenchThread *pThread) {
+  const SBenchCodecParam *pParam = pThread->pTask->param;
+  int32_t                 rawLen = BENCH_CMPR_ROWS * sizeof(int64_t);
+  int32_t                 bufLen = rawLen * 2 + 1024;
+
+  SBenchCodecLocal *pLocal = taosMemoryCalloc(1, sizeof(SBenchCodecLocal) + rawLen * 2 + bufLen * 2);
+  if (pLocal == NULL) return -1;
+  pLocal->rawLen = rawLen;
+  pLocal->bufLen = bufLen;
+  pLocal->raw = pLocal->data;
+  pLocal->out = pLocal->raw + rawLen;
+  pLocal->cmpr = pLocal->out + rawLen;
+  pLocal->buf = pLocal->cmpr + bufLen;
+  pThread->pLocal = pLocal;
+
+  benchGenData(pParam->pCodec->shape, &pThread->seed, pLocal->raw);
+  pLocal->cmprLen = (*pParam->pCodec->compressFp)(pLocal->raw, rawLen, BENCH_CMPR_ROWS, pLocal->cmpr, bufLen,
+                                                  pParam->cmprAlg, pLocal->buf, bufLen);
+  if (pLocal->cmprLen <= 0) return -1;
+
+  pThread->ratio = (double)rawLen / pLocal->cmprLen;
+  return 0;
+}
+
+static void benchCompress(SBenchThread *pThread, int64_t i) {
+  const SBenchCodecParam *pParam = pThread->pTask->param;
+  SBenchCodecLocal       *pLocal = pThread->pLocal;
+  (*pParam->pCodec->compressFp)(pLocal->raw, pLocal->rawLen, BENCH_CMPR_ROWS, pLocal->cmpr, pLocal->bufLen,
+                                pParam->cmprAlg, pLocal->buf, pLocal->bufLen);
+  pThread->bytes += pLocal->rawLen;
+}
+
+static void benchDecompress(SBenchThread *pThread, int64_t i) {
+  const SBenchCodecParam *pParam = pThread->pTask->param;
+  SBenchCodecLocal       *pLocal = pThread->pLocal;
+  (*pParam->pCodec->decompressFp)(pLocal->cmpr, pLocal->cmprLen, BENCH_CMPR_ROWS, pLocal->out, pLocal->rawLen,
+                                  pParam->cmprAlg, pLocal->buf, pLocal->bufLen);
+  pThread->bytes += pLocal->rawLen;
+}
+
+static void benchCodec(int32_t threads, int64_t ops) {
+  const SBenchCodec codecs[] = {
+      {"ts.regular", TSDB_DATA_TYPE_TIMESTAMP, tsCompressTimestamp, tsDecompressTimestamp},
+      {"ts.jitter", TSDB_DATA_TYPE_TIMESTAMP, tsCompressTimestamp, tsDecompressTimestamp},
+      {"bigint.small", TSDB_DATA_TYPE_BIGINT, tsCompressBigint, tsDecompressBigint},
+      {"bigint.rand", TSDB_DATA_TYPE_BIGINT, tsCompressBigint, tsDecompressBigint},
+      {"double.walk", TSDB_DATA_TYPE_DOUBLE, tsCompressDouble, tsDecompressDouble},
+  };
+  const uint8_t algs[] = {ONE_STAGE_COMP, TWO_STAGE_COMP};
+
+  // an op works on a whole block, so there are fewer of them
+  int64_t blocks = TMAX(ops / BENCH_CMPR_ROWS * 16, threads);
+  for (int32_t c = 0; c < tListLen(codecs); ++c) {
+    for (int32_t a = 0; a < tListLen(algs); ++a) {
+      SBenchCodecParam param = {.pCodec = &codecs[c], .cmprAlg = algs[a]};
+      const char      *cmpr = (algs[a] == ONE_STAGE_COMP) ? "compress.1" : "compress.2";
+      const char      *decmpr = (algs[a] == ONE_STAGE_COMP) ? "decompress.1" : "decompress.2";
+      SBenchTask       compress = {
+                .bench = cmpr, .shape = codecs[c].shape, .initFp = benchCodecInit, .opFp = benchCompress, .param = &param};
+      SBenchTask decompress = {.bench = decmpr,
+                               .shape = codecs[c].shape,
+                               .initFp = benchCodecInit,
+                               .opFp = benchDecompress,
+                               .param = &param};
+      if (benchRun(&compress, threads, blocks) == 0) {
+        benchRun(&decompress, threads, blocks);
+      }
+    }
+  }
+}
+
+/*************************************************************************
+ *                  main
+ *************************************************************************/
+typedef struct {
+  const char *name;
+  void (*benchFp)(int32_t threads, int64_t ops);
+} SBenchEntry;
+
+static const SBenchEntry tsBenches[] = {
+    {"hash", benchHash},         {"shash", benchSHash}, {"lru", benchLRU},
+    {"skiplist", benchSkipList}, {"queue", benchQueue}, {"compress", benchCodec},
+};
+
+static bool benchSelected(const char *name) {
+  if (tsBenchConf.benches == NULL) return true;
+
+  int32_t     len = strlen(name);
+  const char *p = tsBenchConf.benches;
+  while ((p = strstr(p, name)) != NULL) {
+    bool begin = (p == tsBenchConf.benches || p[-1] == ',');
+    bool end = (p[len] == 0 || p[len] == ',');
+    if (begin && end) return true;
+    p += len;
+  }
+  return false;
+}
+
+static int32_t benchParseThreads(const char *arg) {
+  tsBenchConf.numOfThreads = 0;
+  while (*arg != 0 && tsBenchConf.numOfThreads < BENCH_MAX_THREADS) {
+    int32_t threads = atoi(arg);
+    if (threads <= 0 || threads > BENCH_MAX_THREADS) return -1;
+    tsBenchConf.threads[tsBenchConf.numOfThreads++] = threads;
+
+    const char *p = strchr(arg, ',');
+    if (p == NULL) break;
+    arg = p + 1;
+  }
+  return 0;
+}
+
+static void benchUsage() {
+  printf("usage: utilBench [-b hash,shash,lru,skiplist,queue,compress] [-t 1,2,4,8] [-n ops] [-f text|csv|json]\n");
+}
+
+int main(int argc, char *argv[]) {
+  for (int32_t i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+      tsBenchConf.benches = argv[++i];
+    } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+      if (benchParseThreads(argv[++i]) != 0) {
+        benchUsage();
+        return -1;
+      }
+    } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+      tsBenchConf.ops = atoll(argv[++i]);
+    } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+      ++i;
+      if (strcmp(argv[i], "csv") == 0) {
+        tsBenchConf.fmt = BENCH_FMT_CSV;
+      } else if (strcmp(argv[i], "json") == 0) {
+        tsBenchConf.fmt = BENCH_FMT_JSON;
+      } else {
+        tsBenchConf.fmt = BENCH_FMT_TEXT;
+      }
+    } else {
+      benchUsage();
+      return (strcmp(argv[i], "-h") == 0) ? 0 : -1;
+    }
+  }
+
+  if (tsBenchConf.numOfThreads == 0) {
+    int32_t threads[] = {1, 2, 4, 8};
+    memcpy(tsBenchConf.threads, threads, sizeof(threads));
+    tsBenchConf.numOfThreads = tListLen(threads);
+  }
+  if (tsBenchConf.ops < BENCH_SAMPLE_INTERVAL) {
+    tsBenchConf.ops = BENCH_SAMPLE_INTERVAL;
+  }
+
+  // keep the logs of the worker pools out of the results
+  uDebugFlag = 0;
+
+  for (int32_t b = 0; b < tListLen(tsBenches); ++b) {
+    if (!benchSelected(tsBenches[b].name)) continue;
+    for (int32_t t = 0; t < tsBenchConf.numOfThreads; ++t) {
+      (*tsBenches[b].benchFp)(tsBenchConf.threads[t], tsBenchConf.ops);
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,99 @@
+import time
+
+from util.log import *
+from util.sql import *
+from util.cases import *
+from util.dnodes import *
+
+class TDTestCase:
+    # 2022-01-01 00:00:00.000 UTC
+    start = 1640995200000
+    dayMs = 86400 * 1000
+    step = 10 * 1000
+    childCnt = 4
+    batchSize = 1000
+
+    def init(self, conn, logSql, replicaVar=1):
+        self.replicaVar = int(replicaVar)
+        tdLog.debug(f"start to excute {__file__}")
+        tdSql.init(conn.cursor(), logSql)
+
+    def insert_rows(self, begin, end):
+        for i in range(self.childCnt):
+            values = []
+            for ts in range(begin, end, self.step):
+                values.append(f"({ts}, {(ts // self.step + i) % 1000 - 500}, {ts // self.step % 97})")
+                if len(values) == self.batchSize:
+                    tdSql.execute(f"insert into db_rollup.t{i} values " + " ".join(values))
+                    values = []
+            if len(values) > 0:
+                tdSql.execute(f"insert into db_rollup.t{i} values " + " ".join(values))
+
+    def create_tables(self):
+        tdSql.execute("create database db_rollup vgroups 2 precision 'ms'")
+        tdSql.execute("create table db_rollup.st(ts timestamp, c1 int, c2 bigint) tags(area int)")
+        for i in range(self.childCnt):
+            tdSql.execute(f"create table db_rollup.t{i} using db_rollup.st tags({i})")
+        tdSql.execute("create sma index sma_rollup on db_rollup.st function(max(c1), min(c1), sum(c2)) interval(1m)")
+
+    def query_with(self, sql, optimize):
+        tdSql.execute(f"alter local 'querySmaOptimize {optimize}'")
+        tdSql.query(sql)
+        return list(tdSql.queryResult)
+
+    # the result read through the index must be the one computed from the raw rows
+    def same_result(self, sql):
+        raw = self.query_with(sql, 0)
+        sma = self.query_with(sql, 1)
+        if raw != sma:
+            tdLog.info(f"result differs, sql={sql} raw rows={len(raw)} sma rows={len(sma)}")
+            return False
+        return True
+
+    def check_closed_range(self):
+        end = self.start + self.dayMs
+        sqls = [
+            f"select _wstart, max(c1), min(c1), sum(c2) from db_rollup.st where ts >= {self.start} and ts < {end} interval(1h)",
+            f"select _wstart, max(c1), sum(c2) from db_rollup.st where ts >= {self.start} and ts < {end} interval(10m) sliding(5m)",
+            f"select _wstart, min(c1) from db_rollup.st where ts >= {self.start} and ts < {end} interval(1d)",
+        ]
+        for sql in sqls:
+            # the index stream fills the history in the background
+            for i in range(60):
+                if self.same_result(sql):
+                    break
+                time.sleep(1)
+            else:
+                tdLog.exit(f"rollup result differs from the raw one, sql={sql}")
+            tdLog.info(f"rollup result checked, sql={sql}")
+
+    def check_open_range(self):
+        # rows after the watermark are not in the index yet, a range that reaches them must still see them
+        hourMs = 3600 * 1000
+        now = int(time.time() * 1000) // self.step * self.step
+        self.insert_rows(now - hourMs, now)
+        begin = now // hourMs * hourMs - 2 * hourMs
+        sqls = [
+            f"select _wstart, max(c1), min(c1), sum(c2) from db_rollup.st where ts >= {begin} interval(1h)",
+            f"select _wstart, max(c1), min(c1), sum(c2) from db_rollup.st where ts >= {begin} and ts < {begin + 3 * hourMs} interval(1h)",
+        ]
+        for sql in sqls:
+            if not self.same_result(sql):
+                tdLog.exit(f"rollup over the unclosed windows differs from the raw one, sql={sql}")
+            tdLog.info(f"open range checked, sql={sql}")
+
+    def run(self):
+        self.create_tables()
+        self.insert_rows(self.start, self.start + self.dayMs)
+        # a later row closes the last index windows of the day
+        self.insert_rows(self.start + 2 * self.dayMs, self.start + 2 * self.dayMs + self.step)
+        self.check_closed_range()
+        self.check_open_range()
+
+    def stop(self):
+        tdSql.execute("alter local 'querySmaOptimize 0'")
+        tdSql.close()
+        tdLog.success(f"{__file__} successfully executed")
+
+tdCases.addLinux(__file__, TDTestCase())
+tdCases.addWindows(__file__, TDTestCase())
@@ -0,0 +1,121 @@
+import sys
+import time
+from taos.tmq import *
+from util.log import *
+from util.sql import *
+from util.cases import *
+from util.dnodes import *
+from util.common import *
+sys.path.append("./7-tmq")
+from tmqCommon import *
+
+
+class TDTestCase:
+    def init(self, conn, logSql, replicaVar=1):
+        self.replicaVar = int(replicaVar)
+        tdLog.debug(f"start to excute {__file__}")
+        tdSql.init(conn.cursor(), False)
+
+        self.db_name = "tmq_prefetch_db"
+        self.topic_name = "tmq_prefetch_topic"
+        self.stable_name = "tmqst"
+        self.ctb_num = 8
+        self.rows_per_ctb = 2000
+        self.prepareData()
+
+    def prepareData(self):
+        tdSql.execute("create database if not exists %s vgroups 4 wal_retention_period 3600;"%(self.db_name))
+        tdSql.execute("use %s;"%(self.db_name))
+        tdSql.execute("create table %s.%s (ts timestamp, col0 int) tags(groupid int);"%(self.db_name, self.stable_name))
+        for i in range(self.ctb_num):
+            tdSql.execute("create table tmqct_%d using %s.%s tags(%d);"%(i, self.db_name, self.stable_name, i))
+        # every row carries a distinct col0, so the consumed set can be checked for holes
+        for i in range(self.ctb_num):
+            for start in range(0, self.rows_per_ctb, 500):
+                sql = "insert into tmqct_%d values"%(i)
+                for j in range(start, start + 500):
+                    sql += "(now+%ds, %d)"%(j, i * self.rows_per_ctb + j)
+                tdSql.execute(sql + ";")
+        tdLog.info("Insert data into child tables successfully")
+        tdSql.execute("create topic %s as select ts, col0 from %s;"%(self.topic_name, self.stable_name))
+
+    def tmqSubscribe(self, clientId):
+        consumer_dict = {
+            "group.id": "prefetch_grp",
+            "client.id": clientId,
+            "td.connect.user": "root",
+            "td.connect.pass": "taosdata",
+            "enable.auto.commit": "false",
+            "auto.offset.reset": "earliest",
+            "experimental.snapshot.enable": "false",
+            "msg.with.table.name": "false",
+            "msg.prefetch.num": "4",
+            "session.timeout.ms": "12000",
+            "heartbeat.interval.ms": "1000"
+        }
+        consumer = Consumer(consumer_dict)
+        consumer.subscribe([self.topic_name])
+        tdLog.info("create consumer %s success!"%(clientId))
+        return consumer
+
+    def pollOnce(self, consumer, consumed):
+        res = consumer.poll(1)
+        if not res:
+            return False
+        err = res.error()
+        if err is not None:
+            raise err
+        for block in res.value():
+            for row in block.fetchall():
+                consumed.add(row[1])
+        consumer.commit(res)
+        return True
+
+    def test_rebalance_with_prefetched_rsp(self):
+        """Rebalance while the first consumer has prefetched rsp buffered, no row may be missed
+        """
+        consumed = set()
+        consumer1 = self.tmqSubscribe("client1")
+        consumer2 = None
+        try:
+            # consume a few messages so that consumer1 has prefetched rsp in its queue
+            polled = 0
+            while polled < 3:
+                if self.pollOnce(consumer1, consumed):
+                    polled += 1
+            tdLog.info("consumer1 polled %d rows before rebalance"%(len(consumed)))
+
+            # the second consumer joins the group and takes over part of the vgroups
+            consumer2 = self.tmqSubscribe("client2")
+            idle = 0
+            while idle < 10:
+                got1 = self.pollOnce(consumer1, consumed)
+                got2 = self.pollOnce(consumer2, consumed)
+                idle = 0 if (got1 or got2) else idle + 1
+
+            assign1 = consumer1.assignment()
+            assign2 = consumer2.assignment()
+            tdLog.info("assignment after rebalance, consumer1: %d, consumer2: %d"%(len(assign1), len(assign2)))
+            total = self.ctb_num * self.rows_per_ctb
+            missing = set(range(total)) - consumed
+            if len(missing) > 0:
+                tdLog.exit("%d rows missing after rebalance, e.g. %s"%(len(missing), sorted(missing)[:10]))
+            tdLog.info("all %d rows consumed across the rebalance"%(total))
+        finally:
+            consumer1.unsubscribe()
+            consumer1.close()
+            if consumer2 is not None:
+                consumer2.unsubscribe()
+                consumer2.close()
+
+    def run(self):
+        self.test_rebalance_with_prefetched_rsp()
+
+    def stop(self):
+        tdSql.execute("drop topic %s" % self.topic_name)
+        tdSql.execute("drop database %s"%(self.db_name))
+        tdSql.close()
+        tdLog.success(f"{__file__} successfully executed")
+
+tdCases.addLinux(__file__, TDTestCase())
+tdCases.addWindows(__file__, TDTestCase())
@@ -0,0 +1,59 @@
+import taos
+import sys
+import os
+
+from util.log import *
+from util.sql import *
+from util.cases import *
+from util.dnodes import *
+from util.common import *
+sys.path.append("./7-tmq")
+from tmqCommon import *
+
+class TDTestCase:
+    def init(self, conn, logSql, replicaVar=1):
+        self.replicaVar = int(replicaVar)
+        tdLog.debug(f"start to excute {__file__}")
+        tdSql.init(conn.cursor())
+
+    def checkData(self):
+        # rsub_ct0 is written in row format, rsub_ct1 in column format, both with a null every 10 rows
+        for tb in ["rsub_ct0", "rsub_ct1"]:
+            tdSql.query("select ts, c1, c2 from rsub_src.%s order by ts"%(tb))
+            src = tdSql.queryResult
+            tdSql.query("select ts, c1, c2 from rsub_dst.%s order by ts"%(tb))
+            tdSql.checkRows(len(src))
+            for i in range(len(src)):
+                for j in range(3):
+                    tdSql.checkData(i, j, src[i][j])
+
+        tdSql.query("select count(*), count(c1), sum(c1) from rsub_dst.rsub_ct1")
+        tdSql.checkData(0, 0, 100)
+        tdSql.checkData(0, 1, 90)
+        tdSql.checkData(0, 2, -4500)
+
+        # nothing is written to the table with another column type
+        tdSql.query("select count(*) from rsub_bad.st")
+        tdSql.checkData(0, 0, 0)
+        return
+
+    def check(self):
+        buildPath = tdCom.getBuildPath()
+        cmdStr = '%s/build/bin/tmq_raw_submit_test'%(buildPath)
+        tdLog.info(cmdStr)
+        if os.system(cmdStr) != 0:
+            tdLog.exit("tmq_raw_submit_test failed")
+
+        self.checkData()
+        return
+
+    def run(self):
+        self.check()
+
+    def stop(self):
+        tdSql.execute("drop topic if exists rsub_topic")
+        tdSql.close()
+        tdLog.success(f"{__file__} successfully executed")
+
+tdCases.addLinux(__file__, TDTestCase())
+tdCases.addWindows(__file__, TDTestCase())
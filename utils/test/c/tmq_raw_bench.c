@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Replication throughput of tmq_get_raw/tmq_write_raw, with or without "msg.raw.submit".
+// usage: tmq_raw_bench [-r] [-t tables] [-n rowsPerTable] [-v vgroups] [-s]
+//   -r  consume wal submit data instead of retrieved blocks
+//   -s  skip writing the source data, reuse the one of a previous run
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "taos.h"
+#include "types.h"
+
+#define BENCH_ROWS_PER_SQL 500
+
+typedef struct {
+  bool    rawSubmit;
+  bool    skipInsert;
+  int32_t tables;
+  int32_t rows;
+  int32_t vgroups;
+} Config;
+
+static Config g_conf = {.rawSubmit = false, .skipInsert = false, .tables = 100, .rows = 10000, .vgroups = 4};
+
+static int32_t execSql(TAOS* pConn, const char* sql) {
+  TAOS_RES* pRes = taos_query(pConn, sql);
+  int32_t   code = taos_errno(pRes);
+  if (code != 0) {
+    printf("failed to run: %s, reason:%s\n", sql, taos_errstr(pRes));
+  }
+  taos_free_result(pRes);
+  return code;
+}
+
+static int64_t queryCount(TAOS* pConn, const char* sql) {
+  TAOS_RES* pRes = taos_query(pConn, sql);
+  int64_t   count = -1;
+  if (taos_errno(pRes) == 0) {
+    TAOS_ROW row = taos_fetch_row(pRes);
+    if (row != NULL && row[0] != NULL) {
+      count = *(int64_t*)row[0];
+    }
+  } else {
+    printf("failed to run: %s, reason:%s\n", sql, taos_errstr(pRes));
+  }
+  taos_free_result(pRes);
+  return count;
+}
+
+static int32_t createDb(TAOS* pConn, const char* db) {
+  char sql[256] = {0};
+  sprintf(sql, "drop database if exists %s", db);
+  if (execSql(pConn, sql) != 0) return -1;
+  sprintf(sql, "create database %s vgroups %d wal_retention_period 3600", db, g_conf.vgroups);
+  if (execSql(pConn, sql) != 0) return -1;
+  sprintf(sql,
+          "create stable %s.meters (ts timestamp, current float, voltage int, phase float, location binary(32)) "
+          "tags (groupid int)",
+          db);
+  if (execSql(pConn, sql) != 0) return -1;
+
+  for (int32_t i = 0; i < g_conf.tables; i++) {
+    sprintf(sql, "create table %s.d%d using %s.meters tags(%d)", db, i, db, i);
+    if (execSql(pConn, sql) != 0) return -1;
+  }
+  return 0;
+}
+
+static int32_t insertData(TAOS* pConn) {
+  char* sql = taosMemoryMalloc(BENCH_ROWS_PER_SQL * 128 + 128);
+  if (sql == NULL) return -1;
+
+  int64_t ts = 1700000000000;
+  int64_t start = taosGetTimestampUs();
+  for (int32_t i = 0; i < g_conf.tables; i++) {
+    for (int32_t r = 0; r < g_conf.rows; r += BENCH_ROWS_PER_SQL) {
+      int32_t len = sprintf(sql, "insert into bench_src.d%d values", i);
+      for (int32_t k = r; k < r + BENCH_ROWS_PER_SQL && k < g_conf.rows; k++) {
+        len += sprintf(sql + len, "(%" PRId64 ",%f,%d,%f,'location_%d')", ts + k, k * 0.1, 200 + k % 20, k * 0.01,
+                       k % 100);
+      }
+      if (execSql(pConn, sql) != 0) {
+        taosMemoryFree(sql);
+        return -1;
+      }
+    }
+  }
+  int64_t cost = taosGetTimestampUs() - start;
+  printf("insert %" PRId64 " rows in %.3f s\n", (int64_t)g_conf.tables * g_conf.rows, cost / 1000000.0);
+
+  taosMemoryFree(sql);
+  return 0;
+}
+
+static tmq_t* buildConsumer() {
+  char group[64] = {0};
+  sprintf(group, "bench_%" PRId64, taosGetTimestampMs());
+
+  tmq_conf_t* conf = tmq_conf_new();
+  tmq_conf_set(conf, "group.id", group);
+  tmq_conf_set(conf, "td.connect.user", "root");
+  tmq_conf_set(conf, "td.connect.pass", "taosdata");
+  tmq_conf_set(conf, "msg.with.table.name", "true");
+  tmq_conf_set(conf, "enable.auto.commit", "false");
+  tmq_conf_set(conf, "auto.offset.reset", "earliest");
+  tmq_conf_set(conf, "msg.raw.submit", g_conf.rawSubmit ? "true" : "false");
+
+  tmq_t* tmq = tmq_consumer_new(conf, NULL, 0);
+  assert(tmq);
+  tmq_conf_destroy(conf);
+  return tmq;
+}
+
+static int32_t replicate(TAOS* pConn) {
+  tmq_t*      tmq = buildConsumer();
+  tmq_list_t* topics = tmq_list_new();
+  tmq_list_append(topics, "bench_topic");
+  int32_t code = tmq_subscribe(tmq, topics);
+  tmq_list_destroy(topics);
+  if (code != 0) {
+    printf("failed to subscribe, reason:%s\n", tmq_err2str(code));
+    tmq_consumer_close(tmq);
+    return -1;
+  }
+
+  int64_t msgs = 0;
+  int64_t bytes = 0;
+  int64_t pollUs = 0;
+  int64_t writeUs = 0;
+  int64_t start = taosGetTimestampUs();
+  while (1) {
+    int64_t   t0 = taosGetTimestampUs();
+    TAOS_RES* msg = tmq_consumer_poll(tmq, 5000);
+    int64_t   t1 = taosGetTimestampUs();
+    pollUs += t1 - t0;
+    if (msg == NULL) break;
+
+    tmq_raw_data raw = {0};
+    code = tmq_get_raw(msg, &raw);
+    if (code == 0) {
+      code = tmq_write_raw(pConn, raw);
+      bytes += raw.raw_len;
+      tmq_free_raw(raw);
+    }
+    taos_free_result(msg);
+    writeUs += taosGetTimestampUs() - t1;
+    if (code != 0) {
+      printf("failed to write raw data, reason:%s\n", tmq_err2str(code));
+      break;
+    }
+    msgs++;
+  }
+  // the last poll only waited for the timeout
+  int64_t cost = taosGetTimestampUs() - start - 5000000;
+  tmq_consumer_close(tmq);
+  if (code != 0) return -1;
+
+  int64_t rows = queryCount(pConn, "select count(*) from bench_dst.meters");
+  if (cost <= 0) cost = 1;
+  printf("raw submit: %s, msgs: %" PRId64 ", raw bytes: %" PRId64 ", rows: %" PRId64 "\n",
+         g_conf.rawSubmit ? "on" : "off", msgs, bytes, rows);
+  printf("replicate cost %.3f s, poll %.3f s, write %.3f s, %.0f rows/s, %.2f MB/s\n", cost / 1000000.0,
+         (pollUs - 5000000) / 1000000.0, writeUs / 1000000.0, rows * 1000000.0 / cost,
+         bytes / 1024.0 / 1024.0 * 1000000.0 / cost);
+
+  if (rows != (int64_t)g_conf.tables * g_conf.rows) {
+    printf("rows mismatch, expect %" PRId64 "\n", (int64_t)g_conf.tables * g_conf.rows);
+    return -1;
+  }
+  return 0;
+}
+
+int main(int argc, char* argv[]) {
+  for (int32_t i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-r") == 0) {
+      g_conf.rawSubmit = true;
+    } else if (strcmp(argv[i], "-s") == 0) {
+      g_conf.skipInsert = true;
+    } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+      g_conf.tables = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+      g_conf.rows = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-v") == 0 && i + 1 < argc) {
+      g_conf.vgroups = atoi(argv[++i]);
+    }
+  }
+
+  TAOS* pConn = taos_connect("localhost", "root", "taosdata", NULL, 0);
+  if (pConn == NULL) {
+    printf("failed to connect, reason:%s\n", taos_errstr(NULL));
+    return -1;
+  }
+
+  if (!g_conf.skipInsert) {
+    execSql(pConn, "drop topic if exists bench_topic");
+    if (createDb(pConn, "bench_src") != 0 || insertData(pConn) != 0) {
+      taos_close(pConn);
+      return -1;
+    }
+    if (execSql(pConn, "create topic bench_topic as database bench_src") != 0) {
+      taos_close(pConn);
+      return -1;
+    }
+  }
+
+  // the child tables are created up front, only the data goes through tmq
+  int32_t code = createDb(pConn, "bench_dst");
+  if (code == 0) {
+    code = execSql(pConn, "use bench_dst");
+  }
+  if (code == 0) {
+    code = replicate(pConn);
+  }
+
+  taos_close(pConn);
+  return code == 0 ? 0 : -1;
+}
@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Round trip of the wal submit data with "msg.raw.submit", checked by 7-tmq/tmqRawSubmit.py.
+// The source stable has a dropped column, so its column ids differ from the destination ones. rsub_ct0 is written
+// by sql in row format and rsub_ct1 by stmt in column format. rsub_dst takes the data, rsub_bad has a column of
+// another type and must reject it.
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "taos.h"
+#include "taoserror.h"
+#include "types.h"
+
+#define RSUB_ROWS 100
+#define RSUB_TS   1700000000000
+
+static int32_t execSql(TAOS* pConn, const char* sql) {
+  TAOS_RES* pRes = taos_query(pConn, sql);
+  int32_t   code = taos_errno(pRes);
+  if (code != 0) {
+    printf("failed to run: %s, reason:%s\n", sql, taos_errstr(pRes));
+  }
+  taos_free_result(pRes);
+  return code;
+}
+
+static int32_t prepareSource(TAOS* pConn) {
+  const char* sqls[] = {
+      "drop topic if exists rsub_topic",
+      "drop database if exists rsub_src",
+      "create database rsub_src vgroups 1 wal_retention_period 3600",
+      "create stable rsub_src.st (ts timestamp, cx int, c1 int, c2 binary(16)) tags (t int)",
+      "alter stable rsub_src.st drop column cx",
+      "create table rsub_src.rsub_ct0 using rsub_src.st tags(0)",
+      "create table rsub_src.rsub_ct1 using rsub_src.st tags(1)",
+  };
+  for (int32_t i = 0; i < sizeof(sqls) / sizeof(sqls[0]); i++) {
+    if (execSql(pConn, sqls[i]) != 0) return -1;
+  }
+
+  char    sql[RSUB_ROWS * 64 + 64] = {0};
+  int32_t len = sprintf(sql, "insert into rsub_src.rsub_ct0 values");
+  for (int32_t i = 0; i < RSUB_ROWS; i++) {
+    if (i % 10 == 0) {
+      len += sprintf(sql + len, "(%" PRId64 ",NULL,'v_%d')", (int64_t)RSUB_TS + i, i);
+    } else {
+      len += sprintf(sql + len, "(%" PRId64 ",%d,'v_%d')", (int64_t)RSUB_TS + i, i, i);
+    }
+  }
+  if (execSql(pConn, sql) != 0) return -1;
+
+  int64_t ts[RSUB_ROWS];
+  int32_t c1[RSUB_ROWS];
+  char    c2[RSUB_ROWS][16];
+  int32_t tsLen[RSUB_ROWS];
+  int32_t c1Len[RSUB_ROWS];
+  int32_t c2Len[RSUB_ROWS];
+  char    c1Null[RSUB_ROWS];
+  for (int32_t i = 0; i < RSUB_ROWS; i++) {
+    ts[i] = RSUB_TS + i;
+    c1[i] = -i;
+    c1Null[i] = (i % 10 == 0);
+    c2Len[i] = snprintf(c2[i], sizeof(c2[i]), "w_%d", i);
+    tsLen[i] = sizeof(int64_t);
+    c1Len[i] = sizeof(int32_t);
+  }
+  TAOS_MULTI_BIND params[3] = {
+      {.buffer_type = TSDB_DATA_TYPE_TIMESTAMP, .buffer = ts, .buffer_length = sizeof(int64_t), .length = tsLen,
+       .is_null = NULL, .num = RSUB_ROWS},
+      {.buffer_type = TSDB_DATA_TYPE_INT, .buffer = c1, .buffer_length = sizeof(int32_t), .length = c1Len,
+       .is_null = c1Null, .num = RSUB_ROWS},
+      {.buffer_type = TSDB_DATA_TYPE_BINARY, .buffer = c2, .buffer_length = sizeof(c2[0]), .length = c2Len,
+       .is_null = NULL, .num = RSUB_ROWS},
+  };
+
+  TAOS_STMT* stmt = taos_stmt_init(pConn);
+  int32_t    code = taos_stmt_prepare(stmt, "insert into rsub_src.rsub_ct1 values(?,?,?)", 0);
+  if (code == 0) code = taos_stmt_bind_param_batch(stmt, params);
+  if (code == 0) code = taos_stmt_add_batch(stmt);
+  if (code == 0) code = taos_stmt_execute(stmt);
+  if (code != 0) {
+    printf("failed to insert by stmt, reason:%s\n", taos_stmt_errstr(stmt));
+  }
+  taos_stmt_close(stmt);
+  if (code != 0) return -1;
+
+  return execSql(pConn, "create topic rsub_topic as stable rsub_src.st");
+}
+
+static int32_t prepareDest(TAOS* pConn, const char* db, const char* c1Type, int32_t c2Bytes) {
+  char sql[256] = {0};
+  sprintf(sql, "drop database if exists %s", db);
+  if (execSql(pConn, sql) != 0) return -1;
+  sprintf(sql, "create database %s vgroups 2", db);
+  if (execSql(pConn, sql) != 0) return -1;
+  sprintf(sql, "create stable %s.st (ts timestamp, c1 %s, c2 binary(%d)) tags (t int)", db, c1Type, c2Bytes);
+  if (execSql(pConn, sql) != 0) return -1;
+  for (int32_t i = 0; i < 2; i++) {
+    sprintf(sql, "create table %s.rsub_ct%d using %s.st tags(%d)", db, i, db, i);
+    if (execSql(pConn, sql) != 0) return -1;
+  }
+  sprintf(sql, "use %s", db);
+  return execSql(pConn, sql);
+}
+
+// consume the topic from the beginning and write every message, stop at the first failure
+static int32_t replicate(TAOS* pConn, const char* group) {
+  tmq_conf_t* conf = tmq_conf_new();
+  tmq_conf_set(conf, "group.id", group);
+  tmq_conf_set(conf, "td.connect.user", "root");
+  tmq_conf_set(conf, "td.connect.pass", "taosdata");
+  tmq_conf_set(conf, "msg.with.table.name", "true");
+  tmq_conf_set(conf, "enable.auto.commit", "false");
+  tmq_conf_set(conf, "auto.offset.reset", "earliest");
+  tmq_conf_set(conf, "msg.raw.submit", "true");
+  tmq_t* tmq = tmq_consumer_new(conf, NULL, 0);
+  assert(tmq);
+  tmq_conf_destroy(conf);
+
+  tmq_list_t* topics = tmq_list_new();
+  tmq_list_append(topics, "rsub_topic");
+  int32_t code = tmq_subscribe(tmq, topics);
+  tmq_list_destroy(topics);
+
+  int32_t msgs = 0;
+  while (code == 0) {
+    TAOS_RES* msg = tmq_consumer_poll(tmq, 5000);
+    if (msg == NULL) break;
+
+    tmq_raw_data raw = {0};
+    code = tmq_get_raw(msg, &raw);
+    if (code == 0) {
+      code = tmq_write_raw(pConn, raw);
+      tmq_free_raw(raw);
+    }
+    taos_free_result(msg);
+    msgs++;
+  }
+  tmq_consumer_close(tmq);
+  printf("group %s, msgs: %d, code: 0x%x %s\n", group, msgs, code, tmq_err2str(code));
+  if (code == 0 && msgs == 0) {
+    return -1;
+  }
+  return code;
+}
+
+int main(int argc, char* argv[]) {
+  TAOS* pConn = taos_connect("localhost", "root", "taosdata", NULL, 0);
+  if (pConn == NULL) {
+    printf("failed to connect, reason:%s\n", taos_errstr(NULL));
+    return -1;
+  }
+
+  int32_t ret = -1;
+  if (prepareSource(pConn) != 0) goto _end;
+
+  // a wider var column is accepted, the column ids are remapped and the schema version is the destination one
+  if (prepareDest(pConn, "rsub_dst", "int", 24) != 0) goto _end;
+  if (replicate(pConn, "rsub_grp_dst") != 0) {
+    printf("failed to replicate to rsub_dst\n");
+    goto _end;
+  }
+
+  // a column of another type is rejected before anything is sent
+  if (prepareDest(pConn, "rsub_bad", "bigint", 16) != 0) goto _end;
+  int32_t code = replicate(pConn, "rsub_grp_bad");
+  if (code != TSDB_CODE_TDB_INVALID_TABLE_SCHEMA_VER) {
+    printf("rsub_bad expect schema version error, got 0x%x\n", code);
+    goto _end;
+  }
+  ret = 0;
+
+_end:
+  taos_close(pConn);
+  return ret;
+}